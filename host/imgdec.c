@@ -0,0 +1,1117 @@
+/*-----------------------------------------------------------------------------+
+|                                                                              |
+| filename: imgdec.c                                                           |
+| project:  zxn::scrnshot                                                      |
+| author:   S. Zell                                                            |
+| date:     10/18/2026                                                         |
+|                                                                              |
++------------------------------------------------------------------------------+
+|                                                                              |
+| description:                                                                 |
+|                                                                              |
+| Image decoders of the regression test (host)                                 |
+|                                                                              |
++------------------------------------------------------------------------------+
+|                                                                              |
+| Copyright (c) 10/18/2026 STZ Engineering                                     |
+|                                                                              |
+| This software is provided  "as is",  without warranty of any kind, express   |
+| or implied. In no event shall STZ or its contributors be held liable for any |
+| direct, indirect, incidental, special or consequential damages arising out   |
+| of the use of or inability to use this software.                             |
+|                                                                              |
+| Permission is granted to anyone  to use this  software for any purpose,      |
+| including commercial applications,  and to alter it and redistribute it      |
+| freely, subject to the following restrictions:                               |
+|                                                                              |
+| 1. Redistributions of source code must retain the above copyright            |
+|    notice, definition, disclaimer, and this list of conditions.              |
+|                                                                              |
+| 2. Redistributions in binary form must reproduce the above copyright         |
+|    notice, definition, disclaimer, and this list of conditions in            |
+|    documentation and/or other materials provided with the distribution.      |
+|                                                                          ;-) |
++-----------------------------------------------------------------------------*/
+
+/*============================================================================*/
+/*                               Includes                                     */
+/*============================================================================*/
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+#include "imgdec.h"
+
+/*============================================================================*/
+/*                               Defines                                      */
+/*============================================================================*/
+#if !defined(EOK)
+  #define EOK 0
+#endif
+
+/*!
+Little / big endian values of the file headers
+*/
+#define GET_LE16(p) ((uint16_t) ((p)[0] | ((p)[1] << 8)))
+#define GET_LE32(p) ((uint32_t) ((p)[0] | ((p)[1] << 8) | ((p)[2] << 16) | ((uint32_t) (p)[3] << 24)))
+#define GET_BE32(p) ((uint32_t) (((uint32_t) (p)[0] << 24) | ((p)[1] << 16) | ((p)[2] << 8) | (p)[3]))
+
+/*!
+Limits of the LZW codes (GIF) and the Huffman codes (deflate)
+*/
+#define LZW_CODES    4096
+#define HUFF_BITS    15
+#define HUFF_SYMBOLS 288
+
+/*============================================================================*/
+/*                               Type-Definitions                             */
+/*============================================================================*/
+/*!
+Canonical Huffman code: number of codes per length, symbols ordered by code
+*/
+typedef struct _huffman
+{
+  uint16_t auiCount[HUFF_BITS + 1];
+  uint16_t auiSymbol[HUFF_SYMBOLS];
+} huffman_t;
+
+/*!
+State of the inflater (zlib stream of the IDAT chunks)
+*/
+typedef struct _inflate
+{
+  const uint8_t* pIn;
+  uint32_t       uiInLen;
+  uint32_t       uiInPos;
+  uint32_t       uiBitBuf;
+  uint8_t        uiBitCnt;
+  uint8_t*       pOut;
+  uint32_t       uiOutLen;
+  uint32_t       uiOutPos;
+} inflate_t;
+
+/*============================================================================*/
+/*                               Prototypes                                   */
+/*============================================================================*/
+/*!
+Decoders of the formats
+*/
+static int decodeBmp(const uint8_t* pData, uint32_t uiSize, rgbimage_t* pImage);
+static int decodeGif(const uint8_t* pData, uint32_t uiSize, rgbimage_t* pImage);
+static int decodePng(const uint8_t* pData, uint32_t uiSize, rgbimage_t* pImage);
+static int decodeQoi(const uint8_t* pData, uint32_t uiSize, rgbimage_t* pImage);
+
+/*!
+Allocates the pixels of an image
+*/
+static int allocRgbImage(rgbimage_t* pImage, uint32_t uiWidth, uint32_t uiHeight);
+
+/*!
+Decompresses a zlib stream into a buffer of the expected size
+*/
+static int inflateData(const uint8_t* pIn, uint32_t uiInLen, uint8_t* pOut, uint32_t uiOutLen);
+
+/*!
+Deflate helpers: bits, Huffman tables, symbols, blocks
+*/
+static int  getBits(inflate_t* pState, uint8_t uiCount, uint32_t* pValue);
+static void buildHuffman(huffman_t* pHuff, const uint8_t* pLen, uint16_t uiCount);
+static int  decodeSymbol(inflate_t* pState, const huffman_t* pHuff);
+static int  inflateCodes(inflate_t* pState, const huffman_t* pLit, const huffman_t* pDist);
+static int  inflateDynamic(inflate_t* pState);
+
+/*============================================================================*/
+/*                               Implementation                               */
+/*============================================================================*/
+
+/*----------------------------------------------------------------------------*/
+/* decodeImage()                                                              */
+/*----------------------------------------------------------------------------*/
+int decodeImage(const uint8_t* pData, uint32_t uiSize, rgbimage_t* pImage)
+{
+  pImage->uiWidth  = 0;
+  pImage->uiHeight = 0;
+  pImage->pRgb     = 0;
+
+  if ((2 <= uiSize) && (0 == memcmp(pData, "BM", 2)))
+  {
+    return decodeBmp(pData, uiSize, pImage);
+  }
+  else if ((6 <= uiSize) && (0 == memcmp(pData, "GIF8", 4)))
+  {
+    return decodeGif(pData, uiSize, pImage);
+  }
+  else if ((8 <= uiSize) && (0 == memcmp(pData, "\x89PNG\r\n\x1A\n", 8)))
+  {
+    return decodePng(pData, uiSize, pImage);
+  }
+  else if ((4 <= uiSize) && (0 == memcmp(pData, "qoif", 4)))
+  {
+    return decodeQoi(pData, uiSize, pImage);
+  }
+
+  return ENOTSUP;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* freeRgbImage()                                                             */
+/*----------------------------------------------------------------------------*/
+void freeRgbImage(rgbimage_t* pImage)
+{
+  free(pImage->pRgb);
+  pImage->pRgb = 0;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* allocRgbImage()                                                            */
+/*----------------------------------------------------------------------------*/
+static int allocRgbImage(rgbimage_t* pImage, uint32_t uiWidth, uint32_t uiHeight)
+{
+  if ((0 == uiWidth) || (0 == uiHeight) || (0xFFFF < uiWidth) || (0xFFFF < uiHeight))
+  {
+    return EBADF;
+  }
+
+  if (0 == (pImage->pRgb = malloc(uiWidth * uiHeight * 3)))
+  {
+    return ENOMEM;
+  }
+
+  pImage->uiWidth  = (uint16_t) uiWidth;
+  pImage->uiHeight = (uint16_t) uiHeight;
+
+  return EOK;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* decodeBmp()                                                                */
+/*----------------------------------------------------------------------------*/
+static int decodeBmp(const uint8_t* pData, uint32_t uiSize, rgbimage_t* pImage)
+{
+  const uint8_t* pPalette;
+  uint32_t uiOffBits;
+  uint32_t uiInfoSize;
+  int32_t  iWidth;
+  int32_t  iHeight;
+  uint16_t uiBits;
+  uint32_t uiStride;
+  uint32_t uiRows;
+  int      iReturn;
+
+  if (54 > uiSize)
+  {
+    return EBADF;
+  }
+
+  uiOffBits  = GET_LE32(&pData[10]);
+  uiInfoSize = GET_LE32(&pData[14]);
+  iWidth     = (int32_t) GET_LE32(&pData[18]);
+  iHeight    = (int32_t) GET_LE32(&pData[22]);
+  uiBits     = GET_LE16(&pData[28]);
+  uiRows     = (uint32_t) (0 > iHeight ? -iHeight : iHeight);
+  pPalette   = &pData[14 + uiInfoSize];
+
+  if (((1 != uiBits) && (4 != uiBits) && (8 != uiBits)) || (0 != GET_LE32(&pData[30])) || (0 >= iWidth))
+  {
+    return EBADF;
+  }
+
+  uiStride = ((((uint32_t) iWidth) * uiBits + 31) >> 5) << 2;
+
+  if ((uiOffBits > uiSize) || ((uiSize - uiOffBits) < uiStride * uiRows) || (uiOffBits < 14 + uiInfoSize))
+  {
+    return EBADF;
+  }
+
+  if (EOK != (iReturn = allocRgbImage(pImage, (uint32_t) iWidth, uiRows)))
+  {
+    return iReturn;
+  }
+
+  for (uint32_t y = 0; y < uiRows; ++y)
+  {
+    /* Bottom-up (positive height) or top-down */
+    const uint8_t* pRow = &pData[uiOffBits + uiStride * (0 < iHeight ? uiRows - 1 - y : y)];
+    uint8_t*       pDst = &pImage->pRgb[y * pImage->uiWidth * 3];
+
+    for (uint32_t x = 0; x < (uint32_t) iWidth; ++x, pDst += 3)
+    {
+      uint32_t uiBit   = x * uiBits;
+      uint8_t  uiIndex = (pRow[uiBit >> 3] >> (8 - uiBits - (uiBit & 7))) & ((1 << uiBits) - 1);
+      const uint8_t* pEntry = &pPalette[uiIndex << 2];
+
+      if ((uint32_t) (pEntry + 4 - pData) > uiOffBits)
+      {
+        freeRgbImage(pImage);
+        return EBADF;
+      }
+
+      pDst[0] = pEntry[2];
+      pDst[1] = pEntry[1];
+      pDst[2] = pEntry[0];
+    }
+  }
+
+  return EOK;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* decodeGif()                                                                */
+/*----------------------------------------------------------------------------*/
+static int decodeGif(const uint8_t* pData, uint32_t uiSize, rgbimage_t* pImage)
+{
+  static uint16_t auiPrefix[LZW_CODES];
+  static uint8_t  auiSuffix[LZW_CODES];
+  static uint8_t  auiStack[LZW_CODES];
+  const uint8_t* pPalette = 0;
+  uint16_t uiColors = 0;
+  uint32_t uiPos = 13;
+  uint32_t uiPixels;
+  uint32_t uiOut = 0;
+  uint8_t* pIndex;
+  int      iReturn;
+
+  if (13 > uiSize)
+  {
+    return EBADF;
+  }
+
+  /* Global colour table */
+  if (0 != (pData[10] & 0x80))
+  {
+    uiColors = (uint16_t) (2 << (pData[10] & 0x07));
+    pPalette = &pData[uiPos];
+    uiPos   += uiColors * 3;
+  }
+
+  /* Extensions up to the first image */
+  while ((uiPos < uiSize) && (0x21 == pData[uiPos]))
+  {
+    uiPos += 2;
+
+    while ((uiPos < uiSize) && (0 != pData[uiPos]))
+    {
+      uiPos += pData[uiPos] + 1;
+    }
+
+    ++uiPos;
+  }
+
+  /* Image descriptor: the whole canvas, not interlaced */
+  if ((uiPos + 11 > uiSize) || (0x2C != pData[uiPos]) || (0 != GET_LE16(&pData[uiPos + 1])) || (0 != GET_LE16(&pData[uiPos + 3])) ||
+      (GET_LE16(&pData[6]) != GET_LE16(&pData[uiPos + 5])) || (GET_LE16(&pData[8]) != GET_LE16(&pData[uiPos + 7])) ||
+      (0 != (pData[uiPos + 9] & 0x40)))
+  {
+    return EBADF;
+  }
+
+  if (0 != (pData[uiPos + 9] & 0x80))
+  {
+    uiColors = (uint16_t) (2 << (pData[uiPos + 9] & 0x07));
+    pPalette = &pData[uiPos + 10];
+    uiPos   += uiColors * 3;
+  }
+
+  uiPos += 10;
+
+  if ((0 == pPalette) || (uiPos >= uiSize) || (2 > pData[uiPos]) || (8 < pData[uiPos]))
+  {
+    return EBADF;
+  }
+
+  if (EOK != (iReturn = allocRgbImage(pImage, GET_LE16(&pData[6]), GET_LE16(&pData[8]))))
+  {
+    return iReturn;
+  }
+
+  uiPixels = ((uint32_t) pImage->uiWidth) * pImage->uiHeight;
+
+  if (0 == (pIndex = malloc(uiPixels)))
+  {
+    freeRgbImage(pImage);
+    return ENOMEM;
+  }
+
+  /* LZW data in sub-blocks */
+  {
+    uint8_t  uiMinSize = pData[uiPos++];
+    uint16_t uiClear   = (uint16_t) (1 << uiMinSize);
+    uint16_t uiNext    = uiClear + 2;
+    uint8_t  uiCodeLen = uiMinSize + 1;
+    int32_t  iPrev     = -1;
+    uint8_t  uiFirst   = 0;
+    uint32_t uiBitBuf  = 0;
+    uint8_t  uiBitCnt  = 0;
+    uint8_t  uiBlock   = 0;
+    bool     bEnd      = false;
+
+    iReturn = EBADF;
+
+    while (!bEnd)
+    {
+      uint16_t uiCode;
+
+      /* Next code (LSB first) */
+      while (uiBitCnt < uiCodeLen)
+      {
+        if (0 == uiBlock)
+        {
+          if ((uiPos >= uiSize) || (0 == (uiBlock = pData[uiPos++])))
+          {
+            bEnd = true;
+            break;
+          }
+        }
+
+        if (uiPos >= uiSize)
+        {
+          bEnd = true;
+          break;
+        }
+
+        uiBitBuf |= ((uint32_t) pData[uiPos++]) << uiBitCnt;
+        uiBitCnt += 8;
+        --uiBlock;
+      }
+
+      if (bEnd)
+      {
+        break;
+      }
+
+      uiCode     = (uint16_t) (uiBitBuf & ((1u << uiCodeLen) - 1));
+      uiBitBuf >>= uiCodeLen;
+      uiBitCnt  -= uiCodeLen;
+
+      if (uiCode == uiClear)
+      {
+        uiNext    = uiClear + 2;
+        uiCodeLen = uiMinSize + 1;
+        iPrev     = -1;
+      }
+      else if (uiCode == uiClear + 1)
+      {
+        iReturn = (uiOut == uiPixels ? EOK : EBADF);
+        bEnd    = true;
+      }
+      else
+      {
+        uint16_t uiSp  = 0;
+        uint16_t uiCur = uiCode;
+
+        if ((uiCode > uiNext) || ((uiCode == uiNext) && (0 > iPrev)))
+        {
+          break;
+        }
+
+        /* Code not yet in the table: previous string + its first byte */
+        if (uiCode == uiNext)
+        {
+          auiStack[uiSp++] = uiFirst;
+          uiCur = (uint16_t) iPrev;
+        }
+
+        while (uiCur >= uiClear)
+        {
+          auiStack[uiSp++] = auiSuffix[uiCur];
+          uiCur = auiPrefix[uiCur];
+        }
+
+        auiStack[uiSp++] = (uint8_t) uiCur;
+        uiFirst = (uint8_t) uiCur;
+
+        if (uiOut + uiSp > uiPixels)
+        {
+          break;
+        }
+
+        while (0 < uiSp)
+        {
+          pIndex[uiOut++] = auiStack[--uiSp];
+        }
+
+        if ((0 <= iPrev) && (LZW_CODES > uiNext))
+        {
+          auiPrefix[uiNext] = (uint16_t) iPrev;
+          auiSuffix[uiNext] = uiFirst;
+
+          if ((++uiNext == (1u << uiCodeLen)) && (12 > uiCodeLen))
+          {
+            ++uiCodeLen;
+          }
+        }
+
+        iPrev = uiCode;
+      }
+    }
+  }
+
+  for (uint32_t i = 0; (EOK == iReturn) && (i < uiPixels); ++i)
+  {
+    if (pIndex[i] >= uiColors)
+    {
+      iReturn = EBADF;
+    }
+    else
+    {
+      memcpy(&pImage->pRgb[i * 3], &pPalette[pIndex[i] * 3], 3);
+    }
+  }
+
+  free(pIndex);
+
+  if (EOK != iReturn)
+  {
+    freeRgbImage(pImage);
+  }
+
+  return iReturn;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* decodePng()                                                                */
+/*----------------------------------------------------------------------------*/
+static int decodePng(const uint8_t* pData, uint32_t uiSize, rgbimage_t* pImage)
+{
+  uint8_t  auiPalette[256 * 3];
+  uint16_t uiColors = 0;
+  uint32_t uiWidth  = 0;
+  uint32_t uiHeight = 0;
+  uint8_t  uiDepth  = 0;
+  uint8_t  uiType   = 0;
+  uint8_t* pZlib    = 0;
+  uint32_t uiZlib   = 0;
+  uint8_t* pRaw     = 0;
+  uint32_t uiStride;
+  uint8_t  uiBpp;
+  uint32_t uiPos    = 8;
+  int      iReturn  = EOK;
+
+  /* Chunks: IHDR, PLTE, IDAT (concatenated) */
+  while ((EOK == iReturn) && (uiPos + 12 <= uiSize))
+  {
+    uint32_t       uiLen  = GET_BE32(&pData[uiPos]);
+    const uint8_t* pChunk = &pData[uiPos + 8];
+
+    if (uiLen > uiSize - uiPos - 12)
+    {
+      iReturn = EBADF;
+      break;
+    }
+
+    if (0 == memcmp(&pData[uiPos + 4], "IHDR", 4))
+    {
+      uiWidth  = GET_BE32(&pChunk[0]);
+      uiHeight = GET_BE32(&pChunk[4]);
+      uiDepth  = pChunk[8];
+      uiType   = pChunk[9];
+
+      if ((13 != uiLen) || (0 != pChunk[12]) || !(((3 == uiType) && ((1 == uiDepth) || (4 == uiDepth) || (8 == uiDepth))) ||
+                                                  ((2 == uiType) && (8 == uiDepth))))
+      {
+        iReturn = EBADF;
+      }
+    }
+    else if (0 == memcmp(&pData[uiPos + 4], "PLTE", 4))
+    {
+      uiColors = (uint16_t) (uiLen / 3);
+      memcpy(auiPalette, pChunk, (uiLen <= sizeof(auiPalette) ? uiLen : sizeof(auiPalette)));
+    }
+    else if (0 == memcmp(&pData[uiPos + 4], "IDAT", 4))
+    {
+      uint8_t* pNew = realloc(pZlib, uiZlib + uiLen);
+
+      if (0 == pNew)
+      {
+        iReturn = ENOMEM;
+        break;
+      }
+
+      pZlib = pNew;
+      memcpy(&pZlib[uiZlib], pChunk, uiLen);
+      uiZlib += uiLen;
+    }
+    else if (0 == memcmp(&pData[uiPos + 4], "IEND", 4))
+    {
+      break;
+    }
+
+    uiPos += uiLen + 12;
+  }
+
+  if ((EOK == iReturn) && ((0 == uiWidth) || (0 == pZlib) || ((3 == uiType) && (0 == uiColors))))
+  {
+    iReturn = EBADF;
+  }
+
+  uiBpp    = (2 == uiType ? 3 : 1);
+  uiStride = (uiWidth * uiDepth * (2 == uiType ? 3 : 1) + 7) >> 3;
+
+  if ((EOK == iReturn) && (0 == (pRaw = malloc((uiStride + 1) * uiHeight))))
+  {
+    iReturn = ENOMEM;
+  }
+
+  if (EOK == iReturn)
+  {
+    iReturn = inflateData(pZlib, uiZlib, pRaw, (uiStride + 1) * uiHeight);
+  }
+
+  if (EOK == iReturn)
+  {
+    iReturn = allocRgbImage(pImage, uiWidth, uiHeight);
+  }
+
+  /* Row filters (in place), then the pixels */
+  for (uint32_t y = 0; (EOK == iReturn) && (y < uiHeight); ++y)
+  {
+    uint8_t* pRow   = &pRaw[y * (uiStride + 1) + 1];
+    uint8_t* pPrev  = (0 < y ? pRow - (uiStride + 1) : 0);
+    uint8_t  uiFilt = pRow[-1];
+    uint8_t* pDst   = &pImage->pRgb[y * uiWidth * 3];
+
+    for (uint32_t x = 0; x < uiStride; ++x)
+    {
+      int a = (x >= uiBpp ? pRow[x - uiBpp] : 0);
+      int b = (0 != pPrev ? pPrev[x] : 0);
+      int c = ((0 != pPrev) && (x >= uiBpp) ? pPrev[x - uiBpp] : 0);
+
+      switch (uiFilt)
+      {
+        case 0:
+          break;
+
+        case 1:
+          pRow[x] += a;
+          break;
+
+        case 2:
+          pRow[x] += b;
+          break;
+
+        case 3:
+          pRow[x] += (a + b) >> 1;
+          break;
+
+        case 4:
+        {
+          int p  = a + b - c;
+          int pa = abs(p - a);
+          int pb = abs(p - b);
+          int pc = abs(p - c);
+
+          pRow[x] += (pa <= pb && pa <= pc ? a : (pb <= pc ? b : c));
+          break;
+        }
+
+        default:
+          iReturn = EBADF;
+      }
+    }
+
+    for (uint32_t x = 0; (EOK == iReturn) && (x < uiWidth); ++x, pDst += 3)
+    {
+      if (2 == uiType)
+      {
+        memcpy(pDst, &pRow[x * 3], 3);
+      }
+      else
+      {
+        uint32_t uiBit   = x * uiDepth;
+        uint8_t  uiIndex = (pRow[uiBit >> 3] >> (8 - uiDepth - (uiBit & 7))) & ((1 << uiDepth) - 1);
+
+        if (uiIndex >= uiColors)
+        {
+          iReturn = EBADF;
+        }
+        else
+        {
+          memcpy(pDst, &auiPalette[uiIndex * 3], 3);
+        }
+      }
+    }
+  }
+
+  if (EOK != iReturn)
+  {
+    freeRgbImage(pImage);
+  }
+
+  free(pRaw);
+  free(pZlib);
+
+  return iReturn;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* decodeQoi()                                                                */
+/*----------------------------------------------------------------------------*/
+static int decodeQoi(const uint8_t* pData, uint32_t uiSize, rgbimage_t* pImage)
+{
+  uint8_t  aauiIndex[64][4];
+  uint8_t  auiPixel[4] = {0, 0, 0, 255};
+  uint32_t uiPixels;
+  uint32_t uiPos = 14;
+  uint32_t uiRun = 0;
+  int      iReturn;
+
+  if ((22 > uiSize) || ((3 != pData[12]) && (4 != pData[12])) ||
+      (0 != memcmp(&pData[uiSize - 8], "\0\0\0\0\0\0\0\1", 8)))
+  {
+    return EBADF;
+  }
+
+  if (EOK != (iReturn = allocRgbImage(pImage, GET_BE32(&pData[4]), GET_BE32(&pData[8]))))
+  {
+    return iReturn;
+  }
+
+  memset(aauiIndex, 0, sizeof(aauiIndex));
+  uiPixels = ((uint32_t) pImage->uiWidth) * pImage->uiHeight;
+  uiSize  -= 8;
+
+  for (uint32_t i = 0; i < uiPixels; ++i)
+  {
+    if (0 < uiRun)
+    {
+      --uiRun;
+    }
+    else if (uiPos >= uiSize)
+    {
+      iReturn = EBADF;
+      break;
+    }
+    else
+    {
+      uint8_t uiOp = pData[uiPos++];
+
+      if ((0xFE == uiOp) && (uiPos + 3 <= uiSize))
+      {
+        memcpy(auiPixel, &pData[uiPos], 3);
+        uiPos += 3;
+      }
+      else if ((0xFF == uiOp) && (uiPos + 4 <= uiSize))
+      {
+        memcpy(auiPixel, &pData[uiPos], 4);
+        uiPos += 4;
+      }
+      else if (0x00 == (uiOp & 0xC0))
+      {
+        memcpy(auiPixel, aauiIndex[uiOp], 4);
+      }
+      else if (0x40 == (uiOp & 0xC0))
+      {
+        auiPixel[0] += ((uiOp >> 4) & 0x03) - 2;
+        auiPixel[1] += ((uiOp >> 2) & 0x03) - 2;
+        auiPixel[2] += ( uiOp       & 0x03) - 2;
+      }
+      else if ((0x80 == (uiOp & 0xC0)) && (uiPos < uiSize))
+      {
+        int iDg = (uiOp & 0x3F) - 32;
+        uint8_t uiNext = pData[uiPos++];
+
+        auiPixel[0] += iDg - 8 + ((uiNext >> 4) & 0x0F);
+        auiPixel[1] += iDg;
+        auiPixel[2] += iDg - 8 + ( uiNext       & 0x0F);
+      }
+      else if ((0xC0 == (uiOp & 0xC0)) && (0xFE > uiOp))
+      {
+        uiRun = uiOp & 0x3F;
+      }
+      else
+      {
+        iReturn = EBADF;
+        break;
+      }
+
+      memcpy(aauiIndex[(auiPixel[0] * 3 + auiPixel[1] * 5 + auiPixel[2] * 7 + auiPixel[3] * 11) & 0x3F], auiPixel, 4);
+    }
+
+    memcpy(&pImage->pRgb[i * 3], auiPixel, 3);
+  }
+
+  if ((EOK == iReturn) && ((0 != uiRun) || (uiPos != uiSize)))
+  {
+    iReturn = EBADF;
+  }
+
+  if (EOK != iReturn)
+  {
+    freeRgbImage(pImage);
+  }
+
+  return iReturn;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* inflateData()                                                              */
+/*----------------------------------------------------------------------------*/
+static int inflateData(const uint8_t* pIn, uint32_t uiInLen, uint8_t* pOut, uint32_t uiOutLen)
+{
+  inflate_t tState;
+  uint32_t  uiFinal = 0;
+  uint32_t  uiType;
+  int       iReturn = EOK;
+
+  /* zlib header: deflate, no dictionary */
+  if ((2 > uiInLen) || (8 != (pIn[0] & 0x0F)) || (0 != (((pIn[0] << 8) | pIn[1]) % 31)) || (0 != (pIn[1] & 0x20)))
+  {
+    return EBADF;
+  }
+
+  memset(&tState, 0, sizeof(tState));
+  tState.pIn      = pIn;
+  tState.uiInLen  = uiInLen;
+  tState.uiInPos  = 2;
+  tState.pOut     = pOut;
+  tState.uiOutLen = uiOutLen;
+
+  while ((EOK == iReturn) && (0 == uiFinal))
+  {
+    if ((EOK != (iReturn = getBits(&tState, 1, &uiFinal))) || (EOK != (iReturn = getBits(&tState, 2, &uiType))))
+    {
+      break;
+    }
+
+    if (0 == uiType)
+    {
+      /* Stored: byte aligned LEN, NLEN, data */
+      uint16_t uiLen;
+
+      tState.uiBitBuf = 0;
+      tState.uiBitCnt = 0;
+
+      if (tState.uiInPos + 4 > uiInLen)
+      {
+        iReturn = EBADF;
+        break;
+      }
+
+      uiLen = GET_LE16(&pIn[tState.uiInPos]);
+
+      if ((0xFFFF != (uiLen ^ GET_LE16(&pIn[tState.uiInPos + 2]))) ||
+          (tState.uiInPos + 4 + uiLen > uiInLen) || (tState.uiOutPos + uiLen > uiOutLen))
+      {
+        iReturn = EBADF;
+        break;
+      }
+
+      memcpy(&pOut[tState.uiOutPos], &pIn[tState.uiInPos + 4], uiLen);
+      tState.uiInPos  += 4 + uiLen;
+      tState.uiOutPos += uiLen;
+    }
+    else if (1 == uiType)
+    {
+      /* Fixed codes */
+      static huffman_t tLit;
+      static huffman_t tDist;
+      uint8_t auiLen[HUFF_SYMBOLS];
+      uint16_t i;
+
+      for (i =   0; i < 144; ++i) auiLen[i] = 8;
+      for (     ; i < 256; ++i) auiLen[i] = 9;
+      for (     ; i < 280; ++i) auiLen[i] = 7;
+      for (     ; i < 288; ++i) auiLen[i] = 8;
+      buildHuffman(&tLit, auiLen, 288);
+
+      memset(auiLen, 5, 30);
+      buildHuffman(&tDist, auiLen, 30);
+
+      iReturn = inflateCodes(&tState, &tLit, &tDist);
+    }
+    else if (2 == uiType)
+    {
+      iReturn = inflateDynamic(&tState);
+    }
+    else
+    {
+      iReturn = EBADF;
+    }
+  }
+
+  if ((EOK == iReturn) && (tState.uiOutPos != uiOutLen))
+  {
+    iReturn = EBADF;
+  }
+
+  return iReturn;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* getBits()                                                                  */
+/*----------------------------------------------------------------------------*/
+static int getBits(inflate_t* pState, uint8_t uiCount, uint32_t* pValue)
+{
+  while (pState->uiBitCnt < uiCount)
+  {
+    if (pState->uiInPos >= pState->uiInLen)
+    {
+      return EBADF;
+    }
+
+    pState->uiBitBuf |= ((uint32_t) pState->pIn[pState->uiInPos++]) << pState->uiBitCnt;
+    pState->uiBitCnt += 8;
+  }
+
+  *pValue = pState->uiBitBuf & ((1u << uiCount) - 1);
+  pState->uiBitBuf >>= uiCount;
+  pState->uiBitCnt  -= uiCount;
+
+  return EOK;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* buildHuffman()                                                             */
+/*----------------------------------------------------------------------------*/
+static void buildHuffman(huffman_t* pHuff, const uint8_t* pLen, uint16_t uiCount)
+{
+  uint16_t auiOffset[HUFF_BITS + 1];
+
+  memset(pHuff->auiCount, 0, sizeof(pHuff->auiCount));
+
+  for (uint16_t i = 0; i < uiCount; ++i)
+  {
+    ++pHuff->auiCount[pLen[i]];
+  }
+
+  auiOffset[1] = 0;
+
+  for (uint8_t uiLen = 1; uiLen < HUFF_BITS; ++uiLen)
+  {
+    auiOffset[uiLen + 1] = auiOffset[uiLen] + pHuff->auiCount[uiLen];
+  }
+
+  for (uint16_t i = 0; i < uiCount; ++i)
+  {
+    if (0 != pLen[i])
+    {
+      pHuff->auiSymbol[auiOffset[pLen[i]]++] = i;
+    }
+  }
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* decodeSymbol()                                                             */
+/*----------------------------------------------------------------------------*/
+static int decodeSymbol(inflate_t* pState, const huffman_t* pHuff)
+{
+  int iCode  = 0;
+  int iFirst = 0;
+  int iIndex = 0;
+
+  /* Codes are stored MSB first: one bit per length */
+  for (uint8_t uiLen = 1; uiLen <= HUFF_BITS; ++uiLen)
+  {
+    uint32_t uiBit;
+    int      iCount = pHuff->auiCount[uiLen];
+
+    if (EOK != getBits(pState, 1, &uiBit))
+    {
+      return -1;
+    }
+
+    iCode |= (int) uiBit;
+
+    if (iCode - iCount < iFirst)
+    {
+      return pHuff->auiSymbol[iIndex + (iCode - iFirst)];
+    }
+
+    iIndex += iCount;
+    iFirst += iCount;
+    iFirst <<= 1;
+    iCode  <<= 1;
+  }
+
+  return -1;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* inflateCodes()                                                             */
+/*----------------------------------------------------------------------------*/
+static int inflateCodes(inflate_t* pState, const huffman_t* pLit, const huffman_t* pDist)
+{
+  static const uint16_t auiLenBase[29]  = {3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+                                           35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+  static const uint8_t  auiLenExtra[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+                                           3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+  static const uint16_t auiDistBase[30] = {1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+                                           257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145,
+                                           8193, 12289, 16385, 24577};
+  static const uint8_t  auiDistExtra[30] = {0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+                                            7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+  int iSymbol;
+
+  while (256 != (iSymbol = decodeSymbol(pState, pLit)))
+  {
+    if (0 > iSymbol)
+    {
+      return EBADF;
+    }
+
+    if (256 > iSymbol)
+    {
+      if (pState->uiOutPos >= pState->uiOutLen)
+      {
+        return EBADF;
+      }
+
+      pState->pOut[pState->uiOutPos++] = (uint8_t) iSymbol;
+    }
+    else
+    {
+      uint32_t uiLen;
+      uint32_t uiDist;
+      int      iDist;
+
+      if ((285 < iSymbol) || (EOK != getBits(pState, auiLenExtra[iSymbol - 257], &uiLen)))
+      {
+        return EBADF;
+      }
+
+      uiLen += auiLenBase[iSymbol - 257];
+
+      if ((0 > (iDist = decodeSymbol(pState, pDist))) || (29 < iDist) || (EOK != getBits(pState, auiDistExtra[iDist], &uiDist)))
+      {
+        return EBADF;
+      }
+
+      uiDist += auiDistBase[iDist];
+
+      if ((uiDist > pState->uiOutPos) || (pState->uiOutPos + uiLen > pState->uiOutLen))
+      {
+        return EBADF;
+      }
+
+      for (; 0 < uiLen; --uiLen, ++pState->uiOutPos)
+      {
+        pState->pOut[pState->uiOutPos] = pState->pOut[pState->uiOutPos - uiDist];
+      }
+    }
+  }
+
+  return EOK;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* inflateDynamic()                                                           */
+/*----------------------------------------------------------------------------*/
+static int inflateDynamic(inflate_t* pState)
+{
+  static const uint8_t auiOrder[19] = {16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15};
+  static huffman_t tLen;
+  static huffman_t tLit;
+  static huffman_t tDist;
+  uint8_t  auiLen[HUFF_SYMBOLS + 32];
+  uint32_t uiLit;
+  uint32_t uiDist;
+  uint32_t uiCode;
+  uint32_t uiValue;
+  uint16_t i;
+
+  if ((EOK != getBits(pState, 5, &uiLit)) || (EOK != getBits(pState, 5, &uiDist)) || (EOK != getBits(pState, 4, &uiCode)))
+  {
+    return EBADF;
+  }
+
+  uiLit  += 257;
+  uiDist += 1;
+  uiCode += 4;
+
+  if ((286 < uiLit) || (30 < uiDist))
+  {
+    return EBADF;
+  }
+
+  /* Code lengths of the code lengths */
+  memset(auiLen, 0, sizeof(auiLen));
+
+  for (i = 0; i < uiCode; ++i)
+  {
+    if (EOK != getBits(pState, 3, &uiValue))
+    {
+      return EBADF;
+    }
+
+    auiLen[auiOrder[i]] = (uint8_t) uiValue;
+  }
+
+  buildHuffman(&tLen, auiLen, 19);
+
+  /* Code lengths of the literals/lengths and distances */
+  for (i = 0; i < uiLit + uiDist; )
+  {
+    int      iSymbol = decodeSymbol(pState, &tLen);
+    uint8_t  uiRep   = 0;
+    uint32_t uiCount;
+
+    if (0 > iSymbol)
+    {
+      return EBADF;
+    }
+
+    if (16 > iSymbol)
+    {
+      auiLen[i++] = (uint8_t) iSymbol;
+      continue;
+    }
+
+    if (16 == iSymbol)
+    {
+      if ((0 == i) || (EOK != getBits(pState, 2, &uiCount)))
+      {
+        return EBADF;
+      }
+
+      uiRep    = auiLen[i - 1];
+      uiCount += 3;
+    }
+    else if (17 == iSymbol)
+    {
+      if (EOK != getBits(pState, 3, &uiCount))
+      {
+        return EBADF;
+      }
+
+      uiCount += 3;
+    }
+    else
+    {
+      if (EOK != getBits(pState, 7, &uiCount))
+      {
+        return EBADF;
+      }
+
+      uiCount += 11;
+    }
+
+    if (i + uiCount > uiLit + uiDist)
+    {
+      return EBADF;
+    }
+
+    while (0 < uiCount--)
+    {
+      auiLen[i++] = uiRep;
+    }
+  }
+
+  buildHuffman(&tLit,  auiLen, (uint16_t) uiLit);
+  buildHuffman(&tDist, &auiLen[uiLit], (uint16_t) uiDist);
+
+  return inflateCodes(pState, &tLit, &tDist);
+}
@@ -0,0 +1,74 @@
+/*-----------------------------------------------------------------------------+
+|                                                                              |
+| filename: imgdec.h                                                           |
+| project:  zxn::scrnshot                                                      |
+| author:   S. Zell                                                            |
+| date:     10/18/2026                                                         |
+|                                                                              |
++------------------------------------------------------------------------------+
+|                                                                              |
+| description:                                                                 |
+|                                                                              |
+| Image decoders of the regression test (host)                                 |
+|                                                                              |
++------------------------------------------------------------------------------+
+|                                                                              |
+| Copyright (c) 10/18/2026 STZ Engineering                                     |
+|                                                                              |
+| This software is provided  "as is",  without warranty of any kind, express   |
+| or implied. In no event shall STZ or its contributors be held liable for any |
+| direct, indirect, incidental, special or consequential damages arising out   |
+| of the use of or inability to use this software.                             |
+|                                                                              |
+| Permission is granted to anyone  to use this  software for any purpose,      |
+| including commercial applications,  and to alter it and redistribute it      |
+| freely, subject to the following restrictions:                               |
+|                                                                              |
+| 1. Redistributions of source code must retain the above copyright            |
+|    notice, definition, disclaimer, and this list of conditions.              |
+|                                                                              |
+| 2. Redistributions in binary form must reproduce the above copyright         |
+|    notice, definition, disclaimer, and this list of conditions in            |
+|    documentation and/or other materials provided with the distribution.      |
+|                                                                          ;-) |
++-----------------------------------------------------------------------------*/
+
+#if !defined(__IMGDEC_H__)
+  #define __IMGDEC_H__
+
+/*============================================================================*/
+/*                               Includes                                     */
+/*============================================================================*/
+#include <stdint.h>
+
+/*============================================================================*/
+/*                               Type-Definitions                             */
+/*============================================================================*/
+/*!
+Decoded image: 3 bytes (R, G, B) per pixel, rows top-down
+*/
+typedef struct _rgbimage
+{
+  uint16_t uiWidth;
+  uint16_t uiHeight;
+  uint8_t* pRgb;                /* to be freed with "freeRgbImage" */
+} rgbimage_t;
+
+/*============================================================================*/
+/*                               Prototypes                                   */
+/*============================================================================*/
+/*!
+Decodes an image file of the formats written by the dot command: BMP (1, 4
+and 8 bit with palette, bottom-up or top-down), GIF (global colour table,
+LZW), PNG (colour type 3 with 1, 4 or 8 bit, deflate stored/fixed/dynamic,
+all row filters) and QOI (RGB or RGBA).
+@return "EOK" = no error; "EBADF" = invalid data; "ENOTSUP" = unknown format
+*/
+int decodeImage(const uint8_t* pData, uint32_t uiSize, rgbimage_t* pImage);
+
+/*!
+Releases the pixels of a decoded image
+*/
+void freeRgbImage(rgbimage_t* pImage);
+
+#endif /* __IMGDEC_H__ */
@@ -0,0 +1,709 @@
+/*-----------------------------------------------------------------------------+
+|                                                                              |
+| filename: regress.c                                                          |
+| project:  zxn::scrnshot                                                      |
+| author:   S. Zell                                                            |
+| date:     10/18/2026                                                         |
+|                                                                              |
++------------------------------------------------------------------------------+
+|                                                                              |
+| description:                                                                 |
+|                                                                              |
+| Golden image regression test of the capture engine (Linux): every fixture    |
+| (video state dump) is captured as BMP and compared byte by byte with the     |
+| reference image of the screen mode; the GIF, PNG and QOI files are decoded,  |
+| the native, ZX0, BMP and state files are loaded back into the cleared video  |
+| memory and recaptured for the comparison                                     |
+|                                                                              |
++------------------------------------------------------------------------------+
+|                                                                              |
+| Copyright (c) 10/18/2026 STZ Engineering                                     |
+|                                                                              |
+| This software is provided  "as is",  without warranty of any kind, express   |
+| or implied. In no event shall STZ or its contributors be held liable for any |
+| direct, indirect, incidental, special or consequential damages arising out   |
+| of the use of or inability to use this software.                             |
+|                                                                              |
+| Permission is granted to anyone  to use this  software for any purpose,      |
+| including commercial applications,  and to alter it and redistribute it      |
+| freely, subject to the following restrictions:                               |
+|                                                                              |
+| 1. Redistributions of source code must retain the above copyright            |
+|    notice, definition, disclaimer, and this list of conditions.              |
+|                                                                              |
+| 2. Redistributions in binary form must reproduce the above copyright         |
+|    notice, definition, disclaimer, and this list of conditions in            |
+|    documentation and/or other materials provided with the distribution.      |
+|                                                                          ;-) |
++-----------------------------------------------------------------------------*/
+
+/*============================================================================*/
+/*                               Includes                                     */
+/*============================================================================*/
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <z80.h>
+#include <intrinsic.h>
+#include <arch/zxn.h>
+#include <arch/zxn/esxdos.h>
+
+#include "libzxn.h"
+#include "scrnshot.h"
+#include "png.h"
+#include "native.h"
+#include "loader.h"
+#include "zxnshim.h"
+#include "imgdec.h"
+
+/*============================================================================*/
+/*                               Type-Definitions                             */
+/*============================================================================*/
+/*!
+Test case: fixture "<name>.nvs" and reference image "<name>.bmp"
+*/
+typedef struct _testcase
+{
+  const char* acName;
+  uint8_t     uiMode;   /* Screen mode (makeScreenshot_Lxx) */
+} testcase_t;
+
+/*!
+Enumeration to describe how an output is compared with the reference image
+*/
+typedef enum _compare
+{
+  COMPARE_BYTES = 0,    /* BMP file identical to the reference             */
+  COMPARE_PIXELS,       /* Decoded file: same size and colours             */
+  COMPARE_NATIVE,       /* Native file written back into the video memory  */
+  COMPARE_LOADER,       /* Loaded into the cleared video memory ("-l")     */
+  COMPARE_STATE         /* Loaded as fixture (video state dump)            */
+} compare_t;
+
+/*!
+Check of a test case: one output format, recaptured as BMP if not decoded
+*/
+typedef struct _check
+{
+  const char* acName;     /* Name in the report, extension of kept files */
+  format_t    eFormat;
+  uint8_t     uiLevel;    /* PNG: compress level (-c)                    */
+  const char* acNative;   /* Native: requested type (-t)                 */
+  compare_t   eCompare;
+} check_t;
+
+/*============================================================================*/
+/*                               Variables                                    */
+/*============================================================================*/
+/*!
+In dieser Struktur werden alle globalen Daten der Anwendung gespeichert.
+*/
+extern appstate_t g_tState;
+
+/*!
+Test cases: one per reference image in the directory "test"
+*/
+static const testcase_t s_atTests[] =
+{
+  {"scrnshot-L00", 0x00},
+  {"scrnshot-L10", 0x10},
+  {"scrnshot-L11", 0x11},
+  {"scrnshot-L12", 0x12},
+  {"scrnshot-L13", 0x13},
+  {"scrnshot-L20", 0x20},
+  {"scrnshot-L22", 0x22},
+  {"scrnshot-L23", 0x23}
+};
+
+/*!
+Checks of every test case: all output formats and the loaders
+*/
+static const check_t s_atChecks[] =
+{
+  {"bmp",  FORMAT_BMP,    0,               0,     COMPARE_BYTES},
+  {"gif",  FORMAT_GIF,    0,               0,     COMPARE_PIXELS},
+  {"png",  FORMAT_PNG,    PNG_LEVEL_STORE, 0,     COMPARE_PIXELS},
+  {"png",  FORMAT_PNG,    PNG_LEVEL_FAST,  0,     COMPARE_PIXELS},
+  {"png",  FORMAT_PNG,    PNG_LEVEL_SMALL, 0,     COMPARE_PIXELS},
+  {"qoi",  FORMAT_QOI,    0,               0,     COMPARE_PIXELS},
+  {"nxi",  FORMAT_NATIVE, 0,               "nxi", COMPARE_NATIVE},
+  {"sl2",  FORMAT_NATIVE, 0,               "sl2", COMPARE_NATIVE},
+  {"bmp",  FORMAT_BMP,    0,               0,     COMPARE_LOADER},
+  {"zx0",  FORMAT_ZX0,    0,               0,     COMPARE_LOADER},
+  {"nvs",  FORMAT_STATE,  0,               0,     COMPARE_STATE}
+};
+
+/*============================================================================*/
+/*                               Prototypes                                   */
+/*============================================================================*/
+/*!
+Initialisation and cleanup of the capture engine ("main.c")
+*/
+void _construct(void);
+void _destruct(void);
+
+/*!
+Runs one check of a test case
+@return "EOK" = image identical to the reference
+*/
+static int runTest(const char* acDir, const char* acWork, const testcase_t* pTest, const check_t* pCheck, bool bKeep);
+
+/*!
+Loads the fixture of a test case into the emulated Next
+@return "EOK" = no error
+*/
+static int loadFixture(const char* acPathName, uint8_t uiMode);
+
+/*!
+Captures the screen into memory, as written by ".scrnshot" with one output
+@return Data of the file (to be freed by the caller); "0" = error
+*/
+static uint8_t* captureFile(uint8_t uiMode, const check_t* pCheck, uint32_t* pSize);
+
+/*!
+Writes a native file (SCR, SLR, SHR, SHC, SL2, NXI) back into the video memory
+@return "EOK" = no error
+*/
+static int loadNativeFile(uint8_t uiMode, const char* acNative, const uint8_t* pData, uint32_t uiSize);
+
+/*!
+Clears the RAM (and the palettes) of the emulated Next
+*/
+static void clearVideo(bool bPalettes);
+
+/*!
+Compares two decoded images pixel by pixel
+@return "EOK" = identical
+*/
+static int comparePixels(const char* acName, const uint8_t* pData, uint32_t uiSize, const uint8_t* pRef, uint32_t uiRefSize);
+
+/*!
+Reads a file into memory (to be freed by the caller)
+@return Data of the file; "0" = error
+*/
+static uint8_t* readFile(const char* acPathName, uint32_t* pSize);
+
+/*!
+Writes a file from memory
+@return "EOK" = no error
+*/
+static int writeFile(const char* acPathName, const uint8_t* pData, uint32_t uiSize);
+
+/*============================================================================*/
+/*                               Implementation                               */
+/*============================================================================*/
+
+/*----------------------------------------------------------------------------*/
+/* main()                                                                     */
+/*----------------------------------------------------------------------------*/
+int main(int argc, char* argv[])
+{
+  const char* acDir    = "../test";
+  char        acWork[] = "/tmp/regress.XXXXXX";
+  bool        bKeep    = false;
+  unsigned    uiFail   = 0;
+  unsigned    uiTests  = 0;
+
+  for (int i = 1; i < argc; ++i)
+  {
+    if (0 == strcmp(argv[i], "-k"))
+    {
+      bKeep = true;
+    }
+    else if ('-' != argv[i][0])
+    {
+      acDir = argv[i];
+    }
+    else
+    {
+      fprintf(stderr, "usage: regress [-k] [directory]\n"
+                      "       -k  keep the files of failed tests (<name>.fail.<ext>)\n");
+      return EXIT_FAILURE;
+    }
+  }
+
+  /* Files read by the loaders */
+  if (0 == mkdtemp(acWork))
+  {
+    fprintf(stderr, "%s: %s\n", acWork, strerror(errno));
+    return EXIT_FAILURE;
+  }
+
+  for (uint8_t i = 0; i < (sizeof(s_atTests) / sizeof(s_atTests[0])); ++i)
+  {
+    for (uint8_t j = 0; j < (sizeof(s_atChecks) / sizeof(s_atChecks[0])); ++j)
+    {
+      const check_t* pCheck = &s_atChecks[j];
+      char acCheck[16];
+      int  iReturn;
+
+      /* SL2 and NXI differ in LAYER 2 only */
+      if ((0 != pCheck->acNative) && (0 == strcmp(pCheck->acNative, "sl2")) &&
+          (0 != strcmp(pCheck->acNative, getNativeFileExt(s_atTests[i].uiMode, pCheck->acNative))))
+      {
+        continue;
+      }
+
+      iReturn = runTest(acDir, acWork, &s_atTests[i], pCheck, bKeep);
+
+      if (FORMAT_NATIVE == pCheck->eFormat)
+      {
+        snprintf(acCheck, sizeof(acCheck), "%s", getNativeFileExt(s_atTests[i].uiMode, pCheck->acNative));
+      }
+      else if (FORMAT_PNG == pCheck->eFormat)
+      {
+        snprintf(acCheck, sizeof(acCheck), "%s -c %u", pCheck->acName, pCheck->uiLevel);
+      }
+      else
+      {
+        snprintf(acCheck, sizeof(acCheck), "%s%s", pCheck->acName, COMPARE_LOADER == pCheck->eCompare ? " -l" : "");
+      }
+
+      printf("%-14s mode 0x%02X %-8s: %s\n", s_atTests[i].acName, s_atTests[i].uiMode, acCheck, EOK == iReturn ? "ok" : "FAILED");
+
+      ++uiTests;
+
+      if (EOK != iReturn)
+      {
+        ++uiFail;
+      }
+    }
+  }
+
+  (void) rmdir(acWork);
+
+  printf("%u of %u tests failed\n", uiFail, uiTests);
+
+  return (0 == uiFail) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* runTest()                                                                  */
+/*----------------------------------------------------------------------------*/
+static int runTest(const char* acDir, const char* acWork, const testcase_t* pTest, const check_t* pCheck, bool bKeep)
+{
+  static const check_t tRecapture = {"bmp", FORMAT_BMP, 0, 0, COMPARE_BYTES};
+  char        acPathName[ESX_PATHNAME_MAX];
+  char        acFile[ESX_PATHNAME_MAX];
+  const char* acExt       = pCheck->acName;
+  uint8_t*    pData;
+  uint32_t    uiSize      = 0;
+  uint8_t*    pImage      = 0;
+  uint32_t    uiImageSize = 0;
+  uint8_t*    pRef;
+  uint32_t    uiRefSize;
+  uint8_t     uiMode;
+  int         iReturn;
+
+  /* Emulated Next in the state of the fixture */
+  snprintf(acPathName, sizeof(acPathName), "%s/%s.nvs", acDir, pTest->acName);
+
+  if (EOK != (iReturn = loadFixture(acPathName, pTest->uiMode)))
+  {
+    return iReturn;
+  }
+
+  if (0 == (pData = captureFile(pTest->uiMode, pCheck, &uiSize)))
+  {
+    return EBADF;
+  }
+
+  /* Back into the video memory, then captured as BMP */
+  if (FORMAT_NATIVE == pCheck->eFormat)
+  {
+    acExt = getNativeFileExt(pTest->uiMode, pCheck->acNative);
+  }
+
+  snprintf(acFile, sizeof(acFile), "%s/%s.%s", acWork, pTest->acName, acExt);
+
+  switch (pCheck->eCompare)
+  {
+    case COMPARE_NATIVE:
+      /* SCR, SLR, SHR, SHC and SL2 have no palette */
+      clearVideo(0 == strcmp(acExt, "nxi"));
+      iReturn = loadNativeFile(pTest->uiMode, acExt, pData, uiSize);
+      break;
+
+    case COMPARE_LOADER:
+      if (EOK == (iReturn = writeFile(acFile, pData, uiSize)))
+      {
+        /* HI-RES has no palette: colours of the Timex port */
+        clearVideo(0x12 != pTest->uiMode);
+
+        _construct();
+        snprintf(g_tState.bmpfile.acPathName, sizeof(g_tState.bmpfile.acPathName), "%s", acFile);
+        iReturn = loadImage();
+        _destruct();
+
+        (void) unlink(acFile);
+      }
+      break;
+
+    case COMPARE_STATE:
+      if (EOK == (iReturn = writeFile(acFile, pData, uiSize)))
+      {
+        zxnReset();
+
+        if ((EOK == (iReturn = zxnLoadState(acFile, &uiMode))) && (uiMode != pTest->uiMode))
+        {
+          iReturn = EINVAL;
+        }
+
+        g_tZxn.uiMode = uiMode;
+        (void) unlink(acFile);
+      }
+      break;
+
+    default:
+      break;
+  }
+
+  if (EOK != iReturn)
+  {
+    fprintf(stderr, "%s: %s: %s\n", pTest->acName, acExt, strerror(iReturn));
+  }
+  else if ((COMPARE_BYTES != pCheck->eCompare) && (COMPARE_PIXELS != pCheck->eCompare) &&
+           (0 == (pImage = captureFile(pTest->uiMode, &tRecapture, &uiImageSize))))
+  {
+    iReturn = EBADF;
+  }
+
+  /* Reference image */
+  snprintf(acPathName, sizeof(acPathName), "%s/%s.bmp", acDir, pTest->acName);
+
+  if ((EOK == iReturn) && (0 == (pRef = readFile(acPathName, &uiRefSize))))
+  {
+    iReturn = EBADF;
+  }
+  else if (EOK == iReturn)
+  {
+    if (COMPARE_PIXELS == pCheck->eCompare)
+    {
+      iReturn = comparePixels(pTest->acName, pData, uiSize, pRef, uiRefSize);
+    }
+    else
+    {
+      const uint8_t* pBmp  = (0 != pImage ? pImage : pData);
+      uint32_t       uiBmp = (0 != pImage ? uiImageSize : uiSize);
+
+      if (uiBmp != uiRefSize)
+      {
+        fprintf(stderr, "%s: %lu bytes, reference %lu bytes\n", pTest->acName, (unsigned long) uiBmp, (unsigned long) uiRefSize);
+        iReturn = ERANGE;
+      }
+
+      for (uint32_t i = 0; (EOK == iReturn) && (i < uiBmp); ++i)
+      {
+        if (pBmp[i] != pRef[i])
+        {
+          fprintf(stderr, "%s: offset %lu: 0x%02X, reference 0x%02X\n", pTest->acName, (unsigned long) i, pBmp[i], pRef[i]);
+          iReturn = ERANGE;
+        }
+      }
+    }
+
+    free(pRef);
+  }
+
+  /* File of the output format; recaptured image of the loaders */
+  if ((EOK != iReturn) && bKeep)
+  {
+    snprintf(acPathName, sizeof(acPathName), "%s.fail.%s", pTest->acName, acExt);
+    (void) writeFile(acPathName, pData, uiSize);
+
+    if (0 != pImage)
+    {
+      snprintf(acPathName, sizeof(acPathName), "%s.fail.%s.bmp", pTest->acName, acExt);
+      (void) writeFile(acPathName, pImage, uiImageSize);
+    }
+  }
+
+  free(pImage);
+  free(pData);
+
+  return iReturn;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* loadFixture()                                                              */
+/*----------------------------------------------------------------------------*/
+static int loadFixture(const char* acPathName, uint8_t uiMode)
+{
+  uint8_t uiState;
+  int     iReturn;
+
+  zxnReset();
+
+  if (EOK != (iReturn = zxnLoadState(acPathName, &uiState)))
+  {
+    return iReturn;
+  }
+
+  if (uiState != uiMode)
+  {
+    fprintf(stderr, "%s: mode 0x%02X in the fixture\n", acPathName, uiState);
+    return EINVAL;
+  }
+
+  g_tZxn.uiMode = uiMode;
+
+  return EOK;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* captureFile()                                                              */
+/*----------------------------------------------------------------------------*/
+static uint8_t* captureFile(uint8_t uiMode, const check_t* pCheck, uint32_t* pSize)
+{
+  uint8_t*       pCopy = 0;
+  const uint8_t* pData;
+  uint8_t        hFile;
+  int            iReturn;
+
+  /* One output into memory, as written by ".scrnshot -f <name>.<ext>" */
+  _construct();
+
+  hFile = zxnOpenMemoryFile();
+  g_tState.uiOutputs                = 1;
+  g_tState.atOutputs[0].eFormat     = pCheck->eFormat;
+  g_tState.atOutputs[0].acNativeExt = pCheck->acNative;
+  g_tState.atOutputs[0].hFile       = hFile;
+  g_tState.bmpfile.eSink            = SINK_FILE;
+  g_tState.uiLevel                  = pCheck->uiLevel;
+
+  if (EOK != (iReturn = captureImage(getScreenModeInfo(uiMode))))
+  {
+    fprintf(stderr, "%s: capture: %s\n", pCheck->acName, strerror(iReturn));
+  }
+  else
+  {
+    pData = zxnGetMemoryFile(hFile, pSize);
+
+    if (0 != (pCopy = malloc(*pSize + 1)))
+    {
+      memcpy(pCopy, pData, *pSize);
+    }
+  }
+
+  (void) esx_f_close(hFile);
+  g_tState.atOutputs[0].hFile = INV_FILE_HND;
+
+  _destruct();
+
+  return pCopy;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* loadNativeFile()                                                           */
+/*----------------------------------------------------------------------------*/
+static int loadNativeFile(uint8_t uiMode, const char* acNative, const uint8_t* pData, uint32_t uiSize)
+{
+  const screenmode_t* pInfo = getScreenModeInfo(uiMode);
+  int iReturn = EOK;
+
+  _construct();
+
+  if (0x20 > uiMode)
+  {
+    /* Pixels, attributes; HI-RES: Timex port */
+    uint32_t uiExpected = pInfo->tMemPixel.uiSize + pInfo->tMemAttr.uiSize + (0x12 == uiMode ? 1 : 0);
+
+    if (uiSize != uiExpected)
+    {
+      iReturn = EBADF;
+    }
+    else
+    {
+      memcpy(zxn_memmap(pInfo->tMemPixel.uiAddr), pData, pInfo->tMemPixel.uiSize);
+      memcpy(zxn_memmap(pInfo->tMemAttr.uiAddr), &pData[pInfo->tMemPixel.uiSize], pInfo->tMemAttr.uiSize);
+
+      if (0x12 == uiMode)
+      {
+        z80_outp(0xFF, pData[uiSize - 1]);
+      }
+    }
+  }
+  else
+  {
+    /* NXI: 256 colours (RRRGGGBB, .......B), then the pages of LAYER 2 */
+    uint8_t  uiPages = (uint8_t) ((((uint32_t) pInfo->uiResX) * ((uint32_t) pInfo->uiResY) * (16 == pInfo->uiColors ? 4 : 8)) >> 16);
+    uint16_t uiPalette = (0 == strcmp(acNative, "nxi") ? 512 : 0);
+    uint8_t  uiMMU2 = ZXN_READ_MMU2();
+
+    if (uiSize != uiPalette + ((uint32_t) uiPages) * pInfo->tMemPixel.uiSize)
+    {
+      iReturn = EBADF;
+    }
+    else
+    {
+      for (uint16_t i = 0; i < (uiPalette >> 1); ++i)
+      {
+        uint16_t uiValue = (((uint16_t) pData[i << 1]) << 1) | (pData[(i << 1) + 1] & 0x01);
+        bmppaletteentry_t* pEntry = &g_tState.bmpfile.tPalette[i];
+
+        pEntry->b = rgb3_to_rgb8( uiValue       & 0x07);
+        pEntry->g = rgb3_to_rgb8((uiValue >> 3) & 0x07);
+        pEntry->r = rgb3_to_rgb8((uiValue >> 6) & 0x07);
+        pEntry->a = 0x00;
+      }
+
+      if (0 != uiPalette)
+      {
+        iReturn = writeColourPalette(pInfo, pInfo->uiColors);
+      }
+
+      /* MMU2 is paged away from the system variables */
+      intrinsic_di();
+
+      for (uint8_t i = 0; i < uiPages; ++i)
+      {
+        ZXN_WRITE_MMU2(getLayer2Page() + i);
+        memcpy(zxn_memmap(pInfo->tMemPixel.uiAddr), &pData[uiPalette + ((uint32_t) i) * pInfo->tMemPixel.uiSize], pInfo->tMemPixel.uiSize);
+      }
+
+      ZXN_WRITE_MMU2(uiMMU2);
+      intrinsic_ei();
+    }
+  }
+
+  _destruct();
+
+  return iReturn;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* clearVideo()                                                               */
+/*----------------------------------------------------------------------------*/
+static void clearVideo(bool bPalettes)
+{
+  memset(g_tZxn.auiMemory, 0, ZXN_MEMORY_SIZE);
+
+  if (bPalettes)
+  {
+    memset(g_tZxn.aauiPalette, 0, sizeof(g_tZxn.aauiPalette));
+  }
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* comparePixels()                                                            */
+/*----------------------------------------------------------------------------*/
+static int comparePixels(const char* acName, const uint8_t* pData, uint32_t uiSize, const uint8_t* pRef, uint32_t uiRefSize)
+{
+  rgbimage_t tImage;
+  rgbimage_t tRef;
+  int        iReturn;
+
+  if (EOK != (iReturn = decodeImage(pData, uiSize, &tImage)))
+  {
+    fprintf(stderr, "%s: decoder: %s\n", acName, strerror(iReturn));
+    return iReturn;
+  }
+
+  if (EOK != (iReturn = decodeImage(pRef, uiRefSize, &tRef)))
+  {
+    fprintf(stderr, "%s: reference: %s\n", acName, strerror(iReturn));
+    freeRgbImage(&tImage);
+    return iReturn;
+  }
+
+  if ((tImage.uiWidth != tRef.uiWidth) || (tImage.uiHeight != tRef.uiHeight))
+  {
+    fprintf(stderr, "%s: %ux%u pixels, reference %ux%u\n", acName, tImage.uiWidth, tImage.uiHeight, tRef.uiWidth, tRef.uiHeight);
+    iReturn = ERANGE;
+  }
+
+  for (uint32_t i = 0; (EOK == iReturn) && (i < ((uint32_t) tRef.uiWidth) * tRef.uiHeight); ++i)
+  {
+    if (0 != memcmp(&tImage.pRgb[i * 3], &tRef.pRgb[i * 3], 3))
+    {
+      fprintf(stderr, "%s: pixel (%lu,%lu): #%02X%02X%02X, reference #%02X%02X%02X\n", acName,
+              (unsigned long) (i % tRef.uiWidth), (unsigned long) (i / tRef.uiWidth),
+              tImage.pRgb[i * 3], tImage.pRgb[i * 3 + 1], tImage.pRgb[i * 3 + 2],
+              tRef.pRgb[i * 3], tRef.pRgb[i * 3 + 1], tRef.pRgb[i * 3 + 2]);
+      iReturn = ERANGE;
+    }
+  }
+
+  freeRgbImage(&tImage);
+  freeRgbImage(&tRef);
+
+  return iReturn;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* readFile()                                                                 */
+/*----------------------------------------------------------------------------*/
+static uint8_t* readFile(const char* acPathName, uint32_t* pSize)
+{
+  FILE*    hFile;
+  uint8_t* pData = 0;
+  long     iSize;
+
+  if (0 == (hFile = fopen(acPathName, "rb")))
+  {
+    fprintf(stderr, "%s: %s\n", acPathName, strerror(errno));
+    return 0;
+  }
+
+  if ((0 == fseek(hFile, 0, SEEK_END)) && (0 <= (iSize = ftell(hFile))) && (0 == fseek(hFile, 0, SEEK_SET)) &&
+      (0 != (pData = malloc(iSize + 1))))
+  {
+    if (((size_t) iSize) != fread(pData, 1, iSize, hFile))
+    {
+      free(pData);
+      pData = 0;
+    }
+    else
+    {
+      *pSize = (uint32_t) iSize;
+    }
+  }
+
+  if (0 == pData)
+  {
+    fprintf(stderr, "%s: read error\n", acPathName);
+  }
+
+  fclose(hFile);
+
+  return pData;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* writeFile()                                                                */
+/*----------------------------------------------------------------------------*/
+static int writeFile(const char* acPathName, const uint8_t* pData, uint32_t uiSize)
+{
+  FILE* hFile;
+  int   iReturn = EOK;
+
+  if (0 == (hFile = fopen(acPathName, "wb")))
+  {
+    fprintf(stderr, "%s: %s\n", acPathName, strerror(errno));
+    return EACCES;
+  }
+
+  if (uiSize != fwrite(pData, 1, uiSize, hFile))
+  {
+    iReturn = EIO;
+  }
+
+  if (0 != fclose(hFile))
+  {
+    iReturn = EIO;
+  }
+
+  return iReturn;
+}
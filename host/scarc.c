@@ -0,0 +1,320 @@
+/*-----------------------------------------------------------------------------+
+|                                                                              |
+| filename: scarc.c                                                            |
+| project:  zxn::scrnshot                                                      |
+| author:   S. Zell                                                            |
+| date:     10/18/2026                                                         |
+|                                                                              |
++------------------------------------------------------------------------------+
+|                                                                              |
+| description:                                                                 |
+|                                                                              |
+| Host tool to list and extract screenshot archives (Linux)                    |
+|                                                                              |
++------------------------------------------------------------------------------+
+|                                                                              |
+| Copyright (c) 10/18/2026 STZ Engineering                                     |
+|                                                                              |
+| This software is provided  "as is",  without warranty of any kind, express   |
+| or implied. In no event shall STZ or its contributors be held liable for any |
+| direct, indirect, incidental, special or consequential damages arising out   |
+| of the use of or inability to use this software.                             |
+|                                                                              |
+| Permission is granted to anyone  to use this  software for any purpose,      |
+| including commercial applications,  and to alter it and redistribute it      |
+| freely, subject to the following restrictions:                               |
+|                                                                              |
+| 1. Redistributions of source code must retain the above copyright            |
+|    notice, definition, disclaimer, and this list of conditions.              |
+|                                                                              |
+| 2. Redistributions in binary form must reproduce the above copyright         |
+|    notice, definition, disclaimer, and this list of conditions in            |
+|    documentation and/or other materials provided with the distribution.      |
+|                                                                          ;-) |
++-----------------------------------------------------------------------------*/
+
+/*============================================================================*/
+/*                               Includes                                     */
+/*============================================================================*/
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+/*============================================================================*/
+/*                               Defines                                      */
+/*============================================================================*/
+/*!
+Layout of an archive (see "inc/archive.h"): header (16 bytes), index
+(16 bytes per entry), image data
+*/
+#define ARCHIVE_MAGIC       "SCA1"
+#define ARCHIVE_HEADER_SIZE 16
+#define ARCHIVE_ENTRY_SIZE  16
+
+/*============================================================================*/
+/*                               Type-Definitions                             */
+/*============================================================================*/
+/*!
+Entry of the index of an archive
+*/
+typedef struct _entry
+{
+  uint16_t uiTime;
+  uint16_t uiDate;
+  uint8_t  uiMode;
+  uint8_t  uiFormat;
+  uint32_t uiOffset;
+  uint32_t uiLength;
+} entry_t;
+
+/*============================================================================*/
+/*                               Prototypes                                   */
+/*============================================================================*/
+static uint16_t    getU16(const uint8_t* p);
+static uint32_t    getU32(const uint8_t* p);
+static const char* getFileExt(const entry_t* pEntry);
+static int         readEntry(FILE* hFile, uint16_t uiIndex, entry_t* pEntry);
+static int         extractEntry(FILE* hFile, const char* acDir, const char* acBase, uint16_t uiIndex);
+
+/*============================================================================*/
+/*                               Implementation                               */
+/*============================================================================*/
+
+/*----------------------------------------------------------------------------*/
+/* main()                                                                     */
+/*----------------------------------------------------------------------------*/
+int main(int argc, char* argv[])
+{
+  const char* acDir  = ".";
+  const char* acBase;
+  FILE*       hFile;
+  uint8_t     auiHeader[ARCHIVE_HEADER_SIZE];
+  uint16_t    uiEntries;
+  entry_t     tEntry;
+  int         iReturn = EXIT_SUCCESS;
+  int         iFirst  = 3;
+
+  if ((3 > argc) || ((0 != strcmp(argv[1], "list")) && (0 != strcmp(argv[1], "extract"))))
+  {
+    fprintf(stderr, "usage: scarc list archive\n"
+                    "       scarc extract archive [-d dir] [index ...]\n");
+    return EXIT_FAILURE;
+  }
+
+  if (0 == (hFile = fopen(argv[2], "rb")))
+  {
+    fprintf(stderr, "%s: %s\n", argv[2], strerror(errno));
+    return EXIT_FAILURE;
+  }
+
+  if ((1 != fread(auiHeader, sizeof(auiHeader), 1, hFile)) || (0 != memcmp(auiHeader, ARCHIVE_MAGIC, 4)))
+  {
+    fprintf(stderr, "%s: no archive\n", argv[2]);
+    fclose(hFile);
+    return EXIT_FAILURE;
+  }
+
+  uiEntries = getU16(&auiHeader[4]);
+
+  /* Name of the extracted files: name of the archive without extension */
+  acBase = strrchr(argv[2], '/');
+  acBase = (0 != acBase ? acBase + 1 : argv[2]);
+
+  if (0 == strcmp(argv[1], "list"))
+  {
+    printf("  # date       time     mode fmt    offset   length\n");
+
+    for (uint16_t i = 0; i < uiEntries; ++i)
+    {
+      if (0 != readEntry(hFile, i, &tEntry))
+      {
+        iReturn = EXIT_FAILURE;
+        break;
+      }
+
+      printf("%3u %04u-%02u-%02u %02u:%02u:%02u 0x%02X %-4s %8u %8u\n",
+             i,
+             1980 + (tEntry.uiDate >> 9), (tEntry.uiDate >> 5) & 0x0F, tEntry.uiDate & 0x1F,
+             tEntry.uiTime >> 11, (tEntry.uiTime >> 5) & 0x3F, (tEntry.uiTime & 0x1F) << 1,
+             tEntry.uiMode,
+             getFileExt(&tEntry),
+             (unsigned int) tEntry.uiOffset,
+             (unsigned int) tEntry.uiLength);
+    }
+  }
+  else
+  {
+    char acName[256];
+    const char* acExt = strrchr(acBase, '.');
+
+    snprintf(acName, sizeof(acName), "%.*s", (int) (0 != acExt ? acExt - acBase : (long) strlen(acBase)), acBase);
+
+    if ((4 < argc) && (0 == strcmp(argv[3], "-d")))
+    {
+      acDir  = argv[4];
+      iFirst = 5;
+    }
+
+    if (iFirst >= argc)
+    {
+      /* All entries */
+      for (uint16_t i = 0; (EXIT_SUCCESS == iReturn) && (i < uiEntries); ++i)
+      {
+        iReturn = extractEntry(hFile, acDir, acName, i);
+      }
+    }
+    else
+    {
+      for (int i = iFirst; (EXIT_SUCCESS == iReturn) && (i < argc); ++i)
+      {
+        unsigned long uiIndex = strtoul(argv[i], 0, 0);
+
+        if (uiIndex >= uiEntries)
+        {
+          fprintf(stderr, "%s: no entry %s\n", argv[2], argv[i]);
+          iReturn = EXIT_FAILURE;
+        }
+        else
+        {
+          iReturn = extractEntry(hFile, acDir, acName, (uint16_t) uiIndex);
+        }
+      }
+    }
+  }
+
+  fclose(hFile);
+
+  return iReturn;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* getU16()                                                                   */
+/*----------------------------------------------------------------------------*/
+static uint16_t getU16(const uint8_t* p)
+{
+  return (uint16_t) (p[0] | (p[1] << 8));
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* getU32()                                                                   */
+/*----------------------------------------------------------------------------*/
+static uint32_t getU32(const uint8_t* p)
+{
+  return ((uint32_t) getU16(p)) | (((uint32_t) getU16(p + 2)) << 16);
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* getFileExt()                                                               */
+/*----------------------------------------------------------------------------*/
+static const char* getFileExt(const entry_t* pEntry)
+{
+  /* format_t: 1 = BMP, 2 = GIF, 3 = PNG, 4 = QOI, 5 = native, 6 = ZX0,
+     7 = video state */
+  switch (pEntry->uiFormat)
+  {
+    case 1: return "bmp";
+    case 2: return "gif";
+    case 3: return "png";
+    case 4: return "qoi";
+    case 6: return "zx0";
+    case 7: return "nvs";
+
+    case 5:
+      switch (pEntry->uiMode)
+      {
+        case 0x00:
+        case 0x11: return "scr";
+        case 0x10: return "slr";
+        case 0x12: return "shr";
+        case 0x13: return "shc";
+        default:   return "nxi";
+      }
+
+    default:
+      return "bin";
+  }
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* readEntry()                                                                */
+/*----------------------------------------------------------------------------*/
+static int readEntry(FILE* hFile, uint16_t uiIndex, entry_t* pEntry)
+{
+  uint8_t auiEntry[ARCHIVE_ENTRY_SIZE];
+
+  if ((0 != fseek(hFile, ARCHIVE_HEADER_SIZE + ((long) uiIndex) * ARCHIVE_ENTRY_SIZE, SEEK_SET)) ||
+      (1 != fread(auiEntry, sizeof(auiEntry), 1, hFile)))
+  {
+    return -1;
+  }
+
+  pEntry->uiTime   = getU16(&auiEntry[0]);
+  pEntry->uiDate   = getU16(&auiEntry[2]);
+  pEntry->uiMode   = auiEntry[4];
+  pEntry->uiFormat = auiEntry[5];
+  pEntry->uiOffset = getU32(&auiEntry[8]);
+  pEntry->uiLength = getU32(&auiEntry[12]);
+
+  return 0;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* extractEntry()                                                             */
+/*----------------------------------------------------------------------------*/
+static int extractEntry(FILE* hFile, const char* acDir, const char* acBase, uint16_t uiIndex)
+{
+  entry_t  tEntry;
+  char     acPathName[4096];
+  uint8_t  auiBuffer[0x2000];
+  FILE*    hOut;
+  uint32_t uiLeft;
+  size_t   uiChunk;
+
+  if ((0 != readEntry(hFile, uiIndex, &tEntry)) || (0 != fseek(hFile, (long) tEntry.uiOffset, SEEK_SET)))
+  {
+    fprintf(stderr, "entry %u: damaged\n", uiIndex);
+    return EXIT_FAILURE;
+  }
+
+  snprintf(acPathName, sizeof(acPathName), "%s/%s-%u.%s", acDir, acBase, uiIndex, getFileExt(&tEntry));
+
+  if (0 == (hOut = fopen(acPathName, "wb")))
+  {
+    fprintf(stderr, "%s: %s\n", acPathName, strerror(errno));
+    return EXIT_FAILURE;
+  }
+
+  for (uiLeft = tEntry.uiLength; 0 < uiLeft; uiLeft -= (uint32_t) uiChunk)
+  {
+    uiChunk = (uiLeft < sizeof(auiBuffer) ? uiLeft : sizeof(auiBuffer));
+
+    if ((uiChunk != fread(auiBuffer, 1, uiChunk, hFile)) || (uiChunk != fwrite(auiBuffer, 1, uiChunk, hOut)))
+    {
+      fprintf(stderr, "%s: incomplete\n", acPathName);
+      fclose(hOut);
+      return EXIT_FAILURE;
+    }
+  }
+
+  if (0 != fclose(hOut))
+  {
+    return EXIT_FAILURE;
+  }
+
+  printf("%s\n", acPathName);
+
+  return EXIT_SUCCESS;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/*                                                                            */
+/*----------------------------------------------------------------------------*/
@@ -0,0 +1,152 @@
+/*-----------------------------------------------------------------------------+
+|                                                                              |
+| filename: scrnhost.c                                                         |
+| project:  zxn::scrnshot                                                      |
+| author:   S. Zell                                                            |
+| date:     10/18/2026                                                         |
+|                                                                              |
++------------------------------------------------------------------------------+
+|                                                                              |
+| description:                                                                 |
+|                                                                              |
+| Host build of the dot command SCRNSHOT (Linux): runs the unmodified command  |
+| on the emulated hardware of the shim, e.g. to profile the decoders           |
+|                                                                              |
++------------------------------------------------------------------------------+
+|                                                                              |
+| Copyright (c) 10/18/2026 STZ Engineering                                     |
+|                                                                              |
+| This software is provided  "as is",  without warranty of any kind, express   |
+| or implied. In no event shall STZ or its contributors be held liable for any |
+| direct, indirect, incidental, special or consequential damages arising out   |
+| of the use of or inability to use this software.                             |
+|                                                                              |
+| Permission is granted to anyone  to use this  software for any purpose,      |
+| including commercial applications,  and to alter it and redistribute it      |
+| freely, subject to the following restrictions:                               |
+|                                                                              |
+| 1. Redistributions of source code must retain the above copyright            |
+|    notice, definition, disclaimer, and this list of conditions.              |
+|                                                                              |
+| 2. Redistributions in binary form must reproduce the above copyright         |
+|    notice, definition, disclaimer, and this list of conditions in            |
+|    documentation and/or other materials provided with the distribution.      |
+|                                                                          ;-) |
++-----------------------------------------------------------------------------*/
+
+/*============================================================================*/
+/*                               Includes                                     */
+/*============================================================================*/
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <arch/zxn.h>
+#include <arch/zxn/esxdos.h>
+
+#include "libzxn.h"
+#include "scrnshot.h"
+#include "zxnshim.h"
+
+/*============================================================================*/
+/*                               Prototypes                                   */
+/*============================================================================*/
+/*!
+Entry point and cleanup of the dot command ("main.c", "main" is renamed by the
+makefile)
+*/
+int  scrnshot_main(int argc, char* argv[]);
+void _destruct(void);
+
+/*============================================================================*/
+/*                               Implementation                               */
+/*============================================================================*/
+
+/*----------------------------------------------------------------------------*/
+/* main()                                                                     */
+/*----------------------------------------------------------------------------*/
+int main(int argc, char* argv[])
+{
+  const char* acImage = 0;
+  const char* acState = 0;
+  uint8_t     uiMode  = 0xFF;
+  unsigned    uiRuns  = 1;
+  bool        bTime   = false;
+  int         iArg;
+  int         iReturn = 0;
+
+  for (iArg = 1; iArg < argc; ++iArg)
+  {
+    if ((0 == strcmp(argv[iArg], "-i")) && ((iArg + 1) < argc))
+    {
+      acImage = argv[++iArg];
+    }
+    else if ((0 == strcmp(argv[iArg], "-n")) && ((iArg + 1) < argc))
+    {
+      acState = argv[++iArg];
+    }
+    else if ((0 == strcmp(argv[iArg], "-M")) && ((iArg + 1) < argc))
+    {
+      uiMode = (uint8_t) strtoul(argv[++iArg], 0, 16);
+    }
+    else if ((0 == strcmp(argv[iArg], "-N")) && ((iArg + 1) < argc))
+    {
+      uiRuns = (unsigned) strtoul(argv[++iArg], 0, 0);
+    }
+    else if (0 == strcmp(argv[iArg], "-t"))
+    {
+      bTime = true;
+    }
+    else if (0 == strcmp(argv[iArg], "--"))
+    {
+      break;
+    }
+    else
+    {
+      iArg = argc;
+    }
+  }
+
+  if ((argc <= iArg) || (0 == uiRuns))
+  {
+    fprintf(stderr, "usage: scrnhost [-i memory.bin] [-n dump.nvs] [-M mode] [-N runs] [-t] -- [options of SCRNSHOT]\n"
+                    "       -i  raw image of the RAM (2 MB, 8K page 0 first)\n"
+                    "       -n  video state dumped by \"scrnshot -f dump.nvs\"\n"
+                    "       -M  screen mode reported by NextZXOS (hex: 00 ... 23)\n"
+                    "       -N  number of runs of the command (profiling)\n"
+                    "       -t  print the time of each run\n");
+    return EXIT_FAILURE;
+  }
+
+  zxnReset();
+
+  if (((0 != acImage) && (EOK != zxnLoadMemory(acImage))) ||
+      ((0 != acState) && (EOK != zxnLoadState(acState, 0))))
+  {
+    return EXIT_FAILURE;
+  }
+
+  g_tZxn.uiMode = uiMode;
+
+  /* argv[iArg] ("--") takes the place of the name of the command */
+  for (unsigned uiRun = 0; (0 == iReturn) && (uiRun < uiRuns); ++uiRun)
+  {
+    struct timespec tStart;
+    struct timespec tEnd;
+
+    clock_gettime(CLOCK_MONOTONIC, &tStart);
+    iReturn = scrnshot_main(argc - iArg, &argv[iArg]);
+    _destruct();
+    clock_gettime(CLOCK_MONOTONIC, &tEnd);
+
+    if (bTime)
+    {
+      fprintf(stderr, "run %u: %.3f ms\n", uiRun + 1,
+              (tEnd.tv_sec - tStart.tv_sec) * 1000.0 + (tEnd.tv_nsec - tStart.tv_nsec) / 1000000.0);
+    }
+  }
+
+  return (0 == iReturn) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,99 @@
+/*-----------------------------------------------------------------------------+
+|                                                                              |
+| filename: zxn.h                                                              |
+| project:  zxn::scrnshot                                                      |
+| author:   S. Zell                                                            |
+| date:     10/18/2026                                                         |
+|                                                                              |
++------------------------------------------------------------------------------+
+|                                                                              |
+| description:                                                                 |
+|                                                                              |
+| Host shim: stands in for the z88dk/libzxn header of the same name, so that   |
+| the capture engine can be compiled for Linux (see "zxnshim.c")               |
+|                                                                              |
++------------------------------------------------------------------------------+
+|                                                                              |
+| Copyright (c) 10/18/2026 STZ Engineering                                     |
+|                                                                              |
+| This software is provided  "as is",  without warranty of any kind, express   |
+| or implied. In no event shall STZ or its contributors be held liable for any |
+| direct, indirect, incidental, special or consequential damages arising out   |
+| of the use of or inability to use this software.                             |
+|                                                                              |
+| Permission is granted to anyone  to use this  software for any purpose,      |
+| including commercial applications,  and to alter it and redistribute it      |
+| freely, subject to the following restrictions:                               |
+|                                                                              |
+| 1. Redistributions of source code must retain the above copyright            |
+|    notice, definition, disclaimer, and this list of conditions.              |
+|                                                                              |
+| 2. Redistributions in binary form must reproduce the above copyright         |
+|    notice, definition, disclaimer, and this list of conditions in            |
+|    documentation and/or other materials provided with the distribution.      |
+|                                                                          ;-) |
++-----------------------------------------------------------------------------*/
+
+#if !defined(__ARCH_ZXN_H__)
+  #define __ARCH_ZXN_H__
+
+/*============================================================================*/
+/*                               Includes                                     */
+/*============================================================================*/
+#include <stdint.h>
+#include <stdbool.h>
+
+/*============================================================================*/
+/*                               Defines                                      */
+/*============================================================================*/
+/*!
+CPU speed: 28 MHz
+*/
+#define RTM_28MHZ 3
+
+/*!
+NextRegs of the colour palettes
+*/
+#define REG_PALETTE_INDEX    0x40
+#define REG_PALETTE_VALUE_8  0x41
+#define REG_PALETTE_CONTROL  0x43
+#define REG_PALETTE_VALUE_16 0x44
+
+/*!
+Bits of the ULA attributes
+*/
+#define FLASH       0x80
+#define BRIGHT      0x40
+#define PAPER_WHITE 0x38
+#define INK_WHITE   0x07
+
+/*!
+Access to the MMU slots
+*/
+#define ZXN_READ_MMU2()   zxn_read_mmu(2)
+#define ZXN_WRITE_MMU2(p) zxn_write_mmu(2, (p))
+#define ZXN_READ_MMU3()   zxn_read_mmu(3)
+#define ZXN_WRITE_MMU3(p) zxn_write_mmu(3, (p))
+#define ZXN_READ_MMU6()   zxn_read_mmu(6)
+#define ZXN_WRITE_MMU6(p) zxn_write_mmu(6, (p))
+#define ZXN_READ_MMU7()   zxn_read_mmu(7)
+#define ZXN_WRITE_MMU7(p) zxn_write_mmu(7, (p))
+
+/*============================================================================*/
+/*                               Prototypes                                   */
+/*============================================================================*/
+uint8_t  ZXN_READ_REG(uint8_t uiReg);
+void     ZXN_WRITE_REG(uint8_t uiReg, uint8_t uiValue);
+uint8_t  zxn_read_mmu(uint8_t uiSlot);
+void     zxn_write_mmu(uint8_t uiSlot, uint8_t uiPage);
+uint8_t  zxn_getspeed(void);
+void     zxn_setspeed(uint8_t uiSpeed);
+uint8_t* zx_pxy2saddr(uint8_t x, uint8_t y);
+uint8_t* zx_cxy2aaddr(uint8_t x, uint8_t y);
+uint8_t* zxn_pixelad(uint8_t x, uint8_t y);
+uint8_t* tshr_pxy2saddr(uint16_t x, uint8_t y);
+uint8_t* tshc_py2saddr(uint8_t y);
+uint8_t* tshc_py2aaddr(uint8_t y);
+uint8_t* tshc_saddr2aaddr(void* pAddr);
+
+#endif /* __ARCH_ZXN_H__ */
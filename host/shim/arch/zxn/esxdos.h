@@ -0,0 +1,114 @@
+/*-----------------------------------------------------------------------------+
+|                                                                              |
+| filename: esxdos.h                                                           |
+| project:  zxn::scrnshot                                                      |
+| author:   S. Zell                                                            |
+| date:     10/18/2026                                                         |
+|                                                                              |
++------------------------------------------------------------------------------+
+|                                                                              |
+| description:                                                                 |
+|                                                                              |
+| Host shim: stands in for the z88dk/libzxn header of the same name, so that   |
+| the capture engine can be compiled for Linux (see "zxnshim.c")               |
+|                                                                              |
++------------------------------------------------------------------------------+
+|                                                                              |
+| Copyright (c) 10/18/2026 STZ Engineering                                     |
+|                                                                              |
+| This software is provided  "as is",  without warranty of any kind, express   |
+| or implied. In no event shall STZ or its contributors be held liable for any |
+| direct, indirect, incidental, special or consequential damages arising out   |
+| of the use of or inability to use this software.                             |
+|                                                                              |
+| Permission is granted to anyone  to use this  software for any purpose,      |
+| including commercial applications,  and to alter it and redistribute it      |
+| freely, subject to the following restrictions:                               |
+|                                                                              |
+| 1. Redistributions of source code must retain the above copyright            |
+|    notice, definition, disclaimer, and this list of conditions.              |
+|                                                                              |
+| 2. Redistributions in binary form must reproduce the above copyright         |
+|    notice, definition, disclaimer, and this list of conditions in            |
+|    documentation and/or other materials provided with the distribution.      |
+|                                                                          ;-) |
++-----------------------------------------------------------------------------*/
+
+#if !defined(__ARCH_ZXN_ESXDOS_H__)
+  #define __ARCH_ZXN_ESXDOS_H__
+
+/*============================================================================*/
+/*                               Includes                                     */
+/*============================================================================*/
+#include <stdint.h>
+
+/*============================================================================*/
+/*                               Defines                                      */
+/*============================================================================*/
+/*!
+File system
+*/
+#define ESX_PATHNAME_MAX 261
+#define ESX_DIR_SEP      "/"
+
+#define ESXDOS_MODE_R  0x01
+#define ESXDOS_MODE_W  0x02
+#define ESXDOS_MODE_OE 0x00
+#define ESXDOS_MODE_CN 0x04
+#define ESXDOS_MODE_OC 0x08
+#define ESXDOS_MODE_CT 0x0C
+
+#define ESX_SEEK_SET 0
+#define ESX_SEEK_FWD 1
+#define ESX_SEEK_BWD 2
+
+/*!
+Version of NextZXOS
+*/
+#define ESX_DOSVERSION_NEXTOS_48K      0
+#define ESX_DOSVERSION_NEXTOS_MAJOR(v) ((v) >> 8)
+#define ESX_DOSVERSION_NEXTOS_MINOR(v) ((v) & 0xFF)
+
+/*!
+Screen mode (IDE_MODE)
+*/
+struct esx_mode
+{
+  struct
+  {
+    uint8_t layer;
+    uint8_t submode;
+  } mode8;
+  uint8_t cols;
+  uint8_t rows;
+};
+
+/*!
+Date and time in MS-DOS format
+*/
+struct dos_tm
+{
+  uint16_t time;
+  uint16_t date;
+};
+
+/*============================================================================*/
+/*                               Prototypes                                   */
+/*============================================================================*/
+uint8_t  esx_f_open(const char* acPathName, uint8_t uiMode);
+uint8_t  esx_f_opendir(const char* acPathName);
+uint8_t  esx_f_close(uint8_t hFile);
+uint8_t  esx_f_closedir(uint8_t hDir);
+uint8_t  esx_f_unlink(const char* acPathName);
+uint16_t esx_f_write(uint8_t hFile, const void* pData, uint16_t uiLen);
+uint16_t esx_f_read(uint8_t hFile, void* pData, uint16_t uiLen);
+uint32_t esx_f_seek(uint8_t hFile, uint32_t uiOffset, uint8_t uiWhence);
+uint32_t esx_f_fgetpos(uint8_t hFile);
+uint8_t  esx_f_getcwd(char* acPathName);
+uint16_t esx_m_dosversion(void);
+uint8_t  esx_m_getdate(struct dos_tm* pTime);
+uint8_t  esx_ide_mode_get(struct esx_mode* pMode);
+uint8_t  esx_ide_bank_alloc(uint8_t uiType);
+uint8_t  esx_ide_bank_free(uint8_t uiType, uint8_t uiPage);
+
+#endif /* __ARCH_ZXN_ESXDOS_H__ */
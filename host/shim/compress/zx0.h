@@ -0,0 +1,57 @@
+/*-----------------------------------------------------------------------------+
+|                                                                              |
+| filename: zx0.h                                                              |
+| project:  zxn::scrnshot                                                      |
+| author:   S. Zell                                                            |
+| date:     10/18/2026                                                         |
+|                                                                              |
++------------------------------------------------------------------------------+
+|                                                                              |
+| description:                                                                 |
+|                                                                              |
+| Host shim: stands in for the z88dk/libzxn header of the same name, so that   |
+| the capture engine can be compiled for Linux (see "zxnshim.c")               |
+|                                                                              |
++------------------------------------------------------------------------------+
+|                                                                              |
+| Copyright (c) 10/18/2026 STZ Engineering                                     |
+|                                                                              |
+| This software is provided  "as is",  without warranty of any kind, express   |
+| or implied. In no event shall STZ or its contributors be held liable for any |
+| direct, indirect, incidental, special or consequential damages arising out   |
+| of the use of or inability to use this software.                             |
+|                                                                              |
+| Permission is granted to anyone  to use this  software for any purpose,      |
+| including commercial applications,  and to alter it and redistribute it      |
+| freely, subject to the following restrictions:                               |
+|                                                                              |
+| 1. Redistributions of source code must retain the above copyright            |
+|    notice, definition, disclaimer, and this list of conditions.              |
+|                                                                              |
+| 2. Redistributions in binary form must reproduce the above copyright         |
+|    notice, definition, disclaimer, and this list of conditions in            |
+|    documentation and/or other materials provided with the distribution.      |
+|                                                                          ;-) |
++-----------------------------------------------------------------------------*/
+
+#if !defined(__COMPRESS_ZX0_H__)
+  #define __COMPRESS_ZX0_H__
+
+/*============================================================================*/
+/*                               Includes                                     */
+/*============================================================================*/
+
+/*============================================================================*/
+/*                               Defines                                      */
+/*============================================================================*/
+
+/*============================================================================*/
+/*                               Prototypes                                   */
+/*============================================================================*/
+/*!
+Decompresses a block in ZX0 format (standard, forward)
+@return Address behind the decompressed data
+*/
+void* dzx0_standard(void* pSrc, void* pDst);
+
+#endif /* __COMPRESS_ZX0_H__ */
@@ -0,0 +1,59 @@
+/*-----------------------------------------------------------------------------+
+|                                                                              |
+| filename: intrinsic.h                                                        |
+| project:  zxn::scrnshot                                                      |
+| author:   S. Zell                                                            |
+| date:     10/18/2026                                                         |
+|                                                                              |
++------------------------------------------------------------------------------+
+|                                                                              |
+| description:                                                                 |
+|                                                                              |
+| Host shim: stands in for the z88dk/libzxn header of the same name, so that   |
+| the capture engine can be compiled for Linux (see "zxnshim.c")               |
+|                                                                              |
++------------------------------------------------------------------------------+
+|                                                                              |
+| Copyright (c) 10/18/2026 STZ Engineering                                     |
+|                                                                              |
+| This software is provided  "as is",  without warranty of any kind, express   |
+| or implied. In no event shall STZ or its contributors be held liable for any |
+| direct, indirect, incidental, special or consequential damages arising out   |
+| of the use of or inability to use this software.                             |
+|                                                                              |
+| Permission is granted to anyone  to use this  software for any purpose,      |
+| including commercial applications,  and to alter it and redistribute it      |
+| freely, subject to the following restrictions:                               |
+|                                                                              |
+| 1. Redistributions of source code must retain the above copyright            |
+|    notice, definition, disclaimer, and this list of conditions.              |
+|                                                                              |
+| 2. Redistributions in binary form must reproduce the above copyright         |
+|    notice, definition, disclaimer, and this list of conditions in            |
+|    documentation and/or other materials provided with the distribution.      |
+|                                                                          ;-) |
++-----------------------------------------------------------------------------*/
+
+#if !defined(__INTRINSIC_H__)
+  #define __INTRINSIC_H__
+
+/*============================================================================*/
+/*                               Includes                                     */
+/*============================================================================*/
+
+/*============================================================================*/
+/*                               Defines                                      */
+/*============================================================================*/
+
+/*============================================================================*/
+/*                               Prototypes                                   */
+/*============================================================================*/
+/*!
+No interrupts on the host: only IFF1 is kept ("g_tZxn.bInterrupts"), so that
+the shim can check that MMU2 holds the system variables (bank 5) whenever
+interrupts are enabled
+*/
+void intrinsic_di(void);
+void intrinsic_ei(void);
+
+#endif /* __INTRINSIC_H__ */
@@ -0,0 +1,81 @@
+/*-----------------------------------------------------------------------------+
+|                                                                              |
+| filename: libzxn.h                                                           |
+| project:  zxn::scrnshot                                                      |
+| author:   S. Zell                                                            |
+| date:     10/18/2026                                                         |
+|                                                                              |
++------------------------------------------------------------------------------+
+|                                                                              |
+| description:                                                                 |
+|                                                                              |
+| Host shim: stands in for the z88dk/libzxn header of the same name, so that   |
+| the capture engine can be compiled for Linux (see "zxnshim.c")               |
+|                                                                              |
++------------------------------------------------------------------------------+
+|                                                                              |
+| Copyright (c) 10/18/2026 STZ Engineering                                     |
+|                                                                              |
+| This software is provided  "as is",  without warranty of any kind, express   |
+| or implied. In no event shall STZ or its contributors be held liable for any |
+| direct, indirect, incidental, special or consequential damages arising out   |
+| of the use of or inability to use this software.                             |
+|                                                                              |
+| Permission is granted to anyone  to use this  software for any purpose,      |
+| including commercial applications,  and to alter it and redistribute it      |
+| freely, subject to the following restrictions:                               |
+|                                                                              |
+| 1. Redistributions of source code must retain the above copyright            |
+|    notice, definition, disclaimer, and this list of conditions.              |
+|                                                                              |
+| 2. Redistributions in binary form must reproduce the above copyright         |
+|    notice, definition, disclaimer, and this list of conditions in            |
+|    documentation and/or other materials provided with the distribution.      |
+|                                                                          ;-) |
++-----------------------------------------------------------------------------*/
+
+#if !defined(__LIBZXN_H__)
+  #define __LIBZXN_H__
+
+/*============================================================================*/
+/*                               Includes                                     */
+/*============================================================================*/
+#include <stdint.h>
+#include <stdbool.h>
+#include <errno.h>
+
+/*============================================================================*/
+/*                               Defines                                      */
+/*============================================================================*/
+/*!
+Type of characters of strings
+*/
+typedef char char_t;
+
+/*!
+Invalid handle of a file
+*/
+#define INV_FILE_HND 0xFF
+
+/*!
+Error codes in addition to "errno.h"
+*/
+#define EOK   0
+#define ESTAT 200
+
+/*!
+Limits a value to the range a ... b
+*/
+#define constrain(x, a, b) ((x) < (a) ? (a) : ((x) > (b) ? (b) : (x)))
+
+/*============================================================================*/
+/*                               Prototypes                                   */
+/*============================================================================*/
+int   stricmp(const char_t* acStr1, const char_t* acStr2);
+int   strnicmp(const char_t* acStr1, const char_t* acStr2, unsigned uiLen);
+char* strupr(char_t* acStr);
+void* zxn_memmap(uint16_t uiAddr);
+bool  zxn_radastan_mode(void);
+int   zxn_strerror(int iCode);
+
+#endif /* __LIBZXN_H__ */
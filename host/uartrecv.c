@@ -0,0 +1,446 @@
+/*-----------------------------------------------------------------------------+
+|                                                                              |
+| filename: uartrecv.c                                                         |
+| project:  zxn::scrnshot                                                      |
+| author:   S. Zell                                                            |
+| date:     10/18/2026                                                         |
+|                                                                              |
++------------------------------------------------------------------------------+
+|                                                                              |
+| description:                                                                 |
+|                                                                              |
+| Host receiver of screenshots sent over the UART (Linux)                      |
+|                                                                              |
++------------------------------------------------------------------------------+
+|                                                                              |
+| Copyright (c) 10/18/2026 STZ Engineering                                     |
+|                                                                              |
+| This software is provided  "as is",  without warranty of any kind, express   |
+| or implied. In no event shall STZ or its contributors be held liable for any |
+| direct, indirect, incidental, special or consequential damages arising out   |
+| of the use of or inability to use this software.                             |
+|                                                                              |
+| Permission is granted to anyone  to use this  software for any purpose,      |
+| including commercial applications,  and to alter it and redistribute it      |
+| freely, subject to the following restrictions:                               |
+|                                                                              |
+| 1. Redistributions of source code must retain the above copyright            |
+|    notice, definition, disclaimer, and this list of conditions.              |
+|                                                                              |
+| 2. Redistributions in binary form must reproduce the above copyright         |
+|    notice, definition, disclaimer, and this list of conditions in            |
+|    documentation and/or other materials provided with the distribution.      |
+|                                                                          ;-) |
++-----------------------------------------------------------------------------*/
+
+/*============================================================================*/
+/*                               Includes                                     */
+/*============================================================================*/
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <termios.h>
+#include <sys/stat.h>
+
+/*============================================================================*/
+/*                               Defines                                      */
+/*============================================================================*/
+/*!
+Packet framing (see "inc/uart.h"):
+  SYNC, TYPE, SEQ, LEN, PAYLOAD[LEN], CHECKSUM (Fletcher-16 of TYPE..PAYLOAD)
+*/
+#define UART_PKT_SYNC  0x5A
+#define UART_PKT_START 0x01
+#define UART_PKT_DATA  0x02
+#define UART_PKT_END   0x03
+#define UART_PKT_ABORT 0x04
+
+/*!
+Default baud rate (see "inc/uart.h")
+*/
+#define UART_BAUD 2000000
+
+/*============================================================================*/
+/*                               Type-Definitions                             */
+/*============================================================================*/
+/*!
+Packet received from the Next
+*/
+typedef struct _packet
+{
+  uint8_t uiType;
+  uint8_t uiSeq;
+  uint8_t uiLen;
+  uint8_t auiPayload[256];
+} packet_t;
+
+/*!
+State of the image that is received
+*/
+typedef struct _image
+{
+  FILE*    hFile;
+  char     acPathName[4096];
+  uint32_t uiLength;
+  uint8_t  uiSeq;
+  bool     bError;
+} image_t;
+
+/*============================================================================*/
+/*                               Prototypes                                   */
+/*============================================================================*/
+static int  openDevice(const char* acDevice, unsigned long uiBaud);
+static int  readByte(int hDevice, uint8_t* pByte);
+static int  readPacket(int hDevice, packet_t* pPacket);
+static void startImage(image_t* pImage, const char* acDir, const packet_t* pPacket);
+static int  finishImage(image_t* pImage, const packet_t* pPacket);
+static void dropImage(image_t* pImage, const char* acReason);
+
+/*============================================================================*/
+/*                               Implementation                               */
+/*============================================================================*/
+
+/*----------------------------------------------------------------------------*/
+/* main()                                                                     */
+/*----------------------------------------------------------------------------*/
+int main(int argc, char* argv[])
+{
+  const char*   acDir    = ".";
+  const char*   acDevice = 0;
+  unsigned long uiBaud   = UART_BAUD;
+  long          iCount   = -1;  /* unlimited */
+  int           hDevice;
+  int           iReturn;
+  packet_t      tPacket;
+  image_t       tImage;
+
+  for (int i = 1; i < argc; ++i)
+  {
+    if ((0 == strcmp(argv[i], "-b")) && ((i + 1) < argc))
+    {
+      uiBaud = strtoul(argv[++i], 0, 0);
+    }
+    else if ((0 == strcmp(argv[i], "-d")) && ((i + 1) < argc))
+    {
+      acDir = argv[++i];
+    }
+    else if ((0 == strcmp(argv[i], "-n")) && ((i + 1) < argc))
+    {
+      iCount = strtol(argv[++i], 0, 0);
+    }
+    else if ('-' != argv[i][0])
+    {
+      acDevice = argv[i];
+    }
+    else
+    {
+      acDevice = 0;
+      break;
+    }
+  }
+
+  if (0 == acDevice)
+  {
+    fprintf(stderr, "usage: uartrecv [-b baud] [-d dir] [-n count] device\n");
+    return EXIT_FAILURE;
+  }
+
+  if (0 > (hDevice = openDevice(acDevice, uiBaud)))
+  {
+    fprintf(stderr, "%s: %s\n", acDevice, strerror(errno));
+    return EXIT_FAILURE;
+  }
+
+  memset(&tImage, 0, sizeof(tImage));
+
+  while (0 != iCount)
+  {
+    if (0 > (iReturn = readPacket(hDevice, &tPacket)))
+    {
+      break;  /* device closed */
+    }
+    else if (0 == iReturn)
+    {
+      if (0 != tImage.hFile)
+      {
+        tImage.bError = true;
+      }
+
+      fprintf(stderr, "checksum error\n");
+      continue;
+    }
+
+    if (UART_PKT_START == tPacket.uiType)
+    {
+      startImage(&tImage, acDir, &tPacket);
+    }
+    else if (0 == tImage.hFile)
+    {
+      continue;  /* image started before the receiver */
+    }
+    else if (tPacket.uiSeq != tImage.uiSeq)
+    {
+      dropImage(&tImage, "packet lost");
+    }
+    else if (UART_PKT_DATA == tPacket.uiType)
+    {
+      ++tImage.uiSeq;
+      tImage.uiLength += tPacket.uiLen;
+
+      if (tPacket.uiLen != fwrite(tPacket.auiPayload, 1, tPacket.uiLen, tImage.hFile))
+      {
+        tImage.bError = true;
+      }
+    }
+    else if (UART_PKT_END == tPacket.uiType)
+    {
+      if ((0 == finishImage(&tImage, &tPacket)) && (0 < iCount))
+      {
+        --iCount;
+      }
+    }
+    else
+    {
+      dropImage(&tImage, "aborted");
+    }
+  }
+
+  dropImage(&tImage, "incomplete");
+  close(hDevice);
+
+  return EXIT_SUCCESS;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* openDevice()                                                               */
+/*----------------------------------------------------------------------------*/
+static int openDevice(const char* acDevice, unsigned long uiBaud)
+{
+  static const struct { unsigned long uiBaud; speed_t tSpeed; } s_atSpeeds[] =
+  {
+    {  115200, B115200  }, {  230400, B230400  }, {  460800, B460800  },
+    {  921600, B921600  }, { 1000000, B1000000 }, { 1152000, B1152000 },
+    { 1500000, B1500000 }, { 2000000, B2000000 }
+  };
+
+  struct termios tTermios;
+  int hDevice;
+
+  if (0 > (hDevice = open(acDevice, O_RDONLY | O_NOCTTY)))
+  {
+    return -1;
+  }
+
+  /* Raw mode; a pseudo-terminal accepts but ignores the speed */
+  if (0 == tcgetattr(hDevice, &tTermios))
+  {
+    cfmakeraw(&tTermios);
+    tTermios.c_cc[VMIN]  = 1;
+    tTermios.c_cc[VTIME] = 0;
+
+    for (size_t i = 0; i < sizeof(s_atSpeeds) / sizeof(s_atSpeeds[0]); ++i)
+    {
+      if (uiBaud == s_atSpeeds[i].uiBaud)
+      {
+        cfsetispeed(&tTermios, s_atSpeeds[i].tSpeed);
+        cfsetospeed(&tTermios, s_atSpeeds[i].tSpeed);
+      }
+    }
+
+    (void) tcsetattr(hDevice, TCSANOW, &tTermios);
+  }
+
+  return hDevice;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* readByte()                                                                 */
+/*----------------------------------------------------------------------------*/
+static int readByte(int hDevice, uint8_t* pByte)
+{
+  ssize_t iRead;
+
+  while (0 > (iRead = read(hDevice, pByte, 1)))
+  {
+    if (EINTR != errno)
+    {
+      return -1;
+    }
+  }
+
+  return (1 == iRead ? 0 : -1);
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* readPacket()                                                               */
+/* Returns 1 = packet, 0 = checksum error, -1 = end of input                  */
+/*----------------------------------------------------------------------------*/
+static int readPacket(int hDevice, packet_t* pPacket)
+{
+  uint8_t  uiByte = 0;
+  uint8_t  auiSum[2];
+  uint16_t uiSum1 = 0;
+  uint16_t uiSum2 = 0;
+
+  /* Synchronize */
+  do
+  {
+    if (0 > readByte(hDevice, &uiByte))
+    {
+      return -1;
+    }
+  }
+  while (UART_PKT_SYNC != uiByte);
+
+  if ((0 > readByte(hDevice, &pPacket->uiType)) ||
+      (0 > readByte(hDevice, &pPacket->uiSeq))  ||
+      (0 > readByte(hDevice, &pPacket->uiLen)))
+  {
+    return -1;
+  }
+
+  for (uint16_t i = 0; i < pPacket->uiLen; ++i)
+  {
+    if (0 > readByte(hDevice, &pPacket->auiPayload[i]))
+    {
+      return -1;
+    }
+  }
+
+  if ((0 > readByte(hDevice, &auiSum[0])) || (0 > readByte(hDevice, &auiSum[1])))
+  {
+    return -1;
+  }
+
+  /* Fletcher-16 of TYPE, SEQ, LEN and PAYLOAD */
+  for (int i = -3; i < (int) pPacket->uiLen; ++i)
+  {
+    uiByte = (-3 == i ? pPacket->uiType : -2 == i ? pPacket->uiSeq : -1 == i ? pPacket->uiLen : pPacket->auiPayload[i]);
+    uiSum1 = (uiSum1 + uiByte) % 255;
+    uiSum2 = (uiSum2 + uiSum1) % 255;
+  }
+
+  return ((auiSum[0] == uiSum1) && (auiSum[1] == uiSum2) ? 1 : 0);
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* startImage()                                                               */
+/*----------------------------------------------------------------------------*/
+static void startImage(image_t* pImage, const char* acDir, const packet_t* pPacket)
+{
+  char acName[256];
+  char acBase[256];
+  const char* acExt;
+  struct stat tStat;
+
+  dropImage(pImage, "incomplete");
+
+  /* Only the last component of the name, no hidden files */
+  memcpy(acName, pPacket->auiPayload, pPacket->uiLen);
+  acName[pPacket->uiLen] = '\0';
+
+  for (char* p = acName; 0 != *p; ++p)
+  {
+    if (('/' == *p) || ('\\' == *p) || (':' == *p) || (' ' > *p))
+    {
+      *p = '_';
+    }
+  }
+
+  if (('\0' == acName[0]) || ('.' == acName[0]))
+  {
+    snprintf(acName, sizeof(acName), "scrnshot.bin");
+  }
+
+  /* Never overwrite: name-N.ext */
+  acExt = strrchr(acName, '.');
+  snprintf(acBase, sizeof(acBase), "%.*s", (int) (0 != acExt ? acExt - acName : (long) strlen(acName)), acName);
+  acExt = (0 != acExt ? acExt : "");
+
+  snprintf(pImage->acPathName, sizeof(pImage->acPathName), "%s/%s", acDir, acName);
+
+  for (unsigned int uiIndex = 1; 0 == stat(pImage->acPathName, &tStat); ++uiIndex)
+  {
+    snprintf(pImage->acPathName, sizeof(pImage->acPathName), "%s/%s-%u%s", acDir, acBase, uiIndex, acExt);
+  }
+
+  pImage->uiLength = 0;
+  pImage->uiSeq    = (uint8_t) (pPacket->uiSeq + 1);
+  pImage->bError   = false;
+
+  if (0 == (pImage->hFile = fopen(pImage->acPathName, "wb")))
+  {
+    fprintf(stderr, "%s: %s\n", pImage->acPathName, strerror(errno));
+  }
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* finishImage()                                                              */
+/*----------------------------------------------------------------------------*/
+static int finishImage(image_t* pImage, const packet_t* pPacket)
+{
+  uint32_t uiLength = 0;
+
+  if (4 == pPacket->uiLen)
+  {
+    uiLength = ((uint32_t) pPacket->auiPayload[0]      ) |
+               ((uint32_t) pPacket->auiPayload[1] <<  8) |
+               ((uint32_t) pPacket->auiPayload[2] << 16) |
+               ((uint32_t) pPacket->auiPayload[3] << 24);
+  }
+
+  if ((4 != pPacket->uiLen) || (uiLength != pImage->uiLength))
+  {
+    pImage->bError = true;
+  }
+
+  if (0 != fclose(pImage->hFile))
+  {
+    pImage->bError = true;
+  }
+
+  pImage->hFile = 0;
+
+  if (pImage->bError)
+  {
+    fprintf(stderr, "%s: damaged, removed\n", pImage->acPathName);
+    (void) remove(pImage->acPathName);
+    return -1;
+  }
+
+  printf("%s (%u bytes)\n", pImage->acPathName, (unsigned int) pImage->uiLength);
+  fflush(stdout);
+
+  return 0;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* dropImage()                                                                */
+/*----------------------------------------------------------------------------*/
+static void dropImage(image_t* pImage, const char* acReason)
+{
+  if (0 != pImage->hFile)
+  {
+    fclose(pImage->hFile);
+    pImage->hFile = 0;
+
+    fprintf(stderr, "%s: %s, removed\n", pImage->acPathName, acReason);
+    (void) remove(pImage->acPathName);
+  }
+}
+
+
+/*----------------------------------------------------------------------------*/
+/*                                                                            */
+/*----------------------------------------------------------------------------*/
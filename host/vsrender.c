@@ -0,0 +1,629 @@
+/*-----------------------------------------------------------------------------+
+|                                                                              |
+| filename: vsrender.c                                                         |
+| project:  zxn::scrnshot                                                      |
+| author:   S. Zell                                                            |
+| date:     10/18/2026                                                         |
+|                                                                              |
++------------------------------------------------------------------------------+
+|                                                                              |
+| description:                                                                 |
+|                                                                              |
+| Host tool to render a video state dump (".nvs") of SCRNSHOT to a BMP file    |
+| (Linux); the layers are decoded by the capture engine of the dot command     |
+|                                                                              |
++------------------------------------------------------------------------------+
+|                                                                              |
+| Copyright (c) 10/18/2026 STZ Engineering                                     |
+|                                                                              |
+| This software is provided  "as is",  without warranty of any kind, express   |
+| or implied. In no event shall STZ or its contributors be held liable for any |
+| direct, indirect, incidental, special or consequential damages arising out   |
+| of the use of or inability to use this software.                             |
+|                                                                              |
+| Permission is granted to anyone  to use this  software for any purpose,      |
+| including commercial applications,  and to alter it and redistribute it      |
+| freely, subject to the following restrictions:                               |
+|                                                                              |
+| 1. Redistributions of source code must retain the above copyright            |
+|    notice, definition, disclaimer, and this list of conditions.              |
+|                                                                              |
+| 2. Redistributions in binary form must reproduce the above copyright         |
+|    notice, definition, disclaimer, and this list of conditions in            |
+|    documentation and/or other materials provided with the distribution.      |
+|                                                                          ;-) |
++-----------------------------------------------------------------------------*/
+
+/*============================================================================*/
+/*                               Includes                                     */
+/*============================================================================*/
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <arch/zxn.h>
+#include <arch/zxn/esxdos.h>
+
+#include "libzxn.h"
+#include "scrnshot.h"
+#include "zxnshim.h"
+
+/*============================================================================*/
+/*                               Defines                                      */
+/*============================================================================*/
+/*!
+Size of the display (including the border) in pixels of the 256x192 modes
+*/
+#define DISPLAY_WIDTH  320
+#define DISPLAY_HEIGHT 256
+
+/*!
+Position of the 256x192 area in the display
+*/
+#define DISPLAY_LEFT 32
+#define DISPLAY_TOP  32
+
+/*!
+Marker of a transparent pixel (no valid RRRGGGBBB value)
+*/
+#define TRANSPARENT 0xFFFF
+
+/*============================================================================*/
+/*                               Type-Definitions                             */
+/*============================================================================*/
+/*!
+Layer decoded by the capture engine
+*/
+typedef struct _layer
+{
+  uint8_t  uiMode;            /* Screen mode; 0xFF = layer not shown */
+  uint16_t uiWidth;
+  uint16_t uiHeight;
+  uint8_t* pPixels;           /* One palette index per pixel         */
+  uint16_t auiColours[256];   /* RRRGGGBBB                           */
+} layer_t;
+
+/*============================================================================*/
+/*                               Variables                                    */
+/*============================================================================*/
+/*!
+In dieser Struktur werden alle globalen Daten der Anwendung gespeichert.
+*/
+extern appstate_t g_tState;
+
+/*============================================================================*/
+/*                               Prototypes                                   */
+/*============================================================================*/
+/*!
+Initialisation of the capture engine ("main.c")
+*/
+void _construct(void);
+
+static uint16_t getU16(const uint8_t* p);
+static uint32_t getU32(const uint8_t* p);
+static int      decodeLayer(uint8_t uiMode, layer_t* pLayer);
+static int      readBmp(const uint8_t* pData, uint32_t uiSize, layer_t* pLayer);
+static uint16_t getUlaPixel(const layer_t* pUla, uint16_t x, uint16_t y, uint8_t uiScale);
+static uint16_t getLayer2Pixel(const layer_t* pL2, uint16_t x, uint16_t y, uint8_t uiScale, bool* pPriority);
+static uint16_t mixPixels(uint16_t uiUla, uint16_t uiL2, bool bPriority);
+static int      saveBmp(const char* acPathName, const uint16_t* pCanvas, uint16_t uiWidth, uint16_t uiHeight, bool bCrop, uint8_t uiScale);
+
+/*============================================================================*/
+/*                               Implementation                               */
+/*============================================================================*/
+
+/*----------------------------------------------------------------------------*/
+/* main()                                                                     */
+/*----------------------------------------------------------------------------*/
+int main(int argc, char* argv[])
+{
+  const char* acInput  = 0;
+  const char* acOutput = 0;
+  char        acName[ESX_PATHNAME_MAX];
+  bool        bCrop = false;
+  uint8_t     uiMode;
+  uint8_t     uiScale;
+  layer_t     tUla;
+  layer_t     tL2;
+  uint16_t*   pCanvas;
+  int         iReturn = EXIT_SUCCESS;
+
+  for (int i = 1; i < argc; ++i)
+  {
+    if (0 == strcmp(argv[i], "-c"))
+    {
+      bCrop = true;
+    }
+    else if ((0 == strcmp(argv[i], "-o")) && ((i + 1) < argc))
+    {
+      acOutput = argv[++i];
+    }
+    else if ('-' != argv[i][0])
+    {
+      acInput = argv[i];
+    }
+    else
+    {
+      acInput = 0;
+      break;
+    }
+  }
+
+  if (0 == acInput)
+  {
+    fprintf(stderr, "usage: vsrender [-c] [-o file.bmp] dump.nvs\n"
+                    "       -c  without border (256x192 area)\n");
+    return EXIT_FAILURE;
+  }
+
+  /* Default name of the image: name of the dump with extension "bmp" */
+  if (0 == acOutput)
+  {
+    char* acExt;
+
+    snprintf(acName, sizeof(acName) - 4, "%s", acInput);
+
+    if ((0 != (acExt = strrchr(acName, '.'))) && (0 == strchr(acExt, '/')))
+    {
+      *acExt = 0;
+    }
+
+    strcat(acName, ".bmp");
+    acOutput = acName;
+  }
+
+  zxnReset();
+  _construct();
+
+  if (EOK != zxnLoadState(acInput, &uiMode))
+  {
+    return EXIT_FAILURE;
+  }
+
+  memset(&tUla, 0, sizeof(tUla));
+  memset(&tL2,  0, sizeof(tL2));
+  tUla.uiMode = 0xFF;
+  tL2.uiMode  = 0xFF;
+
+  /* ULA (NREG 0x68 bit 7: disabled): LoRes or the mode of the Timex port */
+  if (0 == (g_tZxn.auiRegs[0x68] & 0x80))
+  {
+    if (g_tZxn.auiRegs[0x15] & 0x80)
+    {
+      tUla.uiMode = 0x10;
+    }
+    else
+    {
+      switch (g_tZxn.uiPortFF & 0x07)
+      {
+        case 0x02: tUla.uiMode = 0x13; break;
+        case 0x06: tUla.uiMode = 0x12; break;
+        default:   tUla.uiMode = 0x00;
+      }
+    }
+  }
+
+  /* Layer 2: resolution of NREG 0x70 */
+  if ((g_tZxn.auiRegs[0x69] & 0x80) || (g_tZxn.uiPort123B & 0x02))
+  {
+    switch (g_tZxn.auiRegs[0x70] & 0x30)
+    {
+      case 0x10: tL2.uiMode = 0x22; break;
+      case 0x20: tL2.uiMode = 0x23; break;
+      default:   tL2.uiMode = 0x20;
+    }
+  }
+
+  if (g_tZxn.auiRegs[0x6B] & 0x80)
+  {
+    fprintf(stderr, "%s: tilemap not rendered\n", acInput);
+  }
+
+  if (g_tZxn.auiRegs[0x15] & 0x01)
+  {
+    fprintf(stderr, "%s: sprites not rendered (not in the dump)\n", acInput);
+  }
+
+  if (((0xFF != tUla.uiMode) && (0 != decodeLayer(tUla.uiMode, &tUla))) ||
+      ((0xFF != tL2.uiMode)  && (0 != decodeLayer(tL2.uiMode,  &tL2))))
+  {
+    return EXIT_FAILURE;
+  }
+
+  /* Hi-res layers: 640 pixels per line, the others are doubled */
+  uiScale = ((0x12 == tUla.uiMode) || (0x23 == tL2.uiMode)) ? 2 : 1;
+
+  if (0 == (pCanvas = malloc(sizeof(uint16_t) * DISPLAY_WIDTH * uiScale * DISPLAY_HEIGHT)))
+  {
+    fprintf(stderr, "out of memory\n");
+    return EXIT_FAILURE;
+  }
+
+  for (uint16_t y = 0; y < DISPLAY_HEIGHT; ++y)
+  {
+    for (uint16_t x = 0; x < DISPLAY_WIDTH * uiScale; ++x)
+    {
+      bool bPriority = false;
+      uint16_t uiUla = getUlaPixel(&tUla, x, y, uiScale);
+      uint16_t uiL2  = getLayer2Pixel(&tL2, x, y, uiScale, &bPriority);
+
+      pCanvas[(((uint32_t) y) * DISPLAY_WIDTH * uiScale) + x] = mixPixels(uiUla, uiL2, bPriority);
+    }
+  }
+
+  if (0 != saveBmp(acOutput, pCanvas, DISPLAY_WIDTH * uiScale, DISPLAY_HEIGHT, bCrop, uiScale))
+  {
+    fprintf(stderr, "%s: %s\n", acOutput, strerror(errno));
+    iReturn = EXIT_FAILURE;
+  }
+  else
+  {
+    printf("%s: mode 0x%02X, ULA 0x%02X, layer 2 0x%02X -> %s\n",
+           acInput, uiMode, tUla.uiMode, tL2.uiMode, acOutput);
+  }
+
+  free(pCanvas);
+  free(tUla.pPixels);
+  free(tL2.pPixels);
+
+  return iReturn;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* getU16()                                                                   */
+/*----------------------------------------------------------------------------*/
+static uint16_t getU16(const uint8_t* p)
+{
+  return (uint16_t) (p[0] | (p[1] << 8));
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* getU32()                                                                   */
+/*----------------------------------------------------------------------------*/
+static uint32_t getU32(const uint8_t* p)
+{
+  return ((uint32_t) getU16(p)) | (((uint32_t) getU16(p + 2)) << 16);
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* decodeLayer()                                                              */
+/*----------------------------------------------------------------------------*/
+static int decodeLayer(uint8_t uiMode, layer_t* pLayer)
+{
+  int iReturn;
+  uint8_t hFile = zxnOpenMemoryFile();
+  const uint8_t* pData;
+  uint32_t uiSize = 0;
+
+  /* One BMP output into memory */
+  g_tState.uiOutputs            = 1;
+  g_tState.atOutputs[0].eFormat = FORMAT_BMP;
+  g_tState.atOutputs[0].hFile   = hFile;
+  g_tState.bmpfile.eSink        = SINK_FILE;
+
+  if (EOK == (iReturn = captureImage(getScreenModeInfo(uiMode))))
+  {
+    pData   = zxnGetMemoryFile(hFile, &uiSize);
+    iReturn = readBmp(pData, uiSize, pLayer);
+  }
+  else
+  {
+    fprintf(stderr, "mode 0x%02X: %s\n", uiMode, strerror(iReturn));
+  }
+
+  (void) esx_f_close(hFile);
+  g_tState.atOutputs[0].hFile = INV_FILE_HND;
+
+  return iReturn;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* readBmp()                                                                  */
+/*----------------------------------------------------------------------------*/
+static int readBmp(const uint8_t* pData, uint32_t uiSize, layer_t* pLayer)
+{
+  uint32_t uiOffBits;
+  int32_t  iHeight;
+  uint16_t uiBitCount;
+  uint32_t uiColours;
+  uint32_t uiStride;
+
+  if ((54 > uiSize) || ('B' != pData[0]) || ('M' != pData[1]))
+  {
+    return EINVAL;
+  }
+
+  uiOffBits        = getU32(&pData[10]);
+  pLayer->uiWidth  = (uint16_t) getU32(&pData[18]);
+  iHeight          = (int32_t) getU32(&pData[22]);
+  pLayer->uiHeight = (uint16_t) (0 > iHeight ? -iHeight : iHeight);
+  uiBitCount       = getU16(&pData[28]);
+  uiColours        = getU32(&pData[46]);
+  uiStride         = ((((uint32_t) pLayer->uiWidth) * uiBitCount + 31) >> 5) << 2;
+
+  if ((256 < uiColours) || (uiSize < (uiOffBits + uiStride * pLayer->uiHeight)))
+  {
+    return EINVAL;
+  }
+
+  for (uint16_t i = 0; i < uiColours; ++i)
+  {
+    pLayer->auiColours[i] = rgb8_to_rgb9((const bmppaletteentry_t*) &pData[54 + 4 * i]);
+  }
+
+  if (0 == (pLayer->pPixels = malloc(((uint32_t) pLayer->uiWidth) * pLayer->uiHeight)))
+  {
+    return ENOMEM;
+  }
+
+  for (uint16_t y = 0; y < pLayer->uiHeight; ++y)
+  {
+    /* bottom-up (positive height) or top-down */
+    const uint8_t* pRow = pData + uiOffBits + uiStride * (0 < iHeight ? pLayer->uiHeight - 1 - y : y);
+    uint8_t* pPixel = pLayer->pPixels + ((uint32_t) y) * pLayer->uiWidth;
+
+    for (uint16_t x = 0; x < pLayer->uiWidth; ++x)
+    {
+      switch (uiBitCount)
+      {
+        case 1:  pPixel[x] = (pRow[x >> 3] >> (7 - (x & 7))) & 0x01; break;
+        case 4:  pPixel[x] = (x & 1) ? (pRow[x >> 1] & 0x0F) : (pRow[x >> 1] >> 4); break;
+        default: pPixel[x] = pRow[x];
+      }
+    }
+  }
+
+  return EOK;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* getUlaPixel()                                                              */
+/*----------------------------------------------------------------------------*/
+static uint16_t getUlaPixel(const layer_t* pUla, uint16_t x, uint16_t y, uint8_t uiScale)
+{
+  const uint8_t* pClip = g_tZxn.aauiClip[2];
+  uint16_t uiColour;
+  int16_t  ux = (int16_t) (x / uiScale) - DISPLAY_LEFT;
+  int16_t  uy = (int16_t) y - DISPLAY_TOP;
+
+  /* Border: colour of port 0xFE is not readable, the fallback colour is shown */
+  if ((0xFF == pUla->uiMode) || (0 > ux) || (256 <= ux) || (0 > uy) || (192 <= uy))
+  {
+    return TRANSPARENT;
+  }
+
+  /* Clip window (NREG 0x1A) */
+  if ((ux < pClip[0]) || (ux > pClip[1]) || (uy < pClip[2]) || (uy > pClip[3]))
+  {
+    return TRANSPARENT;
+  }
+
+  switch (pUla->uiMode)
+  {
+    case 0x10: /* LoRes: 128x96, scroll NREG 0x32/0x33 */
+      ux = ((ux + g_tZxn.auiRegs[0x32]) & 0xFF) >> 1;
+      uy = ((uy + g_tZxn.auiRegs[0x33]) % 192) >> 1;
+      break;
+
+    case 0x12: /* Hi-res: 512x192, scroll NREG 0x26/0x27 */
+      ux = (((ux << 1) | ((x - DISPLAY_LEFT * uiScale) & (uiScale - 1))) + (g_tZxn.auiRegs[0x26] << 1)) & 0x1FF;
+      uy = (uy + g_tZxn.auiRegs[0x27]) % 192;
+      break;
+
+    default:
+      ux = (ux + g_tZxn.auiRegs[0x26]) & 0xFF;
+      uy = (uy + g_tZxn.auiRegs[0x27]) % 192;
+  }
+
+  uiColour = pUla->auiColours[pUla->pPixels[((uint32_t) uy) * pUla->uiWidth + ux]];
+
+  /* Global transparency (NREG 0x14: RRRGGGBB) */
+  return ((uiColour >> 1) == g_tZxn.auiRegs[0x14]) ? TRANSPARENT : uiColour;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* getLayer2Pixel()                                                           */
+/*----------------------------------------------------------------------------*/
+static uint16_t getLayer2Pixel(const layer_t* pL2, uint16_t x, uint16_t y, uint8_t uiScale, bool* pPriority)
+{
+  const uint8_t* pClip = g_tZxn.aauiClip[0];
+  uint16_t uiScrollX = g_tZxn.auiRegs[0x16] | ((g_tZxn.auiRegs[0x71] & 0x01) << 8);
+  uint8_t  uiIndex;
+  uint16_t uiColour;
+  int16_t  lx;
+  int16_t  ly;
+
+  if (0xFF == pL2->uiMode)
+  {
+    return TRANSPARENT;
+  }
+
+  switch (pL2->uiMode)
+  {
+    case 0x20: /* 256x192 in the middle of the display */
+      lx = (int16_t) (x / uiScale) - DISPLAY_LEFT;
+      ly = (int16_t) y - DISPLAY_TOP;
+
+      if ((0 > lx) || (256 <= lx) || (0 > ly) || (192 <= ly) ||
+          (lx < pClip[0]) || (lx > pClip[1]) || (ly < pClip[2]) || (ly > pClip[3]))
+      {
+        return TRANSPARENT;
+      }
+
+      lx = (lx + (uiScrollX & 0xFF)) & 0xFF;
+      ly = (ly + g_tZxn.auiRegs[0x17]) % 192;
+      break;
+
+    case 0x22: /* 320x256: clip X in steps of 2 pixels */
+      lx = (int16_t) (x / uiScale);
+      ly = (int16_t) y;
+
+      if ((lx < (pClip[0] << 1)) || (lx > ((pClip[1] << 1) | 1)) || (ly < pClip[2]) || (ly > pClip[3]))
+      {
+        return TRANSPARENT;
+      }
+
+      lx = (lx + uiScrollX) % 320;
+      ly = (ly + g_tZxn.auiRegs[0x17]) & 0xFF;
+      break;
+
+    default: /* 640x256: clip X in steps of 4 pixels */
+      lx = (int16_t) x;
+      ly = (int16_t) y;
+
+      if ((lx < (pClip[0] << 2)) || (lx > ((pClip[1] << 2) | 3)) || (ly < pClip[2]) || (ly > pClip[3]))
+      {
+        return TRANSPARENT;
+      }
+
+      lx = (lx + (uiScrollX << 1)) % 640;
+      ly = (ly + g_tZxn.auiRegs[0x17]) & 0xFF;
+  }
+
+  uiIndex  = pL2->pPixels[((uint32_t) ly) * pL2->uiWidth + lx];
+  uiColour = pL2->auiColours[uiIndex];
+
+  /* Priority bit of the active Layer 2 palette (NREG 0x43 bit 2) */
+  *pPriority = 0 != (g_tZxn.aauiPalette[(g_tZxn.auiRegs[0x43] & 0x04) ? 5 : 1][uiIndex] & 0x8000);
+
+  return ((uiColour >> 1) == g_tZxn.auiRegs[0x14]) ? TRANSPARENT : uiColour;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* mixPixels()                                                                */
+/*----------------------------------------------------------------------------*/
+static uint16_t mixPixels(uint16_t uiUla, uint16_t uiL2, bool bPriority)
+{
+  uint8_t uiOrder = (g_tZxn.auiRegs[0x15] >> 2) & 0x07;
+  uint8_t uiFallback = g_tZxn.auiRegs[0x4A];
+
+  if ((TRANSPARENT == uiUla) && (TRANSPARENT == uiL2))
+  {
+    return (uint16_t) ((uiFallback << 1) | ((uiFallback & 0x03) ? 1 : 0));
+  }
+
+  if (TRANSPARENT == uiUla)
+  {
+    return uiL2;
+  }
+
+  if ((TRANSPARENT == uiL2) || (bPriority && (6 > uiOrder)))
+  {
+    return (TRANSPARENT == uiL2) ? uiUla : uiL2;
+  }
+
+  /* NREG 0x15 bits 4-2 (sprites are not rendered): SLU, LSU, SUL, LUS, USL,
+     ULS, U+L, U+L-5 */
+  switch (uiOrder)
+  {
+    case 0:
+    case 1:
+    case 3:
+      return uiL2;
+
+    case 6:
+    case 7:
+    {
+      uint16_t uiColour = 0;
+
+      for (uint8_t i = 0; i < 9; i += 3)
+      {
+        int16_t iValue = ((uiUla >> i) & 0x07) + ((uiL2 >> i) & 0x07) - (7 == uiOrder ? 5 : 0);
+        uiColour |= ((uint16_t) constrain(iValue, 0, 7)) << i;
+      }
+
+      return uiColour;
+    }
+
+    default:
+      return uiUla;
+  }
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* saveBmp()                                                                  */
+/*----------------------------------------------------------------------------*/
+static int saveBmp(const char* acPathName, const uint16_t* pCanvas, uint16_t uiWidth, uint16_t uiHeight, bool bCrop, uint8_t uiScale)
+{
+  FILE*    hFile;
+  uint8_t  auiHeader[54];
+  uint8_t* pRow;
+  uint16_t uiLeft   = bCrop ? DISPLAY_LEFT * uiScale : 0;
+  uint16_t uiTop    = bCrop ? DISPLAY_TOP : 0;
+  uint16_t uiCols   = bCrop ? 256 * uiScale : uiWidth;
+  uint16_t uiRows   = bCrop ? 192 : uiHeight;
+  uint32_t uiStride = ((((uint32_t) uiCols) * 3) + 3) & ~UINT32_C(3);
+  uint32_t uiImage  = uiStride * uiRows;
+  int      iReturn  = 0;
+
+  #define PUT_U16(o, v) do { auiHeader[o] = (uint8_t) (v); auiHeader[(o) + 1] = (uint8_t) ((v) >> 8); } while (0)
+  #define PUT_U32(o, v) do { PUT_U16(o, (v) & 0xFFFF); PUT_U16((o) + 2, (v) >> 16); } while (0)
+
+  memset(auiHeader, 0, sizeof(auiHeader));
+  auiHeader[0] = 'B';
+  auiHeader[1] = 'M';
+  PUT_U32( 2, sizeof(auiHeader) + uiImage); /* file size                */
+  PUT_U32(10, sizeof(auiHeader));           /* offset of the pixel data */
+  PUT_U32(14, 40);                          /* size of the info header  */
+  PUT_U32(18, uiCols);
+  PUT_U32(22, uiRows);                      /* bottom-up                */
+  PUT_U16(26, 1);                           /* planes                   */
+  PUT_U16(28, 24);                          /* bits per pixel           */
+  PUT_U32(34, uiImage);
+  PUT_U32(38, BMP_DPI_72);
+  PUT_U32(42, BMP_DPI_72);
+
+  #undef PUT_U32
+  #undef PUT_U16
+
+  if (0 == (pRow = calloc(1, uiStride)))
+  {
+    return -1;
+  }
+
+  if ((0 == (hFile = fopen(acPathName, "wb"))) || (1 != fwrite(auiHeader, sizeof(auiHeader), 1, hFile)))
+  {
+    iReturn = -1;
+  }
+
+  for (uint16_t y = uiRows; (0 == iReturn) && (0 < y); --y)
+  {
+    const uint16_t* pPixel = pCanvas + ((uint32_t) (uiTop + y - 1)) * uiWidth + uiLeft;
+
+    for (uint16_t x = 0; x < uiCols; ++x)
+    {
+      pRow[3 * x + 0] = rgb3_to_rgb8( pPixel[x]       & 0x07);  /* blue  */
+      pRow[3 * x + 1] = rgb3_to_rgb8((pPixel[x] >> 3) & 0x07);  /* green */
+      pRow[3 * x + 2] = rgb3_to_rgb8((pPixel[x] >> 6) & 0x07);  /* red   */
+    }
+
+    if (1 != fwrite(pRow, uiStride, 1, hFile))
+    {
+      iReturn = -1;
+    }
+  }
+
+  if ((0 != hFile) && (0 != fclose(hFile)))
+  {
+    iReturn = -1;
+  }
+
+  free(pRow);
+
+  return iReturn;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/*                                                                            */
+/*----------------------------------------------------------------------------*/
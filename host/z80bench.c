@@ -0,0 +1,1462 @@
+/*-----------------------------------------------------------------------------+
+|                                                                              |
+| filename: z80bench.c                                                         |
+| project:  zxn::scrnshot                                                      |
+| author:   S. Zell                                                            |
+| date:     10/18/2026                                                         |
+|                                                                              |
++------------------------------------------------------------------------------+
+|                                                                              |
+| description:                                                                 |
+|                                                                              |
+| Host: T-state benchmark of the dot command. The binary built by z88dk runs   |
+| on the Z80N core with the fixtures of the golden image test; esxdos (RST 8)  |
+| is served from the host file system, NextRegs and MMU by the shim. The       |
+| T-states are reported per phase (header, palette, decode, write) and         |
+| compared with a baseline. The results of builds with different pixel address |
+| strategies (_PIXEL_CALC_*) are collected to select the fastest one per path. |
+|                                                                              |
++------------------------------------------------------------------------------+
+|                                                                              |
+| Copyright (c) 10/18/2026 STZ Engineering                                     |
+|                                                                              |
+| This software is provided  "as is",  without warranty of any kind, express   |
+| or implied. In no event shall STZ or its contributors be held liable for any |
+| direct, indirect, incidental, special or consequential damages arising out   |
+| of the use of or inability to use this software.                             |
+|                                                                              |
+| Permission is granted to anyone  to use this  software for any purpose,      |
+| including commercial applications,  and to alter it and redistribute it      |
+| freely, subject to the following restrictions:                               |
+|                                                                              |
+| 1. Redistributions of source code must retain the above copyright            |
+|    notice, definition, disclaimer, and this list of conditions.              |
+|                                                                              |
+| 2. Redistributions in binary form must reproduce the above copyright         |
+|    notice, definition, disclaimer, and this list of conditions in            |
+|    documentation and/or other materials provided with the distribution.      |
+|                                                                          ;-) |
++-----------------------------------------------------------------------------*/
+
+/*============================================================================*/
+/*                               Includes                                     */
+/*============================================================================*/
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <arch/zxn.h>
+#include <arch/zxn/esxdos.h>
+#include <z80.h>
+
+#include "libzxn.h"
+#include "zxnshim.h"
+#include "z80n.h"
+
+/*============================================================================*/
+/*                               Defines                                      */
+/*============================================================================*/
+/*!
+Layout of the dot command: the first 8K are loaded by NextZXOS to 0x2000 (MMU1,
+DivMMC), the crt loads the rest itself (M_GETHANDLE, IDE_BANK, F_READ)
+*/
+#define DOT_ADDR 0x2000
+#define DOT_SIZE 0x2000
+
+/*!
+Command line (BC) and arguments (HL) of the dot command, stack and the return
+address that ends the run
+*/
+#define CMDLINE_ADDR 0x5B00
+#define STACK_ADDR   0xFF40
+#define EXIT_ADDR    0x0000
+
+/*!
+Default limit of a run (T-states)
+*/
+#define TSTATES_MAX 4000000000ULL
+
+/*!
+Clock of the CPU for the times in ms (28 MHz; no contention, no wait states)
+*/
+#define CPU_CLOCK 28000000ULL
+
+/*!
+Functions of RST 8 (esxdos/NextZXOS API)
+*/
+#define M_DOSVERSION 0x88
+#define M_GETSETDRV  0x89
+#define M_GETHANDLE  0x8D
+#define M_GETDATE    0x8E
+#define M_P3DOS      0x94
+#define M_ERRH       0x95
+#define F_OPEN       0x9A
+#define F_CLOSE      0x9B
+#define F_SYNC       0x9C
+#define F_READ       0x9D
+#define F_WRITE      0x9E
+#define F_SEEK       0x9F
+#define F_FGETPOS    0xA0
+#define F_GETCWD     0xA8
+#define F_STAT       0xAC
+#define F_UNLINK     0xAD
+
+/*!
++3DOS calls of M_P3DOS (DE)
+*/
+#define IDE_BANK 0x01BD
+#define IDE_MODE 0x01D5
+
+/*!
+Error codes of esxdos (register A)
+*/
+#define ESXERR_ENOENT 5
+#define ESXERR_EIO    6
+#define ESXERR_EBADF  13
+#define ESXERR_ENOSYS 20
+
+/*!
+Maximum number of symbols of the phases and of nested calls
+*/
+#define SYMBOLS_MAX 64
+#define FRAMES_MAX  64
+
+/*!
+Maximum number of variants of the pixel address strategy in a result file
+*/
+#define VARIANTS_MAX 16
+
+/*============================================================================*/
+/*                               Type-Definitions                             */
+/*============================================================================*/
+/*!
+Phases of a screenshot; the T-states of an instruction are counted for the
+innermost function of a phase that is active
+*/
+typedef enum _phase
+{
+  PHASE_OTHER = 0,  /* startup, options, file handling, exit   */
+  PHASE_HEADER,     /* saveImageHeader                         */
+  PHASE_PALETTE,    /* saveColourPalette, saveColourTable      */
+  PHASE_DECODE,     /* makeScreenshot_Lxx (without the writes) */
+  PHASE_WRITE,      /* esx_f_write*                            */
+  PHASE_COUNT
+} phase_t;
+
+/*!
+Entry of a function of a phase (from the map file of z88dk)
+*/
+typedef struct _symbol
+{
+  uint16_t uiAddr;
+  phase_t  ePhase;
+} symbol_t;
+
+/*!
+Active function of a phase: SP at the entry (return address)
+*/
+typedef struct _frame
+{
+  uint16_t uiSP;
+  phase_t  ePhase;
+} frame_t;
+
+/*!
+Result of one screen mode
+*/
+typedef struct _result
+{
+  uint64_t auiPhases[PHASE_COUNT];
+  uint64_t uiTotal;
+  uint32_t uiWrites;      /* F_WRITE calls   */
+  uint32_t uiBytes;       /* Bytes written   */
+  uint32_t uiCodeSize;    /* makeScreenshot_Lxx (map file) */
+} result_t;
+
+/*!
+Emulated Next running the dot command
+*/
+typedef struct _machine
+{
+  z80n_t   tCpu;
+  uint8_t  uiNextReg;     /* Selected NextReg (port 0x243B)  */
+  uint8_t  hDot;          /* Dot command (M_GETHANDLE)       */
+  bool     bVerbose;      /* Output of RST 0x10 to stdout    */
+  symbol_t atSymbols[SYMBOLS_MAX];
+  uint8_t  uiSymbols;
+  frame_t  atFrames[FRAMES_MAX];
+  uint8_t  uiFrames;
+  result_t tResult;
+} machine_t;
+
+/*!
+Test case: fixture "<name>.nvs" and reference image "<name>.bmp" (see "regress")
+*/
+typedef struct _benchcase
+{
+  const char* acName;
+  const char* acLabel;    /* Key of the baseline                         */
+  const char* acPath;     /* Pixel address strategy (_PIXEL_CALC_<path>_) */
+  const char* acDecoder;  /* Symbol of the decoder (code size)           */
+} benchcase_t;
+
+/*!
+Sum of the modes of a path for one variant of the pixel address strategy
+*/
+typedef struct _variant
+{
+  char     acKey[16];
+  uint64_t uiDecode;
+  uint32_t uiCodeSize;
+  uint8_t  uiModes;
+} variant_t;
+
+/*============================================================================*/
+/*                               Variables                                    */
+/*============================================================================*/
+/*!
+Screen modes: the fixtures of the golden image test
+*/
+static const benchcase_t s_atCases[] =
+{
+  {"scrnshot-L00", "L00", "ULA",     "_makeUlaScreenshot"},
+  {"scrnshot-L10", "L10", 0,         "_makeScreenshot_L10"},
+  {"scrnshot-L11", "L11", "ULA",     "_makeUlaScreenshot"},
+  {"scrnshot-L12", "L12", 0,         "_makeScreenshot_L12"},
+  {"scrnshot-L13", "L13", "HICOLOR", "_makeUlaScreenshot"},
+  {"scrnshot-L20", "L20", 0,         "_makeScreenshot_L20"},
+  {"scrnshot-L22", "L22", 0,         "_makeScreenshot_L22"},
+  {"scrnshot-L23", "L23", 0,         "_makeScreenshot_L23"}
+};
+
+#define CASES_COUNT (sizeof(s_atCases) / sizeof(s_atCases[0]))
+
+/*!
+Names of the phases (columns of the report and the baseline)
+*/
+static const char* s_acPhases[PHASE_COUNT] = {"other", "header", "palette", "decode", "write"};
+
+/*!
+Paths with a choice of the pixel address strategy (see "scrnshot.h")
+*/
+static const char* s_acPaths[] = {"ULA", "HICOLOR"};
+
+/*============================================================================*/
+/*                               Prototypes                                   */
+/*============================================================================*/
+/*!
+Reads the entries of the phase functions from the map file of z88dk (lines
+"_name = $XXXX ; ...")
+@return Number of symbols found
+*/
+static uint8_t readMapFile(machine_t* pMachine, const char* acPathName);
+
+/*!
+Runs the dot command with the fixture of a screen mode and compares the image
+with the reference
+@return "EOK" = run without error, image identical
+*/
+static int runCase(machine_t* pMachine, const char* acDot, const char* acDir, const char* acWork, const benchcase_t* pCase);
+
+/*!
+Executes the dot command until it returns
+@return "EOK" = dot command returned without error
+*/
+static int runDot(machine_t* pMachine, uint64_t uiLimit);
+
+/*!
+Callbacks of the CPU
+*/
+static bool    isWritable(z80n_t* pCpu, uint16_t uiAddr);
+static uint8_t readPort(z80n_t* pCpu, uint16_t uiPort);
+static void    writePort(z80n_t* pCpu, uint16_t uiPort, uint8_t uiValue);
+static void    writeNextReg(z80n_t* pCpu, uint8_t uiReg, uint8_t uiValue);
+static bool    callRestart(z80n_t* pCpu, uint8_t uiAddr);
+
+/*!
+RST 8: esxdos/NextZXOS API on the host file system (pointers in HL, as for
+dot commands); "M_P3DOS" emulates the +3DOS calls IDE_BANK and IDE_MODE
+*/
+static void callEsxdos(machine_t* pMachine, uint8_t uiFunction);
+static void callP3dos(machine_t* pMachine);
+
+/*!
+Return of an esxdos call: carry clear = success, else A = error code
+*/
+static void setEsxResult(z80n_t* pCpu, uint8_t uiError);
+
+/*!
+Copies a string (terminated by 0) from the Z80 address space
+*/
+static void getString(z80n_t* pCpu, uint16_t uiAddr, char* acBuffer, size_t uiSize);
+
+/*!
+Reads and writes the baseline (one line per screen mode: label and T-states of
+the phases and the total)
+@return "EOK" = no error
+*/
+static int readBaseline(const char* acPathName, result_t* pResults, bool* pValid);
+static int writeBaseline(const char* acPathName, const result_t* pResults);
+
+/*!
+Size of a function: distance to the next symbol of the map file
+@return Size in bytes; "0" = not found
+*/
+static uint32_t getCodeSize(const char* acMap, const char* acSymbol);
+
+/*!
+Appends the results of one variant of the pixel address strategy (lines "key
+mode decode size", successful runs only)
+@return "EOK" = no error
+*/
+static int writeVariant(const char* acPathName, const char* acKey, const result_t* pResults, const bool* pValid);
+
+/*!
+Selects the variant with the fewest decode T-states (then code size) of every
+path from the collected results; prints the choice as makefile assignments
+("PIXEL_CALC_<path> := key"), the figures as comments
+@return "EOK" = a variant for every path
+*/
+static int selectVariants(const char* acPathName);
+
+/*!
+Reads a file into memory (to be freed by the caller)
+@return Data of the file; "0" = error
+*/
+static uint8_t* readFile(const char* acPathName, uint32_t* pSize);
+
+/*============================================================================*/
+/*                               Implementation                               */
+/*============================================================================*/
+
+/*----------------------------------------------------------------------------*/
+/* main()                                                                     */
+/*----------------------------------------------------------------------------*/
+int main(int argc, char* argv[])
+{
+  static machine_t tMachine;
+  result_t    atResults[CASES_COUNT];
+  result_t    atBase[CASES_COUNT];
+  bool        abBase[CASES_COUNT];
+  const char* acDot      = 0;
+  const char* acDir      = "../test";
+  const char* acMap      = 0;
+  const char* acBaseline = 0;
+  const char* acResults  = 0;
+  const char* acKey      = 0;
+  bool        abValid[CASES_COUNT];
+  bool        bWrite     = false;
+  double      fTolerance = 0.0;
+  char        acWork[]   = "/tmp/z80bench.XXXXXX";
+  char        acCwd[ESX_PATHNAME_MAX];
+  unsigned    uiFail     = 0;
+
+  memset(&tMachine, 0, sizeof(tMachine));
+
+  for (int i = 1; i < argc; ++i)
+  {
+    if ((0 == strcmp(argv[i], "-m")) && ((i + 1) < argc))
+    {
+      acMap = argv[++i];
+    }
+    else if (((0 == strcmp(argv[i], "-b")) || (0 == strcmp(argv[i], "-w"))) && ((i + 1) < argc))
+    {
+      bWrite     = ('w' == argv[i][1]);
+      acBaseline = argv[++i];
+    }
+    else if ((0 == strcmp(argv[i], "-t")) && ((i + 1) < argc))
+    {
+      fTolerance = strtod(argv[++i], 0);
+    }
+    else if ((0 == strcmp(argv[i], "-k")) && ((i + 1) < argc))
+    {
+      acKey = argv[++i];
+    }
+    else if ((0 == strcmp(argv[i], "-r")) && ((i + 1) < argc))
+    {
+      acResults = argv[++i];
+    }
+    else if ((0 == strcmp(argv[i], "-s")) && ((i + 1) < argc))
+    {
+      return (EOK == selectVariants(argv[++i])) ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+    else if (0 == strcmp(argv[i], "-v"))
+    {
+      tMachine.bVerbose = true;
+    }
+    else if (('-' != argv[i][0]) && (0 == acDot))
+    {
+      acDot = argv[i];
+    }
+    else if ('-' != argv[i][0])
+    {
+      acDir = argv[i];
+    }
+    else
+    {
+      acDot = 0;
+      break;
+    }
+  }
+
+  if ((0 == acDot) || ((0 == acKey) != (0 == acResults)))
+  {
+    fprintf(stderr, "usage: z80bench [-m file.map] [-b|-w baseline] [-t percent] [-k key -r results] [-v] dot [directory]\n"
+                    "       z80bench -s results\n"
+                    "       -m  map file of the dot command (phases; \"zcc -m\")\n"
+                    "       -b  compare with the baseline (fails on a regression)\n"
+                    "       -w  write the baseline\n"
+                    "       -t  tolerance of the comparison in percent (default 0)\n"
+                    "       -k  variant of the build (e.g. _PIXEL_CALC_ value)\n"
+                    "       -r  append the decode T-states and code sizes to results\n"
+                    "       -s  select the fastest variant per path of results\n"
+                    "       -v  show the output of the dot command\n");
+    return EXIT_FAILURE;
+  }
+
+  if (0 != access(acDot, R_OK))
+  {
+    fprintf(stderr, "%s: %s (build it with \"make\" in the directory \"build\")\n", acDot, strerror(errno));
+    return EXIT_FAILURE;
+  }
+
+  if ((0 == acMap) || (0 == readMapFile(&tMachine, acMap)))
+  {
+    fprintf(stderr, "no map file: only the total is measured\n");
+  }
+
+  /* The images are written to a temporary directory (relative names) */
+  if ((0 == getcwd(acCwd, sizeof(acCwd))) || (0 == mkdtemp(acWork)))
+  {
+    perror("z80bench");
+    return EXIT_FAILURE;
+  }
+
+  printf("%-5s %10s %10s %10s %10s %10s %10s %8s %7s %8s\n",
+         "mode", s_acPhases[PHASE_HEADER], s_acPhases[PHASE_PALETTE], s_acPhases[PHASE_DECODE],
+         s_acPhases[PHASE_WRITE], s_acPhases[PHASE_OTHER], "total", "ms", "writes", "bytes");
+
+  for (uint8_t i = 0; i < CASES_COUNT; ++i)
+  {
+    const result_t* p = &tMachine.tResult;
+    int iReturn = runCase(&tMachine, acDot, acDir, acWork, &s_atCases[i]);
+
+    if (0 != chdir(acCwd))
+    {
+      perror(acCwd);
+      return EXIT_FAILURE;
+    }
+
+    atResults[i] = tMachine.tResult;
+    abValid[i]   = (EOK == iReturn);
+
+    if (0 != acMap)
+    {
+      atResults[i].uiCodeSize = getCodeSize(acMap, s_atCases[i].acDecoder);
+    }
+
+    printf("%-5s %10llu %10llu %10llu %10llu %10llu %10llu %8.1f %7u %8u%s\n",
+           s_atCases[i].acLabel,
+           (unsigned long long) p->auiPhases[PHASE_HEADER],
+           (unsigned long long) p->auiPhases[PHASE_PALETTE],
+           (unsigned long long) p->auiPhases[PHASE_DECODE],
+           (unsigned long long) p->auiPhases[PHASE_WRITE],
+           (unsigned long long) p->auiPhases[PHASE_OTHER],
+           (unsigned long long) p->uiTotal,
+           (double) p->uiTotal * 1000.0 / CPU_CLOCK,
+           p->uiWrites, p->uiBytes,
+           EOK == iReturn ? "" : "  FAILED");
+
+    if (EOK != iReturn)
+    {
+      ++uiFail;
+    }
+  }
+
+  (void) rmdir(acWork);
+
+  if ((0 != acResults) && (EOK != writeVariant(acResults, acKey, atResults, abValid)))
+  {
+    ++uiFail;
+  }
+
+  if ((0 != acBaseline) && bWrite)
+  {
+    if (0 != uiFail)
+    {
+      fprintf(stderr, "%s: not written (failed runs)\n", acBaseline);
+    }
+    else if (EOK == writeBaseline(acBaseline, atResults))
+    {
+      printf("baseline written to %s\n", acBaseline);
+    }
+    else
+    {
+      ++uiFail;
+    }
+  }
+  else if ((0 != acBaseline) && (EOK == readBaseline(acBaseline, atBase, abBase)))
+  {
+    printf("\ncompared with %s (tolerance %.1f%%):\n", acBaseline, fTolerance);
+
+    for (uint8_t i = 0; i < CASES_COUNT; ++i)
+    {
+      if (!abBase[i])
+      {
+        printf("%-5s not in the baseline\n", s_atCases[i].acLabel);
+        continue;
+      }
+
+      printf("%-5s", s_atCases[i].acLabel);
+
+      for (uint8_t j = 0; j <= PHASE_COUNT; ++j)
+      {
+        /* Columns of the report: phases from "header", "other", total */
+        uint8_t  uiPhase = (PHASE_COUNT > j) ? (uint8_t) ((j + 1) % PHASE_COUNT) : PHASE_COUNT;
+        uint64_t uiNew  = (PHASE_COUNT == uiPhase) ? atResults[i].uiTotal : atResults[i].auiPhases[uiPhase];
+        uint64_t uiOld  = (PHASE_COUNT == uiPhase) ? atBase[i].uiTotal    : atBase[i].auiPhases[uiPhase];
+        double   fDelta = (0 == uiOld) ? (0 == uiNew ? 0.0 : 100.0) : (((double) uiNew - (double) uiOld) * 100.0 / (double) uiOld);
+        bool     bWorse = fDelta > fTolerance;
+
+        printf(" %s %+.1f%%%s", (PHASE_COUNT == uiPhase) ? "total" : s_acPhases[uiPhase], fDelta, bWorse ? " (!)" : "");
+
+        if (bWorse)
+        {
+          ++uiFail;
+        }
+      }
+
+      printf("\n");
+    }
+  }
+  else if (0 != acBaseline)
+  {
+    ++uiFail;
+  }
+
+  return (0 == uiFail) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* readMapFile()                                                              */
+/*----------------------------------------------------------------------------*/
+static uint8_t readMapFile(machine_t* pMachine, const char* acPathName)
+{
+  static const struct
+  {
+    const char* acName;
+    bool        bPrefix;
+    phase_t     ePhase;
+  } atPhases[] =
+  {
+    {"_saveImageHeader",   false, PHASE_HEADER},
+    {"_saveColourPalette", false, PHASE_PALETTE},
+    {"_saveColourTable",   false, PHASE_PALETTE},
+    {"_makeScreenshot_L",  true,  PHASE_DECODE},
+    {"_makeUlaScreenshot", false, PHASE_DECODE},
+    {"_esx_f_write",       true,  PHASE_WRITE}
+  };
+
+  FILE* hFile;
+  char  acLine[512];
+
+  if (0 == (hFile = fopen(acPathName, "r")))
+  {
+    fprintf(stderr, "%s: %s\n", acPathName, strerror(errno));
+    return 0;
+  }
+
+  while ((0 != fgets(acLine, sizeof(acLine), hFile)) && (SYMBOLS_MAX > pMachine->uiSymbols))
+  {
+    char     acName[128];
+    unsigned uiAddr;
+
+    if (2 != sscanf(acLine, "%127s = $%x", acName, &uiAddr))
+    {
+      continue;
+    }
+
+    for (uint8_t i = 0; i < (sizeof(atPhases) / sizeof(atPhases[0])); ++i)
+    {
+      bool bMatch = atPhases[i].bPrefix ?
+                    (0 == strncmp(acName, atPhases[i].acName, strlen(atPhases[i].acName))) :
+                    (0 == strcmp(acName, atPhases[i].acName));
+
+      if (bMatch)
+      {
+        pMachine->atSymbols[pMachine->uiSymbols].uiAddr = (uint16_t) uiAddr;
+        pMachine->atSymbols[pMachine->uiSymbols].ePhase = atPhases[i].ePhase;
+        ++pMachine->uiSymbols;
+        break;
+      }
+    }
+  }
+
+  fclose(hFile);
+
+  return pMachine->uiSymbols;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* runCase()                                                                  */
+/*----------------------------------------------------------------------------*/
+static int runCase(machine_t* pMachine, const char* acDot, const char* acDir, const char* acWork, const benchcase_t* pCase)
+{
+  static const char acArgs[] = "-f bench.bmp";
+  char      acPathName[ESX_PATHNAME_MAX];
+  z80n_t*   pCpu = &pMachine->tCpu;
+  uint8_t   uiMode;
+  uint8_t*  pData = 0;
+  uint8_t*  pRef;
+  uint32_t  uiSize;
+  uint32_t  uiRefSize;
+  uint16_t  uiAddr;
+  int       iReturn;
+
+  memset(&pMachine->tResult, 0, sizeof(pMachine->tResult));
+  pMachine->uiFrames  = 0;
+  pMachine->uiNextReg = 0;
+
+  /* Emulated Next in the state of the fixture; MMU0/1: DivMMC with the dot */
+  zxnReset();
+  snprintf(acPathName, sizeof(acPathName), "%s/%s.nvs", acDir, pCase->acName);
+
+  if (EOK != (iReturn = zxnLoadState(acPathName, &uiMode)))
+  {
+    fprintf(stderr, "%s: %s\n", acPathName, strerror(iReturn));
+    return iReturn;
+  }
+
+  snprintf(acPathName, sizeof(acPathName), "%s/%s.bmp", acDir, pCase->acName);
+
+  if (0 == (pRef = readFile(acPathName, &uiRefSize)))
+  {
+    return EBADF;
+  }
+
+  g_tZxn.uiMode = uiMode;
+  ZXN_WRITE_REG(0x50, 0xFF);
+  ZXN_WRITE_REG(0x51, 0xFF);
+
+  if (INV_FILE_HND == (pMachine->hDot = esx_f_open(acDot, ESXDOS_MODE_R | ESXDOS_MODE_OE)))
+  {
+    fprintf(stderr, "%s: %s\n", acDot, strerror(errno));
+    free(pRef);
+    return EBADF;
+  }
+
+  if (0 == esx_f_read(pMachine->hDot, g_tZxn.pAddress + DOT_ADDR, DOT_SIZE))
+  {
+    fprintf(stderr, "%s: read error\n", acDot);
+    (void) esx_f_close(pMachine->hDot);
+    free(pRef);
+    return EBADF;
+  }
+
+  /* Command line ".scrnshot <args>" (BC), arguments (HL), terminated by CR */
+  uiAddr = CMDLINE_ADDR;
+  snprintf((char*) g_tZxn.pAddress + uiAddr, 64, "scrnshot %s\r", acArgs);
+
+  z80nReset(pCpu);
+  pCpu->pMemory    = g_tZxn.pAddress;
+  pCpu->pMachine   = pMachine;
+  pCpu->fnWritable = isWritable;
+  pCpu->fnIn       = readPort;
+  pCpu->fnOut      = writePort;
+  pCpu->fnNextReg  = writeNextReg;
+  pCpu->fnRst      = callRestart;
+
+  pCpu->auiReg[Z80N_B] = (uint8_t) (uiAddr >> 8);
+  pCpu->auiReg[Z80N_C] = (uint8_t) uiAddr;
+  uiAddr += strlen("scrnshot ");
+  pCpu->auiReg[Z80N_H] = (uint8_t) (uiAddr >> 8);
+  pCpu->auiReg[Z80N_L] = (uint8_t) uiAddr;
+  pCpu->uiIY = 0x5C3A;  /* system variables (ERR_NR) */
+  pCpu->uiSP = STACK_ADDR - 2;
+  pCpu->uiPC = DOT_ADDR;
+  pCpu->pMemory[pCpu->uiSP]     = (uint8_t) EXIT_ADDR;
+  pCpu->pMemory[pCpu->uiSP + 1] = (uint8_t) (EXIT_ADDR >> 8);
+
+  if (0 != chdir(acWork))
+  {
+    perror(acWork);
+    (void) esx_f_close(pMachine->hDot);
+    free(pRef);
+    return EACCES;
+  }
+
+  iReturn = runDot(pMachine, TSTATES_MAX);
+
+  (void) esx_f_close(pMachine->hDot);
+
+  /* Image of the dot command: must be identical to the reference */
+  if ((EOK == iReturn) && (0 == (pData = readFile("bench.bmp", &uiSize))))
+  {
+    iReturn = EBADF;
+  }
+  else if (EOK == iReturn)
+  {
+    if ((uiSize != uiRefSize) || (0 != memcmp(pData, pRef, uiSize)))
+    {
+      fprintf(stderr, "%s: image differs from the reference\n", pCase->acName);
+      iReturn = ERANGE;
+    }
+
+    free(pData);
+  }
+
+  (void) unlink("bench.bmp");
+  free(pRef);
+
+  return iReturn;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* runDot()                                                                   */
+/*----------------------------------------------------------------------------*/
+static int runDot(machine_t* pMachine, uint64_t uiLimit)
+{
+  z80n_t*   pCpu    = &pMachine->tCpu;
+  result_t* pResult = &pMachine->tResult;
+
+  while (EXIT_ADDR != pCpu->uiPC)
+  {
+    uint8_t uiT;
+
+    /* Left functions (RET: SP above the return address) */
+    while ((0 < pMachine->uiFrames) && (pCpu->uiSP > pMachine->atFrames[pMachine->uiFrames - 1].uiSP))
+    {
+      --pMachine->uiFrames;
+    }
+
+    for (uint8_t i = 0; i < pMachine->uiSymbols; ++i)
+    {
+      if ((pMachine->atSymbols[i].uiAddr == pCpu->uiPC) && (FRAMES_MAX > pMachine->uiFrames))
+      {
+        pMachine->atFrames[pMachine->uiFrames].uiSP   = pCpu->uiSP;
+        pMachine->atFrames[pMachine->uiFrames].ePhase = pMachine->atSymbols[i].ePhase;
+        ++pMachine->uiFrames;
+        break;
+      }
+    }
+
+    uiT = z80nStep(pCpu);
+
+    pResult->auiPhases[(0 < pMachine->uiFrames) ? pMachine->atFrames[pMachine->uiFrames - 1].ePhase : PHASE_OTHER] += uiT;
+
+    if (pCpu->bHalted)
+    {
+      fprintf(stderr, "HALT at 0x%04X (no interrupts)\n", pCpu->uiPC);
+      return EINVAL;
+    }
+
+    if (uiLimit < pCpu->uiTStates)
+    {
+      fprintf(stderr, "no exit after %llu T-states (PC 0x%04X)\n", (unsigned long long) uiLimit, pCpu->uiPC);
+      return ERANGE;
+    }
+  }
+
+  pResult->uiTotal = pCpu->uiTStates;
+
+  /* Exit of a dot command: carry set = error (A = code; 0 = message at HL) */
+  if (pCpu->uiF & Z80N_FLAG_C)
+  {
+    if (0 != pCpu->auiReg[Z80N_A])
+    {
+      fprintf(stderr, "dot command: error %u\n", pCpu->auiReg[Z80N_A]);
+    }
+    else
+    {
+      uint16_t uiAddr = Z80N_HL(pCpu);
+      char     c;
+
+      fprintf(stderr, "dot command: ");
+
+      do
+      {
+        c = (char) pCpu->pMemory[uiAddr++];
+        fputc(c & 0x7F, stderr);
+      }
+      while ((0 == (c & 0x80)) && (0 != uiAddr));
+
+      fputc('\n', stderr);
+    }
+
+    return EINVAL;
+  }
+
+  return EOK;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* isWritable()                                                               */
+/*----------------------------------------------------------------------------*/
+static bool isWritable(z80n_t* pCpu, uint16_t uiAddr)
+{
+  (void) pCpu;
+
+  /* MMU0 with page 0xFF: ROM of the DivMMC; MMU1: RAM of the dot command */
+  return (0x2000 <= uiAddr) || (0xFF != g_tZxn.auiMmu[0]);
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* readPort()                                                                 */
+/*----------------------------------------------------------------------------*/
+static uint8_t readPort(z80n_t* pCpu, uint16_t uiPort)
+{
+  machine_t* pMachine = (machine_t*) pCpu->pMachine;
+
+  switch (uiPort)
+  {
+    case 0x243B:
+      return pMachine->uiNextReg;
+
+    case 0x253B:
+      return ZXN_READ_REG(pMachine->uiNextReg);
+
+    default:
+      /* Timex port: decoded by the lower 8 bit */
+      return z80_inp((0xFF == (uiPort & 0xFF)) ? 0x00FF : uiPort);
+  }
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* writePort()                                                                */
+/*----------------------------------------------------------------------------*/
+static void writePort(z80n_t* pCpu, uint16_t uiPort, uint8_t uiValue)
+{
+  machine_t* pMachine = (machine_t*) pCpu->pMachine;
+
+  switch (uiPort)
+  {
+    case 0x243B:
+      pMachine->uiNextReg = uiValue;
+      break;
+
+    case 0x253B:
+      ZXN_WRITE_REG(pMachine->uiNextReg, uiValue);
+      break;
+
+    default:
+      z80_outp((0xFF == (uiPort & 0xFF)) ? 0x00FF : uiPort, uiValue);
+  }
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* writeNextReg()                                                             */
+/*----------------------------------------------------------------------------*/
+static void writeNextReg(z80n_t* pCpu, uint8_t uiReg, uint8_t uiValue)
+{
+  (void) pCpu;
+
+  ZXN_WRITE_REG(uiReg, uiValue);
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* callRestart()                                                              */
+/*----------------------------------------------------------------------------*/
+static bool callRestart(z80n_t* pCpu, uint8_t uiAddr)
+{
+  machine_t* pMachine = (machine_t*) pCpu->pMachine;
+
+  switch (uiAddr)
+  {
+    case 0x08: /* RST 8; DEFB function */
+      pCpu->uiPC += 2;
+      callEsxdos(pMachine, pCpu->pMemory[(uint16_t) (pCpu->uiPC - 1)]);
+      return true;
+
+    case 0x10: /* RST 0x10: print A */
+      pCpu->uiPC += 1;
+
+      if (pMachine->bVerbose)
+      {
+        putchar(('\r' == pCpu->auiReg[Z80N_A]) ? '\n' : pCpu->auiReg[Z80N_A]);
+      }
+      return true;
+
+    case 0x18: /* RST 0x18; DEFW address: call of the ROM */
+      pCpu->uiPC += 3;
+      fprintf(stderr, "RST 0x18 to 0x%04X ignored\n", pCpu->pMemory[(uint16_t) (pCpu->uiPC - 2)] | (pCpu->pMemory[(uint16_t) (pCpu->uiPC - 1)] << 8));
+      return true;
+
+    case 0x00: /* Reset: end of the run */
+      return false;
+
+    default:
+      pCpu->uiPC += 1;
+      fprintf(stderr, "RST 0x%02X ignored\n", uiAddr);
+      return true;
+  }
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* callEsxdos()                                                               */
+/*----------------------------------------------------------------------------*/
+static void callEsxdos(machine_t* pMachine, uint8_t uiFunction)
+{
+  z80n_t*  pCpu = &pMachine->tCpu;
+  char     acPathName[ESX_PATHNAME_MAX];
+  uint8_t  hFile = pCpu->auiReg[Z80N_A];
+  uint16_t uiHL  = Z80N_HL(pCpu);
+  uint16_t uiLen = Z80N_BC(pCpu);
+  uint32_t uiPos;
+
+  /* Buffers end at the top of the address space */
+  if ((0x10000 - uiHL) < uiLen)
+  {
+    uiLen = (uint16_t) (0x10000 - uiHL);
+  }
+
+  switch (uiFunction)
+  {
+    case M_DOSVERSION: /* BC = "NX", DE = version, A = 0: NextZXOS mode */
+      pCpu->auiReg[Z80N_B] = 'N';
+      pCpu->auiReg[Z80N_C] = 'X';
+      pCpu->auiReg[Z80N_D] = (uint8_t) (esx_m_dosversion() >> 8);
+      pCpu->auiReg[Z80N_E] = (uint8_t) esx_m_dosversion();
+      pCpu->auiReg[Z80N_A] = 0;
+      pCpu->uiF = Z80N_FLAG_Z;
+      return;
+
+    case M_GETSETDRV: /* drive C: */
+      pCpu->auiReg[Z80N_A] = (2 << 3) | 0x01;
+      setEsxResult(pCpu, EOK);
+      return;
+
+    case M_GETHANDLE: /* dot command, positioned after the first 8K */
+      pCpu->auiReg[Z80N_A] = pMachine->hDot;
+      setEsxResult(pCpu, EOK);
+      return;
+
+    case M_GETDATE:
+    {
+      struct dos_tm tTime;
+
+      (void) esx_m_getdate(&tTime);
+      pCpu->auiReg[Z80N_B] = (uint8_t) (tTime.date >> 8);
+      pCpu->auiReg[Z80N_C] = (uint8_t) tTime.date;
+      pCpu->auiReg[Z80N_D] = (uint8_t) (tTime.time >> 8);
+      pCpu->auiReg[Z80N_E] = (uint8_t) tTime.time;
+      setEsxResult(pCpu, EOK);
+      return;
+    }
+
+    case M_P3DOS:
+      callP3dos(pMachine);
+      return;
+
+    case M_ERRH:
+    case F_SYNC:
+      setEsxResult(pCpu, EOK);
+      return;
+
+    case F_OPEN: /* A = drive, HL = name, B = mode; A = handle */
+      getString(pCpu, uiHL, acPathName, sizeof(acPathName));
+      hFile = esx_f_open(acPathName, pCpu->auiReg[Z80N_B]);
+
+      if (INV_FILE_HND == hFile)
+      {
+        setEsxResult(pCpu, ESXERR_ENOENT);
+        return;
+      }
+
+      pCpu->auiReg[Z80N_A] = hFile;
+      setEsxResult(pCpu, EOK);
+      return;
+
+    case F_CLOSE:
+      setEsxResult(pCpu, (hFile == pMachine->hDot) || (EOK == esx_f_close(hFile)) ? EOK : ESXERR_EBADF);
+      return;
+
+    case F_READ: /* A = handle, HL = buffer, BC = length; BC = bytes read */
+    case F_WRITE:
+      if (F_READ == uiFunction)
+      {
+        uiLen = esx_f_read(hFile, pCpu->pMemory + uiHL, uiLen);
+      }
+      else
+      {
+        uiLen = esx_f_write(hFile, pCpu->pMemory + uiHL, uiLen);
+        pMachine->tResult.uiWrites += 1;
+        pMachine->tResult.uiBytes  += uiLen;
+      }
+
+      pCpu->auiReg[Z80N_B] = (uint8_t) (uiLen >> 8);
+      pCpu->auiReg[Z80N_C] = (uint8_t) uiLen;
+      setEsxResult(pCpu, EOK);
+      return;
+
+    case F_SEEK: /* A = handle, BCDE = offset, L = whence; BCDE = position */
+    case F_FGETPOS:
+      if (F_SEEK == uiFunction)
+      {
+        uiPos = ((uint32_t) Z80N_BC(pCpu) << 16) | Z80N_DE(pCpu);
+        uiPos = esx_f_seek(hFile, uiPos, pCpu->auiReg[Z80N_L]);
+      }
+      else
+      {
+        uiPos = esx_f_fgetpos(hFile);
+      }
+
+      if (0xFFFFFFFF == uiPos)
+      {
+        setEsxResult(pCpu, ESXERR_EIO);
+        return;
+      }
+
+      pCpu->auiReg[Z80N_B] = (uint8_t) (uiPos >> 24);
+      pCpu->auiReg[Z80N_C] = (uint8_t) (uiPos >> 16);
+      pCpu->auiReg[Z80N_D] = (uint8_t) (uiPos >> 8);
+      pCpu->auiReg[Z80N_E] = (uint8_t) uiPos;
+      setEsxResult(pCpu, EOK);
+      return;
+
+    case F_GETCWD: /* A = drive, HL = buffer; the work directory is the root */
+      pCpu->pMemory[uiHL]                  = '/';
+      pCpu->pMemory[(uint16_t) (uiHL + 1)] = 0;
+      setEsxResult(pCpu, EOK);
+      return;
+
+    case F_STAT: /* A = drive, HL = name, DE = buffer (11 bytes) */
+    {
+      struct stat tStat;
+
+      getString(pCpu, uiHL, acPathName, sizeof(acPathName));
+
+      if (0 != stat(acPathName, &tStat))
+      {
+        setEsxResult(pCpu, ESXERR_ENOENT);
+        return;
+      }
+
+      for (uint8_t i = 0; i < 11; ++i)
+      {
+        /* drive, device, attributes, date/time (not set), size */
+        pCpu->pMemory[(uint16_t) (Z80N_DE(pCpu) + i)] = (7 <= i) ? (uint8_t) (tStat.st_size >> ((i - 7) << 3)) :
+                                                        (2 == i) ? (S_ISDIR(tStat.st_mode) ? 0x10 : 0x00) : 0;
+      }
+
+      setEsxResult(pCpu, EOK);
+      return;
+    }
+
+    case F_UNLINK: /* A = drive, HL = name */
+      getString(pCpu, uiHL, acPathName, sizeof(acPathName));
+      setEsxResult(pCpu, (EOK == esx_f_unlink(acPathName)) ? EOK : ESXERR_ENOENT);
+      return;
+
+    default:
+      fprintf(stderr, "RST 8: function 0x%02X not supported\n", uiFunction);
+      setEsxResult(pCpu, ESXERR_ENOSYS);
+      return;
+  }
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* callP3dos()                                                                */
+/*----------------------------------------------------------------------------*/
+static void callP3dos(machine_t* pMachine)
+{
+  z80n_t* pCpu = &pMachine->tCpu;
+  uint8_t uiPage;
+
+  /* DE = call, parameters in the alternate registers; carry set = success */
+  switch (Z80N_DE(pCpu))
+  {
+    case IDE_BANK: /* H' = type (0: RAM), L' = reason (1: allocate, 3: free), E' = page */
+      if (1 == pCpu->auiAlt[Z80N_L])
+      {
+        if (0xFF == (uiPage = esx_ide_bank_alloc(pCpu->auiAlt[Z80N_H])))
+        {
+          pCpu->auiReg[Z80N_A] = ESXERR_ENOSYS;
+          pCpu->uiF = 0;
+          return;
+        }
+
+        pCpu->auiReg[Z80N_E] = uiPage;
+      }
+      else if (3 == pCpu->auiAlt[Z80N_L])
+      {
+        (void) esx_ide_bank_free(pCpu->auiAlt[Z80N_H], pCpu->auiAlt[Z80N_E]);
+      }
+
+      pCpu->uiF = Z80N_FLAG_C;
+      return;
+
+    case IDE_MODE: /* A = mode: layer (bits 3-2) and submode (bits 1-0) */
+    {
+      struct esx_mode tMode;
+
+      (void) esx_ide_mode_get(&tMode);
+      pCpu->auiReg[Z80N_A] = (uint8_t) ((tMode.mode8.layer << 2) | (tMode.mode8.submode & 0x03));
+      pCpu->auiReg[Z80N_B] = tMode.cols;
+      pCpu->auiReg[Z80N_C] = tMode.rows;
+      pCpu->uiF = Z80N_FLAG_C;
+      return;
+    }
+
+    default:
+      fprintf(stderr, "M_P3DOS: call 0x%04X not supported\n", Z80N_DE(pCpu));
+      pCpu->auiReg[Z80N_A] = ESXERR_ENOSYS;
+      pCpu->uiF = 0;
+      return;
+  }
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* setEsxResult()                                                             */
+/*----------------------------------------------------------------------------*/
+static void setEsxResult(z80n_t* pCpu, uint8_t uiError)
+{
+  if (EOK == uiError)
+  {
+    pCpu->uiF &= ~Z80N_FLAG_C;
+  }
+  else
+  {
+    pCpu->auiReg[Z80N_A] = uiError;
+    pCpu->uiF |= Z80N_FLAG_C;
+  }
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* getString()                                                                */
+/*----------------------------------------------------------------------------*/
+static void getString(z80n_t* pCpu, uint16_t uiAddr, char* acBuffer, size_t uiSize)
+{
+  size_t i = 0;
+
+  while (((i + 1) < uiSize) && (0 != pCpu->pMemory[uiAddr]))
+  {
+    acBuffer[i++] = (char) pCpu->pMemory[uiAddr++];
+  }
+
+  acBuffer[i] = 0;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* readBaseline()                                                             */
+/*----------------------------------------------------------------------------*/
+static int readBaseline(const char* acPathName, result_t* pResults, bool* pValid)
+{
+  FILE* hFile;
+  char  acLine[256];
+
+  if (0 == (hFile = fopen(acPathName, "r")))
+  {
+    fprintf(stderr, "%s: %s\n", acPathName, strerror(errno));
+    return EBADF;
+  }
+
+  memset(pValid, 0, CASES_COUNT * sizeof(bool));
+
+  while (0 != fgets(acLine, sizeof(acLine), hFile))
+  {
+    char               acLabel[16];
+    unsigned long long auiValues[PHASE_COUNT + 1];
+
+    if (('#' == acLine[0]) ||
+        (7 != sscanf(acLine, "%15s %llu %llu %llu %llu %llu %llu", acLabel,
+                     &auiValues[PHASE_HEADER], &auiValues[PHASE_PALETTE], &auiValues[PHASE_DECODE],
+                     &auiValues[PHASE_WRITE], &auiValues[PHASE_OTHER], &auiValues[PHASE_COUNT])))
+    {
+      continue;
+    }
+
+    for (uint8_t i = 0; i < CASES_COUNT; ++i)
+    {
+      if (0 == strcmp(acLabel, s_atCases[i].acLabel))
+      {
+        for (uint8_t uiPhase = 0; uiPhase < PHASE_COUNT; ++uiPhase)
+        {
+          pResults[i].auiPhases[uiPhase] = auiValues[uiPhase];
+        }
+
+        pResults[i].uiTotal = auiValues[PHASE_COUNT];
+        pValid[i] = true;
+      }
+    }
+  }
+
+  fclose(hFile);
+
+  return EOK;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* writeBaseline()                                                            */
+/*----------------------------------------------------------------------------*/
+static int writeBaseline(const char* acPathName, const result_t* pResults)
+{
+  FILE* hFile;
+
+  if (0 == (hFile = fopen(acPathName, "w")))
+  {
+    fprintf(stderr, "%s: %s\n", acPathName, strerror(errno));
+    return EBADF;
+  }
+
+  fprintf(hFile, "# T-states of the dot command (z80bench): mode header palette decode write other total\n");
+
+  for (uint8_t i = 0; i < CASES_COUNT; ++i)
+  {
+    fprintf(hFile, "%s %llu %llu %llu %llu %llu %llu\n", s_atCases[i].acLabel,
+            (unsigned long long) pResults[i].auiPhases[PHASE_HEADER],
+            (unsigned long long) pResults[i].auiPhases[PHASE_PALETTE],
+            (unsigned long long) pResults[i].auiPhases[PHASE_DECODE],
+            (unsigned long long) pResults[i].auiPhases[PHASE_WRITE],
+            (unsigned long long) pResults[i].auiPhases[PHASE_OTHER],
+            (unsigned long long) pResults[i].uiTotal);
+  }
+
+  fclose(hFile);
+
+  return EOK;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* getCodeSize()                                                              */
+/*----------------------------------------------------------------------------*/
+static uint32_t getCodeSize(const char* acMap, const char* acSymbol)
+{
+  FILE*    hFile;
+  char     acLine[512];
+  bool     bFound = false;
+  unsigned uiStart = 0;
+  unsigned uiNext  = 0x10000;
+
+  if (0 == (hFile = fopen(acMap, "r")))
+  {
+    return 0;
+  }
+
+  /* First pass: address of the symbol, second pass: next address above it */
+  for (uint8_t uiPass = 0; uiPass < 2; ++uiPass)
+  {
+    rewind(hFile);
+
+    while (0 != fgets(acLine, sizeof(acLine), hFile))
+    {
+      char     acName[128];
+      unsigned uiAddr;
+
+      if (2 != sscanf(acLine, "%127s = $%x", acName, &uiAddr))
+      {
+        continue;
+      }
+
+      if ((0 == uiPass) && (0 == strcmp(acName, acSymbol)))
+      {
+        uiStart = uiAddr;
+        bFound  = true;
+        break;
+      }
+      else if ((1 == uiPass) && (uiAddr > uiStart) && (uiAddr < uiNext))
+      {
+        uiNext = uiAddr;
+      }
+    }
+
+    if (!bFound)
+    {
+      break;
+    }
+  }
+
+  fclose(hFile);
+
+  return (bFound && (0x10000 != uiNext)) ? (uint32_t) (uiNext - uiStart) : 0;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* writeVariant()                                                             */
+/*----------------------------------------------------------------------------*/
+static int writeVariant(const char* acPathName, const char* acKey, const result_t* pResults, const bool* pValid)
+{
+  FILE* hFile;
+
+  if (0 == (hFile = fopen(acPathName, "a")))
+  {
+    fprintf(stderr, "%s: %s\n", acPathName, strerror(errno));
+    return EBADF;
+  }
+
+  for (uint8_t i = 0; i < CASES_COUNT; ++i)
+  {
+    if (pValid[i])
+    {
+      fprintf(hFile, "%s %s %llu %u\n", acKey, s_atCases[i].acLabel,
+              (unsigned long long) pResults[i].auiPhases[PHASE_DECODE],
+              pResults[i].uiCodeSize);
+    }
+  }
+
+  fclose(hFile);
+
+  return EOK;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* selectVariants()                                                           */
+/*----------------------------------------------------------------------------*/
+static int selectVariants(const char* acPathName)
+{
+  int iReturn = EOK;
+
+  printf("# pixel address strategies (z80bench -s %s): decode T-states, code size\n", acPathName);
+
+  for (uint8_t uiPath = 0; uiPath < (sizeof(s_acPaths) / sizeof(s_acPaths[0])); ++uiPath)
+  {
+    variant_t atVariants[VARIANTS_MAX];
+    uint8_t   uiVariants = 0;
+    uint8_t   uiModes    = 0;
+    int       iBest      = -1;
+    FILE*     hFile;
+    char      acLine[256];
+
+    if (0 == (hFile = fopen(acPathName, "r")))
+    {
+      fprintf(stderr, "%s: %s\n", acPathName, strerror(errno));
+      return EBADF;
+    }
+
+    for (uint8_t i = 0; i < CASES_COUNT; ++i)
+    {
+      uiModes += ((0 != s_atCases[i].acPath) && (0 == strcmp(s_atCases[i].acPath, s_acPaths[uiPath]))) ? 1 : 0;
+    }
+
+    /* Sum of the modes of the path per variant */
+    while (0 != fgets(acLine, sizeof(acLine), hFile))
+    {
+      char               acKey[16];
+      char               acLabel[16];
+      unsigned long long uiDecode;
+      unsigned           uiSize;
+      uint8_t            uiVariant;
+
+      if (('#' == acLine[0]) || (4 != sscanf(acLine, "%15s %15s %llu %u", acKey, acLabel, &uiDecode, &uiSize)))
+      {
+        continue;
+      }
+
+      for (uint8_t i = 0; i < CASES_COUNT; ++i)
+      {
+        if ((0 == strcmp(acLabel, s_atCases[i].acLabel)) &&
+            (0 != s_atCases[i].acPath) && (0 == strcmp(s_atCases[i].acPath, s_acPaths[uiPath])))
+        {
+          for (uiVariant = 0; (uiVariant < uiVariants) && (0 != strcmp(atVariants[uiVariant].acKey, acKey)); ++uiVariant)
+          {
+          }
+
+          if ((uiVariant == uiVariants) && (VARIANTS_MAX > uiVariants))
+          {
+            memset(&atVariants[uiVariant], 0, sizeof(atVariants[uiVariant]));
+            snprintf(atVariants[uiVariant].acKey, sizeof(atVariants[uiVariant].acKey), "%s", acKey);
+            ++uiVariants;
+          }
+
+          if (uiVariant < uiVariants)
+          {
+            atVariants[uiVariant].uiDecode   += uiDecode;
+            atVariants[uiVariant].uiCodeSize += uiSize;
+            ++atVariants[uiVariant].uiModes;
+          }
+        }
+      }
+    }
+
+    fclose(hFile);
+
+    /* Fastest variant with results of all modes of the path; ties: smaller code */
+    for (uint8_t i = 0; i < uiVariants; ++i)
+    {
+      const variant_t* p = &atVariants[i];
+
+      printf("# %-8s %-4s %12llu T %6u bytes%s\n", s_acPaths[uiPath], p->acKey,
+             (unsigned long long) p->uiDecode, p->uiCodeSize, (uiModes == p->uiModes) ? "" : "  (incomplete)");
+
+      if ((uiModes == p->uiModes) &&
+          ((0 > iBest) ||
+           (p->uiDecode < atVariants[iBest].uiDecode) ||
+           ((p->uiDecode == atVariants[iBest].uiDecode) && (p->uiCodeSize < atVariants[iBest].uiCodeSize))))
+      {
+        iBest = i;
+      }
+    }
+
+    if (0 <= iBest)
+    {
+      printf("PIXEL_CALC_%s := %s\n", s_acPaths[uiPath], atVariants[iBest].acKey);
+    }
+    else
+    {
+      fprintf(stderr, "%s: no complete results of the path %s\n", acPathName, s_acPaths[uiPath]);
+      iReturn = ERANGE;
+    }
+  }
+
+  return iReturn;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* readFile()                                                                 */
+/*----------------------------------------------------------------------------*/
+static uint8_t* readFile(const char* acPathName, uint32_t* pSize)
+{
+  FILE*    hFile;
+  uint8_t* pData = 0;
+  long     iSize;
+
+  if (0 == (hFile = fopen(acPathName, "rb")))
+  {
+    fprintf(stderr, "%s: %s\n", acPathName, strerror(errno));
+    return 0;
+  }
+
+  if ((0 == fseek(hFile, 0, SEEK_END)) && (0 <= (iSize = ftell(hFile))) && (0 == fseek(hFile, 0, SEEK_SET)) &&
+      (0 != (pData = malloc(iSize + 1))))
+  {
+    if (((size_t) iSize) != fread(pData, 1, iSize, hFile))
+    {
+      free(pData);
+      pData = 0;
+    }
+    else
+    {
+      *pSize = (uint32_t) iSize;
+    }
+  }
+
+  if (0 == pData)
+  {
+    fprintf(stderr, "%s: read error\n", acPathName);
+  }
+
+  fclose(hFile);
+
+  return pData;
+}
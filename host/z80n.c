@@ -0,0 +1,1413 @@
+/*-----------------------------------------------------------------------------+
+|                                                                              |
+| filename: z80n.c                                                             |
+| project:  zxn::scrnshot                                                      |
+| author:   S. Zell                                                            |
+| date:     10/18/2026                                                         |
+|                                                                              |
++------------------------------------------------------------------------------+
+|                                                                              |
+| description:                                                                 |
+|                                                                              |
+| Host: Z80N CPU core (Z80 with the extended instructions of the ZX Spectrum   |
+| Next) with the T-states of every instruction, for the benchmark of the dot   |
+| command                                                                      |
+|                                                                              |
++------------------------------------------------------------------------------+
+|                                                                              |
+| Copyright (c) 10/18/2026 STZ Engineering                                     |
+|                                                                              |
+| This software is provided  "as is",  without warranty of any kind, express   |
+| or implied. In no event shall STZ or its contributors be held liable for any |
+| direct, indirect, incidental, special or consequential damages arising out   |
+| of the use of or inability to use this software.                             |
+|                                                                              |
+| Permission is granted to anyone  to use this  software for any purpose,      |
+| including commercial applications,  and to alter it and redistribute it      |
+| freely, subject to the following restrictions:                               |
+|                                                                              |
+| 1. Redistributions of source code must retain the above copyright            |
+|    notice, definition, disclaimer, and this list of conditions.              |
+|                                                                              |
+| 2. Redistributions in binary form must reproduce the above copyright         |
+|    notice, definition, disclaimer, and this list of conditions in            |
+|    documentation and/or other materials provided with the distribution.      |
+|                                                                          ;-) |
++-----------------------------------------------------------------------------*/
+
+/*============================================================================*/
+/*                               Includes                                     */
+/*============================================================================*/
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "z80n.h"
+
+/*============================================================================*/
+/*                               Defines                                      */
+/*============================================================================*/
+/*!
+Operand "(HL)" in the encoding of the 8 bit registers
+*/
+#define Z80N_MEM 6
+
+/*!
+Index register of a DD/FD prefix: none (HL), IX, IY
+*/
+#define IDX_HL 0
+#define IDX_IX 1
+#define IDX_IY 2
+
+/*!
+Flags of a result: sign, zero and the undocumented bits 3 and 5
+*/
+#define FLAGS_SZXY(v) (s_auiSZ[(uint8_t) (v)])
+
+/*============================================================================*/
+/*                               Variables                                    */
+/*============================================================================*/
+/*!
+Flags S, Z, X, Y (and P/V = parity) of all 8 bit values
+*/
+static uint8_t s_auiSZ[256];
+static uint8_t s_auiSZP[256];
+static bool    s_bTables = false;
+
+/*============================================================================*/
+/*                               Prototypes                                   */
+/*============================================================================*/
+/*!
+Memory access (writes to read only memory are ignored)
+*/
+static uint8_t  readByte(z80n_t* pCpu, uint16_t uiAddr);
+static void     writeByte(z80n_t* pCpu, uint16_t uiAddr, uint8_t uiValue);
+static uint16_t readWord(z80n_t* pCpu, uint16_t uiAddr);
+static void     writeWord(z80n_t* pCpu, uint16_t uiAddr, uint16_t uiValue);
+static uint8_t  fetchByte(z80n_t* pCpu);
+static uint16_t fetchWord(z80n_t* pCpu);
+static void     pushWord(z80n_t* pCpu, uint16_t uiValue);
+static uint16_t popWord(z80n_t* pCpu);
+
+/*!
+Registers: 8 bit (H/L replaced by IXH/IXL, IYH/IYL), pairs (0 = BC, 1 = DE,
+2 = HL/IX/IY, 3 = SP; "bAF": 3 = AF)
+*/
+static uint8_t  getReg(z80n_t* pCpu, uint8_t r, uint8_t uiIdx);
+static void     setReg(z80n_t* pCpu, uint8_t r, uint8_t uiIdx, uint8_t uiValue);
+static uint16_t getPair(z80n_t* pCpu, uint8_t p, uint8_t uiIdx, bool bAF);
+static void     setPair(z80n_t* pCpu, uint8_t p, uint8_t uiIdx, bool bAF, uint16_t uiValue);
+
+/*!
+Address of the operand "(HL)" or "(IX+d)"; the displacement is fetched
+*/
+static uint16_t getMemAddr(z80n_t* pCpu, uint8_t uiIdx);
+
+/*!
+Condition "cc" (NZ, Z, NC, C, PO, PE, P, M)
+*/
+static bool     testCondition(z80n_t* pCpu, uint8_t cc);
+
+/*!
+Arithmetic and logic
+*/
+static void     aluOp(z80n_t* pCpu, uint8_t uiOp, uint8_t uiValue);
+static uint8_t  incByte(z80n_t* pCpu, uint8_t uiValue);
+static uint8_t  decByte(z80n_t* pCpu, uint8_t uiValue);
+static uint8_t  rotOp(z80n_t* pCpu, uint8_t uiOp, uint8_t uiValue);
+static uint16_t addWord(z80n_t* pCpu, uint16_t uiValue1, uint16_t uiValue2);
+static uint16_t adcWord(z80n_t* pCpu, uint16_t uiValue1, uint16_t uiValue2, bool bSub);
+static void     daa(z80n_t* pCpu);
+
+/*!
+Instructions without prefix (or DD/FD), with CB, DD/FD CB and ED prefix
+@return T-states (without the DD/FD prefix)
+*/
+static uint8_t  execMain(z80n_t* pCpu, uint8_t uiOp, uint8_t uiIdx);
+static uint8_t  execCB(z80n_t* pCpu, uint8_t uiIdx);
+static uint8_t  execED(z80n_t* pCpu);
+
+/*!
+Block instructions (LDI, CPI, INI, OUTI and the Z80N variants)
+@return "true" = repeated instruction is not finished
+*/
+static bool     execBlock(z80n_t* pCpu, uint8_t uiOp);
+
+/*============================================================================*/
+/*                               Implementation                               */
+/*============================================================================*/
+
+/*----------------------------------------------------------------------------*/
+/* z80nReset()                                                                */
+/*----------------------------------------------------------------------------*/
+void z80nReset(z80n_t* pCpu)
+{
+  if (!s_bTables)
+  {
+    for (uint16_t i = 0; i < 256; ++i)
+    {
+      uint8_t uiParity = (uint8_t) i;
+
+      uiParity ^= uiParity >> 4;
+      uiParity ^= uiParity >> 2;
+      uiParity ^= uiParity >> 1;
+
+      s_auiSZ[i]  = (i & (Z80N_FLAG_S | Z80N_FLAG_X | Z80N_FLAG_Y)) | (0 == i ? Z80N_FLAG_Z : 0);
+      s_auiSZP[i] = s_auiSZ[i] | ((uiParity & 0x01) ? 0 : Z80N_FLAG_PV);
+    }
+
+    s_bTables = true;
+  }
+
+  memset(pCpu->auiReg, 0xFF, sizeof(pCpu->auiReg));
+  memset(pCpu->auiAlt, 0xFF, sizeof(pCpu->auiAlt));
+
+  pCpu->uiF       = 0xFF;
+  pCpu->uiAltF    = 0xFF;
+  pCpu->uiIX      = 0xFFFF;
+  pCpu->uiIY      = 0xFFFF;
+  pCpu->uiSP      = 0xFFFF;
+  pCpu->uiPC      = 0x0000;
+  pCpu->uiI       = 0;
+  pCpu->uiR       = 0;
+  pCpu->bIFF1     = false;
+  pCpu->bIFF2     = false;
+  pCpu->uiIM      = 0;
+  pCpu->bHalted   = false;
+  pCpu->uiTStates = 0;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* z80nStep()                                                                 */
+/*----------------------------------------------------------------------------*/
+uint8_t z80nStep(z80n_t* pCpu)
+{
+  uint8_t uiT   = 0;
+  uint8_t uiIdx = IDX_HL;
+  uint8_t uiOp;
+
+  /* Prefixes DD/FD: the last one counts, each one takes 4 T-states */
+  for (;;)
+  {
+    uiOp = fetchByte(pCpu);
+    pCpu->uiR = (pCpu->uiR & 0x80) | ((pCpu->uiR + 1) & 0x7F);
+
+    if (0xDD == uiOp)
+    {
+      uiIdx = IDX_IX;
+      uiT  += 4;
+    }
+    else if (0xFD == uiOp)
+    {
+      uiIdx = IDX_IY;
+      uiT  += 4;
+    }
+    else
+    {
+      break;
+    }
+  }
+
+  if (0xED == uiOp)
+  {
+    uiT += execED(pCpu); /* a DD/FD prefix is ignored */
+  }
+  else if (0xCB == uiOp)
+  {
+    uiT += execCB(pCpu, uiIdx);
+  }
+  else
+  {
+    uiT += execMain(pCpu, uiOp, uiIdx);
+  }
+
+  pCpu->uiTStates += uiT;
+
+  return uiT;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* readByte()                                                                 */
+/*----------------------------------------------------------------------------*/
+static uint8_t readByte(z80n_t* pCpu, uint16_t uiAddr)
+{
+  return pCpu->pMemory[uiAddr];
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* writeByte()                                                                */
+/*----------------------------------------------------------------------------*/
+static void writeByte(z80n_t* pCpu, uint16_t uiAddr, uint8_t uiValue)
+{
+  if ((0 == pCpu->fnWritable) || pCpu->fnWritable(pCpu, uiAddr))
+  {
+    pCpu->pMemory[uiAddr] = uiValue;
+  }
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* readWord()                                                                 */
+/*----------------------------------------------------------------------------*/
+static uint16_t readWord(z80n_t* pCpu, uint16_t uiAddr)
+{
+  return (uint16_t) (readByte(pCpu, uiAddr) | (readByte(pCpu, (uint16_t) (uiAddr + 1)) << 8));
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* writeWord()                                                                */
+/*----------------------------------------------------------------------------*/
+static void writeWord(z80n_t* pCpu, uint16_t uiAddr, uint16_t uiValue)
+{
+  writeByte(pCpu, uiAddr, (uint8_t) uiValue);
+  writeByte(pCpu, (uint16_t) (uiAddr + 1), (uint8_t) (uiValue >> 8));
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* fetchByte()                                                                */
+/*----------------------------------------------------------------------------*/
+static uint8_t fetchByte(z80n_t* pCpu)
+{
+  return readByte(pCpu, pCpu->uiPC++);
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* fetchWord()                                                                */
+/*----------------------------------------------------------------------------*/
+static uint16_t fetchWord(z80n_t* pCpu)
+{
+  uint16_t uiValue = readWord(pCpu, pCpu->uiPC);
+
+  pCpu->uiPC += 2;
+
+  return uiValue;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* pushWord()                                                                 */
+/*----------------------------------------------------------------------------*/
+static void pushWord(z80n_t* pCpu, uint16_t uiValue)
+{
+  pCpu->uiSP -= 2;
+  writeWord(pCpu, pCpu->uiSP, uiValue);
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* popWord()                                                                  */
+/*----------------------------------------------------------------------------*/
+static uint16_t popWord(z80n_t* pCpu)
+{
+  uint16_t uiValue = readWord(pCpu, pCpu->uiSP);
+
+  pCpu->uiSP += 2;
+
+  return uiValue;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* getReg()                                                                   */
+/*----------------------------------------------------------------------------*/
+static uint8_t getReg(z80n_t* pCpu, uint8_t r, uint8_t uiIdx)
+{
+  if ((IDX_HL != uiIdx) && ((Z80N_H == r) || (Z80N_L == r)))
+  {
+    uint16_t uiValue = (IDX_IX == uiIdx) ? pCpu->uiIX : pCpu->uiIY;
+
+    return (uint8_t) ((Z80N_H == r) ? (uiValue >> 8) : uiValue);
+  }
+
+  return pCpu->auiReg[r];
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* setReg()                                                                   */
+/*----------------------------------------------------------------------------*/
+static void setReg(z80n_t* pCpu, uint8_t r, uint8_t uiIdx, uint8_t uiValue)
+{
+  if ((IDX_HL != uiIdx) && ((Z80N_H == r) || (Z80N_L == r)))
+  {
+    uint16_t* pIdx = (IDX_IX == uiIdx) ? &pCpu->uiIX : &pCpu->uiIY;
+
+    *pIdx = (Z80N_H == r) ? ((*pIdx & 0x00FF) | (uiValue << 8)) : ((*pIdx & 0xFF00) | uiValue);
+  }
+  else
+  {
+    pCpu->auiReg[r] = uiValue;
+  }
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* getPair()                                                                  */
+/*----------------------------------------------------------------------------*/
+static uint16_t getPair(z80n_t* pCpu, uint8_t p, uint8_t uiIdx, bool bAF)
+{
+  switch (p)
+  {
+    case 0:  return Z80N_BC(pCpu);
+    case 1:  return Z80N_DE(pCpu);
+    case 2:  return (IDX_IX == uiIdx) ? pCpu->uiIX : ((IDX_IY == uiIdx) ? pCpu->uiIY : Z80N_HL(pCpu));
+    default: return bAF ? (uint16_t) ((pCpu->auiReg[Z80N_A] << 8) | pCpu->uiF) : pCpu->uiSP;
+  }
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* setPair()                                                                  */
+/*----------------------------------------------------------------------------*/
+static void setPair(z80n_t* pCpu, uint8_t p, uint8_t uiIdx, bool bAF, uint16_t uiValue)
+{
+  switch (p)
+  {
+    case 0:
+      pCpu->auiReg[Z80N_B] = (uint8_t) (uiValue >> 8);
+      pCpu->auiReg[Z80N_C] = (uint8_t) uiValue;
+      break;
+
+    case 1:
+      pCpu->auiReg[Z80N_D] = (uint8_t) (uiValue >> 8);
+      pCpu->auiReg[Z80N_E] = (uint8_t) uiValue;
+      break;
+
+    case 2:
+      if (IDX_IX == uiIdx)
+      {
+        pCpu->uiIX = uiValue;
+      }
+      else if (IDX_IY == uiIdx)
+      {
+        pCpu->uiIY = uiValue;
+      }
+      else
+      {
+        pCpu->auiReg[Z80N_H] = (uint8_t) (uiValue >> 8);
+        pCpu->auiReg[Z80N_L] = (uint8_t) uiValue;
+      }
+      break;
+
+    default:
+      if (bAF)
+      {
+        pCpu->auiReg[Z80N_A] = (uint8_t) (uiValue >> 8);
+        pCpu->uiF            = (uint8_t) uiValue;
+      }
+      else
+      {
+        pCpu->uiSP = uiValue;
+      }
+  }
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* getMemAddr()                                                               */
+/*----------------------------------------------------------------------------*/
+static uint16_t getMemAddr(z80n_t* pCpu, uint8_t uiIdx)
+{
+  if (IDX_HL == uiIdx)
+  {
+    return Z80N_HL(pCpu);
+  }
+
+  return (uint16_t) (((IDX_IX == uiIdx) ? pCpu->uiIX : pCpu->uiIY) + (int8_t) fetchByte(pCpu));
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* testCondition()                                                            */
+/*----------------------------------------------------------------------------*/
+static bool testCondition(z80n_t* pCpu, uint8_t cc)
+{
+  static const uint8_t auiFlag[4] = {Z80N_FLAG_Z, Z80N_FLAG_C, Z80N_FLAG_PV, Z80N_FLAG_S};
+  bool bSet = 0 != (pCpu->uiF & auiFlag[cc >> 1]);
+
+  return (cc & 0x01) ? bSet : !bSet;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* aluOp()                                                                    */
+/*----------------------------------------------------------------------------*/
+static void aluOp(z80n_t* pCpu, uint8_t uiOp, uint8_t uiValue)
+{
+  uint8_t  uiA = pCpu->auiReg[Z80N_A];
+  uint16_t uiResult;
+  uint8_t  uiCarry = pCpu->uiF & Z80N_FLAG_C;
+
+  switch (uiOp)
+  {
+    case 0: /* ADD */
+    case 1: /* ADC */
+      uiCarry  = (1 == uiOp) ? uiCarry : 0;
+      uiResult = uiA + uiValue + uiCarry;
+      pCpu->uiF = FLAGS_SZXY(uiResult)
+                | ((uiResult >> 8) & Z80N_FLAG_C)
+                | ((uiA ^ uiValue ^ uiResult) & Z80N_FLAG_H)
+                | ((((uiA ^ ~uiValue) & (uiA ^ uiResult)) & 0x80) ? Z80N_FLAG_PV : 0);
+      pCpu->auiReg[Z80N_A] = (uint8_t) uiResult;
+      break;
+
+    case 2: /* SUB */
+    case 3: /* SBC */
+    case 7: /* CP  */
+      uiCarry  = (3 == uiOp) ? uiCarry : 0;
+      uiResult = (uint16_t) (uiA - uiValue - uiCarry);
+      pCpu->uiF = (s_auiSZ[(uint8_t) uiResult] & ~(Z80N_FLAG_X | Z80N_FLAG_Y))
+                | Z80N_FLAG_N
+                | ((uiResult >> 8) & Z80N_FLAG_C)
+                | ((uiA ^ uiValue ^ uiResult) & Z80N_FLAG_H)
+                | ((((uiA ^ uiValue) & (uiA ^ uiResult)) & 0x80) ? Z80N_FLAG_PV : 0);
+
+      if (7 == uiOp)
+      {
+        pCpu->uiF |= uiValue & (Z80N_FLAG_X | Z80N_FLAG_Y); /* CP: bits 3/5 of the operand */
+      }
+      else
+      {
+        pCpu->uiF |= uiResult & (Z80N_FLAG_X | Z80N_FLAG_Y);
+        pCpu->auiReg[Z80N_A] = (uint8_t) uiResult;
+      }
+      break;
+
+    case 4: /* AND */
+      pCpu->auiReg[Z80N_A] = uiA & uiValue;
+      pCpu->uiF = s_auiSZP[pCpu->auiReg[Z80N_A]] | Z80N_FLAG_H;
+      break;
+
+    case 5: /* XOR */
+      pCpu->auiReg[Z80N_A] = uiA ^ uiValue;
+      pCpu->uiF = s_auiSZP[pCpu->auiReg[Z80N_A]];
+      break;
+
+    default: /* OR */
+      pCpu->auiReg[Z80N_A] = uiA | uiValue;
+      pCpu->uiF = s_auiSZP[pCpu->auiReg[Z80N_A]];
+  }
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* incByte()                                                                  */
+/*----------------------------------------------------------------------------*/
+static uint8_t incByte(z80n_t* pCpu, uint8_t uiValue)
+{
+  uint8_t uiResult = uiValue + 1;
+
+  pCpu->uiF = (pCpu->uiF & Z80N_FLAG_C)
+            | FLAGS_SZXY(uiResult)
+            | ((0x00 == (uiResult & 0x0F)) ? Z80N_FLAG_H : 0)
+            | ((0x80 == uiResult) ? Z80N_FLAG_PV : 0);
+
+  return uiResult;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* decByte()                                                                  */
+/*----------------------------------------------------------------------------*/
+static uint8_t decByte(z80n_t* pCpu, uint8_t uiValue)
+{
+  uint8_t uiResult = uiValue - 1;
+
+  pCpu->uiF = (pCpu->uiF & Z80N_FLAG_C)
+            | Z80N_FLAG_N
+            | FLAGS_SZXY(uiResult)
+            | ((0x0F == (uiResult & 0x0F)) ? Z80N_FLAG_H : 0)
+            | ((0x7F == uiResult) ? Z80N_FLAG_PV : 0);
+
+  return uiResult;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* rotOp()                                                                    */
+/*----------------------------------------------------------------------------*/
+static uint8_t rotOp(z80n_t* pCpu, uint8_t uiOp, uint8_t uiValue)
+{
+  uint8_t uiCarry = pCpu->uiF & Z80N_FLAG_C;
+  uint8_t uiResult;
+  uint8_t uiOut;
+
+  switch (uiOp)
+  {
+    case 0:  uiOut = uiValue >> 7;   uiResult = (uint8_t) ((uiValue << 1) | uiOut);          break; /* RLC */
+    case 1:  uiOut = uiValue & 0x01; uiResult = (uint8_t) ((uiValue >> 1) | (uiOut << 7));   break; /* RRC */
+    case 2:  uiOut = uiValue >> 7;   uiResult = (uint8_t) ((uiValue << 1) | uiCarry);        break; /* RL  */
+    case 3:  uiOut = uiValue & 0x01; uiResult = (uint8_t) ((uiValue >> 1) | (uiCarry << 7)); break; /* RR  */
+    case 4:  uiOut = uiValue >> 7;   uiResult = (uint8_t) (uiValue << 1);                    break; /* SLA */
+    case 5:  uiOut = uiValue & 0x01; uiResult = (uint8_t) ((uiValue >> 1) | (uiValue & 0x80)); break; /* SRA */
+    case 6:  uiOut = uiValue >> 7;   uiResult = (uint8_t) ((uiValue << 1) | 0x01);           break; /* SLL */
+    default: uiOut = uiValue & 0x01; uiResult = (uint8_t) (uiValue >> 1);                    break; /* SRL */
+  }
+
+  pCpu->uiF = s_auiSZP[uiResult] | uiOut;
+
+  return uiResult;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* addWord()                                                                  */
+/*----------------------------------------------------------------------------*/
+static uint16_t addWord(z80n_t* pCpu, uint16_t uiValue1, uint16_t uiValue2)
+{
+  uint32_t uiResult = (uint32_t) uiValue1 + uiValue2;
+
+  pCpu->uiF = (pCpu->uiF & (Z80N_FLAG_S | Z80N_FLAG_Z | Z80N_FLAG_PV))
+            | ((uiResult >> 16) & Z80N_FLAG_C)
+            | (((uiValue1 ^ uiValue2 ^ uiResult) >> 8) & Z80N_FLAG_H)
+            | ((uiResult >> 8) & (Z80N_FLAG_X | Z80N_FLAG_Y));
+
+  return (uint16_t) uiResult;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* adcWord()                                                                  */
+/*----------------------------------------------------------------------------*/
+static uint16_t adcWord(z80n_t* pCpu, uint16_t uiValue1, uint16_t uiValue2, bool bSub)
+{
+  uint32_t uiCarry = pCpu->uiF & Z80N_FLAG_C;
+  uint32_t uiResult;
+  bool     bOverflow;
+
+  if (bSub)
+  {
+    uiResult  = (uint32_t) uiValue1 - uiValue2 - uiCarry;
+    bOverflow = 0 != (((uiValue1 ^ uiValue2) & (uiValue1 ^ uiResult)) & 0x8000);
+  }
+  else
+  {
+    uiResult  = (uint32_t) uiValue1 + uiValue2 + uiCarry;
+    bOverflow = 0 != (((uiValue1 ^ ~uiValue2) & (uiValue1 ^ uiResult)) & 0x8000);
+  }
+
+  pCpu->uiF = ((uiResult >> 8) & (Z80N_FLAG_S | Z80N_FLAG_X | Z80N_FLAG_Y))
+            | ((0 == (uiResult & 0xFFFF)) ? Z80N_FLAG_Z : 0)
+            | (((uiValue1 ^ uiValue2 ^ uiResult) >> 8) & Z80N_FLAG_H)
+            | (bOverflow ? Z80N_FLAG_PV : 0)
+            | (bSub ? Z80N_FLAG_N : 0)
+            | ((uiResult >> 16) & Z80N_FLAG_C);
+
+  return (uint16_t) uiResult;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* daa()                                                                      */
+/*----------------------------------------------------------------------------*/
+static void daa(z80n_t* pCpu)
+{
+  uint8_t uiA      = pCpu->auiReg[Z80N_A];
+  uint8_t uiAdjust = 0;
+  uint8_t uiCarry  = pCpu->uiF & Z80N_FLAG_C;
+  uint8_t uiResult;
+
+  if ((pCpu->uiF & Z80N_FLAG_H) || (0x09 < (uiA & 0x0F)))
+  {
+    uiAdjust |= 0x06;
+  }
+
+  if (uiCarry || (0x99 < uiA))
+  {
+    uiAdjust |= 0x60;
+    uiCarry   = Z80N_FLAG_C;
+  }
+
+  uiResult = (pCpu->uiF & Z80N_FLAG_N) ? (uint8_t) (uiA - uiAdjust) : (uint8_t) (uiA + uiAdjust);
+
+  pCpu->uiF = s_auiSZP[uiResult]
+            | (pCpu->uiF & Z80N_FLAG_N)
+            | uiCarry
+            | ((uiA ^ uiResult) & Z80N_FLAG_H);
+  pCpu->auiReg[Z80N_A] = uiResult;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* execMain()                                                                 */
+/*----------------------------------------------------------------------------*/
+static uint8_t execMain(z80n_t* pCpu, uint8_t uiOp, uint8_t uiIdx)
+{
+  uint8_t  x = uiOp >> 6;
+  uint8_t  y = (uiOp >> 3) & 0x07;
+  uint8_t  z = uiOp & 0x07;
+  uint8_t  p = y >> 1;
+  uint8_t  q = y & 0x01;
+  uint16_t uiAddr;
+  uint16_t uiValue;
+  uint8_t  uiByte;
+
+  switch (x)
+  {
+    case 0:
+      switch (z)
+      {
+        case 0:
+          switch (y)
+          {
+            case 0: /* NOP */
+              return 4;
+
+            case 1: /* EX AF,AF' */
+              uiByte = pCpu->auiReg[Z80N_A]; pCpu->auiReg[Z80N_A] = pCpu->auiAlt[Z80N_A]; pCpu->auiAlt[Z80N_A] = uiByte;
+              uiByte = pCpu->uiF;            pCpu->uiF            = pCpu->uiAltF;          pCpu->uiAltF          = uiByte;
+              return 4;
+
+            case 2: /* DJNZ e */
+              uiByte = fetchByte(pCpu);
+              if (0 != --pCpu->auiReg[Z80N_B])
+              {
+                pCpu->uiPC += (int8_t) uiByte;
+                return 13;
+              }
+              return 8;
+
+            case 3: /* JR e */
+              uiByte = fetchByte(pCpu);
+              pCpu->uiPC += (int8_t) uiByte;
+              return 12;
+
+            default: /* JR cc,e */
+              uiByte = fetchByte(pCpu);
+              if (testCondition(pCpu, y - 4))
+              {
+                pCpu->uiPC += (int8_t) uiByte;
+                return 12;
+              }
+              return 7;
+          }
+
+        case 1:
+          if (0 == q) /* LD rp,nn */
+          {
+            setPair(pCpu, p, uiIdx, false, fetchWord(pCpu));
+            return 10;
+          }
+
+          /* ADD HL,rp */
+          setPair(pCpu, 2, uiIdx, false, addWord(pCpu, getPair(pCpu, 2, uiIdx, false), getPair(pCpu, p, uiIdx, false)));
+          return 11;
+
+        case 2:
+          switch (y)
+          {
+            case 0: writeByte(pCpu, Z80N_BC(pCpu), pCpu->auiReg[Z80N_A]); return 7;             /* LD (BC),A  */
+            case 1: pCpu->auiReg[Z80N_A] = readByte(pCpu, Z80N_BC(pCpu)); return 7;             /* LD A,(BC)  */
+            case 2: writeByte(pCpu, Z80N_DE(pCpu), pCpu->auiReg[Z80N_A]); return 7;             /* LD (DE),A  */
+            case 3: pCpu->auiReg[Z80N_A] = readByte(pCpu, Z80N_DE(pCpu)); return 7;             /* LD A,(DE)  */
+            case 4: writeWord(pCpu, fetchWord(pCpu), getPair(pCpu, 2, uiIdx, false)); return 16; /* LD (nn),HL */
+            case 5: setPair(pCpu, 2, uiIdx, false, readWord(pCpu, fetchWord(pCpu))); return 16; /* LD HL,(nn) */
+            case 6: writeByte(pCpu, fetchWord(pCpu), pCpu->auiReg[Z80N_A]); return 13;          /* LD (nn),A  */
+            default: pCpu->auiReg[Z80N_A] = readByte(pCpu, fetchWord(pCpu)); return 13;         /* LD A,(nn)  */
+          }
+
+        case 3: /* INC rp / DEC rp */
+          setPair(pCpu, p, uiIdx, false, (uint16_t) (getPair(pCpu, p, uiIdx, false) + (q ? -1 : 1)));
+          return 6;
+
+        case 4: /* INC r */
+        case 5: /* DEC r */
+          if (Z80N_MEM == y)
+          {
+            uiAddr = getMemAddr(pCpu, uiIdx);
+            uiByte = readByte(pCpu, uiAddr);
+            writeByte(pCpu, uiAddr, (4 == z) ? incByte(pCpu, uiByte) : decByte(pCpu, uiByte));
+            return (IDX_HL == uiIdx) ? 11 : 19;
+          }
+
+          uiByte = getReg(pCpu, y, uiIdx);
+          setReg(pCpu, y, uiIdx, (4 == z) ? incByte(pCpu, uiByte) : decByte(pCpu, uiByte));
+          return 4;
+
+        case 6: /* LD r,n */
+          if (Z80N_MEM == y)
+          {
+            uiAddr = getMemAddr(pCpu, uiIdx);
+            writeByte(pCpu, uiAddr, fetchByte(pCpu));
+            return (IDX_HL == uiIdx) ? 10 : 15;
+          }
+
+          setReg(pCpu, y, uiIdx, fetchByte(pCpu));
+          return 7;
+
+        default:
+          switch (y)
+          {
+            case 0: /* RLCA */
+            case 1: /* RRCA */
+            case 2: /* RLA  */
+            case 3: /* RRA  */
+            {
+              uint8_t uiF = pCpu->uiF & (Z80N_FLAG_S | Z80N_FLAG_Z | Z80N_FLAG_PV);
+
+              pCpu->auiReg[Z80N_A] = rotOp(pCpu, y, pCpu->auiReg[Z80N_A]);
+              pCpu->uiF = uiF | (pCpu->uiF & Z80N_FLAG_C) | (pCpu->auiReg[Z80N_A] & (Z80N_FLAG_X | Z80N_FLAG_Y));
+              return 4;
+            }
+
+            case 4: /* DAA */
+              daa(pCpu);
+              return 4;
+
+            case 5: /* CPL */
+              pCpu->auiReg[Z80N_A] = ~pCpu->auiReg[Z80N_A];
+              pCpu->uiF = (pCpu->uiF & (Z80N_FLAG_S | Z80N_FLAG_Z | Z80N_FLAG_PV | Z80N_FLAG_C))
+                        | Z80N_FLAG_H | Z80N_FLAG_N
+                        | (pCpu->auiReg[Z80N_A] & (Z80N_FLAG_X | Z80N_FLAG_Y));
+              return 4;
+
+            case 6: /* SCF */
+              pCpu->uiF = (pCpu->uiF & (Z80N_FLAG_S | Z80N_FLAG_Z | Z80N_FLAG_PV))
+                        | Z80N_FLAG_C
+                        | (pCpu->auiReg[Z80N_A] & (Z80N_FLAG_X | Z80N_FLAG_Y));
+              return 4;
+
+            default: /* CCF */
+              pCpu->uiF = (pCpu->uiF & (Z80N_FLAG_S | Z80N_FLAG_Z | Z80N_FLAG_PV))
+                        | ((pCpu->uiF & Z80N_FLAG_C) ? Z80N_FLAG_H : Z80N_FLAG_C)
+                        | (pCpu->auiReg[Z80N_A] & (Z80N_FLAG_X | Z80N_FLAG_Y));
+              return 4;
+          }
+      }
+
+    case 1:
+      if ((Z80N_MEM == y) && (Z80N_MEM == z)) /* HALT */
+      {
+        pCpu->bHalted = true;
+        pCpu->uiPC--;
+        return 4;
+      }
+
+      /* LD r,r' (with (IX+d) the other register is H/L, not IXH/IXL) */
+      if (Z80N_MEM == z)
+      {
+        pCpu->auiReg[y] = readByte(pCpu, getMemAddr(pCpu, uiIdx));
+        return (IDX_HL == uiIdx) ? 7 : 15;
+      }
+
+      if (Z80N_MEM == y)
+      {
+        uiAddr = getMemAddr(pCpu, uiIdx);
+        writeByte(pCpu, uiAddr, pCpu->auiReg[z]);
+        return (IDX_HL == uiIdx) ? 7 : 15;
+      }
+
+      setReg(pCpu, y, uiIdx, getReg(pCpu, z, uiIdx));
+      return 4;
+
+    case 2: /* ALU A,r */
+      if (Z80N_MEM == z)
+      {
+        aluOp(pCpu, y, readByte(pCpu, getMemAddr(pCpu, uiIdx)));
+        return (IDX_HL == uiIdx) ? 7 : 15;
+      }
+
+      aluOp(pCpu, y, getReg(pCpu, z, uiIdx));
+      return 4;
+
+    default:
+      switch (z)
+      {
+        case 0: /* RET cc */
+          if (testCondition(pCpu, y))
+          {
+            pCpu->uiPC = popWord(pCpu);
+            return 11;
+          }
+          return 5;
+
+        case 1:
+          if (0 == q) /* POP rp2 */
+          {
+            setPair(pCpu, p, uiIdx, true, popWord(pCpu));
+            return 10;
+          }
+
+          switch (p)
+          {
+            case 0: /* RET */
+              pCpu->uiPC = popWord(pCpu);
+              return 10;
+
+            case 1: /* EXX */
+              for (uint8_t i = Z80N_B; i <= Z80N_L; ++i)
+              {
+                uiByte = pCpu->auiReg[i]; pCpu->auiReg[i] = pCpu->auiAlt[i]; pCpu->auiAlt[i] = uiByte;
+              }
+              return 4;
+
+            case 2: /* JP (HL) */
+              pCpu->uiPC = getPair(pCpu, 2, uiIdx, false);
+              return 4;
+
+            default: /* LD SP,HL */
+              pCpu->uiSP = getPair(pCpu, 2, uiIdx, false);
+              return 6;
+          }
+
+        case 2: /* JP cc,nn */
+          uiValue = fetchWord(pCpu);
+          if (testCondition(pCpu, y))
+          {
+            pCpu->uiPC = uiValue;
+          }
+          return 10;
+
+        case 3:
+          switch (y)
+          {
+            case 0: /* JP nn */
+              pCpu->uiPC = fetchWord(pCpu);
+              return 10;
+
+            case 2: /* OUT (n),A */
+              uiByte = fetchByte(pCpu);
+              if (0 != pCpu->fnOut)
+              {
+                pCpu->fnOut(pCpu, (uint16_t) ((pCpu->auiReg[Z80N_A] << 8) | uiByte), pCpu->auiReg[Z80N_A]);
+              }
+              return 11;
+
+            case 3: /* IN A,(n) */
+              uiByte = fetchByte(pCpu);
+              pCpu->auiReg[Z80N_A] = (0 != pCpu->fnIn) ? pCpu->fnIn(pCpu, (uint16_t) ((pCpu->auiReg[Z80N_A] << 8) | uiByte)) : 0xFF;
+              return 11;
+
+            case 4: /* EX (SP),HL */
+              uiValue = readWord(pCpu, pCpu->uiSP);
+              writeWord(pCpu, pCpu->uiSP, getPair(pCpu, 2, uiIdx, false));
+              setPair(pCpu, 2, uiIdx, false, uiValue);
+              return 19;
+
+            case 5: /* EX DE,HL (not affected by DD/FD) */
+              uiValue = Z80N_DE(pCpu);
+              setPair(pCpu, 1, IDX_HL, false, Z80N_HL(pCpu));
+              setPair(pCpu, 2, IDX_HL, false, uiValue);
+              return 4;
+
+            case 6: /* DI */
+              pCpu->bIFF1 = false;
+              pCpu->bIFF2 = false;
+              return 4;
+
+            default: /* EI */
+              pCpu->bIFF1 = true;
+              pCpu->bIFF2 = true;
+              return 4;
+          }
+
+        case 4: /* CALL cc,nn */
+          uiValue = fetchWord(pCpu);
+          if (testCondition(pCpu, y))
+          {
+            pushWord(pCpu, pCpu->uiPC);
+            pCpu->uiPC = uiValue;
+            return 17;
+          }
+          return 10;
+
+        case 5:
+          if (0 == q) /* PUSH rp2 */
+          {
+            pushWord(pCpu, getPair(pCpu, p, uiIdx, true));
+            return 11;
+          }
+
+          /* CALL nn (the prefixes DD, ED, FD are decoded before) */
+          uiValue = fetchWord(pCpu);
+          pushWord(pCpu, pCpu->uiPC);
+          pCpu->uiPC = uiValue;
+          return 17;
+
+        case 6: /* ALU A,n */
+          aluOp(pCpu, y, fetchByte(pCpu));
+          return 7;
+
+        default: /* RST p */
+          pCpu->uiPC--;
+
+          if ((0 != pCpu->fnRst) && pCpu->fnRst(pCpu, (uint8_t) (y << 3)))
+          {
+            return 11;
+          }
+
+          pushWord(pCpu, (uint16_t) (pCpu->uiPC + 1));
+          pCpu->uiPC = (uint16_t) (y << 3);
+          return 11;
+      }
+  }
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* execCB()                                                                   */
+/*----------------------------------------------------------------------------*/
+static uint8_t execCB(z80n_t* pCpu, uint8_t uiIdx)
+{
+  uint16_t uiAddr = 0;
+  uint8_t  uiOp;
+  uint8_t  uiValue;
+  uint8_t  uiResult;
+  uint8_t  x;
+  uint8_t  y;
+  uint8_t  z;
+
+  /* DD CB d op: the displacement comes before the opcode */
+  if (IDX_HL != uiIdx)
+  {
+    uiAddr = getMemAddr(pCpu, uiIdx);
+  }
+
+  uiOp = fetchByte(pCpu);
+  x    = uiOp >> 6;
+  y    = (uiOp >> 3) & 0x07;
+  z    = uiOp & 0x07;
+
+  if (IDX_HL == uiIdx)
+  {
+    pCpu->uiR = (pCpu->uiR & 0x80) | ((pCpu->uiR + 1) & 0x7F);
+
+    if (Z80N_MEM == z)
+    {
+      uiAddr = Z80N_HL(pCpu);
+    }
+  }
+
+  uiValue = ((IDX_HL == uiIdx) && (Z80N_MEM != z)) ? pCpu->auiReg[z] : readByte(pCpu, uiAddr);
+
+  switch (x)
+  {
+    case 0: /* rotate/shift */
+      uiResult = rotOp(pCpu, y, uiValue);
+      break;
+
+    case 1: /* BIT b */
+      pCpu->uiF = (pCpu->uiF & Z80N_FLAG_C)
+                | Z80N_FLAG_H
+                | (s_auiSZP[uiValue & (1 << y)] & (Z80N_FLAG_S | Z80N_FLAG_Z | Z80N_FLAG_PV))
+                | (((IDX_HL == uiIdx) && (Z80N_MEM != z) ? uiValue : (uiAddr >> 8)) & (Z80N_FLAG_X | Z80N_FLAG_Y));
+
+      if (IDX_HL != uiIdx)
+      {
+        return 16;  /* + 4 (DD/FD) = 20 */
+      }
+
+      return (Z80N_MEM == z) ? 12 : 8;
+
+    case 2: /* RES b */
+      uiResult = uiValue & ~(1 << y);
+      break;
+
+    default: /* SET b */
+      uiResult = uiValue | (1 << y);
+  }
+
+  if (IDX_HL != uiIdx)
+  {
+    writeByte(pCpu, uiAddr, uiResult);
+
+    if (Z80N_MEM != z)
+    {
+      pCpu->auiReg[z] = uiResult; /* undocumented: copy to the register */
+    }
+
+    return 19;  /* + 4 (DD/FD) = 23 */
+  }
+
+  if (Z80N_MEM == z)
+  {
+    writeByte(pCpu, uiAddr, uiResult);
+    return 15;
+  }
+
+  pCpu->auiReg[z] = uiResult;
+
+  return 8;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* execED()                                                                   */
+/*----------------------------------------------------------------------------*/
+static uint8_t execED(z80n_t* pCpu)
+{
+  uint8_t  uiOp = fetchByte(pCpu);
+  uint8_t  x    = uiOp >> 6;
+  uint8_t  y    = (uiOp >> 3) & 0x07;
+  uint8_t  z    = uiOp & 0x07;
+  uint8_t  p    = y >> 1;
+  uint8_t  q    = y & 0x01;
+  uint16_t uiValue;
+  uint8_t  uiByte;
+
+  pCpu->uiR = (pCpu->uiR & 0x80) | ((pCpu->uiR + 1) & 0x7F);
+
+  /* Extended instructions of the Z80N */
+  switch (uiOp)
+  {
+    case 0x23: /* SWAPNIB */
+      pCpu->auiReg[Z80N_A] = (uint8_t) ((pCpu->auiReg[Z80N_A] << 4) | (pCpu->auiReg[Z80N_A] >> 4));
+      return 8;
+
+    case 0x24: /* MIRROR A */
+      uiByte = pCpu->auiReg[Z80N_A];
+      uiByte = (uint8_t) (((uiByte & 0xF0) >> 4) | ((uiByte & 0x0F) << 4));
+      uiByte = (uint8_t) (((uiByte & 0xCC) >> 2) | ((uiByte & 0x33) << 2));
+      uiByte = (uint8_t) (((uiByte & 0xAA) >> 1) | ((uiByte & 0x55) << 1));
+      pCpu->auiReg[Z80N_A] = uiByte;
+      return 8;
+
+    case 0x27: /* TEST n */
+      uiByte = pCpu->auiReg[Z80N_A] & fetchByte(pCpu);
+      pCpu->uiF = s_auiSZP[uiByte] | Z80N_FLAG_H;
+      return 11;
+
+    case 0x28: /* BSLA DE,B */
+      setPair(pCpu, 1, IDX_HL, false, (uint16_t) (Z80N_DE(pCpu) << (pCpu->auiReg[Z80N_B] & 0x1F)));
+      return 8;
+
+    case 0x29: /* BSRA DE,B */
+      setPair(pCpu, 1, IDX_HL, false, (uint16_t) (((int16_t) Z80N_DE(pCpu)) >> ((pCpu->auiReg[Z80N_B] & 0x1F) < 16 ? (pCpu->auiReg[Z80N_B] & 0x1F) : 15)));
+      return 8;
+
+    case 0x2A: /* BSRL DE,B */
+      setPair(pCpu, 1, IDX_HL, false, (uint16_t) (Z80N_DE(pCpu) >> (pCpu->auiReg[Z80N_B] & 0x1F)));
+      return 8;
+
+    case 0x2B: /* BSRF DE,B */
+      setPair(pCpu, 1, IDX_HL, false, (uint16_t) ~(((uint16_t) ~Z80N_DE(pCpu)) >> (pCpu->auiReg[Z80N_B] & 0x1F)));
+      return 8;
+
+    case 0x2C: /* BRLC DE,B */
+      uiValue = Z80N_DE(pCpu);
+      uiByte  = pCpu->auiReg[Z80N_B] & 0x0F;
+      setPair(pCpu, 1, IDX_HL, false, (uint16_t) ((uiValue << uiByte) | (uiValue >> ((16 - uiByte) & 0x0F))));
+      return 8;
+
+    case 0x30: /* MUL D,E */
+      setPair(pCpu, 1, IDX_HL, false, (uint16_t) (pCpu->auiReg[Z80N_D] * pCpu->auiReg[Z80N_E]));
+      return 8;
+
+    case 0x31: /* ADD HL,A */
+    case 0x32: /* ADD DE,A */
+    case 0x33: /* ADD BC,A */
+      p = (0x31 == uiOp) ? 2 : ((0x32 == uiOp) ? 1 : 0);
+      setPair(pCpu, p, IDX_HL, false, (uint16_t) (getPair(pCpu, p, IDX_HL, false) + pCpu->auiReg[Z80N_A]));
+      return 8;
+
+    case 0x34: /* ADD HL,nn */
+    case 0x35: /* ADD DE,nn */
+    case 0x36: /* ADD BC,nn */
+      p = (0x34 == uiOp) ? 2 : ((0x35 == uiOp) ? 1 : 0);
+      setPair(pCpu, p, IDX_HL, false, (uint16_t) (getPair(pCpu, p, IDX_HL, false) + fetchWord(pCpu)));
+      return 16;
+
+    case 0x8A: /* PUSH nn (big endian) */
+      uiValue  = (uint16_t) (fetchByte(pCpu) << 8);
+      uiValue |= fetchByte(pCpu);
+      pushWord(pCpu, uiValue);
+      return 23;
+
+    case 0x90: /* OUTINB */
+      if (0 != pCpu->fnOut)
+      {
+        pCpu->fnOut(pCpu, Z80N_BC(pCpu), readByte(pCpu, Z80N_HL(pCpu)));
+      }
+      setPair(pCpu, 2, IDX_HL, false, (uint16_t) (Z80N_HL(pCpu) + 1));
+      return 16;
+
+    case 0x91: /* NEXTREG n,n */
+      uiByte = fetchByte(pCpu);
+      if (0 != pCpu->fnNextReg)
+      {
+        pCpu->fnNextReg(pCpu, uiByte, fetchByte(pCpu));
+      }
+      else
+      {
+        (void) fetchByte(pCpu);
+      }
+      return 20;
+
+    case 0x92: /* NEXTREG n,A */
+      uiByte = fetchByte(pCpu);
+      if (0 != pCpu->fnNextReg)
+      {
+        pCpu->fnNextReg(pCpu, uiByte, pCpu->auiReg[Z80N_A]);
+      }
+      return 17;
+
+    case 0x93: /* PIXELDN */
+      uiValue = Z80N_HL(pCpu);
+
+      if (0x0700 != (uiValue & 0x0700))
+      {
+        uiValue += 0x0100;
+      }
+      else if (0xE0 != (uiValue & 0xE0))
+      {
+        uiValue = (uint16_t) ((uiValue & 0xF8FF) + 0x20);
+      }
+      else
+      {
+        uiValue = (uint16_t) ((uiValue & 0xF81F) + 0x0800);
+      }
+
+      setPair(pCpu, 2, IDX_HL, false, uiValue);
+      return 8;
+
+    case 0x94: /* PIXELAD */
+      uiByte  = pCpu->auiReg[Z80N_D];
+      uiValue = (uint16_t) (0x4000 + ((uiByte & 0xC0) << 5) + ((uiByte & 0x07) << 8) + ((uiByte & 0x38) << 2) + (pCpu->auiReg[Z80N_E] >> 3));
+      setPair(pCpu, 2, IDX_HL, false, uiValue);
+      return 8;
+
+    case 0x95: /* SETAE */
+      pCpu->auiReg[Z80N_A] = (uint8_t) (0x80 >> (pCpu->auiReg[Z80N_E] & 0x07));
+      return 8;
+
+    case 0x98: /* JP (C) */
+      uiByte = (0 != pCpu->fnIn) ? pCpu->fnIn(pCpu, Z80N_BC(pCpu)) : 0xFF;
+      pCpu->uiPC = (uint16_t) ((pCpu->uiPC & 0xC000) + (uiByte << 6));
+      return 13;
+
+    case 0xA4: /* LDIX   */
+    case 0xA5: /* LDWS   */
+    case 0xAC: /* LDDX   */
+      (void) execBlock(pCpu, uiOp);
+      return (0xA5 == uiOp) ? 14 : 16;
+
+    case 0xB4: /* LDIRX  */
+    case 0xB7: /* LDPIRX */
+    case 0xBC: /* LDDRX  */
+      return execBlock(pCpu, uiOp) ? 21 : 16;
+
+    default:
+      break;
+  }
+
+  if (1 == x)
+  {
+    switch (z)
+    {
+      case 0: /* IN r,(C) (r = 6: flags only) */
+        uiByte = (0 != pCpu->fnIn) ? pCpu->fnIn(pCpu, Z80N_BC(pCpu)) : 0xFF;
+        pCpu->uiF = (pCpu->uiF & Z80N_FLAG_C) | s_auiSZP[uiByte];
+        if (Z80N_MEM != y)
+        {
+          pCpu->auiReg[y] = uiByte;
+        }
+        return 12;
+
+      case 1: /* OUT (C),r (r = 6: 0) */
+        if (0 != pCpu->fnOut)
+        {
+          pCpu->fnOut(pCpu, Z80N_BC(pCpu), (Z80N_MEM == y) ? 0 : pCpu->auiReg[y]);
+        }
+        return 12;
+
+      case 2: /* SBC HL,rp / ADC HL,rp */
+        setPair(pCpu, 2, IDX_HL, false, adcWord(pCpu, Z80N_HL(pCpu), getPair(pCpu, p, IDX_HL, false), 0 == q));
+        return 15;
+
+      case 3: /* LD (nn),rp / LD rp,(nn) */
+        uiValue = fetchWord(pCpu);
+        if (0 == q)
+        {
+          writeWord(pCpu, uiValue, getPair(pCpu, p, IDX_HL, false));
+        }
+        else
+        {
+          setPair(pCpu, p, IDX_HL, false, readWord(pCpu, uiValue));
+        }
+        return 20;
+
+      case 4: /* NEG */
+        uiByte = pCpu->auiReg[Z80N_A];
+        pCpu->auiReg[Z80N_A] = 0;
+        aluOp(pCpu, 2, uiByte);
+        return 8;
+
+      case 5: /* RETN / RETI */
+        pCpu->uiPC  = popWord(pCpu);
+        pCpu->bIFF1 = pCpu->bIFF2;
+        return 14;
+
+      case 6: /* IM 0/1/2 */
+        pCpu->uiIM = (0 == (y & 0x03)) ? 0 : (y & 0x03) - 1;
+        return 8;
+
+      default:
+        switch (y)
+        {
+          case 0: pCpu->uiI = pCpu->auiReg[Z80N_A]; return 9; /* LD I,A */
+          case 1: pCpu->uiR = pCpu->auiReg[Z80N_A]; return 9; /* LD R,A */
+
+          case 2: /* LD A,I */
+          case 3: /* LD A,R */
+            pCpu->auiReg[Z80N_A] = (2 == y) ? pCpu->uiI : pCpu->uiR;
+            pCpu->uiF = (pCpu->uiF & Z80N_FLAG_C) | FLAGS_SZXY(pCpu->auiReg[Z80N_A]) | (pCpu->bIFF2 ? Z80N_FLAG_PV : 0);
+            return 9;
+
+          case 4: /* RRD */
+          case 5: /* RLD */
+            uiByte = readByte(pCpu, Z80N_HL(pCpu));
+
+            if (4 == y)
+            {
+              writeByte(pCpu, Z80N_HL(pCpu), (uint8_t) ((pCpu->auiReg[Z80N_A] << 4) | (uiByte >> 4)));
+              pCpu->auiReg[Z80N_A] = (pCpu->auiReg[Z80N_A] & 0xF0) | (uiByte & 0x0F);
+            }
+            else
+            {
+              writeByte(pCpu, Z80N_HL(pCpu), (uint8_t) ((uiByte << 4) | (pCpu->auiReg[Z80N_A] & 0x0F)));
+              pCpu->auiReg[Z80N_A] = (pCpu->auiReg[Z80N_A] & 0xF0) | (uiByte >> 4);
+            }
+
+            pCpu->uiF = (pCpu->uiF & Z80N_FLAG_C) | s_auiSZP[pCpu->auiReg[Z80N_A]];
+            return 18;
+
+          default: /* NOP */
+            return 8;
+        }
+    }
+  }
+
+  if ((2 == x) && (4 <= y) && (3 >= z))
+  {
+    /* LDI, CPI, INI, OUTI, ... (y = 5, 7: decrement; y = 6, 7: repeat) */
+    if (y & 0x02)
+    {
+      return execBlock(pCpu, uiOp) ? 21 : 16;
+    }
+
+    (void) execBlock(pCpu, uiOp);
+    return 16;
+  }
+
+  return 8; /* invalid: NOP */
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* execBlock()                                                                */
+/*----------------------------------------------------------------------------*/
+static bool execBlock(z80n_t* pCpu, uint8_t uiOp)
+{
+  uint16_t uiHL = Z80N_HL(pCpu);
+  uint16_t uiDE = Z80N_DE(pCpu);
+  uint16_t uiBC = Z80N_BC(pCpu);
+  int8_t   iStep = (uiOp & 0x08) ? -1 : 1;
+  bool     bRepeat = 0 != (uiOp & 0x10);
+  bool     bAgain = false;
+  uint8_t  uiByte;
+  uint8_t  uiResult;
+
+  switch (uiOp)
+  {
+    case 0xA4: /* LDIX   */
+    case 0xAC: /* LDDX   */
+    case 0xB4: /* LDIRX  */
+    case 0xBC: /* LDDRX  */
+    case 0xB7: /* LDPIRX */
+      if (0xB7 == uiOp)
+      {
+        uiByte = readByte(pCpu, (uint16_t) ((uiHL & 0xFFF8) | (pCpu->auiReg[Z80N_E] & 0x07)));
+      }
+      else
+      {
+        uiByte = readByte(pCpu, uiHL);
+        uiHL  += iStep;
+      }
+
+      if (uiByte != pCpu->auiReg[Z80N_A])
+      {
+        writeByte(pCpu, uiDE, uiByte);
+      }
+
+      ++uiDE;
+      --uiBC;
+      bAgain = bRepeat && (0 != uiBC);
+      break;
+
+    case 0xA5: /* LDWS */
+      writeByte(pCpu, uiDE, readByte(pCpu, uiHL));
+      uiHL = (uiHL & 0xFF00) | ((uiHL + 1) & 0x00FF);
+      uiDE = (uint16_t) ((((uiDE >> 8) + 1) << 8) | (uiDE & 0x00FF));
+      (void) incByte(pCpu, (uint8_t) ((uiDE >> 8) - 1));
+      break;
+
+    default:
+      switch (uiOp & 0x03)
+      {
+        case 0: /* LDI, LDD, LDIR, LDDR */
+          uiByte = readByte(pCpu, uiHL);
+          writeByte(pCpu, uiDE, uiByte);
+          uiHL += iStep;
+          uiDE += iStep;
+          --uiBC;
+          uiByte += pCpu->auiReg[Z80N_A];
+          pCpu->uiF = (pCpu->uiF & (Z80N_FLAG_S | Z80N_FLAG_Z | Z80N_FLAG_C))
+                    | ((0 != uiBC) ? Z80N_FLAG_PV : 0)
+                    | (uiByte & Z80N_FLAG_X)
+                    | ((uiByte << 4) & Z80N_FLAG_Y);
+          bAgain = bRepeat && (0 != uiBC);
+          break;
+
+        case 1: /* CPI, CPD, CPIR, CPDR */
+          uiByte   = readByte(pCpu, uiHL);
+          uiResult = pCpu->auiReg[Z80N_A] - uiByte;
+          uiHL += iStep;
+          --uiBC;
+          pCpu->uiF = (pCpu->uiF & Z80N_FLAG_C)
+                    | Z80N_FLAG_N
+                    | (s_auiSZ[uiResult] & (Z80N_FLAG_S | Z80N_FLAG_Z))
+                    | ((pCpu->auiReg[Z80N_A] ^ uiByte ^ uiResult) & Z80N_FLAG_H)
+                    | ((0 != uiBC) ? Z80N_FLAG_PV : 0);
+          bAgain = bRepeat && (0 != uiBC) && (0 != uiResult);
+          break;
+
+        case 2: /* INI, IND, INIR, INDR */
+          uiByte = (0 != pCpu->fnIn) ? pCpu->fnIn(pCpu, uiBC) : 0xFF;
+          writeByte(pCpu, uiHL, uiByte);
+          uiHL += iStep;
+          uiBC  = (uint16_t) (uiBC - 0x0100);
+          pCpu->uiF = (s_auiSZ[uiBC >> 8] & ~(Z80N_FLAG_X | Z80N_FLAG_Y)) | Z80N_FLAG_N | (pCpu->uiF & Z80N_FLAG_C);
+          bAgain = bRepeat && (0 != (uiBC >> 8));
+          break;
+
+        default: /* OUTI, OUTD, OTIR, OTDR */
+          uiByte = readByte(pCpu, uiHL);
+          uiBC   = (uint16_t) (uiBC - 0x0100);
+          if (0 != pCpu->fnOut)
+          {
+            pCpu->fnOut(pCpu, uiBC, uiByte);
+          }
+          uiHL += iStep;
+          pCpu->uiF = (s_auiSZ[uiBC >> 8] & ~(Z80N_FLAG_X | Z80N_FLAG_Y)) | Z80N_FLAG_N | (pCpu->uiF & Z80N_FLAG_C);
+          bAgain = bRepeat && (0 != (uiBC >> 8));
+          break;
+      }
+  }
+
+  setPair(pCpu, 0, IDX_HL, false, uiBC);
+  setPair(pCpu, 1, IDX_HL, false, uiDE);
+  setPair(pCpu, 2, IDX_HL, false, uiHL);
+
+  if (bAgain)
+  {
+    pCpu->uiPC -= 2;
+  }
+
+  return bAgain;
+}
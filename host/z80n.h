@@ -0,0 +1,143 @@
+/*-----------------------------------------------------------------------------+
+|                                                                              |
+| filename: z80n.h                                                             |
+| project:  zxn::scrnshot                                                      |
+| author:   S. Zell                                                            |
+| date:     10/18/2026                                                         |
+|                                                                              |
++------------------------------------------------------------------------------+
+|                                                                              |
+| description:                                                                 |
+|                                                                              |
+| Host: Z80N CPU core (Z80 with the extended instructions of the ZX Spectrum   |
+| Next) with the T-states of every instruction, for the benchmark of the dot   |
+| command                                                                      |
+|                                                                              |
++------------------------------------------------------------------------------+
+|                                                                              |
+| Copyright (c) 10/18/2026 STZ Engineering                                     |
+|                                                                              |
+| This software is provided  "as is",  without warranty of any kind, express   |
+| or implied. In no event shall STZ or its contributors be held liable for any |
+| direct, indirect, incidental, special or consequential damages arising out   |
+| of the use of or inability to use this software.                             |
+|                                                                              |
+| Permission is granted to anyone  to use this  software for any purpose,      |
+| including commercial applications,  and to alter it and redistribute it      |
+| freely, subject to the following restrictions:                               |
+|                                                                              |
+| 1. Redistributions of source code must retain the above copyright            |
+|    notice, definition, disclaimer, and this list of conditions.              |
+|                                                                              |
+| 2. Redistributions in binary form must reproduce the above copyright         |
+|    notice, definition, disclaimer, and this list of conditions in            |
+|    documentation and/or other materials provided with the distribution.      |
+|                                                                          ;-) |
++-----------------------------------------------------------------------------*/
+
+#if !defined(__Z80N_H__)
+  #define __Z80N_H__
+
+/*============================================================================*/
+/*                               Includes                                     */
+/*============================================================================*/
+#include <stdint.h>
+#include <stdbool.h>
+
+/*============================================================================*/
+/*                               Defines                                      */
+/*============================================================================*/
+/*!
+Indices of the 8 bit registers in "auiReg" (encoding of the opcodes; 6 is the
+operand "(HL)")
+*/
+#define Z80N_B 0
+#define Z80N_C 1
+#define Z80N_D 2
+#define Z80N_E 3
+#define Z80N_H 4
+#define Z80N_L 5
+#define Z80N_A 7
+
+/*!
+Flags
+*/
+#define Z80N_FLAG_C  0x01
+#define Z80N_FLAG_N  0x02
+#define Z80N_FLAG_PV 0x04
+#define Z80N_FLAG_X  0x08
+#define Z80N_FLAG_H  0x10
+#define Z80N_FLAG_Y  0x20
+#define Z80N_FLAG_Z  0x40
+#define Z80N_FLAG_S  0x80
+
+/*!
+Register pairs
+*/
+#define Z80N_BC(p) ((uint16_t) (((p)->auiReg[Z80N_B] << 8) | (p)->auiReg[Z80N_C]))
+#define Z80N_DE(p) ((uint16_t) (((p)->auiReg[Z80N_D] << 8) | (p)->auiReg[Z80N_E]))
+#define Z80N_HL(p) ((uint16_t) (((p)->auiReg[Z80N_H] << 8) | (p)->auiReg[Z80N_L]))
+
+/*============================================================================*/
+/*                               Type-Definitions                             */
+/*============================================================================*/
+/*!
+Z80N CPU (Z80 with the extended opcodes of the Next); the memory is the 64K
+address space of the MMU, the ports, the NextRegs and the RST instructions
+are passed to the machine
+*/
+typedef struct _z80n
+{
+  uint8_t  auiReg[8];           /* B C D E H L - A                        */
+  uint8_t  uiF;
+  uint8_t  auiAlt[8];           /* B' C' D' E' H' L' - A'                 */
+  uint8_t  uiAltF;
+  uint16_t uiIX;
+  uint16_t uiIY;
+  uint16_t uiSP;
+  uint16_t uiPC;
+  uint8_t  uiI;
+  uint8_t  uiR;
+  bool     bIFF1;
+  bool     bIFF2;
+  uint8_t  uiIM;
+  bool     bHalted;
+  uint64_t uiTStates;           /* T-states since the reset               */
+
+  uint8_t* pMemory;             /* 64K address space                      */
+  void*    pMachine;            /* Context of the callbacks               */
+
+  /*! Write access to the memory; "false" = read only (ROM) */
+  bool    (*fnWritable)(struct _z80n* pCpu, uint16_t uiAddr);
+
+  /*! Ports (IN, OUT) */
+  uint8_t (*fnIn)(struct _z80n* pCpu, uint16_t uiPort);
+  void    (*fnOut)(struct _z80n* pCpu, uint16_t uiPort, uint8_t uiValue);
+
+  /*! NextRegs (NEXTREG n,n / NEXTREG n,A) */
+  void    (*fnNextReg)(struct _z80n* pCpu, uint8_t uiReg, uint8_t uiValue);
+
+  /*!
+  RST instruction at "uiPC" (not yet executed); "true" = handled by the
+  machine, which has set the registers and the PC to continue
+  */
+  bool    (*fnRst)(struct _z80n* pCpu, uint8_t uiAddr);
+} z80n_t;
+
+/*============================================================================*/
+/*                               Prototypes                                   */
+/*============================================================================*/
+/*!
+Resets the CPU (PC = 0, interrupts disabled, T-states = 0); memory and
+callbacks are not changed
+*/
+void z80nReset(z80n_t* pCpu);
+
+/*!
+Executes one instruction (with all prefixes); a repeated block instruction
+counts one iteration
+@return T-states of the instruction
+*/
+uint8_t z80nStep(z80n_t* pCpu);
+
+#endif /* __Z80N_H__ */
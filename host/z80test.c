@@ -0,0 +1,447 @@
+/*-----------------------------------------------------------------------------+
+|                                                                              |
+| filename: z80test.c                                                          |
+| project:  zxn::scrnshot                                                      |
+| author:   S. Zell                                                            |
+| date:     10/18/2026                                                         |
+|                                                                              |
++------------------------------------------------------------------------------+
+|                                                                              |
+| description:                                                                 |
+|                                                                              |
+| Host: unit test of the Z80N core of the benchmark (Linux): flags and         |
+| T-states of single instructions and known sequences, the extended opcodes    |
+| of the Next and the calls of the machine (RST 8, NEXTREG, OUTINB)            |
+|                                                                              |
++------------------------------------------------------------------------------+
+|                                                                              |
+| Copyright (c) 10/18/2026 STZ Engineering                                     |
+|                                                                              |
+| This software is provided  "as is",  without warranty of any kind, express   |
+| or implied. In no event shall STZ or its contributors be held liable for any |
+| direct, indirect, incidental, special or consequential damages arising out   |
+| of the use of or inability to use this software.                             |
+|                                                                              |
+| Permission is granted to anyone  to use this  software for any purpose,      |
+| including commercial applications,  and to alter it and redistribute it      |
+| freely, subject to the following restrictions:                               |
+|                                                                              |
+| 1. Redistributions of source code must retain the above copyright            |
+|    notice, definition, disclaimer, and this list of conditions.              |
+|                                                                              |
+| 2. Redistributions in binary form must reproduce the above copyright         |
+|    notice, definition, disclaimer, and this list of conditions in            |
+|    documentation and/or other materials provided with the distribution.      |
+|                                                                          ;-) |
++-----------------------------------------------------------------------------*/
+
+/*============================================================================*/
+/*                               Includes                                     */
+/*============================================================================*/
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "z80n.h"
+
+/*============================================================================*/
+/*                               Defines                                      */
+/*============================================================================*/
+/*!
+Address of the code of a test case, of the data page (byte = low byte of the
+address; IX and IY point to it) and of the stack
+*/
+#define CODE_ADDR  0x8000
+#define DATA_ADDR  0xC000
+#define STACK_ADDR 0xFF00
+
+/*!
+Port of the tests of the I/O instructions (JP (C), OUTINB)
+*/
+#define TEST_PORT  0x123B
+
+/*============================================================================*/
+/*                               Type-Definitions                             */
+/*============================================================================*/
+/*!
+Test case: code at "CODE_ADDR", the registers before and after the given
+number of instructions (F with all bits, including X and Y) and the T-states;
+a repeated block instruction is one instruction per iteration
+*/
+typedef struct _cputest
+{
+  const char* acName;
+  uint8_t     auiCode[8];
+  uint8_t     uiSteps;
+  uint8_t     uiA;        /* Before */
+  uint8_t     uiF;
+  uint16_t    uiBC;
+  uint16_t    uiDE;
+  uint16_t    uiHL;
+  uint8_t     uiExpA;     /* After  */
+  uint8_t     uiExpF;
+  uint16_t    uiExpBC;
+  uint16_t    uiExpDE;
+  uint16_t    uiExpHL;
+  uint16_t    uiExpPC;
+  uint32_t    uiTStates;
+} cputest_t;
+
+/*!
+Calls of the machine recorded by the callbacks
+*/
+typedef struct _machine
+{
+  uint8_t  auiMemory[0x10000];
+  uint8_t  uiRstAddr;     /* Last RST passed to "fnRst" (0xFF = none) */
+  uint8_t  uiEsxdos;      /* Function of the last RST 8                */
+  uint8_t  uiNextReg;     /* Last NEXTREG                              */
+  uint8_t  uiNextValue;
+  uint16_t uiOutPort;     /* Last OUT                                  */
+  uint8_t  uiOutValue;
+} machine_t;
+
+/*============================================================================*/
+/*                               Variables                                    */
+/*============================================================================*/
+/*!
+Instructions with their flags and T-states (Zilog timing, Z80N: timing of the
+Next at 3.5 MHz)
+*/
+static const cputest_t s_atTests[] =
+{
+  /* Flags of the 8 bit arithmetic */
+  {"ADD A,B overflow",  {0x80},                         1, 0x7F, 0x00, 0x0100, 0x0000, 0x0000, 0x80, 0x94, 0x0100, 0x0000, 0x0000, 0x8001,  4},
+  {"SUB n borrow",      {0xD6, 0x01},                   1, 0x00, 0x00, 0x0000, 0x0000, 0x0000, 0xFF, 0xBB, 0x0000, 0x0000, 0x0000, 0x8002,  7},
+  {"CP n (X/Y of n)",   {0xFE, 0x28},                   1, 0x40, 0x00, 0x0000, 0x0000, 0x0000, 0x40, 0x3A, 0x0000, 0x0000, 0x0000, 0x8002,  7},
+  {"INC A keeps C",     {0x3C},                         1, 0xFF, 0x01, 0x0000, 0x0000, 0x0000, 0x00, 0x51, 0x0000, 0x0000, 0x0000, 0x8001,  4},
+  {"DEC A overflow",    {0x3D},                         1, 0x80, 0x00, 0x0000, 0x0000, 0x0000, 0x7F, 0x3E, 0x0000, 0x0000, 0x0000, 0x8001,  4},
+  {"ADD A,n; DAA",      {0xC6, 0x27, 0x27},             2, 0x15, 0x00, 0x0000, 0x0000, 0x0000, 0x42, 0x14, 0x0000, 0x0000, 0x0000, 0x8003, 11},
+  {"SUB n; DAA",        {0xD6, 0x18, 0x27},             2, 0x42, 0x00, 0x0000, 0x0000, 0x0000, 0x24, 0x26, 0x0000, 0x0000, 0x0000, 0x8003, 11},
+  {"AND n parity",      {0xE6, 0x3C},                   1, 0xF0, 0x01, 0x0000, 0x0000, 0x0000, 0x30, 0x34, 0x0000, 0x0000, 0x0000, 0x8002,  7},
+  {"NEG 0x80",          {0xED, 0x44},                   1, 0x80, 0x00, 0x0000, 0x0000, 0x0000, 0x80, 0x87, 0x0000, 0x0000, 0x0000, 0x8002,  8},
+  {"RLCA",              {0x07},                         1, 0x81, 0xC4, 0x0000, 0x0000, 0x0000, 0x03, 0xC5, 0x0000, 0x0000, 0x0000, 0x8001,  4},
+  {"BIT 7,A",           {0xCB, 0x7F},                   1, 0x80, 0x01, 0x0000, 0x0000, 0x0000, 0x80, 0x91, 0x0000, 0x0000, 0x0000, 0x8002,  8},
+
+  /* Flags of the 16 bit arithmetic */
+  {"ADD HL,DE",         {0x19},                         1, 0x00, 0xC4, 0x0000, 0x0001, 0x0FFF, 0x00, 0xD4, 0x0000, 0x0001, 0x1000, 0x8001, 11},
+  {"ADC HL,DE",         {0xED, 0x5A},                   1, 0x00, 0x01, 0x0000, 0x0000, 0x7FFF, 0x00, 0x94, 0x0000, 0x0000, 0x8000, 0x8002, 15},
+  {"SBC HL,BC",         {0xED, 0x42},                   1, 0x00, 0x00, 0x0001, 0x0000, 0x0000, 0x00, 0xBB, 0x0001, 0x0000, 0xFFFF, 0x8002, 15},
+
+  /* Extended instructions of the Z80N (flags not changed) */
+  {"SWAPNIB",           {0xED, 0x23},                   1, 0x12, 0x00, 0x0000, 0x0000, 0x0000, 0x21, 0x00, 0x0000, 0x0000, 0x0000, 0x8002,  8},
+  {"MIRROR A",          {0xED, 0x24},                   1, 0xC4, 0x00, 0x0000, 0x0000, 0x0000, 0x23, 0x00, 0x0000, 0x0000, 0x0000, 0x8002,  8},
+  {"TEST n",            {0xED, 0x27, 0x0F},             1, 0xF0, 0x01, 0x0000, 0x0000, 0x0000, 0xF0, 0x54, 0x0000, 0x0000, 0x0000, 0x8003, 11},
+  {"BSLA DE,B",         {0xED, 0x28},                   1, 0x00, 0x00, 0x0400, 0x0001, 0x0000, 0x00, 0x00, 0x0400, 0x0010, 0x0000, 0x8002,  8},
+  {"BSRA DE,B",         {0xED, 0x29},                   1, 0x00, 0x00, 0x0400, 0x8000, 0x0000, 0x00, 0x00, 0x0400, 0xF800, 0x0000, 0x8002,  8},
+  {"BSRL DE,B",         {0xED, 0x2A},                   1, 0x00, 0x00, 0x0400, 0x8000, 0x0000, 0x00, 0x00, 0x0400, 0x0800, 0x0000, 0x8002,  8},
+  {"BSRF DE,B",         {0xED, 0x2B},                   1, 0x00, 0x00, 0x0400, 0x0000, 0x0000, 0x00, 0x00, 0x0400, 0xF000, 0x0000, 0x8002,  8},
+  {"BRLC DE,B",         {0xED, 0x2C},                   1, 0x00, 0x00, 0x0100, 0x8001, 0x0000, 0x00, 0x00, 0x0100, 0x0003, 0x0000, 0x8002,  8},
+  {"MUL D,E",           {0xED, 0x30},                   1, 0x00, 0x00, 0x0000, 0xFFFF, 0x0000, 0x00, 0x00, 0x0000, 0xFE01, 0x0000, 0x8002,  8},
+  {"ADD HL,A",          {0xED, 0x31},                   1, 0x01, 0x00, 0x0000, 0x0000, 0x80FF, 0x01, 0x00, 0x0000, 0x0000, 0x8100, 0x8002,  8},
+  {"ADD BC,A",          {0xED, 0x33},                   1, 0xFF, 0x00, 0xFF01, 0x0000, 0x0000, 0xFF, 0x00, 0x0000, 0x0000, 0x0000, 0x8002,  8},
+  {"ADD DE,nn",         {0xED, 0x35, 0x34, 0x12},       1, 0x00, 0x00, 0x0000, 0x0101, 0x0000, 0x00, 0x00, 0x0000, 0x1335, 0x0000, 0x8004, 16},
+  {"PIXELAD",           {0xED, 0x94},                   1, 0x00, 0x00, 0x0000, 0x5B57, 0x0000, 0x00, 0x00, 0x0000, 0x5B57, 0x4B6A, 0x8002,  8},
+  {"PIXELDN line",      {0xED, 0x93},                   1, 0x00, 0x00, 0x0000, 0x0000, 0x4105, 0x00, 0x00, 0x0000, 0x0000, 0x4205, 0x8002,  8},
+  {"PIXELDN char row",  {0xED, 0x93},                   1, 0x00, 0x00, 0x0000, 0x0000, 0x4705, 0x00, 0x00, 0x0000, 0x0000, 0x4025, 0x8002,  8},
+  {"PIXELDN third",     {0xED, 0x93},                   1, 0x00, 0x00, 0x0000, 0x0000, 0x47E5, 0x00, 0x00, 0x0000, 0x0000, 0x4805, 0x8002,  8},
+  {"SETAE",             {0xED, 0x95},                   1, 0x00, 0x00, 0x0000, 0x0005, 0x0000, 0x04, 0x00, 0x0000, 0x0005, 0x0000, 0x8002,  8},
+  {"JP (C)",            {0xED, 0x98},                   1, 0x00, 0x00, 0x123B, 0x0000, 0x0000, 0x00, 0x00, 0x123B, 0x0000, 0x0000, 0x8280, 13},
+  {"LDIX skips A",      {0xED, 0xA4},                   1, 0x10, 0x00, 0x0002, 0xD000, 0xC010, 0x10, 0x00, 0x0001, 0xD001, 0xC011, 0x8002, 16},
+  {"LDIRX 3 bytes",     {0xED, 0xB4},                   3, 0x00, 0x00, 0x0003, 0xD000, 0xC011, 0x00, 0x00, 0x0000, 0xD003, 0xC014, 0x8002, 58},
+
+  /* T-states of sequences */
+  {"LD B,n; DJNZ x3",   {0x06, 0x03, 0x10, 0xFE},       4, 0x00, 0x00, 0x0000, 0x0000, 0x0000, 0x00, 0x00, 0x0000, 0x0000, 0x0000, 0x8004, 41},
+  {"LDIR 4 bytes",      {0xED, 0xB0},                   4, 0x00, 0x00, 0x0004, 0xD000, 0xC020, 0x00, 0x20, 0x0000, 0xD004, 0xC024, 0x8002, 79},
+  {"CALL nn; RET",      {0xCD, 0x06, 0x80, 0, 0, 0, 0xC9}, 2, 0x00, 0x00, 0x0000, 0x0000, 0x0000, 0x00, 0x00, 0x0000, 0x0000, 0x0000, 0x8003, 27},
+  {"PUSH BC; POP DE",   {0xC5, 0xD1},                   2, 0x00, 0x00, 0x1234, 0x0000, 0x0000, 0x00, 0x00, 0x1234, 0x1234, 0x0000, 0x8002, 21},
+  {"JR NZ not taken",   {0x20, 0x10},                   1, 0x00, 0x40, 0x0000, 0x0000, 0x0000, 0x00, 0x40, 0x0000, 0x0000, 0x0000, 0x8002,  7},
+  {"JR NZ taken",       {0x20, 0x10},                   1, 0x00, 0x00, 0x0000, 0x0000, 0x0000, 0x00, 0x00, 0x0000, 0x0000, 0x0000, 0x8012, 12},
+  {"LD A,(IX+d)",       {0xDD, 0x7E, 0x05},             1, 0x00, 0x00, 0x0000, 0x0000, 0x0000, 0x05, 0x00, 0x0000, 0x0000, 0x0000, 0x8003, 19},
+  {"SET 3,(IY+d); LD",  {0xFD, 0xCB, 0x02, 0xDE, 0x3A, 0x02, 0xC0}, 2, 0x00, 0x00, 0x0000, 0x0000, 0x0000, 0x0A, 0x00, 0x0000, 0x0000, 0x0000, 0x8007, 36},
+  {"ADD IX,BC",         {0xDD, 0x09},                   1, 0x00, 0x00, 0x0000, 0x0000, 0x0000, 0x00, 0x00, 0x0000, 0x0000, 0x0000, 0x8002, 15},
+  {"EX (SP),HL",        {0xE3},                         1, 0x00, 0x00, 0x0000, 0x0000, 0x1234, 0x00, 0x00, 0x0000, 0x0000, 0x0100, 0x8001, 19}
+};
+
+/*============================================================================*/
+/*                               Prototypes                                   */
+/*============================================================================*/
+/*!
+Prepares the CPU and the memory of a test: code, data page, stack, registers
+*/
+static void setupCpu(z80n_t* pCpu, machine_t* pMachine, const uint8_t* pCode, uint8_t uiLen);
+
+/*!
+Runs a test case of the table
+@return "true" = passed
+*/
+static bool runTest(const cputest_t* pTest);
+
+/*!
+Tests of the machine interface: RST (esxdos call), NEXTREG, OUTINB, PUSH nn
+@return Number of failed checks
+*/
+static unsigned testRestart(void);
+static unsigned testMachine(void);
+
+/*!
+Callbacks of the machine
+*/
+static uint8_t readPort(z80n_t* pCpu, uint16_t uiPort);
+static void    writePort(z80n_t* pCpu, uint16_t uiPort, uint8_t uiValue);
+static void    writeNextReg(z80n_t* pCpu, uint8_t uiReg, uint8_t uiValue);
+static bool    callRestart(z80n_t* pCpu, uint8_t uiAddr);
+
+/*!
+Reports a check
+@return 0 = passed, 1 = failed
+*/
+static unsigned check(const char* acName, bool bPassed);
+
+/*============================================================================*/
+/*                               Implementation                               */
+/*============================================================================*/
+
+/*----------------------------------------------------------------------------*/
+/* main()                                                                     */
+/*----------------------------------------------------------------------------*/
+int main(void)
+{
+  unsigned uiFail  = 0;
+  unsigned uiTests = (sizeof(s_atTests) / sizeof(s_atTests[0]));
+
+  for (unsigned i = 0; i < (sizeof(s_atTests) / sizeof(s_atTests[0])); ++i)
+  {
+    uiFail += check(s_atTests[i].acName, runTest(&s_atTests[i]));
+  }
+
+  uiFail  += testRestart();
+  uiFail  += testMachine();
+  uiTests += 6;
+
+  printf("%u of %u Z80N tests failed\n", uiFail, uiTests);
+
+  return (0 == uiFail) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* setupCpu()                                                                 */
+/*----------------------------------------------------------------------------*/
+static void setupCpu(z80n_t* pCpu, machine_t* pMachine, const uint8_t* pCode, uint8_t uiLen)
+{
+  memset(pMachine, 0, sizeof(*pMachine));
+
+  for (unsigned i = 0; i < 0x100; ++i)
+  {
+    pMachine->auiMemory[DATA_ADDR + i] = (uint8_t) i;
+  }
+
+  pMachine->auiMemory[STACK_ADDR]     = 0x00;
+  pMachine->auiMemory[STACK_ADDR + 1] = 0x01;
+  pMachine->uiRstAddr = 0xFF;
+
+  memcpy(&pMachine->auiMemory[CODE_ADDR], pCode, uiLen);
+
+  pCpu->pMemory    = pMachine->auiMemory;
+  pCpu->pMachine   = pMachine;
+  pCpu->fnWritable = 0;
+  pCpu->fnIn       = readPort;
+  pCpu->fnOut      = writePort;
+  pCpu->fnNextReg  = writeNextReg;
+  pCpu->fnRst      = callRestart;
+
+  z80nReset(pCpu);
+
+  pCpu->uiPC = CODE_ADDR;
+  pCpu->uiSP = STACK_ADDR;
+  pCpu->uiIX = DATA_ADDR;
+  pCpu->uiIY = DATA_ADDR;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* runTest()                                                                  */
+/*----------------------------------------------------------------------------*/
+static bool runTest(const cputest_t* pTest)
+{
+  static machine_t tMachine;
+  z80n_t tCpu;
+
+  setupCpu(&tCpu, &tMachine, pTest->auiCode, sizeof(pTest->auiCode));
+
+  tCpu.auiReg[Z80N_A] = pTest->uiA;
+  tCpu.uiF            = pTest->uiF;
+  tCpu.auiReg[Z80N_B] = (uint8_t) (pTest->uiBC >> 8);
+  tCpu.auiReg[Z80N_C] = (uint8_t)  pTest->uiBC;
+  tCpu.auiReg[Z80N_D] = (uint8_t) (pTest->uiDE >> 8);
+  tCpu.auiReg[Z80N_E] = (uint8_t)  pTest->uiDE;
+  tCpu.auiReg[Z80N_H] = (uint8_t) (pTest->uiHL >> 8);
+  tCpu.auiReg[Z80N_L] = (uint8_t)  pTest->uiHL;
+
+  for (uint8_t i = 0; i < pTest->uiSteps; ++i)
+  {
+    (void) z80nStep(&tCpu);
+  }
+
+  if ((pTest->uiExpA  != tCpu.auiReg[Z80N_A]) || (pTest->uiExpF  != tCpu.uiF)      ||
+      (pTest->uiExpBC != Z80N_BC(&tCpu))      || (pTest->uiExpDE != Z80N_DE(&tCpu)) ||
+      (pTest->uiExpHL != Z80N_HL(&tCpu))      || (pTest->uiExpPC != tCpu.uiPC)      ||
+      (pTest->uiTStates != tCpu.uiTStates))
+  {
+    printf("  expected A=%02X F=%02X BC=%04X DE=%04X HL=%04X PC=%04X T=%u\n",
+           pTest->uiExpA, pTest->uiExpF, pTest->uiExpBC, pTest->uiExpDE, pTest->uiExpHL, pTest->uiExpPC, (unsigned) pTest->uiTStates);
+    printf("  got      A=%02X F=%02X BC=%04X DE=%04X HL=%04X PC=%04X T=%u\n",
+           tCpu.auiReg[Z80N_A], tCpu.uiF, Z80N_BC(&tCpu), Z80N_DE(&tCpu), Z80N_HL(&tCpu), tCpu.uiPC, (unsigned) tCpu.uiTStates);
+    return false;
+  }
+
+  return true;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* testRestart()                                                              */
+/*----------------------------------------------------------------------------*/
+static unsigned testRestart(void)
+{
+  static machine_t tMachine;
+  static const uint8_t auiEsxdos[] = {0xCF, 0x9A, 0x3E, 0x55}; /* RST 8; DEFB F_WRITE; LD A,0x55 */
+  static const uint8_t auiPrint[]  = {0xD7};                   /* RST 0x10 (not handled)         */
+  unsigned uiFail = 0;
+  uint8_t  uiT;
+  z80n_t   tCpu;
+
+  /* RST 8 is trapped before it is executed: no return address is pushed */
+  setupCpu(&tCpu, &tMachine, auiEsxdos, sizeof(auiEsxdos));
+  tCpu.uiF = Z80N_FLAG_C;
+  uiT = z80nStep(&tCpu);
+  uiFail += check("RST 8 trapped",
+                  (11 == uiT) && (0x08 == tMachine.uiRstAddr) && (0x9A == tMachine.uiEsxdos) &&
+                  (STACK_ADDR == tCpu.uiSP) && (CODE_ADDR + 2 == tCpu.uiPC) && (0 == (tCpu.uiF & Z80N_FLAG_C)));
+
+  (void) z80nStep(&tCpu);
+  uiFail += check("RST 8 continues", (0x55 == tCpu.auiReg[Z80N_A]) && (CODE_ADDR + 4 == tCpu.uiPC) && (18 == tCpu.uiTStates));
+
+  /* A restart the machine doesn't handle is executed */
+  setupCpu(&tCpu, &tMachine, auiPrint, sizeof(auiPrint));
+  uiT = z80nStep(&tCpu);
+  uiFail += check("RST 0x10 executed",
+                  (11 == uiT) && (0x10 == tMachine.uiRstAddr) && (0x0010 == tCpu.uiPC) && (STACK_ADDR - 2 == tCpu.uiSP) &&
+                  (0x01 == tMachine.auiMemory[STACK_ADDR - 2]) && (0x80 == tMachine.auiMemory[STACK_ADDR - 1]));
+
+  return uiFail;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* testMachine()                                                              */
+/*----------------------------------------------------------------------------*/
+static unsigned testMachine(void)
+{
+  static machine_t tMachine;
+  static const uint8_t auiNextReg[] = {0xED, 0x91, 0x07, 0x03, 0xED, 0x92, 0x56}; /* NEXTREG 7,3; NEXTREG 0x56,A */
+  static const uint8_t auiOutInB[]  = {0xED, 0x90};                               /* OUTINB                      */
+  static const uint8_t auiPushNN[]  = {0xED, 0x8A, 0x12, 0x34};                   /* PUSH 0x1234                 */
+  unsigned uiFail = 0;
+  bool     bPassed;
+  z80n_t   tCpu;
+
+  setupCpu(&tCpu, &tMachine, auiNextReg, sizeof(auiNextReg));
+  tCpu.auiReg[Z80N_A] = 0x2A;
+  bPassed = (20 == z80nStep(&tCpu)) && (0x07 == tMachine.uiNextReg) && (0x03 == tMachine.uiNextValue);
+  bPassed = bPassed && (17 == z80nStep(&tCpu)) && (0x56 == tMachine.uiNextReg) && (0x2A == tMachine.uiNextValue);
+  uiFail += check("NEXTREG n,n; NEXTREG n,A", bPassed && (CODE_ADDR + 7 == tCpu.uiPC));
+
+  /* B is not decremented */
+  setupCpu(&tCpu, &tMachine, auiOutInB, sizeof(auiOutInB));
+  tCpu.auiReg[Z80N_B] = (uint8_t) (TEST_PORT >> 8);
+  tCpu.auiReg[Z80N_C] = (uint8_t)  TEST_PORT;
+  tCpu.auiReg[Z80N_H] = (uint8_t) (DATA_ADDR >> 8);
+  tCpu.auiReg[Z80N_L] = 0x42;
+  uiFail += check("OUTINB",
+                  (16 == z80nStep(&tCpu)) && (TEST_PORT == tMachine.uiOutPort) && (0x42 == tMachine.uiOutValue) &&
+                  (TEST_PORT == Z80N_BC(&tCpu)) && (DATA_ADDR + 0x43 == Z80N_HL(&tCpu)));
+
+  /* The operand is big endian, the stack little endian */
+  setupCpu(&tCpu, &tMachine, auiPushNN, sizeof(auiPushNN));
+  uiFail += check("PUSH nn",
+                  (23 == z80nStep(&tCpu)) && (STACK_ADDR - 2 == tCpu.uiSP) &&
+                  (0x34 == tMachine.auiMemory[STACK_ADDR - 2]) && (0x12 == tMachine.auiMemory[STACK_ADDR - 1]));
+
+  return uiFail;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* readPort()                                                                 */
+/*----------------------------------------------------------------------------*/
+static uint8_t readPort(z80n_t* pCpu, uint16_t uiPort)
+{
+  (void) pCpu;
+
+  return (TEST_PORT == uiPort) ? 0x0A : 0xFF;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* writePort()                                                                */
+/*----------------------------------------------------------------------------*/
+static void writePort(z80n_t* pCpu, uint16_t uiPort, uint8_t uiValue)
+{
+  machine_t* pMachine = (machine_t*) pCpu->pMachine;
+
+  pMachine->uiOutPort  = uiPort;
+  pMachine->uiOutValue = uiValue;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* writeNextReg()                                                             */
+/*----------------------------------------------------------------------------*/
+static void writeNextReg(z80n_t* pCpu, uint8_t uiReg, uint8_t uiValue)
+{
+  machine_t* pMachine = (machine_t*) pCpu->pMachine;
+
+  pMachine->uiNextReg   = uiReg;
+  pMachine->uiNextValue = uiValue;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* callRestart()                                                              */
+/*----------------------------------------------------------------------------*/
+static bool callRestart(z80n_t* pCpu, uint8_t uiAddr)
+{
+  machine_t* pMachine = (machine_t*) pCpu->pMachine;
+
+  pMachine->uiRstAddr = uiAddr;
+
+  if (0x08 == uiAddr) /* RST 8; DEFB function: like esxdos, no error */
+  {
+    pMachine->uiEsxdos = pCpu->pMemory[(uint16_t) (pCpu->uiPC + 1)];
+    pCpu->uiF  &= (uint8_t) ~Z80N_FLAG_C;
+    pCpu->uiPC += 2;
+    return true;
+  }
+
+  return false;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* check()                                                                    */
+/*----------------------------------------------------------------------------*/
+static unsigned check(const char* acName, bool bPassed)
+{
+  printf("%-24s: %s\n", acName, bPassed ? "ok" : "FAILED");
+
+  return bPassed ? 0 : 1;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/*                                                                            */
+/*----------------------------------------------------------------------------*/
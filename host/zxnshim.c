@@ -0,0 +1,1429 @@
+/*-----------------------------------------------------------------------------+
+|                                                                              |
+| filename: zxnshim.c                                                          |
+| project:  zxn::scrnshot                                                      |
+| author:   S. Zell                                                            |
+| date:     10/18/2026                                                         |
+|                                                                              |
++------------------------------------------------------------------------------+
+|                                                                              |
+| description:                                                                 |
+|                                                                              |
+| Host shim: emulated hardware of the Next (2 MB memory, MMU, NextRegs,        |
+| palettes, ports) and NextZXOS (files on the host file system) for the capture|
+| engine compiled for Linux                                                    |
+|                                                                              |
++------------------------------------------------------------------------------+
+|                                                                              |
+| Copyright (c) 10/18/2026 STZ Engineering                                     |
+|                                                                              |
+| This software is provided  "as is",  without warranty of any kind, express   |
+| or implied. In no event shall STZ or its contributors be held liable for any |
+| direct, indirect, incidental, special or consequential damages arising out   |
+| of the use of or inability to use this software.                             |
+|                                                                              |
+| Permission is granted to anyone  to use this  software for any purpose,      |
+| including commercial applications,  and to alter it and redistribute it      |
+| freely, subject to the following restrictions:                               |
+|                                                                              |
+| 1. Redistributions of source code must retain the above copyright            |
+|    notice, definition, disclaimer, and this list of conditions.              |
+|                                                                              |
+| 2. Redistributions in binary form must reproduce the above copyright         |
+|    notice, definition, disclaimer, and this list of conditions in            |
+|    documentation and/or other materials provided with the distribution.      |
+|                                                                          ;-) |
++-----------------------------------------------------------------------------*/
+
+/*============================================================================*/
+/*                               Includes                                     */
+/*============================================================================*/
+#define _GNU_SOURCE /* memfd_create */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <ctype.h>
+#include <errno.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <sys/mman.h>
+#include <z80.h>
+#include <intrinsic.h>
+#include <arch/zxn.h>
+#include <arch/zxn/esxdos.h>
+#include <compress/zx0.h>
+
+#include "libzxn.h"
+#include "scrnshot.h"
+#include "vstate.h"
+#include "zxnshim.h"
+
+/*============================================================================*/
+/*                               Defines                                      */
+/*============================================================================*/
+/*!
+First and last 8K page handed out by "esx_ide_bank_alloc" (above Layer 2 and
+its shadow buffer)
+*/
+#define ZXN_ALLOC_FIRST 64
+#define ZXN_ALLOC_LAST  223
+
+/*!
+Size of the Z80 address space
+*/
+#define ZXN_ADDRESS_SIZE 0x10000
+
+/*!
+CTC: 8 channels at 0x183B-0x1F3B, clocked with 28 MHz
+*/
+#define ZXN_CTC_CHANNELS 8
+#define ZXN_CTC_PORT     0x183B
+#define ZXN_CTC_CLOCK    28000000ULL
+
+/*============================================================================*/
+/*                               Type-Definitions                             */
+/*============================================================================*/
+/*!
+Open file or directory
+*/
+typedef struct _zxnfile
+{
+  bool     bUsed;
+  int      iFd;       /* File on the host; -1 = none */
+  DIR*     pDir;      /* Directory on the host       */
+  uint8_t* pData;     /* File in memory              */
+  uint32_t uiSize;
+  uint32_t uiCapacity;
+} zxnfile_t;
+
+/*============================================================================*/
+/*                               Variables                                    */
+/*============================================================================*/
+/*!
+State of the emulated hardware
+*/
+zxnstate_t g_tZxn;
+
+/*!
+Open files and directories; the index is the handle
+*/
+static zxnfile_t s_atFiles[ZXN_FILES_MAX];
+
+/*!
+Pages allocated by "esx_ide_bank_alloc"
+*/
+static bool s_abAllocated[256];
+
+/*!
+File (in memory) backing the RAM and the ROM; the slots of the address space
+are mapped onto it
+*/
+static int s_iMemFd = -1;
+
+/*!
+CTC: control word, time constant and start of the channels; the counts are
+calculated from the host clock (channel n counts the ZC/TO of channel n-1)
+*/
+static struct _zxnctc
+{
+  uint8_t  auiControl[ZXN_CTC_CHANNELS];
+  uint8_t  auiConstant[ZXN_CTC_CHANNELS];
+  bool     abLoad[ZXN_CTC_CHANNELS];     /* time constant follows */
+  bool     abRunning[ZXN_CTC_CHANNELS];
+  uint64_t uiStart;                      /* host clock (ns)       */
+} s_tCtc;
+
+/*============================================================================*/
+/*                               Prototypes                                   */
+/*============================================================================*/
+/*!
+The inline functions of "scrnshot.h" need one external definition
+*/
+extern uint8_t  rgb3_to_rgb8(uint8_t v);
+extern uint16_t rgb8_to_rgb9(const bmppaletteentry_t* p);
+
+/*!
+Returns a free entry of the file table
+@return Handle; "INV_FILE_HND" = no free entry
+*/
+static uint8_t allocFile(void);
+
+/*!
+Returns the open file of a handle
+@return Entry of the file table; "0" = invalid handle
+*/
+static zxnfile_t* getFile(uint8_t hFile);
+
+/*!
+Address of the byte at (x, y) in the ULA layout of a 6K screen at "uiBase"
+*/
+static uint16_t getUlaAddr(uint16_t uiBase, uint8_t x, uint8_t y);
+
+/*!
+Creates the RAM, the ROM and the Z80 address space (once)
+*/
+static void createMemory(void);
+
+/*!
+Maps the page of an MMU slot into the Z80 address space
+*/
+static void mapSlot(uint8_t uiSlot);
+
+/*!
+Current count of a CTC channel
+*/
+static uint8_t readCtc(uint8_t uiChannel);
+
+/*!
+Control word or time constant to a CTC channel
+*/
+static void writeCtc(uint8_t uiChannel, uint8_t uiValue);
+
+/*!
+Stops the program if interrupts are enabled while MMU2 is not bank 5: the IM1
+handler would write the system variables (0x5C00) into another page
+*/
+static void checkInterrupts(const char* acWhere);
+
+static uint16_t getU16(const uint8_t* p);
+static uint32_t getU32(const uint8_t* p);
+
+/*============================================================================*/
+/*                               Implementation                               */
+/*============================================================================*/
+
+/*----------------------------------------------------------------------------*/
+/* zxnReset()                                                                 */
+/*----------------------------------------------------------------------------*/
+void zxnReset(void)
+{
+  static const uint8_t auiMmu[8] = {0xFF, 0xFF, 10, 11, 4, 5, 0, 1};
+
+  for (uint8_t i = 0; i < ZXN_FILES_MAX; ++i)
+  {
+    if (s_atFiles[i].bUsed)
+    {
+      esx_f_close(i);
+    }
+  }
+
+  createMemory();
+
+  memset(g_tZxn.auiMemory, 0, ZXN_MEMORY_SIZE);
+  memset(g_tZxn.auiRom, 0xFF, ZXN_ROM_SIZE);
+  memset(g_tZxn.auiRegs, 0, sizeof(g_tZxn.auiRegs));
+  memset(s_abAllocated, 0, sizeof(s_abAllocated));
+  memset(&s_tCtc, 0, sizeof(s_tCtc));
+  memcpy(g_tZxn.auiMmu, auiMmu, sizeof(g_tZxn.auiMmu));
+  g_tZxn.bInterrupts = true;
+
+  for (uint8_t i = 0; i < 8; ++i)
+  {
+    mapSlot(i);
+  }
+
+  g_tZxn.auiRegs[0x12] = 8;     /* Layer 2: bank 8     */
+  g_tZxn.auiRegs[0x13] = 11;    /* shadow: bank 11     */
+  g_tZxn.auiRegs[0x14] = 0xE3;  /* transparent colour  */
+  g_tZxn.auiRegs[0x4A] = 0xE3;  /* fallback colour     */
+  g_tZxn.auiRegs[0x4B] = 0xE3;  /* sprite transparency */
+
+  for (uint8_t i = 0; i < 4; ++i)
+  {
+    g_tZxn.aauiClip[i][0] = 0;
+    g_tZxn.aauiClip[i][1] = (3 == i ? 159 : 255);
+    g_tZxn.aauiClip[i][2] = 0;
+    g_tZxn.aauiClip[i][3] = (3 == i ? 255 : 191);
+  }
+
+  g_tZxn.uiClipIndex   = 0;
+  g_tZxn.bPaletteValue = false;
+  g_tZxn.uiPortFF      = 0;
+  g_tZxn.uiPort123B    = 0;
+  g_tZxn.uiMode        = 0xFF;
+
+  /* ULA: Spectrum colours (INK 0 - 15, PAPER 16 - 31); others: RRRGGGBB */
+  for (uint16_t i = 0; i < 256; ++i)
+  {
+    uint8_t  uiLevel  = (i & 0x08) ? 0x07 : 0x05;
+    uint16_t uiColour = 0;
+
+    uiColour |= (i & 0x02) ? (uiLevel << 6) : 0;  /* red   */
+    uiColour |= (i & 0x04) ? (uiLevel << 3) : 0;  /* green */
+    uiColour |= (i & 0x01) ? uiLevel        : 0;  /* blue  */
+
+    for (uint8_t uiPal = 0; uiPal < 8; ++uiPal)
+    {
+      g_tZxn.aauiPalette[uiPal][i] = (0 == (uiPal & 0x03)) ?
+                                     uiColour :
+                                     (uint16_t) ((i << 1) | ((i & 0x03) ? 1 : 0));
+    }
+  }
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* zxnLoadMemory()                                                            */
+/*----------------------------------------------------------------------------*/
+int zxnLoadMemory(const char* acPathName)
+{
+  FILE* hFile;
+  int   iReturn = EOK;
+
+  if (0 == (hFile = fopen(acPathName, "rb")))
+  {
+    fprintf(stderr, "%s: %s\n", acPathName, strerror(errno));
+    return EBADF;
+  }
+
+  (void) fread(g_tZxn.auiMemory, 1, ZXN_MEMORY_SIZE, hFile);
+
+  if (ferror(hFile))
+  {
+    fprintf(stderr, "%s: %s\n", acPathName, strerror(errno));
+    iReturn = EBADF;
+  }
+
+  fclose(hFile);
+
+  return iReturn;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* zxnLoadState()                                                             */
+/*----------------------------------------------------------------------------*/
+int zxnLoadState(const char* acPathName, uint8_t* pMode)
+{
+  FILE*    hFile;
+  uint8_t  auiHeader[8];
+  uint8_t  auiChunk[8];
+  uint8_t  auiData[ZXN_PAGE_SIZE];
+  uint16_t uiChunks;
+  int      iReturn = EOK;
+
+  if (0 == (hFile = fopen(acPathName, "rb")))
+  {
+    fprintf(stderr, "%s: %s\n", acPathName, strerror(errno));
+    return EBADF;
+  }
+
+  if ((1 != fread(auiHeader, sizeof(auiHeader), 1, hFile)) ||
+      (0 != memcmp(auiHeader, VSTATE_MAGIC, 4)) ||
+      (VSTATE_VERSION != auiHeader[4]))
+  {
+    fprintf(stderr, "%s: no video state\n", acPathName);
+    fclose(hFile);
+    return ENOTSUP;
+  }
+
+  if (0 != pMode)
+  {
+    *pMode = auiHeader[5];
+  }
+
+  uiChunks = getU16(&auiHeader[6]);
+
+  for (uint16_t i = 0; (EOK == iReturn) && (i < uiChunks); ++i)
+  {
+    uint32_t uiSize;
+
+    if (1 != fread(auiChunk, sizeof(auiChunk), 1, hFile))
+    {
+      iReturn = EBADF;
+      break;
+    }
+
+    if ((sizeof(auiData) < (uiSize = getU32(&auiChunk[4]))) ||
+        ((0 < uiSize) && (1 != fread(auiData, uiSize, 1, hFile))))
+    {
+      iReturn = EBADF;
+      break;
+    }
+
+    switch (auiChunk[0])
+    {
+      case VSTATE_CHUNK_REGS:
+        memcpy(g_tZxn.auiRegs, auiData, uiSize < sizeof(g_tZxn.auiRegs) ? uiSize : sizeof(g_tZxn.auiRegs));
+        break;
+
+      case VSTATE_CHUNK_CLIP:
+        memcpy(g_tZxn.aauiClip, auiData, uiSize < sizeof(g_tZxn.aauiClip) ? uiSize : sizeof(g_tZxn.aauiClip));
+        break;
+
+      case VSTATE_CHUNK_PALETTE:
+        for (uint16_t j = 0; (j < 256) && (((uint32_t) 2 * j + 1) < uiSize); ++j)
+        {
+          uint8_t uiValue8  = auiData[2 * j];
+          uint8_t uiValue16 = auiData[2 * j + 1];
+
+          g_tZxn.aauiPalette[auiChunk[1] & 0x07][j] = (uint16_t) ((uiValue8 << 1) | (uiValue16 & 0x01) | ((uiValue16 & 0x80) ? 0x8000 : 0));
+        }
+        break;
+
+      case VSTATE_CHUNK_PORTS:
+        for (uint32_t j = 0; (j + 2) < uiSize; j += 3)
+        {
+          switch (getU16(&auiData[j]))
+          {
+            case 0x00FF: g_tZxn.uiPortFF   = auiData[j + 2]; break;
+            case 0x123B: g_tZxn.uiPort123B = auiData[j + 2]; break;
+            default:     break;
+          }
+        }
+        break;
+
+      case VSTATE_CHUNK_PAGE:
+        memcpy(&g_tZxn.auiMemory[((uint32_t) auiChunk[1]) * ZXN_PAGE_SIZE], auiData, uiSize);
+        break;
+
+      default:
+        break; /* unknown chunk: skipped */
+    }
+  }
+
+  if (EOK != iReturn)
+  {
+    fprintf(stderr, "%s: truncated\n", acPathName);
+  }
+
+  /* NREG 0x1C: indices of the clip windows */
+  g_tZxn.uiClipIndex = g_tZxn.auiRegs[0x1C];
+
+  fclose(hFile);
+
+  return iReturn;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* zxnGetScreenMode()                                                         */
+/*----------------------------------------------------------------------------*/
+uint8_t zxnGetScreenMode(void)
+{
+  if (0xFF != g_tZxn.uiMode)
+  {
+    return g_tZxn.uiMode;
+  }
+
+  /* Layer 2 enabled: resolution (NREG 0x70 bits 5-4) */
+  if ((g_tZxn.auiRegs[0x69] & 0x80) || (g_tZxn.uiPort123B & 0x02))
+  {
+    switch (g_tZxn.auiRegs[0x70] & 0x30)
+    {
+      case 0x10: return 0x22;
+      case 0x20: return 0x23;
+      default:   return 0x20;
+    }
+  }
+
+  /* LoRes (NREG 0x15 bit 7) */
+  if (g_tZxn.auiRegs[0x15] & 0x80)
+  {
+    return 0x10;
+  }
+
+  /* Timex modes (port 0xFF bits 2-0) */
+  switch (g_tZxn.uiPortFF & 0x07)
+  {
+    case 0x02: return 0x13;
+    case 0x06: return 0x12;
+    default:   return 0x00;
+  }
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* zxnOpenMemoryFile()                                                        */
+/*----------------------------------------------------------------------------*/
+uint8_t zxnOpenMemoryFile(void)
+{
+  uint8_t hFile = allocFile();
+
+  if (INV_FILE_HND != hFile)
+  {
+    s_atFiles[hFile].uiCapacity = 0x10000;
+
+    if (0 == (s_atFiles[hFile].pData = malloc(s_atFiles[hFile].uiCapacity)))
+    {
+      s_atFiles[hFile].bUsed = false;
+      hFile = INV_FILE_HND;
+    }
+  }
+
+  return hFile;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* zxnGetMemoryFile()                                                         */
+/*----------------------------------------------------------------------------*/
+const uint8_t* zxnGetMemoryFile(uint8_t hFile, uint32_t* pSize)
+{
+  zxnfile_t* pFile = getFile(hFile);
+
+  if ((0 == pFile) || (0 == pFile->pData))
+  {
+    return 0;
+  }
+
+  *pSize = pFile->uiSize;
+
+  return pFile->pData;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* allocFile()                                                                */
+/*----------------------------------------------------------------------------*/
+static uint8_t allocFile(void)
+{
+  for (uint8_t i = 0; i < ZXN_FILES_MAX; ++i)
+  {
+    if (!s_atFiles[i].bUsed)
+    {
+      memset(&s_atFiles[i], 0, sizeof(s_atFiles[i]));
+      s_atFiles[i].bUsed = true;
+      s_atFiles[i].iFd   = -1;
+      return i;
+    }
+  }
+
+  return INV_FILE_HND;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* getFile()                                                                  */
+/*----------------------------------------------------------------------------*/
+static zxnfile_t* getFile(uint8_t hFile)
+{
+  return ((ZXN_FILES_MAX > hFile) && s_atFiles[hFile].bUsed) ? &s_atFiles[hFile] : 0;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* getUlaAddr()                                                               */
+/*----------------------------------------------------------------------------*/
+static uint16_t getUlaAddr(uint16_t uiBase, uint8_t x, uint8_t y)
+{
+  return uiBase + ((y & 0xC0) << 5) + ((y & 0x07) << 8) + ((y & 0x38) << 2) + (x >> 3);
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* createMemory()                                                             */
+/*----------------------------------------------------------------------------*/
+static void createMemory(void)
+{
+  uint8_t* pReserved;
+
+  if (0 <= s_iMemFd)
+  {
+    return;
+  }
+
+  /* RAM and ROM are one file, so a page can be mapped into several slots */
+  if ((0 > (s_iMemFd = memfd_create("zxnmemory", 0))) ||
+      (0 != ftruncate(s_iMemFd, ZXN_MEMORY_SIZE + ZXN_ROM_SIZE)) ||
+      (MAP_FAILED == (g_tZxn.auiMemory = mmap(0, ZXN_MEMORY_SIZE + ZXN_ROM_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, s_iMemFd, 0))))
+  {
+    perror("zxnmemory");
+    exit(EXIT_FAILURE);
+  }
+
+  g_tZxn.auiRom = g_tZxn.auiMemory + ZXN_MEMORY_SIZE;
+
+  /* Address space aligned to 64K: (uint16_t) pointer = Z80 address */
+  if (MAP_FAILED == (pReserved = mmap(0, 2 * ZXN_ADDRESS_SIZE, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0)))
+  {
+    perror("zxnmemory");
+    exit(EXIT_FAILURE);
+  }
+
+  g_tZxn.pAddress = (uint8_t*) ((((uintptr_t) pReserved) + ZXN_ADDRESS_SIZE - 1) & ~((uintptr_t) ZXN_ADDRESS_SIZE - 1));
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* mapSlot()                                                                  */
+/*----------------------------------------------------------------------------*/
+static void mapSlot(uint8_t uiSlot)
+{
+  uint8_t uiPage = g_tZxn.auiMmu[uiSlot];
+  off_t   uiOffset;
+
+  /* Page 0xFF: ROM in MMU0/1 (the 16K ROM is repeated in the other slots) */
+  if (0xFF == uiPage)
+  {
+    uiOffset = ZXN_MEMORY_SIZE + (uiSlot & 0x01) * ZXN_PAGE_SIZE;
+  }
+  else
+  {
+    uiOffset = ((off_t) uiPage) * ZXN_PAGE_SIZE;
+  }
+
+  if (MAP_FAILED == mmap(g_tZxn.pAddress + uiSlot * ZXN_PAGE_SIZE, ZXN_PAGE_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, s_iMemFd, uiOffset))
+  {
+    perror("zxnmemory");
+    exit(EXIT_FAILURE);
+  }
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* checkInterrupts()                                                          */
+/*----------------------------------------------------------------------------*/
+static void checkInterrupts(const char* acWhere)
+{
+  if (g_tZxn.bInterrupts && (10 != g_tZxn.auiMmu[2]))
+  {
+    fprintf(stderr, "zxnshim: %s: interrupts enabled with page %u in MMU2\n", acWhere, g_tZxn.auiMmu[2]);
+    abort();
+  }
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* readCtc()                                                                  */
+/*----------------------------------------------------------------------------*/
+static uint8_t readCtc(uint8_t uiChannel)
+{
+  struct timespec tNow;
+  uint64_t uiClocks;
+  uint64_t uiPulses = 0;
+  uint64_t uiCount  = 0;
+
+  clock_gettime(CLOCK_MONOTONIC, &tNow);
+  uiClocks = ((((uint64_t) tNow.tv_sec) * 1000000000ULL + tNow.tv_nsec) - s_tCtc.uiStart) * ZXN_CTC_CLOCK / 1000000000ULL;
+
+  /* Down counters of the chain up to the channel */
+  for (uint8_t i = 0; i <= uiChannel; ++i)
+  {
+    uint32_t uiConstant = (0 != s_tCtc.auiConstant[i] ? s_tCtc.auiConstant[i] : 256);
+
+    if (!s_tCtc.abRunning[i])
+    {
+      return s_tCtc.auiConstant[i];
+    }
+
+    if (0 == (s_tCtc.auiControl[i] & 0x40)) /* timer: prescaler 16 or 256 */
+    {
+      uiCount = uiClocks / ((s_tCtc.auiControl[i] & 0x20) ? 256 : 16);
+    }
+    else                                    /* counter: ZC/TO of n-1      */
+    {
+      uiCount = uiPulses;
+    }
+
+    uiPulses = uiCount / uiConstant;
+    uiCount  = uiConstant - (uiCount % uiConstant);
+  }
+
+  return (uint8_t) uiCount;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* writeCtc()                                                                 */
+/*----------------------------------------------------------------------------*/
+static void writeCtc(uint8_t uiChannel, uint8_t uiValue)
+{
+  if (s_tCtc.abLoad[uiChannel])
+  {
+    s_tCtc.auiConstant[uiChannel] = uiValue;
+    s_tCtc.abLoad[uiChannel]      = false;
+    s_tCtc.abRunning[uiChannel]   = true;
+
+    if (0 == (s_tCtc.auiControl[uiChannel] & 0x40))
+    {
+      struct timespec tNow;
+
+      clock_gettime(CLOCK_MONOTONIC, &tNow);
+      s_tCtc.uiStart = ((uint64_t) tNow.tv_sec) * 1000000000ULL + tNow.tv_nsec;
+    }
+  }
+  else if (0 != (uiValue & 0x01)) /* control word */
+  {
+    s_tCtc.auiControl[uiChannel] = uiValue;
+    s_tCtc.abLoad[uiChannel]     = (0 != (uiValue & 0x04));
+
+    if (0 != (uiValue & 0x02))    /* software reset */
+    {
+      s_tCtc.abRunning[uiChannel] = false;
+    }
+  }
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* getU16()                                                                   */
+/*----------------------------------------------------------------------------*/
+static uint16_t getU16(const uint8_t* p)
+{
+  return (uint16_t) (p[0] | (p[1] << 8));
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* getU32()                                                                   */
+/*----------------------------------------------------------------------------*/
+static uint32_t getU32(const uint8_t* p)
+{
+  return ((uint32_t) getU16(p)) | (((uint32_t) getU16(p + 2)) << 16);
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* ZXN_READ_REG()                                                             */
+/*----------------------------------------------------------------------------*/
+uint8_t ZXN_READ_REG(uint8_t uiReg)
+{
+  const uint16_t* pPalette = g_tZxn.aauiPalette[(g_tZxn.auiRegs[REG_PALETTE_CONTROL] >> 4) & 0x07];
+  uint8_t uiIndex = g_tZxn.auiRegs[REG_PALETTE_INDEX];
+
+  switch (uiReg)
+  {
+    case 0x18:
+    case 0x19:
+    case 0x1A:
+    case 0x1B:
+      return g_tZxn.aauiClip[uiReg - 0x18][(g_tZxn.uiClipIndex >> ((uiReg - 0x18) << 1)) & 0x03];
+
+    case 0x1C:
+      return g_tZxn.uiClipIndex;
+
+    case REG_PALETTE_VALUE_8:
+      return (uint8_t) (pPalette[uiIndex] >> 1);
+
+    case REG_PALETTE_VALUE_16:
+      return (uint8_t) ((pPalette[uiIndex] & 0x01) | ((pPalette[uiIndex] & 0x8000) ? 0x80 : 0x00));
+
+    case 0x50:
+    case 0x51:
+    case 0x52:
+    case 0x53:
+    case 0x54:
+    case 0x55:
+    case 0x56:
+    case 0x57:
+      return g_tZxn.auiMmu[uiReg - 0x50];
+
+    case 0x69:
+      return (g_tZxn.auiRegs[0x69] & 0xC0) | (g_tZxn.uiPortFF & 0x3F);
+
+    default:
+      return g_tZxn.auiRegs[uiReg];
+  }
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* ZXN_WRITE_REG()                                                            */
+/*----------------------------------------------------------------------------*/
+void ZXN_WRITE_REG(uint8_t uiReg, uint8_t uiValue)
+{
+  uint16_t* pPalette = g_tZxn.aauiPalette[(g_tZxn.auiRegs[REG_PALETTE_CONTROL] >> 4) & 0x07];
+  uint8_t*  pIndex   = &g_tZxn.auiRegs[REG_PALETTE_INDEX];
+  bool      bAutoInc = (0 == (g_tZxn.auiRegs[REG_PALETTE_CONTROL] & 0x80));
+
+  switch (uiReg)
+  {
+    case 0x18:
+    case 0x19:
+    case 0x1A:
+    case 0x1B:
+    {
+      uint8_t uiShift = (uiReg - 0x18) << 1;
+      uint8_t uiClip  = (g_tZxn.uiClipIndex >> uiShift) & 0x03;
+
+      g_tZxn.aauiClip[uiReg - 0x18][uiClip] = uiValue;
+      g_tZxn.uiClipIndex = (g_tZxn.uiClipIndex & ~(0x03 << uiShift)) | (((uiClip + 1) & 0x03) << uiShift);
+      break;
+    }
+
+    case 0x1C:
+      for (uint8_t i = 0; i < 4; ++i)
+      {
+        if (uiValue & (1 << i))
+        {
+          g_tZxn.uiClipIndex &= ~(0x03 << (i << 1));
+        }
+      }
+      break;
+
+    case REG_PALETTE_INDEX:
+      *pIndex = uiValue;
+      g_tZxn.bPaletteValue = false;
+      break;
+
+    case REG_PALETTE_VALUE_8:
+      /* RRRGGGBB; the lowest bit of blue is the OR of the two others */
+      pPalette[*pIndex] = (uint16_t) ((uiValue << 1) | ((uiValue & 0x03) ? 1 : 0));
+      *pIndex += (bAutoInc ? 1 : 0);
+      g_tZxn.bPaletteValue = false;
+      break;
+
+    case REG_PALETTE_VALUE_16:
+      if (!g_tZxn.bPaletteValue)
+      {
+        g_tZxn.uiPaletteValue = uiValue;
+        g_tZxn.bPaletteValue  = true;
+      }
+      else
+      {
+        pPalette[*pIndex] = (uint16_t) ((g_tZxn.uiPaletteValue << 1) | (uiValue & 0x01) | ((uiValue & 0x80) ? 0x8000 : 0));
+        *pIndex += (bAutoInc ? 1 : 0);
+        g_tZxn.bPaletteValue = false;
+      }
+      break;
+
+    case REG_PALETTE_CONTROL:
+      g_tZxn.auiRegs[uiReg] = uiValue;
+      g_tZxn.bPaletteValue  = false;
+      break;
+
+    case 0x50:
+    case 0x51:
+    case 0x52:
+    case 0x53:
+    case 0x54:
+    case 0x55:
+    case 0x56:
+    case 0x57:
+      g_tZxn.auiMmu[uiReg - 0x50] = uiValue;
+      mapSlot(uiReg - 0x50);
+      break;
+
+    case 0x69:
+      g_tZxn.auiRegs[0x69] = uiValue;
+      g_tZxn.uiPortFF      = (g_tZxn.uiPortFF & 0xC0) | (uiValue & 0x3F);
+      break;
+
+    default:
+      g_tZxn.auiRegs[uiReg] = uiValue;
+  }
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* zxn_read_mmu()                                                             */
+/*----------------------------------------------------------------------------*/
+uint8_t zxn_read_mmu(uint8_t uiSlot)
+{
+  return g_tZxn.auiMmu[uiSlot & 0x07];
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* zxn_write_mmu()                                                            */
+/*----------------------------------------------------------------------------*/
+void zxn_write_mmu(uint8_t uiSlot, uint8_t uiPage)
+{
+  g_tZxn.auiMmu[uiSlot & 0x07] = uiPage;
+  mapSlot(uiSlot & 0x07);
+
+  if (2 == (uiSlot & 0x07))
+  {
+    checkInterrupts("MMU2");
+  }
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* intrinsic_di()                                                             */
+/*----------------------------------------------------------------------------*/
+void intrinsic_di(void)
+{
+  g_tZxn.bInterrupts = false;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* intrinsic_ei()                                                             */
+/*----------------------------------------------------------------------------*/
+void intrinsic_ei(void)
+{
+  g_tZxn.bInterrupts = true;
+  checkInterrupts("EI");
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* zxn_memmap()                                                               */
+/*----------------------------------------------------------------------------*/
+void* zxn_memmap(uint16_t uiAddr)
+{
+  return g_tZxn.pAddress + uiAddr;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* zxn_radastan_mode()                                                        */
+/*----------------------------------------------------------------------------*/
+bool zxn_radastan_mode(void)
+{
+  return 0 != (g_tZxn.auiRegs[0x6A] & 0x20);
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* zxn_getspeed()                                                             */
+/*----------------------------------------------------------------------------*/
+uint8_t zxn_getspeed(void)
+{
+  return g_tZxn.auiRegs[0x07] & 0x03;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* zxn_setspeed()                                                             */
+/*----------------------------------------------------------------------------*/
+void zxn_setspeed(uint8_t uiSpeed)
+{
+  g_tZxn.auiRegs[0x07] = uiSpeed & 0x03;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* zxn_strerror()                                                             */
+/*----------------------------------------------------------------------------*/
+int zxn_strerror(int iCode)
+{
+  fprintf(stderr, "%s\n", ESTAT == iCode ? "invalid state" : strerror(iCode));
+  return iCode;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* zx_pxy2saddr()                                                             */
+/*----------------------------------------------------------------------------*/
+uint8_t* zx_pxy2saddr(uint8_t x, uint8_t y)
+{
+  return (uint8_t*) zxn_memmap(getUlaAddr(0x4000, x, y));
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* zx_cxy2aaddr()                                                             */
+/*----------------------------------------------------------------------------*/
+uint8_t* zx_cxy2aaddr(uint8_t x, uint8_t y)
+{
+  return (uint8_t*) zxn_memmap(0x5800 + (((uint16_t) y) << 5) + x);
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* zxn_pixelad()                                                              */
+/*----------------------------------------------------------------------------*/
+uint8_t* zxn_pixelad(uint8_t x, uint8_t y)
+{
+  return (uint8_t*) zxn_memmap(getUlaAddr(0x4000, x, y));
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* tshr_pxy2saddr()                                                           */
+/*----------------------------------------------------------------------------*/
+uint8_t* tshr_pxy2saddr(uint16_t x, uint8_t y)
+{
+  /* Columns of 8 pixels: even ones at 0x4000, odd ones at 0x6000 */
+  uint8_t uiCol = (uint8_t) (x >> 3);
+
+  return (uint8_t*) zxn_memmap(getUlaAddr((uiCol & 0x01) ? 0x6000 : 0x4000, (uiCol >> 1) << 3, y));
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* tshc_py2saddr()                                                            */
+/*----------------------------------------------------------------------------*/
+uint8_t* tshc_py2saddr(uint8_t y)
+{
+  return (uint8_t*) zxn_memmap(getUlaAddr(0x4000, 0, y));
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* tshc_py2aaddr()                                                            */
+/*----------------------------------------------------------------------------*/
+uint8_t* tshc_py2aaddr(uint8_t y)
+{
+  return (uint8_t*) zxn_memmap(getUlaAddr(0x6000, 0, y));
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* tshc_saddr2aaddr()                                                         */
+/*----------------------------------------------------------------------------*/
+uint8_t* tshc_saddr2aaddr(void* pAddr)
+{
+  return ((uint8_t*) pAddr) + 0x2000;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* z80_inp()                                                                  */
+/*----------------------------------------------------------------------------*/
+uint8_t z80_inp(uint16_t uiPort)
+{
+  switch (uiPort)
+  {
+    case 0x00FF:
+      return g_tZxn.uiPortFF;
+
+    case 0x123B:
+      return g_tZxn.uiPort123B;
+
+    default:
+      if ((0x3B == (uiPort & 0xFF)) && (uiPort >= ZXN_CTC_PORT) && (uiPort < (ZXN_CTC_PORT + (ZXN_CTC_CHANNELS << 8))))
+      {
+        return readCtc((uint8_t) ((uiPort - ZXN_CTC_PORT) >> 8));
+      }
+      return 0xFF;
+  }
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* z80_outp()                                                                 */
+/*----------------------------------------------------------------------------*/
+void z80_outp(uint16_t uiPort, uint8_t uiValue)
+{
+  switch (uiPort)
+  {
+    case 0x00FF:
+      g_tZxn.uiPortFF = uiValue;
+      break;
+
+    case 0x123B:
+      g_tZxn.uiPort123B = uiValue;
+      break;
+
+    default:
+      if ((0x3B == (uiPort & 0xFF)) && (uiPort >= ZXN_CTC_PORT) && (uiPort < (ZXN_CTC_PORT + (ZXN_CTC_CHANNELS << 8))))
+      {
+        writeCtc((uint8_t) ((uiPort - ZXN_CTC_PORT) >> 8), uiValue);
+      }
+      break;
+  }
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* esx_f_open()                                                               */
+/*----------------------------------------------------------------------------*/
+uint8_t esx_f_open(const char* acPathName, uint8_t uiMode)
+{
+  uint8_t hFile = allocFile();
+  int iFlags;
+
+  if (INV_FILE_HND == hFile)
+  {
+    return INV_FILE_HND;
+  }
+
+  switch (uiMode & (ESXDOS_MODE_R | ESXDOS_MODE_W))
+  {
+    case ESXDOS_MODE_W:                 iFlags = O_WRONLY; break;
+    case ESXDOS_MODE_R | ESXDOS_MODE_W: iFlags = O_RDWR;   break;
+    default:                            iFlags = O_RDONLY;
+  }
+
+  switch (uiMode & ESXDOS_MODE_CT)
+  {
+    case ESXDOS_MODE_CN: iFlags |= O_CREAT | O_EXCL;  break;
+    case ESXDOS_MODE_OC: iFlags |= O_CREAT;           break;
+    case ESXDOS_MODE_CT: iFlags |= O_CREAT | O_TRUNC; break;
+    default:             break;
+  }
+
+  if (0 > (s_atFiles[hFile].iFd = open(acPathName, iFlags, 0644)))
+  {
+    s_atFiles[hFile].bUsed = false;
+    return INV_FILE_HND;
+  }
+
+  return hFile;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* esx_f_opendir()                                                            */
+/*----------------------------------------------------------------------------*/
+uint8_t esx_f_opendir(const char* acPathName)
+{
+  uint8_t hDir = allocFile();
+
+  if ((INV_FILE_HND != hDir) && (0 == (s_atFiles[hDir].pDir = opendir(acPathName))))
+  {
+    s_atFiles[hDir].bUsed = false;
+    hDir = INV_FILE_HND;
+  }
+
+  return hDir;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* esx_f_close()                                                              */
+/*----------------------------------------------------------------------------*/
+uint8_t esx_f_close(uint8_t hFile)
+{
+  zxnfile_t* pFile = getFile(hFile);
+
+  if (0 == pFile)
+  {
+    return EBADF;
+  }
+
+  if (0 <= pFile->iFd)
+  {
+    close(pFile->iFd);
+  }
+
+  if (0 != pFile->pDir)
+  {
+    closedir(pFile->pDir);
+  }
+
+  free(pFile->pData);
+  memset(pFile, 0, sizeof(*pFile));
+
+  return EOK;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* esx_f_closedir()                                                           */
+/*----------------------------------------------------------------------------*/
+uint8_t esx_f_closedir(uint8_t hDir)
+{
+  return esx_f_close(hDir);
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* esx_f_unlink()                                                             */
+/*----------------------------------------------------------------------------*/
+uint8_t esx_f_unlink(const char* acPathName)
+{
+  return (0 == unlink(acPathName)) ? EOK : EACCES;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* esx_f_write()                                                              */
+/*----------------------------------------------------------------------------*/
+uint16_t esx_f_write(uint8_t hFile, const void* pData, uint16_t uiLen)
+{
+  zxnfile_t* pFile = getFile(hFile);
+
+  if (0 == pFile)
+  {
+    return 0;
+  }
+
+  if (0 != pFile->pData)
+  {
+    if (pFile->uiCapacity < (pFile->uiSize + uiLen))
+    {
+      uint8_t* pNew = realloc(pFile->pData, (pFile->uiCapacity << 1) + uiLen);
+
+      if (0 == pNew)
+      {
+        return 0;
+      }
+
+      pFile->pData       = pNew;
+      pFile->uiCapacity  = (pFile->uiCapacity << 1) + uiLen;
+    }
+
+    memcpy(pFile->pData + pFile->uiSize, pData, uiLen);
+    pFile->uiSize += uiLen;
+
+    return uiLen;
+  }
+
+  ssize_t iLen = write(pFile->iFd, pData, uiLen);
+
+  return (0 > iLen) ? 0 : (uint16_t) iLen;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* esx_f_read()                                                               */
+/*----------------------------------------------------------------------------*/
+uint16_t esx_f_read(uint8_t hFile, void* pData, uint16_t uiLen)
+{
+  zxnfile_t* pFile = getFile(hFile);
+  ssize_t iLen;
+
+  if ((0 == pFile) || (0 > pFile->iFd))
+  {
+    return 0;
+  }
+
+  iLen = read(pFile->iFd, pData, uiLen);
+
+  return (0 > iLen) ? 0 : (uint16_t) iLen;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* esx_f_seek()                                                               */
+/*----------------------------------------------------------------------------*/
+uint32_t esx_f_seek(uint8_t hFile, uint32_t uiOffset, uint8_t uiWhence)
+{
+  zxnfile_t* pFile = getFile(hFile);
+  off_t iPos;
+
+  if ((0 == pFile) || (0 > pFile->iFd))
+  {
+    return 0xFFFFFFFF;
+  }
+
+  switch (uiWhence)
+  {
+    case ESX_SEEK_FWD: iPos = lseek(pFile->iFd, (off_t) uiOffset, SEEK_CUR);    break;
+    case ESX_SEEK_BWD: iPos = lseek(pFile->iFd, -((off_t) uiOffset), SEEK_CUR); break;
+    default:           iPos = lseek(pFile->iFd, (off_t) uiOffset, SEEK_SET);
+  }
+
+  return (0 > iPos) ? 0xFFFFFFFF : (uint32_t) iPos;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* esx_f_fgetpos()                                                            */
+/*----------------------------------------------------------------------------*/
+uint32_t esx_f_fgetpos(uint8_t hFile)
+{
+  zxnfile_t* pFile = getFile(hFile);
+
+  if (0 == pFile)
+  {
+    return 0;
+  }
+
+  return (0 != pFile->pData) ? pFile->uiSize : (uint32_t) lseek(pFile->iFd, 0, SEEK_CUR);
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* esx_f_getcwd()                                                             */
+/*----------------------------------------------------------------------------*/
+uint8_t esx_f_getcwd(char* acPathName)
+{
+  return (0 != getcwd(acPathName, ESX_PATHNAME_MAX)) ? EOK : EACCES;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* esx_m_dosversion()                                                         */
+/*----------------------------------------------------------------------------*/
+uint16_t esx_m_dosversion(void)
+{
+  return 0x0207; /* NextZXOS 2.07 */
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* esx_m_getdate()                                                            */
+/*----------------------------------------------------------------------------*/
+uint8_t esx_m_getdate(struct dos_tm* pTime)
+{
+  time_t tNow = time(0);
+  struct tm* pNow = localtime(&tNow);
+
+  pTime->time = (uint16_t) ((pNow->tm_hour << 11) | (pNow->tm_min << 5) | (pNow->tm_sec >> 1));
+  pTime->date = (uint16_t) (((pNow->tm_year - 80) << 9) | ((pNow->tm_mon + 1) << 5) | pNow->tm_mday);
+
+  return EOK;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* esx_ide_mode_get()                                                         */
+/*----------------------------------------------------------------------------*/
+uint8_t esx_ide_mode_get(struct esx_mode* pMode)
+{
+  uint8_t uiMode = zxnGetScreenMode();
+
+  pMode->mode8.layer   = uiMode >> 4;
+  pMode->mode8.submode = uiMode & 0x0F;
+  pMode->cols          = 32;
+  pMode->rows          = 24;
+
+  return 0;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* esx_ide_bank_alloc()                                                       */
+/*----------------------------------------------------------------------------*/
+uint8_t esx_ide_bank_alloc(uint8_t uiType)
+{
+  (void) uiType;
+
+  for (uint16_t i = ZXN_ALLOC_FIRST; i <= ZXN_ALLOC_LAST; ++i)
+  {
+    if (!s_abAllocated[i])
+    {
+      s_abAllocated[i] = true;
+      return (uint8_t) i;
+    }
+  }
+
+  return 0xFF;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* esx_ide_bank_free()                                                        */
+/*----------------------------------------------------------------------------*/
+uint8_t esx_ide_bank_free(uint8_t uiType, uint8_t uiPage)
+{
+  (void) uiType;
+  s_abAllocated[uiPage] = false;
+
+  return EOK;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* stricmp()                                                                  */
+/*----------------------------------------------------------------------------*/
+int stricmp(const char_t* acStr1, const char_t* acStr2)
+{
+  return strcasecmp(acStr1, acStr2);
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* strnicmp()                                                                 */
+/*----------------------------------------------------------------------------*/
+int strnicmp(const char_t* acStr1, const char_t* acStr2, unsigned uiLen)
+{
+  return strncasecmp(acStr1, acStr2, uiLen);
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* strupr()                                                                   */
+/*----------------------------------------------------------------------------*/
+char* strupr(char_t* acStr)
+{
+  for (char_t* p = acStr; 0 != *p; ++p)
+  {
+    *p = (char_t) toupper((unsigned char) *p);
+  }
+
+  return acStr;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* ultoa()                                                                    */
+/*----------------------------------------------------------------------------*/
+char* ultoa(unsigned long uiValue, char* acBuffer, int iRadix)
+{
+  char  acDigits[33];
+  char* p = &acDigits[sizeof(acDigits) - 1];
+  char* q = acBuffer;
+
+  *p = 0;
+
+  do
+  {
+    *--p = "0123456789abcdefghijklmnopqrstuvwxyz"[uiValue % iRadix];
+    uiValue /= iRadix;
+  } while (0 != uiValue);
+
+  while (0 != (*q++ = *p++))
+  {
+  }
+
+  return acBuffer;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* dzx0_standard()                                                            */
+/*----------------------------------------------------------------------------*/
+void* dzx0_standard(void* pSrc, void* pDst)
+{
+  const uint8_t* s = (const uint8_t*) pSrc;
+  uint8_t* d = (uint8_t*) pDst;
+  uint8_t  uiMask = 0;
+  uint8_t  uiBits = 0;
+  uint8_t  uiLast = 0;
+  bool     bBacktrack = false;
+  uint32_t uiOffset = 1;
+  uint32_t uiLen;
+
+  /* Next bit of the stream; after a new offset the first bit is taken from
+     the offset byte ("backtrack") */
+  #define ZX0_BIT() (bBacktrack ? (bBacktrack = false, uiLast & 1) :                \
+                     ((uiMask >>= 1) ? (0 != (uiBits & uiMask)) :                  \
+                      (uiMask = 0x80, uiBits = *s++, 0 != (uiBits & 0x80))))
+
+  /* Interlaced Elias gamma code */
+  #define ZX0_GAMMA(v, inv) do { (v) = 1; while (!ZX0_BIT()) { (v) = ((v) << 1) | (ZX0_BIT() ^ (inv)); } } while (0)
+
+  /* Literals first */
+  ZX0_GAMMA(uiLen, 0);
+  while (uiLen--) { *d++ = *s++; }
+
+  for (;;)
+  {
+    /* After literals: 0 = match with the last offset, 1 = new offset */
+    if (!ZX0_BIT())
+    {
+      ZX0_GAMMA(uiLen, 0);
+      for (; uiLen--; ++d) { *d = *(d - uiOffset); }
+
+      /* After a match with the last offset: 0 = literals, 1 = new offset */
+      if (!ZX0_BIT())
+      {
+        ZX0_GAMMA(uiLen, 0);
+        while (uiLen--) { *d++ = *s++; }
+        continue;
+      }
+    }
+
+    /* Matches with a new offset, as long as the following bit is 1 */
+    do
+    {
+      ZX0_GAMMA(uiOffset, 1);
+
+      if (256 == uiOffset)
+      {
+        return d; /* end marker */
+      }
+
+      uiLast     = *s++;
+      uiOffset   = (uiOffset << 7) - (uiLast >> 1);
+      bBacktrack = true;
+
+      ZX0_GAMMA(uiLen, 0);
+      for (++uiLen; uiLen--; ++d) { *d = *(d - uiOffset); }
+    } while (ZX0_BIT());
+
+    ZX0_GAMMA(uiLen, 0);
+    while (uiLen--) { *d++ = *s++; }
+  }
+
+  #undef ZX0_GAMMA
+  #undef ZX0_BIT
+}
+
+
+/*----------------------------------------------------------------------------*/
+/*                                                                            */
+/*----------------------------------------------------------------------------*/
@@ -0,0 +1,150 @@
+/*-----------------------------------------------------------------------------+
+|                                                                              |
+| filename: zxnshim.h                                                          |
+| project:  zxn::scrnshot                                                      |
+| author:   S. Zell                                                            |
+| date:     10/18/2026                                                         |
+|                                                                              |
++------------------------------------------------------------------------------+
+|                                                                              |
+| description:                                                                 |
+|                                                                              |
+| Host shim: emulated hardware of the Next (2 MB memory, MMU, NextRegs,        |
+| palettes, ports) and NextZXOS (files on the host file system) for the capture|
+| engine compiled for Linux                                                    |
+|                                                                              |
++------------------------------------------------------------------------------+
+|                                                                              |
+| Copyright (c) 10/18/2026 STZ Engineering                                     |
+|                                                                              |
+| This software is provided  "as is",  without warranty of any kind, express   |
+| or implied. In no event shall STZ or its contributors be held liable for any |
+| direct, indirect, incidental, special or consequential damages arising out   |
+| of the use of or inability to use this software.                             |
+|                                                                              |
+| Permission is granted to anyone  to use this  software for any purpose,      |
+| including commercial applications,  and to alter it and redistribute it      |
+| freely, subject to the following restrictions:                               |
+|                                                                              |
+| 1. Redistributions of source code must retain the above copyright            |
+|    notice, definition, disclaimer, and this list of conditions.              |
+|                                                                              |
+| 2. Redistributions in binary form must reproduce the above copyright         |
+|    notice, definition, disclaimer, and this list of conditions in            |
+|    documentation and/or other materials provided with the distribution.      |
+|                                                                          ;-) |
++-----------------------------------------------------------------------------*/
+
+#if !defined(__ZXNSHIM_H__)
+  #define __ZXNSHIM_H__
+
+/*============================================================================*/
+/*                               Includes                                     */
+/*============================================================================*/
+#include <stdint.h>
+#include <stdbool.h>
+
+/*============================================================================*/
+/*                               Defines                                      */
+/*============================================================================*/
+/*!
+Size of the emulated memory: 2 MB = 256 8K pages
+*/
+#define ZXN_MEMORY_SIZE 0x200000
+
+/*!
+Size of a page of the MMU
+*/
+#define ZXN_PAGE_SIZE 0x2000
+
+/*!
+Size of the ROM (MMU0/1 with page 0xFF)
+*/
+#define ZXN_ROM_SIZE 0x4000
+
+/*!
+Maximum number of open files and directories
+*/
+#define ZXN_FILES_MAX 16
+
+/*============================================================================*/
+/*                               Type-Definitions                             */
+/*============================================================================*/
+/*!
+State of the emulated hardware
+*/
+typedef struct _zxnstate
+{
+  uint8_t* auiMemory;                  /* RAM: 8K pages 0 ... 255                */
+  uint8_t* auiRom;                     /* MMU0/1 with page 0xFF                  */
+  uint8_t* pAddress;                   /* Z80 address space (64K aligned)        */
+  uint8_t  auiRegs[256];               /* NextRegs                               */
+  uint8_t  auiMmu[8];                  /* Pages of the MMU slots                 */
+  uint8_t  aauiClip[4][4];             /* L2, sprites, ULA, tilemap: X1 X2 Y1 Y2 */
+  uint8_t  uiClipIndex;                /* 2 bits per window (NREG 0x1C)          */
+  uint16_t aauiPalette[8][256];        /* RRRGGGBBB; bit 15: priority            */
+  uint8_t  uiPaletteValue;             /* First byte written to NREG 0x44        */
+  bool     bPaletteValue;              /* True, if the first byte is written     */
+  uint8_t  uiPortFF;                   /* Timex port                             */
+  uint8_t  uiPort123B;                 /* Layer 2 port                           */
+  uint8_t  uiMode;                     /* IDE_MODE; 0xFF = from the registers    */
+  bool     bInterrupts;                /* IFF1 (intrinsic_di/intrinsic_ei)       */
+} zxnstate_t;
+
+/*============================================================================*/
+/*                               Variables                                    */
+/*============================================================================*/
+/*!
+State of the emulated hardware
+*/
+extern zxnstate_t g_tZxn;
+
+/*============================================================================*/
+/*                               Prototypes                                   */
+/*============================================================================*/
+/*!
+Resets the emulated hardware to the state after power on (pages, palettes,
+clip windows, Layer 2 in bank 8) and closes all files.
+
+The memory is one shared mapping: the 8K slots of the Z80 address space are
+mapped onto the pages of the RAM like the MMU of the Next. A pointer taken
+from "zxn_memmap" keeps its address and sees the page that is mapped when it
+is used, and the lower 16 bit of a pointer are its Z80 address.
+*/
+void zxnReset(void);
+
+/*!
+Loads a raw image of the RAM (up to 2 MB, 8K page 0 first).
+@return "EOK" = no error
+*/
+int zxnLoadMemory(const char* acPathName);
+
+/*!
+Loads a dump of the video state (format "nvs", see "vstate.h"): NextRegs, clip
+windows, palettes, ports and the pages of the video memory.
+@param pMode Screen mode reported by NextZXOS when the state was dumped ("0"
+             = not needed)
+@return "EOK" = no error
+*/
+int zxnLoadState(const char* acPathName, uint8_t* pMode);
+
+/*!
+Returns the screen mode (0x00, 0x10 ... 0x23) that NextZXOS would report for
+the current registers.
+*/
+uint8_t zxnGetScreenMode(void);
+
+/*!
+Opens a file in memory for writing; the data can be read with
+"zxnGetMemoryFile" until the file is closed.
+@return Handle of the file; "INV_FILE_HND" = error
+*/
+uint8_t zxnOpenMemoryFile(void);
+
+/*!
+Returns the data written to a file in memory.
+@return Data of the file; "0" = no file in memory
+*/
+const uint8_t* zxnGetMemoryFile(uint8_t hFile, uint32_t* pSize);
+
+#endif /* __ZXNSHIM_H__ */
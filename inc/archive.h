@@ -0,0 +1,136 @@
+/*-----------------------------------------------------------------------------+
+|                                                                              |
+| filename: archive.h                                                          |
+| project:  zxn::scrnshot                                                      |
+| author:   S. Zell                                                            |
+| date:     10/18/2026                                                         |
+|                                                                              |
++------------------------------------------------------------------------------+
+|                                                                              |
+| description:                                                                 |
+|                                                                              |
+| Append-only archive of screenshots (one container file)                      |
+|                                                                              |
++------------------------------------------------------------------------------+
+|                                                                              |
+| Copyright (c) 10/18/2026 STZ Engineering                                     |
+|                                                                              |
+| This software is provided  "as is",  without warranty of any kind, express   |
+| or implied. In no event shall STZ or its contributors be held liable for any |
+| direct, indirect, incidental, special or consequential damages arising out   |
+| of the use of or inability to use this software.                             |
+|                                                                              |
+| Permission is granted to anyone  to use this  software for any purpose,      |
+| including commercial applications,  and to alter it and redistribute it      |
+| freely, subject to the following restrictions:                               |
+|                                                                              |
+| 1. Redistributions of source code must retain the above copyright            |
+|    notice, definition, disclaimer, and this list of conditions.              |
+|                                                                              |
+| 2. Redistributions in binary form must reproduce the above copyright         |
+|    notice, definition, disclaimer, and this list of conditions in            |
+|    documentation and/or other materials provided with the distribution.      |
+|                                                                          ;-) |
++-----------------------------------------------------------------------------*/
+
+#if !defined(__ARCHIVE_H__)
+  #define __ARCHIVE_H__
+
+/*============================================================================*/
+/*                               Includes                                     */
+/*============================================================================*/
+
+/*============================================================================*/
+/*                               Defines                                      */
+/*============================================================================*/
+/*!
+Magic number of an archive ("SCA1")
+*/
+#define ARCHIVE_MAGIC "SCA1"
+
+/*!
+Maximum number of entries of an archive; the header and the index fill the
+first 4K of the file, the image data follows.
+*/
+#define ARCHIVE_ENTRIES_MAX 255
+
+/*!
+Offset of the first image in the archive
+*/
+#define ARCHIVE_DATA_START 0x1000
+
+/*!
+Size of a new archive: the file is pre-grown, so that appending an image does
+not need to allocate clusters (256K)
+*/
+#define ARCHIVE_SIZE_INITIAL 0x40000
+
+/*============================================================================*/
+/*                               Namespaces                                   */
+/*============================================================================*/
+
+/*============================================================================*/
+/*                               Constants                                   */
+/*============================================================================*/
+
+/*============================================================================*/
+/*                               Variables                                    */
+/*============================================================================*/
+
+/*============================================================================*/
+/*                               Structures                                   */
+/*============================================================================*/
+
+/*============================================================================*/
+/*                               Type-Definitions                             */
+/*============================================================================*/
+/*!
+Header of an archive (16 bytes, LE)
+*/
+typedef struct _archiveheader
+{
+  char_t   acMagic[4];    /* "SCA1"                                 */
+  uint16_t uiEntries;     /* Number of valid entries of the index   */
+  uint16_t uiEntriesMax;  /* Size of the index                      */
+  uint32_t uiDataEnd;     /* Offset of the end of the last image    */
+  uint32_t uiCapacity;    /* Pre-grown size of the file             */
+} archiveheader_t;
+
+/*!
+Entry of the index of an archive (16 bytes, LE)
+*/
+typedef struct _archiveentry
+{
+  uint16_t uiTime;        /* Time of the screenshot (MS-DOS format) */
+  uint16_t uiDate;        /* Date of the screenshot (MS-DOS format) */
+  uint8_t  uiMode;        /* Screen mode (0x00, 0x10, ... 0x23)     */
+  uint8_t  uiFormat;      /* Format of the image ("format_t")       */
+  uint16_t uiRes;         /* 0                                      */
+  uint32_t uiOffset;      /* Offset of the image in the file        */
+  uint32_t uiLength;      /* Length of the image                    */
+} archiveentry_t;
+
+/*============================================================================*/
+/*                               Prototypes                                   */
+/*============================================================================*/
+/*!
+Appends a screenshot of the current screen mode to the archive
+"g_tState.bmpfile.acPathName" (created and pre-grown if it does not exist).
+Only the image data and one index entry are written.
+@return "EOK" = no error
+*/
+int saveArchiveImage(const screenmode_t* pInfo);
+
+/*============================================================================*/
+/*                               Classes                                      */
+/*============================================================================*/
+
+/*============================================================================*/
+/*                               Implementation                               */
+/*============================================================================*/
+
+/*----------------------------------------------------------------------------*/
+/*                                                                            */
+/*----------------------------------------------------------------------------*/
+
+#endif /* __ARCHIVE_H__ */
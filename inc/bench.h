@@ -0,0 +1,156 @@
+/*-----------------------------------------------------------------------------+
+|                                                                              |
+| filename: bench.h                                                            |
+| project:  zxn::scrnshot                                                      |
+| author:   S. Zell                                                            |
+| date:     10/18/2026                                                         |
+|                                                                              |
++------------------------------------------------------------------------------+
+|                                                                              |
+| description:                                                                 |
+|                                                                              |
+| On-device benchmark and counters of the capture: timing of the phases with   |
+| the CTC, counters of the hot paths                                           |
+|                                                                              |
++------------------------------------------------------------------------------+
+|                                                                              |
+| Copyright (c) 10/18/2026 STZ Engineering                                     |
+|                                                                              |
+| This software is provided  "as is",  without warranty of any kind, express   |
+| or implied. In no event shall STZ or its contributors be held liable for any |
+| direct, indirect, incidental, special or consequential damages arising out   |
+| of the use of or inability to use this software.                             |
+|                                                                              |
+| Permission is granted to anyone  to use this  software for any purpose,      |
+| including commercial applications,  and to alter it and redistribute it      |
+| freely, subject to the following restrictions:                               |
+|                                                                              |
+| 1. Redistributions of source code must retain the above copyright            |
+|    notice, definition, disclaimer, and this list of conditions.              |
+|                                                                              |
+| 2. Redistributions in binary form must reproduce the above copyright         |
+|    notice, definition, disclaimer, and this list of conditions in            |
+|    documentation and/or other materials provided with the distribution.      |
+|                                                                          ;-) |
++-----------------------------------------------------------------------------*/
+
+#if !defined(__BENCH_H__)
+  #define __BENCH_H__
+
+/*============================================================================*/
+/*                               Includes                                     */
+/*============================================================================*/
+
+/*============================================================================*/
+/*                               Defines                                      */
+/*============================================================================*/
+/*!
+Maximum number of runs per sink (option "-B n")
+*/
+#define BENCH_RUNS_MAX 16
+
+/*!
+CTC ticks (16 clocks at 28 MHz) per 0.1 ms
+*/
+#define BENCH_TICKS_100US 175
+
+/*!
+Switches the timed phase of the benchmark; nothing is done without options
+"-B" and "-S", so the hooks cost only a test in the normal pipeline
+*/
+#define BENCH_PHASE(p) (g_tState.bench.bTimer ? setBenchPhase(p) : (p))
+
+/*!
+Hooks of the counters (option "-S"): DI/EI with the time in between, MMU
+switches, calls of F_WRITE and accesses of the palette registers. DI/EI nest:
+a sink called inside a section (e.g. "-m" from the Layer 2 decoder) keeps the
+interrupts of the caller disabled, the time is taken once.
+*/
+#define STATS_DI()        do { intrinsic_di(); if ((0 == g_tState.uiDiNesting++) && g_tState.bench.bTimer) { beginDiTime(); } } while (0)
+#define STATS_EI()        do { if (0 == --g_tState.uiDiNesting) { if (g_tState.bench.bTimer) { endDiTime(); } intrinsic_ei(); } } while (0)
+#define STATS_MMU2(p)     do { ZXN_WRITE_MMU2(p); ++g_tState.stats.uiMmuSwitches; } while (0)
+#define STATS_MMU3(p)     do { ZXN_WRITE_MMU3(p); ++g_tState.stats.uiMmuSwitches; } while (0)
+#define STATS_WRITE(n)    (g_tState.stats.uiWrites += (n))
+#define STATS_PALETTE(n)  (g_tState.stats.uiPaletteRegs += (n))
+
+/*============================================================================*/
+/*                               Namespaces                                   */
+/*============================================================================*/
+
+/*============================================================================*/
+/*                               Constants                                    */
+/*============================================================================*/
+
+/*============================================================================*/
+/*                               Variables                                    */
+/*============================================================================*/
+
+/*============================================================================*/
+/*                               Structures                                   */
+/*============================================================================*/
+
+/*============================================================================*/
+/*                               Type-Definitions                             */
+/*============================================================================*/
+/*!
+Copy of the counters for NextBASIC (option "-S address", all values LE; times
+in us): DPEEK for 16 bit values, DPEEK + 65536 * DPEEK for 32 bit values
+*/
+typedef struct _statsblock
+{
+  uint32_t uiBytes;                     /* +0  image data written         */
+  uint16_t uiWrites;                    /* +4  calls of F_WRITE           */
+  uint16_t uiMmuSwitches;               /* +6  MMU switches               */
+  uint16_t uiPaletteRegs;               /* +8  palette register accesses  */
+  uint32_t uiDiTime;                    /* +10 interrupts disabled        */
+  uint32_t auiPhases[BENCH_PHASES];     /* +14 see "benchphase_t"         */
+} statsblock_t;
+
+/*============================================================================*/
+/*                               Prototypes                                   */
+/*============================================================================*/
+/*!
+Benchmark of the screenshot of the current screen mode: "uiRuns" captures to
+the discard sink (no SD card access) and "uiRuns" captures to the file; prints
+minimum, median and maximum of each phase in ms.
+@return "EOK" = no error
+*/
+int runBenchmark(void);
+
+/*!
+Adds the time since the last call to the current phase and starts the timing
+of the phase "ePhase".
+@return Previous phase
+*/
+benchphase_t setBenchPhase(benchphase_t ePhase);
+
+/*!
+Resets the counters and starts the timer (option "-S")
+*/
+void beginStats(void);
+
+/*!
+Stops the timer, prints the counters ("name value", one per line) and copies
+them to the address of option "-S" (if any)
+*/
+void endStats(void);
+
+/*!
+Interrupts disabled / enabled again (hooks "STATS_DI" and "STATS_EI")
+*/
+void beginDiTime(void);
+void endDiTime(void);
+
+/*============================================================================*/
+/*                               Classes                                      */
+/*============================================================================*/
+
+/*============================================================================*/
+/*                               Implementation                               */
+/*============================================================================*/
+
+/*----------------------------------------------------------------------------*/
+/*                                                                            */
+/*----------------------------------------------------------------------------*/
+
+#endif /* __BENCH_H__ */
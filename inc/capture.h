@@ -0,0 +1,129 @@
+/*-----------------------------------------------------------------------------+
+|                                                                              |
+| filename: capture.h                                                          |
+| project:  zxn::scrnshot                                                      |
+| author:   S. Zell                                                            |
+| date:     10/18/2026                                                         |
+|                                                                              |
++------------------------------------------------------------------------------+
+|                                                                              |
+| description:                                                                 |
+|                                                                              |
+| Capture of screenshots to RAM pages (no file system access)                  |
+|                                                                              |
++------------------------------------------------------------------------------+
+|                                                                              |
+| Copyright (c) 10/18/2026 STZ Engineering                                     |
+|                                                                              |
+| This software is provided  "as is",  without warranty of any kind, express   |
+| or implied. In no event shall STZ or its contributors be held liable for any |
+| direct, indirect, incidental, special or consequential damages arising out   |
+| of the use of or inability to use this software.                             |
+|                                                                              |
+| Permission is granted to anyone  to use this  software for any purpose,      |
+| including commercial applications,  and to alter it and redistribute it      |
+| freely, subject to the following restrictions:                               |
+|                                                                              |
+| 1. Redistributions of source code must retain the above copyright            |
+|    notice, definition, disclaimer, and this list of conditions.              |
+|                                                                              |
+| 2. Redistributions in binary form must reproduce the above copyright         |
+|    notice, definition, disclaimer, and this list of conditions in            |
+|    documentation and/or other materials provided with the distribution.      |
+|                                                                          ;-) |
++-----------------------------------------------------------------------------*/
+
+#if !defined(__CAPTURE_H__)
+  #define __CAPTURE_H__
+
+/*============================================================================*/
+/*                               Includes                                     */
+/*============================================================================*/
+
+/*============================================================================*/
+/*                               Defines                                      */
+/*============================================================================*/
+/*!
+Maximum number of 8K RAM pages of a capture (128K)
+*/
+#define CAPTURE_BANKS_MAX 16
+
+/*!
+Size of a RAM page of a capture
+*/
+#define CAPTURE_BANK_SIZE 0x2000
+
+/*============================================================================*/
+/*                               Namespaces                                   */
+/*============================================================================*/
+
+/*============================================================================*/
+/*                               Constants                                   */
+/*============================================================================*/
+
+/*============================================================================*/
+/*                               Variables                                    */
+/*============================================================================*/
+
+/*============================================================================*/
+/*                               Structures                                   */
+/*============================================================================*/
+
+/*============================================================================*/
+/*                               Type-Definitions                             */
+/*============================================================================*/
+/*!
+Descriptor of a capture to RAM pages (layout is part of the interface: it is
+copied to the address given with option "-m")
+*/
+typedef struct _capture
+{
+  uint32_t uiLength;                     /* Number of bytes of the image   */
+  uint8_t  uiBanks;                      /* Number of allocated 8K pages   */
+  uint8_t  auiBanks[CAPTURE_BANKS_MAX];  /* Pages in order of the data     */
+} capture_t;
+
+/*============================================================================*/
+/*                               Prototypes                                   */
+/*============================================================================*/
+/*!
+Runs the pipeline of the given format (header, palette, pixel data, trailer)
+for the current screen mode into 8K RAM pages allocated from NextZXOS. The
+pages are owned by the caller and have to be released by "releaseCapture"
+(or "esx_ide_bank_free") when no longer needed.
+@return "EOK" = no error
+*/
+int captureScreen(format_t eFormat, capture_t* pCapture);
+
+/*!
+Releases all RAM pages of a capture.
+*/
+void releaseCapture(capture_t* pCapture);
+
+/*!
+Appends a block of data to the RAM pages of the running capture; new pages
+are allocated on demand.
+@return "EOK" = no error
+*/
+int writeCaptureData(const void* pData, uint16_t uiLen);
+
+/*!
+Dot command: captures the screen to RAM pages, copies the descriptor to
+"g_tState.uiCaptureAddr" (if set) and prints the pages and the length.
+@return "EOK" = no error
+*/
+int makeCapture(void);
+
+/*============================================================================*/
+/*                               Classes                                      */
+/*============================================================================*/
+
+/*============================================================================*/
+/*                               Implementation                               */
+/*============================================================================*/
+
+/*----------------------------------------------------------------------------*/
+/*                                                                            */
+/*----------------------------------------------------------------------------*/
+
+#endif /* __CAPTURE_H__ */
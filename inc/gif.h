@@ -0,0 +1,109 @@
+/*-----------------------------------------------------------------------------+
+|                                                                              |
+| filename: gif.h                                                              |
+| project:  zxn::scrnshot                                                      |
+| author:   S. Zell                                                            |
+| date:     10/18/2026                                                         |
+|                                                                              |
++------------------------------------------------------------------------------+
+|                                                                              |
+| description:                                                                 |
+|                                                                              |
+| GIF (LZW) encoder for paletted images                                        |
+|                                                                              |
++------------------------------------------------------------------------------+
+|                                                                              |
+| Copyright (c) 10/18/2026 STZ Engineering                                     |
+|                                                                              |
+| This software is provided  "as is",  without warranty of any kind, express   |
+| or implied. In no event shall STZ or its contributors be held liable for any |
+| direct, indirect, incidental, special or consequential damages arising out   |
+| of the use of or inability to use this software.                             |
+|                                                                              |
+| Permission is granted to anyone  to use this  software for any purpose,      |
+| including commercial applications,  and to alter it and redistribute it      |
+| freely, subject to the following restrictions:                               |
+|                                                                              |
+| 1. Redistributions of source code must retain the above copyright            |
+|    notice, definition, disclaimer, and this list of conditions.              |
+|                                                                              |
+| 2. Redistributions in binary form must reproduce the above copyright         |
+|    notice, definition, disclaimer, and this list of conditions in            |
+|    documentation and/or other materials provided with the distribution.      |
+|                                                                          ;-) |
++-----------------------------------------------------------------------------*/
+
+#if !defined(__GIF_H__)
+  #define __GIF_H__
+
+/*============================================================================*/
+/*                               Includes                                     */
+/*============================================================================*/
+
+/*============================================================================*/
+/*                               Defines                                      */
+/*============================================================================*/
+
+/*============================================================================*/
+/*                               Namespaces                                   */
+/*============================================================================*/
+
+/*============================================================================*/
+/*                               Constants                                   */
+/*============================================================================*/
+
+/*============================================================================*/
+/*                               Variables                                    */
+/*============================================================================*/
+
+/*============================================================================*/
+/*                               Structures                                   */
+/*============================================================================*/
+
+/*============================================================================*/
+/*                               Type-Definitions                             */
+/*============================================================================*/
+
+/*============================================================================*/
+/*                               Prototypes                                   */
+/*============================================================================*/
+/*!
+Saves the GIF signature and the logical screen descriptor to the output file.
+The image is described by "g_tState.bmpfile.tInfoHdr".
+@return "EOK" = no error
+*/
+int saveGifHeader(void);
+
+/*!
+Saves the global colour table and the image descriptor to the output file and
+prepares the LZW encoder.
+@return "EOK" = no error
+*/
+int saveGifPalette(const bmppaletteentry_t* pPalette, uint16_t uiColors);
+
+/*!
+Compresses one row of pixel data (1, 4 or 8 bits per pixel; top-down) and
+saves it to the output file.
+@return "EOK" = no error
+*/
+int saveGifRow(const uint8_t* pRow, uint16_t uiLen);
+
+/*!
+Flushes the LZW encoder and saves the GIF trailer to the output file.
+@return "EOK" = no error
+*/
+int saveGifTrailer(void);
+
+/*============================================================================*/
+/*                               Classes                                      */
+/*============================================================================*/
+
+/*============================================================================*/
+/*                               Implementation                               */
+/*============================================================================*/
+
+/*----------------------------------------------------------------------------*/
+/*                                                                            */
+/*----------------------------------------------------------------------------*/
+
+#endif /* __GIF_H__ */
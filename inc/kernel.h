@@ -0,0 +1,123 @@
+/*-----------------------------------------------------------------------------+
+|                                                                              |
+| filename: kernel.h                                                           |
+| project:  zxn::scrnshot                                                      |
+| author:   S. Zell                                                            |
+| date:     10/18/2026                                                         |
+|                                                                              |
++------------------------------------------------------------------------------+
+|                                                                              |
+| description:                                                                 |
+|                                                                              |
+| Pixel kernels of the hot loops (ULA attributes, HiRes interleave, LoRes      |
+| rows, Layer 2 spans), shared by the dot command and the host build           |
+|                                                                              |
++------------------------------------------------------------------------------+
+|                                                                              |
+| Copyright (c) 10/18/2026 STZ Engineering                                     |
+|                                                                              |
+| This software is provided  "as is",  without warranty of any kind, express   |
+| or implied. In no event shall STZ or its contributors be held liable for any |
+| direct, indirect, incidental, special or consequential damages arising out   |
+| of the use of or inability to use this software.                             |
+|                                                                              |
+| Permission is granted to anyone  to use this  software for any purpose,      |
+| including commercial applications,  and to alter it and redistribute it      |
+| freely, subject to the following restrictions:                               |
+|                                                                              |
+| 1. Redistributions of source code must retain the above copyright            |
+|    notice, definition, disclaimer, and this list of conditions.              |
+|                                                                              |
+| 2. Redistributions in binary form must reproduce the above copyright         |
+|    notice, definition, disclaimer, and this list of conditions in            |
+|    documentation and/or other materials provided with the distribution.      |
+|                                                                          ;-) |
++-----------------------------------------------------------------------------*/
+
+#if !defined(__KERNEL_H__)
+  #define __KERNEL_H__
+
+/*============================================================================*/
+/*                               Includes                                     */
+/*============================================================================*/
+
+/*============================================================================*/
+/*                               Defines                                      */
+/*============================================================================*/
+
+/*============================================================================*/
+/*                               Namespaces                                   */
+/*============================================================================*/
+
+/*============================================================================*/
+/*                               Constants                                    */
+/*============================================================================*/
+
+/*============================================================================*/
+/*                               Variables                                    */
+/*============================================================================*/
+
+/*============================================================================*/
+/*                               Structures                                   */
+/*============================================================================*/
+
+/*============================================================================*/
+/*                               Type-Definitions                             */
+/*============================================================================*/
+
+/*============================================================================*/
+/*                               Prototypes                                   */
+/*============================================================================*/
+/*!
+ULA attribute expansion (LAYER 0, 1,1 and 1,3): every column of 8 pixels
+(pixel byte and attribute) gives 4 bytes of 4 bit colour indices, INK and
+PAPER with BRIGHT, swapped if FLASH is set.
+@param pDst   Destination (4 bytes per column)
+@param pPixel Pixel bytes of the row, first column
+@param pAttr  Attributes of the row, first column
+@param uiCols Number of columns (1 .. 255)
+*/
+void expandUlaRow(uint8_t* pDst, const uint8_t* pPixel, const uint8_t* pAttr, uint16_t uiCols);
+
+/*!
+Timex HiRes column interleave (LAYER 1,2): the bytes of a row are taken
+alternately from screen 0 (0x4000) and screen 1 (0x6000).
+@param pDst    Destination
+@param pRow0   Row of screen 0, first column (the one of screen 1 is 0x2000
+               above)
+@param uiBytes Number of bytes (even, > 0)
+*/
+void interleaveHiResRow(uint8_t* pDst, const uint8_t* pRow0, uint16_t uiBytes);
+
+/*!
+LoRes row copy (LAYER 1,0): copies a row from the top (0x4000) or bottom
+(0x6000) half of the screen; a scaled image reads every n-th byte only.
+@param pDst     Destination ("uiLen / uiStep" bytes)
+@param uiOffset Offset of the row in the 12K of LoRes (0x0000 .. 0x2FFF)
+@param uiLen    Number of bytes of the row (> 0, a multiple of "uiStep", the
+                row doesn't cross the halves)
+@param uiStep   Distance of the bytes that are read (1, 2 or 4)
+*/
+void copyLoResRow(uint8_t* pDst, uint16_t uiOffset, uint16_t uiLen, uint8_t uiStep);
+
+/*!
+Layer 2 span copy (LAYER 2,2 and 2,3, column major): gathers the bytes of a
+row from the columns of 256 bytes in the mapped 8K bank; a scaled image reads
+every n-th column only.
+@param pDst   Destination
+@param pSrc   Byte of the first column
+@param uiCnt  Number of bytes (1 .. 32, inside of the bank)
+@param uiStep Distance of the columns that are read (1, 2 or 4)
+@return Destination behind the last byte
+*/
+uint8_t* gatherLayer2Cols(uint8_t* pDst, const uint8_t* pSrc, uint16_t uiCnt, uint8_t uiStep);
+
+/*!
+Subsampling of a row of 4 bit pixels read with "uiStep" > 1 (LoRes/Radastan,
+LAYER 2,3): every byte keeps its left pixel, two of them give one byte.
+@param pRow    Row (packed in place)
+@param uiBytes Number of bytes (even, > 0)
+*/
+void packLeftNibbles(uint8_t* pRow, uint16_t uiBytes);
+
+#endif /* __KERNEL_H__ */
@@ -63,6 +63,16 @@
 /*============================================================================*/
 /*                               Type-Definitions                             */
 /*============================================================================*/
+/*!
+Layout of the attributes of the ULA family (LAYER 0, 1,1 and 1,3): one row of
+32 attributes per character row of 8 lines at 0x5800 (ULA) or one attribute
+byte per pixel byte at the same offset in screen 1 (Timex HiColor)
+*/
+typedef enum _attrrow
+{
+  ATTR_ROW_CELL = 0,  /* attributes per 8 lines   */
+  ATTR_ROW_LINE       /* attributes per line      */
+} attrrow_t;
 
 /*============================================================================*/
 /*                               Prototypes                                   */
@@ -72,6 +82,13 @@ Reading the video memory and transcode it to BMP data for LAYER 0
 */
 int makeScreenshot_L00(const screenmode_t* pInfo);
 
+/*!
+Row decoder of the ULA family (LAYER 0, 1,1 and 1,3): writes the header, the
+palette and the rows expanded by "expandUlaRow()" (FLASH, BRIGHT, INK and
+PAPER); "eAttrRow" selects the layout of the attributes
+*/
+int makeUlaScreenshot(const screenmode_t* pInfo, attrrow_t eAttrRow);
+
 /*============================================================================*/
 /*                               Classes                                      */
 /*============================================================================*/
@@ -0,0 +1,117 @@
+/*-----------------------------------------------------------------------------+
+|                                                                              |
+| filename: png.h                                                              |
+| project:  zxn::scrnshot                                                      |
+| author:   S. Zell                                                            |
+| date:     10/18/2026                                                         |
+|                                                                              |
++------------------------------------------------------------------------------+
+|                                                                              |
+| description:                                                                 |
+|                                                                              |
+| PNG encoder (indexed colour, deflate compression)                            |
+|                                                                              |
++------------------------------------------------------------------------------+
+|                                                                              |
+| Copyright (c) 10/18/2026 STZ Engineering                                     |
+|                                                                              |
+| This software is provided  "as is",  without warranty of any kind, express   |
+| or implied. In no event shall STZ or its contributors be held liable for any |
+| direct, indirect, incidental, special or consequential damages arising out   |
+| of the use of or inability to use this software.                             |
+|                                                                              |
+| Permission is granted to anyone  to use this  software for any purpose,      |
+| including commercial applications,  and to alter it and redistribute it      |
+| freely, subject to the following restrictions:                               |
+|                                                                              |
+| 1. Redistributions of source code must retain the above copyright            |
+|    notice, definition, disclaimer, and this list of conditions.              |
+|                                                                              |
+| 2. Redistributions in binary form must reproduce the above copyright         |
+|    notice, definition, disclaimer, and this list of conditions in            |
+|    documentation and/or other materials provided with the distribution.      |
+|                                                                          ;-) |
++-----------------------------------------------------------------------------*/
+
+#if !defined(__PNG_H__)
+  #define __PNG_H__
+
+/*============================================================================*/
+/*                               Includes                                     */
+/*============================================================================*/
+
+/*============================================================================*/
+/*                               Defines                                      */
+/*============================================================================*/
+/*!
+Compression levels of the PNG encoder
+  - 0 = stored blocks (no compression, fastest)
+  - 1 = fixed Huffman codes, single hash probe
+  - 2 = dynamic Huffman codes, hash chains (smallest files)
+*/
+#define PNG_LEVEL_STORE 0
+#define PNG_LEVEL_FAST  1
+#define PNG_LEVEL_SMALL 2
+
+/*============================================================================*/
+/*                               Namespaces                                   */
+/*============================================================================*/
+
+/*============================================================================*/
+/*                               Constants                                   */
+/*============================================================================*/
+
+/*============================================================================*/
+/*                               Variables                                    */
+/*============================================================================*/
+
+/*============================================================================*/
+/*                               Structures                                   */
+/*============================================================================*/
+
+/*============================================================================*/
+/*                               Type-Definitions                             */
+/*============================================================================*/
+
+/*============================================================================*/
+/*                               Prototypes                                   */
+/*============================================================================*/
+/*!
+Saves the PNG signature and the IHDR chunk to the output file. The image is
+described by "g_tState.bmpfile.tInfoHdr".
+@return "EOK" = no error
+*/
+int savePngHeader(void);
+
+/*!
+Saves the PLTE chunk to the output file and prepares the deflate encoder.
+@return "EOK" = no error
+*/
+int savePngPalette(const bmppaletteentry_t* pPalette, uint16_t uiColors);
+
+/*!
+Compresses one row of pixel data (1, 4 or 8 bits per pixel; top-down) and
+saves it to the output file.
+@return "EOK" = no error
+*/
+int savePngRow(const uint8_t* pRow, uint16_t uiLen);
+
+/*!
+Flushes the deflate encoder and saves the IEND chunk to the output file.
+@return "EOK" = no error
+*/
+int savePngTrailer(void);
+
+/*============================================================================*/
+/*                               Classes                                      */
+/*============================================================================*/
+
+/*============================================================================*/
+/*                               Implementation                               */
+/*============================================================================*/
+
+/*----------------------------------------------------------------------------*/
+/*                                                                            */
+/*----------------------------------------------------------------------------*/
+
+#endif /* __PNG_H__ */
@@ -44,20 +44,81 @@
 /*                               Defines                                      */
 /*============================================================================*/
 /*!
-With this macro it can be controlled wether the pixel calculations should be
+With these macros it can be controlled wether the pixel calculations should be
 done by the functions from "zxn.h" or not ...
   - 0 = calculate pixeladdress the hard way (bit-fiddling in C)
   - 1 = calculate pixeladdress with function from z88dk-newlib
   - 2 = calculate pixeladdress with PIXELAD opcode
   - 3 = calculate pixeladdress with PIXELAD and bit-fiddling
+  - 4 = step from row to row with the walker of "walker.h"
+The strategy is selected per path: ULA (LAYER 0, LAYER 1,1; attributes per
+character row) and HICOLOR (LAYER 1,3; attributes per pixel row). The build
+passes the fastest one measured by "make pixelcalc" (build/pixelcalc.mk);
+without a measurement it stays at 3.
 */
-#define _PIXEL_CALC_ 3
+#if !defined(_PIXEL_CALC_ULA_)
+  #define _PIXEL_CALC_ULA_ 3
+#endif
+
+#if !defined(_PIXEL_CALC_HICOLOR_)
+  #define _PIXEL_CALC_HICOLOR_ 3
+#endif
 
 /*!
 Default-resolution of the created BMP files
 */
 #define BMP_DPI_72 (2835)
 
+/*!
+Maximum number of 8K RAM pages that can be allocated by the encoders
+*/
+#define BANKS_MAX 4
+
+/*!
+Maximum number of outputs of a screenshot (file argument and "-o")
+*/
+#define OUTPUTS_MAX 4
+
+/*!
+Maximum number of layers of a snapshot (ULA, Layer 2, tilemap)
+*/
+#define LAYERS_MAX 3
+
+/*!
+Invalid/unused 8K RAM page
+*/
+#define INV_BANK 0xFF
+
+/*!
+Address of the MMU slot used to map the working pages of the encoders
+(MMU3: 0x6000 - 0x7FFF)
+*/
+#define WORK_BANK_ADDR 0x6000
+
+/*!
+First row of the given region of the screen that has to be transferred to the
+output file. BMP files are stored bottom-up, all other formats top-down.
+*/
+#define IMAGE_ROW_FIRST(r) (0 < g_tState.bmpfile.iRowStep ? (r)->uiY : (r)->uiY + (r)->uiH + g_tState.bmpfile.iRowStep)
+
+/*!
+True, while the row "y" is inside the given region of the screen (in both
+directions of "g_tState.bmpfile.iRowStep").
+*/
+#define IMAGE_ROW_VALID(y, r) (((uint16_t) ((y) - (r)->uiY)) < (r)->uiH)
+
+/*!
+True, if the destination of the image data is ready: an opened file, the
+RAM pages of a capture or the UART.
+*/
+#define IMAGE_SINK_OPEN() ((SINK_FILE != g_tState.bmpfile.eSink) || (INV_FILE_HND != g_tState.bmpfile.hFile))
+
+/*!
+True for formats that are produced row by row by the decoders of the layers
+(all others are written from the video memory as a whole).
+*/
+#define IS_ROW_FORMAT(f) ((FORMAT_NATIVE != (f)) && (FORMAT_ZX0 != (f)) && (FORMAT_STATE != (f)))
+
 /*============================================================================*/
 /*                               Namespaces                                   */
 /*============================================================================*/
@@ -85,9 +146,74 @@ typedef enum _action
   ACTION_NONE = 0,
   ACTION_HELP,
   ACTION_INFO,
-  ACTION_SHOT
+  ACTION_SHOT,
+  ACTION_LOAD,
+  ACTION_CAPTURE,
+  ACTION_LAYERS,
+  ACTION_BENCH
 } action_t;
 
+/*!
+Enumeration to describe all supported formats of the output file
+*/
+typedef enum _format
+{
+  FORMAT_NONE = 0,
+  FORMAT_BMP,
+  FORMAT_GIF,
+  FORMAT_PNG,
+  FORMAT_QOI,
+  FORMAT_NATIVE,
+  FORMAT_ZX0,
+  FORMAT_STATE
+} format_t;
+
+/*!
+Structure to describe an output of a screenshot
+*/
+typedef struct _output
+{
+  format_t      eFormat;
+  const char_t* acNativeExt;  /* native: requested type ("sl2", "nxi", ...) */
+  uint8_t       hFile;
+  const char_t* acPathName;
+} output_t;
+
+/*!
+Enumeration to describe the destination of the image data
+*/
+typedef enum _sink
+{
+  SINK_FILE = 0,  /* g_tState.bmpfile.hFile      */
+  SINK_BANKS,     /* allocated 8K RAM pages      */
+  SINK_UART,      /* packets to a host receiver  */
+  SINK_NULL       /* discarded (option "-B")     */
+} sink_t;
+
+/*!
+Enumeration to describe the phases of a screenshot that are timed by the
+benchmark (option "-B"); the time of the writes is taken out of the others
+*/
+typedef enum _benchphase
+{
+  BENCH_OTHER = 0,  /* open/close of the files, setup */
+  BENCH_HEADER,
+  BENCH_PALETTE,
+  BENCH_PIXELS,     /* decoder of the screen mode     */
+  BENCH_TRAILER,
+  BENCH_WRITE,      /* writeImageData                 */
+  BENCH_PHASES
+} benchphase_t;
+
+/*!
+Structure to describe a supported format of the output file
+*/
+typedef struct _fileformat
+{
+  format_t      eFormat;
+  const char_t* acExt;
+} fileformat_t;
+
 /*!
 Structure to describe the file header of a BMP file
 */
@@ -137,6 +263,17 @@ typedef struct _memregion
   uint16_t  uiSize;
 } memregion_t;
 
+/*!
+Structure to describe a region of the screen in pixels (option "--rect")
+*/
+typedef struct _imagerect
+{
+  uint16_t  uiX;
+  uint16_t  uiY;
+  uint16_t  uiW;
+  uint16_t  uiH;
+} imagerect_t;
+
 /*!
 Structure to describe the properties of a videomode of Spectrum Next
 */
@@ -181,6 +318,118 @@ typedef struct _appstate
   */
   bool bForce;
 
+  /*!
+  If this flag is set, the screenshot is appended to an archive
+  */
+  bool bArchive;
+
+  /*!
+  Format of the output file (BMP, GIF, ...)
+  */
+  format_t eFormat;
+
+  /*!
+  Native format: requested type (option "-t" or extension, e.g. "sl2" or
+  "nxi"); "0" = type of the screen mode
+  */
+  const char_t* acNativeExt;
+
+  /*!
+  Compression level of the output file (PNG: 0 = store, 1 = fast, 2 = small)
+  */
+  uint8_t uiLevel;
+
+  /*!
+  Address the descriptor of a capture to RAM pages is copied to (0 = none)
+  */
+  uint16_t uiCaptureAddr;
+
+  /*!
+  Region of the screen to capture (option "--rect"); width 0 = whole screen
+  */
+  imagerect_t tRect;
+
+  /*!
+  Scale of the image: 1 = full size, 2 or 4 = every 2nd/4th pixel and row
+  (option "-s")
+  */
+  uint8_t uiScale;
+
+  /*!
+  Scale of a thumbnail written next to the screenshot (option "-T"; 0 = none)
+  */
+  uint8_t uiThumb;
+
+  /*!
+  NextReg of the Layer 2 buffer to capture: 0x12 = active, 0x13 = shadow
+  (option "-b")
+  */
+  uint8_t uiLayer2Reg;
+
+  /*!
+  If this flag is set, both Layer 2 buffers are captured (option "-b b")
+  */
+  bool bLayer2Both;
+
+  /*!
+  Outputs of the screenshot, written in one pass over the video memory
+  (0 = file given as argument, more with option "-o")
+  */
+  output_t atOutputs[OUTPUTS_MAX];
+
+  /*!
+  Number of outputs
+  */
+  uint8_t uiOutputs;
+
+  /*!
+  Output that is currently written (see "selectOutput")
+  */
+  uint8_t uiOutput;
+
+  /*!
+  8K RAM pages allocated from NextZXOS by the encoders
+  */
+  uint8_t auiBanks[BANKS_MAX];
+
+  /*!
+  Benchmark (option "-B"): number of runs per sink (0 = off), timer running
+  (options "-B" and "-S"), the phase that is timed and the times of the phases
+  of the current run (CTC ticks of 16 clocks)
+  */
+  struct _bench
+  {
+    uint8_t      uiRuns;
+    bool         bTimer;
+    benchphase_t ePhase;
+    uint32_t     uiStart;
+    uint32_t     auiTimes[BENCH_PHASES];
+  } bench;
+
+  /*!
+  Counters of the capture (option "-S"): image data written (all sinks), calls
+  of F_WRITE, MMU switches, accesses of the palette registers and the time with
+  disabled interrupts (CTC ticks); optional address of the copy for NextBASIC
+  */
+  struct _stats
+  {
+    bool     bEnabled;
+    uint16_t uiAddr;
+    uint32_t uiBytes;
+    uint16_t uiWrites;
+    uint16_t uiMmuSwitches;
+    uint16_t uiPaletteRegs;
+    uint32_t uiDiStart;
+    uint32_t uiDiTime;
+  } stats;
+
+  /*!
+  Depth of the sections with disabled interrupts ("STATS_DI"/"STATS_EI"):
+  only the outermost section enables them again (MMU2 may still be paged away
+  from the system variables in the inner ones, i.e. the sinks)
+  */
+  uint8_t uiDiNesting;
+
   /*!
   Backup: Current speed of Z80
   */
@@ -192,7 +441,8 @@ typedef struct _appstate
   int iExitCode;
 
   /*!
-  Structure of all information of the BMP output file
+  Structure of all information of the output file (the BMP headers describe
+  the image for all formats)
   */
   struct _bmpfile
   {
@@ -206,6 +456,11 @@ typedef struct _appstate
     */
     uint8_t hFile;
 
+    /*!
+    Destination of the image data (file, RAM pages, UART)
+    */
+    sink_t eSink;
+
     /*!
     File header of the BMP file
     */
@@ -215,8 +470,61 @@ typedef struct _appstate
     Info header of the BMO file
     */
     bmpinfoheader_t tInfoHdr;
+
+    /*!
+    Step between the rows of the video memory that are transferred: positive =
+    top-down, negative = bottom-up; the amount is the scale of the image
+    */
+    int8_t iRowStep;
+
+    /*!
+    Buffer of a scaled image row (only while a scaled image is written)
+    */
+    uint8_t* pScaledRow;
+
+    /*!
+    Colour palette of the image
+    */
+    bmppaletteentry_t tPalette[256];
   } bmpfile;
 
+  /*!
+  Snapshot of the video hardware for the screenshots of all layers (option
+  "-L"); while it is valid, it is used instead of the NextRegs.
+  */
+  struct _snapshot
+  {
+    /*!
+    If this flag is set, the snapshot is valid
+    */
+    bool bValid;
+
+    /*!
+    Screen modes of the enabled layers (ULA, Layer 2, tilemap)
+    */
+    uint8_t auiModes[LAYERS_MAX];
+
+    /*!
+    Number of enabled layers
+    */
+    uint8_t uiModes;
+
+    /*!
+    Layer that is currently written
+    */
+    uint8_t uiLayer;
+
+    /*!
+    First 8K page of Layer 2
+    */
+    uint8_t uiLayer2Page;
+
+    /*!
+    Colour palettes of the layers (RRRGGGBBB)
+    */
+    uint16_t auiPalette[LAYERS_MAX][256];
+  } snapshot;
+
 } appstate_t;
 
 /*============================================================================*/
@@ -234,7 +542,46 @@ video-/screenmode
 const screenmode_t* getScreenModeInfo(uint8_t uiMode);
 
 /*!
-This function saves the predefined BMP header to the already opened file
+This function returns the first 8K page of the Layer 2 image to capture
+(NREG 0x12, NREG 0x13 with option "-b" or the snapshot).
+*/
+uint8_t getLayer2Page(void);
+
+/*!
+This function returns the region of the screen the decoder of the given mode
+has to capture: the whole screen or the rectangle of option "--rect". The
+columns are aligned to 32 bit of the scaled output row (i.e. 8 pixels at 4 bpp
+and full size), the rows to the scale of the image.
+@param pInfo Screen mode
+@param uiBitCount Bits per pixel of the output rows
+@param pRect Region of the screen (output)
+@return EOK or ERANGE (rectangle outside of the screen)
+*/
+int getImageRect(const screenmode_t* pInfo, uint8_t uiBitCount, imagerect_t* pRect);
+
+/*!
+This function is responsible for creation of the BMP file. It calls
+specialized functions for the active video-/screenmode.
+*/
+int makeScreenshot(void);
+
+/*!
+This function runs the complete pipeline (header, palette, pixel data,
+trailer) of the current format for the given screen mode into the already
+opened destination (file, RAM pages or UART).
+@return "EOK" = no error
+*/
+int captureImage(const screenmode_t* pInfo);
+
+/*!
+This function makes the given output the current one: "eFormat" and
+"bmpfile.hFile" are taken from the list of outputs.
+*/
+void selectOutput(uint8_t uiOutput);
+
+/*!
+This function saves the predefined BMP header to the already opened file. The
+size of a scaled image (option "-s") is calculated here from the full size.
 @return "EOK" = no error
 */
 int saveImageHeader(void);
@@ -246,6 +593,74 @@ already opened BMP file.
 */
 int saveColourPalette(const screenmode_t* pInfo);
 
+/*!
+This function reads the current colour palette of the screen mode from NREGs
+to "g_tState.bmpfile.tPalette".
+@return Number of colours read
+*/
+uint16_t readColourPalette(const screenmode_t* pInfo);
+
+/*!
+This function writes the first entries of "g_tState.bmpfile.tPalette" to the
+active colour palette of the screen mode.
+@return "EOK" = no error
+*/
+int writeColourPalette(const screenmode_t* pInfo, uint16_t uiColors);
+
+/*!
+This function selects the active colour palette of the screen mode for
+reading and writing (NREG 0x43).
+@return Previous value of NREG 0x43
+*/
+uint8_t selectColourPalette(const screenmode_t* pInfo);
+
+/*!
+This function saves the first entries of the colour palette in
+"g_tState.bmpfile.tPalette" to the already opened file.
+@return "EOK" = no error
+*/
+int saveColourTable(uint16_t uiColors);
+
+/*!
+This function saves one row of pixel data to the already opened file. The rows
+have to be passed in the order given by "g_tState.bmpfile.iRowStep"; they are
+passed in full size and subsampled here for a scaled image.
+@return "EOK" = no error
+*/
+int saveImageRow(const uint8_t* pRow, uint16_t uiLen);
+
+/*!
+This function saves one row like "saveImageRow()", but the row is already
+subsampled by the decoder for a scaled image (only every n-th pixel read).
+@return "EOK" = no error
+*/
+int saveScaledRow(const uint8_t* pRow, uint16_t uiLen);
+
+/*!
+This function completes the image in the already opened file.
+@return "EOK" = no error
+*/
+int saveImageTrailer(void);
+
+/*!
+This function writes a block of data to the already opened destination
+(file, RAM pages or UART).
+@return "EOK" = no error
+*/
+int writeImageData(const void* pData, uint16_t uiLen);
+
+/*!
+This function allocates an 8K RAM page from NextZXOS. The page is released
+automatically when the application terminates.
+@return Number of the page; "INV_BANK" = error
+*/
+uint8_t allocBank(void);
+
+/*!
+This function releases an 8K RAM page allocated by "allocBank".
+*/
+void freeBank(uint8_t uiBank);
+
 /*!
 Convert a RGB3 value to a corresponding RGB8 value
 3-Bit (0..7) -> 8-Bit (0..255): "bit replicate"
@@ -255,6 +670,15 @@ inline uint8_t rgb3_to_rgb8(uint8_t v)
   return (uint8_t)((v << 5) | (v << 2) | (v >> 1));  // 0,36,73,109,146,182,219,255
 }
 
+/*!
+Convert a palette entry (RGB8, bit replicated) to the 9-bit colour value of
+the Next palette: RRRGGGBBB
+*/
+inline uint16_t rgb8_to_rgb9(const bmppaletteentry_t* p)
+{
+  return (((uint16_t) (p->r & 0xE0)) << 1) | (((uint16_t) (p->g & 0xE0)) >> 2) | (p->b >> 5);
+}
+
 /*============================================================================*/
 /*                               Klassen                                      */
 /*============================================================================*/
@@ -0,0 +1,139 @@
+/*-----------------------------------------------------------------------------+
+|                                                                              |
+| filename: uart.h                                                             |
+| project:  zxn::scrnshot                                                      |
+| author:   S. Zell                                                            |
+| date:     10/18/2026                                                         |
+|                                                                              |
++------------------------------------------------------------------------------+
+|                                                                              |
+| description:                                                                 |
+|                                                                              |
+| Transfer of screenshots over the UART to a host receiver                     |
+|                                                                              |
++------------------------------------------------------------------------------+
+|                                                                              |
+| Copyright (c) 10/18/2026 STZ Engineering                                     |
+|                                                                              |
+| This software is provided  "as is",  without warranty of any kind, express   |
+| or implied. In no event shall STZ or its contributors be held liable for any |
+| direct, indirect, incidental, special or consequential damages arising out   |
+| of the use of or inability to use this software.                             |
+|                                                                              |
+| Permission is granted to anyone  to use this  software for any purpose,      |
+| including commercial applications,  and to alter it and redistribute it      |
+| freely, subject to the following restrictions:                               |
+|                                                                              |
+| 1. Redistributions of source code must retain the above copyright            |
+|    notice, definition, disclaimer, and this list of conditions.              |
+|                                                                              |
+| 2. Redistributions in binary form must reproduce the above copyright         |
+|    notice, definition, disclaimer, and this list of conditions in            |
+|    documentation and/or other materials provided with the distribution.      |
+|                                                                          ;-) |
++-----------------------------------------------------------------------------*/
+
+#if !defined(__UART_H__)
+  #define __UART_H__
+
+/*============================================================================*/
+/*                               Includes                                     */
+/*============================================================================*/
+
+/*============================================================================*/
+/*                               Defines                                      */
+/*============================================================================*/
+/*!
+Baud rate of the transfer (maximum of the Next UART)
+*/
+#define UART_BAUD 2000000
+
+/*!
+Packet framing (shared with the host receiver, all values LE):
+  SYNC, TYPE, SEQ, LEN, PAYLOAD[LEN], CHECKSUM (Fletcher-16 of TYPE..PAYLOAD)
+*/
+#define UART_PKT_SYNC 0x5A
+
+/*!
+Size of the framing of a packet (SYNC, TYPE, SEQ, LEN, CHECKSUM)
+*/
+#define UART_PKT_OVERHEAD 6
+
+/*!
+Maximum size of the payload of a packet
+*/
+#define UART_PAYLOAD_MAX 255
+
+/*!
+Packet types: START (payload: name of the image), DATA (payload: image data),
+END (payload: uint32_t length of the image), ABORT (no payload)
+*/
+#define UART_PKT_START 0x01
+#define UART_PKT_DATA  0x02
+#define UART_PKT_END   0x03
+#define UART_PKT_ABORT 0x04
+
+/*============================================================================*/
+/*                               Namespaces                                   */
+/*============================================================================*/
+
+/*============================================================================*/
+/*                               Constants                                   */
+/*============================================================================*/
+
+/*============================================================================*/
+/*                               Variables                                    */
+/*============================================================================*/
+
+/*============================================================================*/
+/*                               Structures                                   */
+/*============================================================================*/
+
+/*============================================================================*/
+/*                               Type-Definitions                             */
+/*============================================================================*/
+
+/*============================================================================*/
+/*                               Prototypes                                   */
+/*============================================================================*/
+/*!
+Sends a complete screenshot of the current screen mode over the UART: the
+name of the image, the data of the normal pipeline and the trailer.
+@return "EOK" = no error
+*/
+int sendUartImage(const screenmode_t* pInfo, const char_t* acExt);
+
+/*!
+Configures the UART (maximum baud rate) and sends the START packet with the
+name of the image.
+@return "EOK" = no error
+*/
+int openUart(const char_t* acName);
+
+/*!
+Appends a block of data to the DATA packets; a full packet is sent while the
+next one is filled (double buffering).
+@return "EOK" = no error
+*/
+int writeUartData(const void* pData, uint16_t uiLen);
+
+/*!
+Sends the last DATA packet and the END packet (or ABORT on error) and waits
+until all bytes are transmitted.
+@return "EOK" = no error
+*/
+int closeUart(int iResult);
+
+/*============================================================================*/
+/*                               Classes                                      */
+/*============================================================================*/
+
+/*============================================================================*/
+/*                               Implementation                               */
+/*============================================================================*/
+
+/*----------------------------------------------------------------------------*/
+/*                                                                            */
+/*----------------------------------------------------------------------------*/
+
+#endif /* __UART_H__ */
@@ -0,0 +1,152 @@
+/*-----------------------------------------------------------------------------+
+|                                                                              |
+| filename: vstate.h                                                           |
+| project:  zxn::scrnshot                                                      |
+| author:   S. Zell                                                            |
+| date:     10/18/2026                                                         |
+|                                                                              |
++------------------------------------------------------------------------------+
+|                                                                              |
+| description:                                                                 |
+|                                                                              |
+| Dump of the complete state of the video hardware (NextRegs, palettes,        |
+| clip windows, video memory) for a host side renderer                         |
+|                                                                              |
++------------------------------------------------------------------------------+
+|                                                                              |
+| Copyright (c) 10/18/2026 STZ Engineering                                     |
+|                                                                              |
+| This software is provided  "as is",  without warranty of any kind, express   |
+| or implied. In no event shall STZ or its contributors be held liable for any |
+| direct, indirect, incidental, special or consequential damages arising out   |
+| of the use of or inability to use this software.                             |
+|                                                                              |
+| Permission is granted to anyone  to use this  software for any purpose,      |
+| including commercial applications,  and to alter it and redistribute it      |
+| freely, subject to the following restrictions:                               |
+|                                                                              |
+| 1. Redistributions of source code must retain the above copyright            |
+|    notice, definition, disclaimer, and this list of conditions.              |
+|                                                                              |
+| 2. Redistributions in binary form must reproduce the above copyright         |
+|    notice, definition, disclaimer, and this list of conditions in            |
+|    documentation and/or other materials provided with the distribution.      |
+|                                                                          ;-) |
++-----------------------------------------------------------------------------*/
+
+#if !defined(__VSTATE_H__)
+  #define __VSTATE_H__
+
+/*============================================================================*/
+/*                               Includes                                     */
+/*============================================================================*/
+
+/*============================================================================*/
+/*                               Defines                                      */
+/*============================================================================*/
+/*!
+Magic number of a video state dump ("SCVS")
+*/
+#define VSTATE_MAGIC "SCVS"
+
+/*!
+Version of the layout of a video state dump
+*/
+#define VSTATE_VERSION 1
+
+/*!
+Types of the chunks of a video state dump; "uiId" and the payload of a chunk:
+  - REGS:    0; NextRegs 0x00 - 0x7F (128 bytes, as read)
+  - CLIP:    0; clip windows of Layer 2, sprites, ULA and tilemap
+             (4 x 4 bytes: X1, X2, Y1, Y2)
+  - PALETTE: palette (NREG 0x43 bits 6-4: 0 = ULA, 1 = Layer 2, 2 = sprites,
+             3 = tilemap, +4 = second palette); 256 x 2 bytes (NREG 0x41,
+             NREG 0x44)
+  - PORTS:   0; triples of port address (LE) and value (0xFF, 0x123B)
+  - PAGE:    number of the 8K page; 8192 bytes
+*/
+#define VSTATE_CHUNK_REGS    1
+#define VSTATE_CHUNK_CLIP    2
+#define VSTATE_CHUNK_PALETTE 3
+#define VSTATE_CHUNK_PORTS   4
+#define VSTATE_CHUNK_PAGE    5
+
+/*!
+Number of NextRegs in the chunk "REGS"
+*/
+#define VSTATE_REGS 0x80
+
+/*!
+Number of colour palettes of the Next (ULA, Layer 2, sprites, tilemap; first
+and second)
+*/
+#define VSTATE_PALETTES 8
+
+/*============================================================================*/
+/*                               Namespaces                                   */
+/*============================================================================*/
+
+/*============================================================================*/
+/*                               Constants                                   */
+/*============================================================================*/
+
+/*============================================================================*/
+/*                               Variables                                    */
+/*============================================================================*/
+
+/*============================================================================*/
+/*                               Structures                                   */
+/*============================================================================*/
+
+/*============================================================================*/
+/*                               Type-Definitions                             */
+/*============================================================================*/
+/*!
+Header of a video state dump (8 bytes, LE)
+*/
+typedef struct _vstateheader
+{
+  char_t   acMagic[4];    /* "SCVS"                                 */
+  uint8_t  uiVersion;     /* Layout of the dump: 1                  */
+  uint8_t  uiMode;        /* Detected screen mode (0x00 ... 0x23)   */
+  uint16_t uiChunks;      /* Number of chunks following the header  */
+} vstateheader_t;
+
+/*!
+Header of a chunk of a video state dump (8 bytes, LE); the payload follows
+*/
+typedef struct _vstatechunk
+{
+  uint8_t  uiType;        /* Type of the chunk ("VSTATE_CHUNK_...") */
+  uint8_t  uiId;          /* Palette or page number, otherwise 0    */
+  uint16_t uiRes;         /* 0                                      */
+  uint32_t uiSize;        /* Size of the payload                    */
+} vstatechunk_t;
+
+
+/*============================================================================*/
+/*                               Prototypes                                   */
+/*============================================================================*/
+/*!
+Dumps the complete state of the video hardware to the already opened
+destination: the NextRegs, the clip windows, all colour palettes, the Timex
+and Layer 2 ports and the 8K pages in use by the ULA, the tilemap and Layer 2.
+The screen mode is only stored for information; the dump is rendered on a host
+("host/vsrender").
+@return "EOK" = no error
+*/
+int saveStateImage(const screenmode_t* pInfo);
+
+/*============================================================================*/
+/*                               Classes                                      */
+/*============================================================================*/
+
+/*============================================================================*/
+/*                               Implementation                               */
+/*============================================================================*/
+
+/*----------------------------------------------------------------------------*/
+/*                                                                            */
+/*----------------------------------------------------------------------------*/
+
+#endif /* __VSTATE_H__ */
@@ -0,0 +1,107 @@
+/*-----------------------------------------------------------------------------+
+|                                                                              |
+| filename: walker.h                                                           |
+| project:  zxn::scrnshot                                                      |
+| author:   S. Zell                                                            |
+| date:     10/18/2026                                                         |
+|                                                                              |
++------------------------------------------------------------------------------+
+|                                                                              |
+| description:                                                                 |
+|                                                                              |
+| Row walker over the ULA and Timex screen layout: steps pixel and attribute   |
+| rows incrementally instead of calculating the address of every row           |
+|                                                                              |
++------------------------------------------------------------------------------+
+|                                                                              |
+| Copyright (c) 10/18/2026 STZ Engineering                                     |
+|                                                                              |
+| This software is provided  "as is",  without warranty of any kind, express   |
+| or implied. In no event shall STZ or its contributors be held liable for any |
+| direct, indirect, incidental, special or consequential damages arising out   |
+| of the use of or inability to use this software.                             |
+|                                                                              |
+| Permission is granted to anyone  to use this  software for any purpose,      |
+| including commercial applications,  and to alter it and redistribute it      |
+| freely, subject to the following restrictions:                               |
+|                                                                              |
+| 1. Redistributions of source code must retain the above copyright            |
+|    notice, definition, disclaimer, and this list of conditions.              |
+|                                                                              |
+| 2. Redistributions in binary form must reproduce the above copyright         |
+|    notice, definition, disclaimer, and this list of conditions in            |
+|    documentation and/or other materials provided with the distribution.      |
+|                                                                          ;-) |
++-----------------------------------------------------------------------------*/
+
+#if !defined(__WALKER_H__)
+  #define __WALKER_H__
+
+/*============================================================================*/
+/*                               Includes                                     */
+/*============================================================================*/
+
+/*============================================================================*/
+/*                               Defines                                      */
+/*============================================================================*/
+/*!
+Distance of the second Timex screen (0x6000) from the first one (0x4000):
+HiRes columns and HiColor attributes of a row
+*/
+#define WALK_SCREEN1 0x2000
+
+/*============================================================================*/
+/*                               Namespaces                                   */
+/*============================================================================*/
+
+/*============================================================================*/
+/*                               Constants                                    */
+/*============================================================================*/
+
+/*============================================================================*/
+/*                               Variables                                    */
+/*============================================================================*/
+
+/*============================================================================*/
+/*                               Structures                                   */
+/*============================================================================*/
+
+/*============================================================================*/
+/*                               Type-Definitions                             */
+/*============================================================================*/
+/*!
+Row walker over the ULA screen layout (thirds, character rows, pixel lines of
+the Spectrum; also the Timex screens at 0x4000 and 0x6000). The offset of the
+row is kept as "000T TLLL RRR0 0000" without the screen address, so the steps
+work on the host shim as well.
+*/
+typedef struct _ulawalk
+{
+  const uint8_t* pPixel;    /* pixel row, column 0                         */
+  const uint8_t* pAttr;     /* attribute row of the character row (ULA)    */
+  uint16_t       uiOffset;  /* offset of the pixel row in the screen       */
+} ulawalk_t;
+
+/*============================================================================*/
+/*                               Prototypes                                   */
+/*============================================================================*/
+/*!
+Starts the walk at the given row
+@param pWalk   Walker
+@param pScreen Pixel data of the screen (0x4000)
+@param pAttrs  Attributes of the screen (0x5800)
+@param uiY     Pixel row (0 .. 191)
+*/
+void initUlaWalk(ulawalk_t* pWalk, const uint8_t* pScreen, const uint8_t* pAttrs, uint8_t uiY);
+
+/*!
+Steps pixel and attribute row to the next row of the walk, PIXELDN-style:
+inside of a character cell only the line bits change; at the boundary of a
+cell the character row, at the boundary of a third the third changes.
+@param pWalk Walker
+@param iStep Rows to step (1, 2, 4 down or -1, -2, -4 up; the start row is a
+             multiple of it, see "getImageRect()")
+*/
+void stepUlaWalk(ulawalk_t* pWalk, int8_t iStep);
+
+#endif /* __WALKER_H__ */
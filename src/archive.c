@@ -0,0 +1,275 @@
+/*-----------------------------------------------------------------------------+
+|                                                                              |
+| filename: archive.c                                                          |
+| project:  zxn::scrnshot                                                      |
+| author:   S. Zell                                                            |
+| date:     10/18/2026                                                         |
+|                                                                              |
++------------------------------------------------------------------------------+
+|                                                                              |
+| description:                                                                 |
+|                                                                              |
+| Append-only archive of screenshots (one container file)                      |
+|                                                                              |
++------------------------------------------------------------------------------+
+|                                                                              |
+| Copyright (c) 10/18/2026 STZ Engineering                                     |
+|                                                                              |
+| This software is provided  "as is",  without warranty of any kind, express   |
+| or implied. In no event shall STZ or its contributors be held liable for any |
+| direct, indirect, incidental, special or consequential damages arising out   |
+| of the use of or inability to use this software.                             |
+|                                                                              |
+| Permission is granted to anyone  to use this  software for any purpose,      |
+| including commercial applications,  and to alter it and redistribute it      |
+| freely, subject to the following restrictions:                               |
+|                                                                              |
+| 1. Redistributions of source code must retain the above copyright            |
+|    notice, definition, disclaimer, and this list of conditions.              |
+|                                                                              |
+| 2. Redistributions in binary form must reproduce the above copyright         |
+|    notice, definition, disclaimer, and this list of conditions in            |
+|    documentation and/or other materials provided with the distribution.      |
+|                                                                          ;-) |
++-----------------------------------------------------------------------------*/
+
+/*============================================================================*/
+/*                               Includes                                     */
+/*============================================================================*/
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <arch/zxn.h>
+#include <arch/zxn/esxdos.h>
+
+#include "libzxn.h"
+#include "scrnshot.h"
+#include "archive.h"
+#include "bench.h"
+#include "version.h"
+
+/*============================================================================*/
+/*                               Defines                                      */
+/*============================================================================*/
+
+/*============================================================================*/
+/*                               Namespaces                                   */
+/*============================================================================*/
+
+/*============================================================================*/
+/*                               Constants                                    */
+/*============================================================================*/
+
+/*============================================================================*/
+/*                               Variables                                    */
+/*============================================================================*/
+/*!
+In dieser Struktur werden alle globalen Daten der Anwendung gespeichert.
+*/
+extern appstate_t g_tState;
+
+/*============================================================================*/
+/*                               Structures                                   */
+/*============================================================================*/
+
+/*============================================================================*/
+/*                               Type-Definitions                             */
+/*============================================================================*/
+
+/*============================================================================*/
+/*                               Prototypes                                   */
+/*============================================================================*/
+/*!
+Creates a new, pre-grown archive with an empty index
+*/
+static int createArchive(archiveheader_t* pHeader);
+
+/*============================================================================*/
+/*                               Classes                                      */
+/*============================================================================*/
+
+/*============================================================================*/
+/*                               Implementation                               */
+/*============================================================================*/
+
+/*----------------------------------------------------------------------------*/
+/* saveArchiveImage()                                                         */
+/*----------------------------------------------------------------------------*/
+int saveArchiveImage(const screenmode_t* pInfo)
+{
+  int iReturn = EOK;
+  archiveheader_t tHeader;
+  archiveentry_t  tEntry;
+  struct dos_tm   tTime;
+  uint32_t        uiEnd;
+
+  if ((0 == pInfo) || (1 != g_tState.uiOutputs))
+  {
+    return EINVAL; /* option "-o" is not supported */
+  }
+
+  /* Directory: default name of the archive */
+  if (INV_FILE_HND != (g_tState.bmpfile.hFile = esx_f_opendir(g_tState.bmpfile.acPathName)))
+  {
+    esx_f_closedir(g_tState.bmpfile.hFile);
+
+    strncat(g_tState.bmpfile.acPathName,
+            ESX_DIR_SEP VER_INTERNALNAME_STR ".sca",
+            sizeof(g_tState.bmpfile.acPathName) - strlen(g_tState.bmpfile.acPathName) - 1);
+  }
+
+  /* Open the archive or create a new one */
+  if (INV_FILE_HND != (g_tState.bmpfile.hFile = esx_f_open(g_tState.bmpfile.acPathName, ESXDOS_MODE_R | ESXDOS_MODE_W | ESXDOS_MODE_OE)))
+  {
+    if ((sizeof(tHeader) != esx_f_read(g_tState.bmpfile.hFile, &tHeader, sizeof(tHeader))) ||
+        (0 != memcmp(tHeader.acMagic, ARCHIVE_MAGIC, sizeof(tHeader.acMagic))))
+    {
+      iReturn = EBADF; /* Error: no archive */
+    }
+  }
+  else
+  {
+    iReturn = createArchive(&tHeader);
+  }
+
+  if ((EOK == iReturn) && (tHeader.uiEntries >= tHeader.uiEntriesMax))
+  {
+    iReturn = ERANGE; /* Error: archive is full */
+  }
+
+  /* Append the image behind the last one */
+  if (EOK == iReturn)
+  {
+    if (tHeader.uiDataEnd != esx_f_seek(g_tState.bmpfile.hFile, tHeader.uiDataEnd, ESX_SEEK_SET))
+    {
+      iReturn = EBADF;
+    }
+    else
+    {
+      g_tState.atOutputs[0].eFormat     = g_tState.eFormat;
+      g_tState.atOutputs[0].acNativeExt = g_tState.acNativeExt;
+      g_tState.atOutputs[0].hFile       = g_tState.bmpfile.hFile;
+
+      iReturn = captureImage(pInfo);
+
+      g_tState.atOutputs[0].hFile   = INV_FILE_HND;
+      uiEnd = esx_f_fgetpos(g_tState.bmpfile.hFile);
+    }
+  }
+
+  /* Index entry, then header: an interrupted capture leaves the index valid */
+  if (EOK == iReturn)
+  {
+    memset(&tEntry, 0, sizeof(tEntry));
+
+    if (0 == esx_m_getdate(&tTime))
+    {
+      tEntry.uiTime = tTime.time;
+      tEntry.uiDate = tTime.date;
+    }
+
+    tEntry.uiMode   = pInfo->uiMode;
+    tEntry.uiFormat = (uint8_t) g_tState.eFormat;
+    tEntry.uiOffset = tHeader.uiDataEnd;
+    tEntry.uiLength = uiEnd - tHeader.uiDataEnd;
+
+    tHeader.uiDataEnd  = uiEnd;
+    tHeader.uiCapacity = (uiEnd > tHeader.uiCapacity ? uiEnd : tHeader.uiCapacity);
+
+    STATS_WRITE(2); /* index entry and header */
+
+    if ((sizeof(tHeader) + tHeader.uiEntries * sizeof(tEntry)) != esx_f_seek(g_tState.bmpfile.hFile, sizeof(tHeader) + tHeader.uiEntries * sizeof(tEntry), ESX_SEEK_SET))
+    {
+      iReturn = EBADF;
+    }
+    else if (sizeof(tEntry) != esx_f_write(g_tState.bmpfile.hFile, &tEntry, sizeof(tEntry)))
+    {
+      iReturn = EBADF;
+    }
+    else
+    {
+      ++tHeader.uiEntries;
+
+      if ((0 != esx_f_seek(g_tState.bmpfile.hFile, 0, ESX_SEEK_SET)) ||
+          (sizeof(tHeader) != esx_f_write(g_tState.bmpfile.hFile, &tHeader, sizeof(tHeader))))
+      {
+        iReturn = EBADF;
+      }
+    }
+  }
+
+  if (INV_FILE_HND != g_tState.bmpfile.hFile)
+  {
+    (void) esx_f_close(g_tState.bmpfile.hFile);
+    g_tState.bmpfile.hFile = INV_FILE_HND;
+  }
+
+  return iReturn;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* createArchive()                                                            */
+/*----------------------------------------------------------------------------*/
+static int createArchive(archiveheader_t* pHeader)
+{
+  int iReturn = EOK;
+  uint8_t uiBank;
+  uint8_t uiMMU3;
+  uint8_t* pPage = (uint8_t*) zxn_memmap(WORK_BANK_ADDR);
+
+  memcpy(pHeader->acMagic, ARCHIVE_MAGIC, sizeof(pHeader->acMagic));
+  pHeader->uiEntries    = 0;
+  pHeader->uiEntriesMax = ARCHIVE_ENTRIES_MAX;
+  pHeader->uiDataEnd    = ARCHIVE_DATA_START;
+  pHeader->uiCapacity   = ARCHIVE_SIZE_INITIAL;
+
+  if (INV_BANK == (uiBank = allocBank()))
+  {
+    return ENOMEM;
+  }
+
+  if (INV_FILE_HND == (g_tState.bmpfile.hFile = esx_f_open(g_tState.bmpfile.acPathName, ESXDOS_MODE_R | ESXDOS_MODE_W | ESXDOS_MODE_CN)))
+  {
+    freeBank(uiBank);
+    return EACCES;
+  }
+
+  /* Header, empty index and zeroed data area: clusters are allocated once */
+  uiMMU3 = ZXN_READ_MMU3();
+  STATS_MMU3(uiBank);
+
+  memset(pPage, 0, 0x2000);
+  memcpy(pPage, pHeader, sizeof(*pHeader));
+
+  for (uint32_t uiSize = 0; uiSize < ARCHIVE_SIZE_INITIAL; uiSize += 0x2000)
+  {
+    STATS_WRITE(1);
+
+    if (0x2000 != esx_f_write(g_tState.bmpfile.hFile, pPage, 0x2000))
+    {
+      iReturn = EBADF;
+      break;
+    }
+
+    memset(pPage, 0, sizeof(*pHeader));
+  }
+
+  STATS_MMU3(uiMMU3);
+  freeBank(uiBank);
+
+  if (EOK != iReturn)
+  {
+    (void) esx_f_close(g_tState.bmpfile.hFile);
+    g_tState.bmpfile.hFile = INV_FILE_HND;
+    (void) esx_f_unlink(g_tState.bmpfile.acPathName);
+  }
+
+  return iReturn;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/*                                                                            */
+/*----------------------------------------------------------------------------*/
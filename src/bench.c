@@ -0,0 +1,440 @@
+/*-----------------------------------------------------------------------------+
+|                                                                              |
+| filename: bench.c                                                            |
+| project:  zxn::scrnshot                                                      |
+| author:   S. Zell                                                            |
+| date:     10/18/2026                                                         |
+|                                                                              |
++------------------------------------------------------------------------------+
+|                                                                              |
+| description:                                                                 |
+|                                                                              |
+| On-device benchmark and counters of the capture: the phases of the           |
+| screenshot are timed with the chained CTC channels 0-3 for the discard and   |
+| the file sink (option "-B") or counted on the hot paths (option "-S")        |
+|                                                                              |
++------------------------------------------------------------------------------+
+|                                                                              |
+| Copyright (c) 10/18/2026 STZ Engineering                                     |
+|                                                                              |
+| This software is provided  "as is",  without warranty of any kind, express   |
+| or implied. In no event shall STZ or its contributors be held liable for any |
+| direct, indirect, incidental, special or consequential damages arising out   |
+| of the use of or inability to use this software.                             |
+|                                                                              |
+| Permission is granted to anyone  to use this  software for any purpose,      |
+| including commercial applications,  and to alter it and redistribute it      |
+| freely, subject to the following restrictions:                               |
+|                                                                              |
+| 1. Redistributions of source code must retain the above copyright            |
+|    notice, definition, disclaimer, and this list of conditions.              |
+|                                                                              |
+| 2. Redistributions in binary form must reproduce the above copyright         |
+|    notice, definition, disclaimer, and this list of conditions in            |
+|    documentation and/or other materials provided with the distribution.      |
+|                                                                          ;-) |
++-----------------------------------------------------------------------------*/
+
+/*============================================================================*/
+/*                               Includes                                     */
+/*============================================================================*/
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <z80.h>
+#include <arch/zxn.h>
+#include <arch/zxn/esxdos.h>
+
+#include "libzxn.h"
+#include "scrnshot.h"
+#include "bench.h"
+
+/*============================================================================*/
+/*                               Defines                                      */
+/*============================================================================*/
+/*!
+Ports of the CTC channels 0-3 (0x183B, 0x193B, 0x1A3B, 0x1B3B)
+*/
+#define CTC_PORT(n) (0x183B + (((uint16_t) (n)) << 8))
+
+/*!
+Control words of the CTC: timer (prescaler 16) and counter of the ZC/TO of
+the previous channel, time constant follows, software reset; stop = reset
+*/
+#define CTC_TIMER   0x07
+#define CTC_COUNTER 0x47
+#define CTC_STOP    0x03
+
+/*!
+Chain of the channels with the 28 MHz clock: 28 MHz / 16 / 175 = 100 us,
+/ 10 = 1 ms, / 256 = 256 ms, / 256 = 65.5 s
+*/
+#define CTC_TC_100US BENCH_TICKS_100US
+#define CTC_TC_1MS   10
+
+/*!
+Wrap of the timer in ticks (channel 3 counts 256 * 256 ms)
+*/
+#define BENCH_WRAP (655360UL * BENCH_TICKS_100US)
+
+/*!
+Ticks to us (16 clocks at 28 MHz = 4/7 us)
+*/
+#define BENCH_TICKS_TO_US(t) ((((uint32_t) (t)) * 4) / 7)
+
+/*============================================================================*/
+/*                               Namespaces                                   */
+/*============================================================================*/
+
+/*============================================================================*/
+/*                               Constants                                    */
+/*============================================================================*/
+/*!
+Names of the phases (index "benchphase_t"; last = sum of all phases)
+*/
+static const char_t* s_acPhases[BENCH_PHASES + 1] =
+{
+  "other", "header", "palette", "pixels", "trailer", "write", "total"
+};
+
+/*============================================================================*/
+/*                               Variables                                    */
+/*============================================================================*/
+/*!
+In dieser Struktur werden alle globalen Daten der Anwendung gespeichert.
+*/
+extern appstate_t g_tState;
+
+/*!
+Times of all runs of one sink (ticks) per phase and the total
+*/
+static struct _benchstate
+{
+  uint32_t auiRuns[BENCH_PHASES + 1][BENCH_RUNS_MAX];
+} s_tBench;
+
+/*============================================================================*/
+/*                               Structures                                   */
+/*============================================================================*/
+
+/*============================================================================*/
+/*                               Type-Definitions                             */
+/*============================================================================*/
+
+/*============================================================================*/
+/*                               Prototypes                                   */
+/*============================================================================*/
+/*!
+Starts the chain of the CTC channels 0-3 at 0
+*/
+static void startTimer(void);
+
+/*!
+Stops the CTC channels 0-3
+*/
+static void stopTimer(void);
+
+/*!
+Reads the chain of the CTC channels (the counters are read again until the
+higher channels are stable)
+@return Time since "startTimer" in ticks of 16 clocks
+*/
+static uint32_t readTimer(void);
+
+/*!
+Time since "uiStart" in ticks (timer wrapped at most once)
+*/
+static uint32_t getElapsed(uint32_t uiStart, uint32_t uiNow);
+
+/*!
+Prints minimum, median and maximum of all phases of the runs of one sink
+*/
+static void printBenchResults(const char_t* acSink);
+
+/*============================================================================*/
+/*                               Classes                                      */
+/*============================================================================*/
+
+/*============================================================================*/
+/*                               Implementation                               */
+/*============================================================================*/
+
+/*----------------------------------------------------------------------------*/
+/* runBenchmark()                                                             */
+/*----------------------------------------------------------------------------*/
+int runBenchmark(void)
+{
+  int iReturn = EOK;
+  bool bTimer = g_tState.bench.bTimer; /* already running for "-S" */
+
+  if (SINK_FILE != g_tState.bmpfile.eSink)
+  {
+    return EINVAL; /* UART: not timed */
+  }
+
+  if (!bTimer)
+  {
+    startTimer();
+  }
+
+  for (uint8_t uiSink = 0; (EOK == iReturn) && (uiSink < 2); ++uiSink)
+  {
+    g_tState.bmpfile.eSink = (0 == uiSink ? SINK_NULL : SINK_FILE);
+
+    for (uint8_t uiRun = 0; (EOK == iReturn) && (uiRun < g_tState.bench.uiRuns); ++uiRun)
+    {
+      uint32_t uiTotal = 0;
+
+      memset(g_tState.bench.auiTimes, 0, sizeof(g_tState.bench.auiTimes));
+      g_tState.bench.ePhase  = BENCH_OTHER;
+      g_tState.bench.uiStart = readTimer();
+
+      iReturn = makeScreenshot();
+
+      (void) setBenchPhase(BENCH_OTHER);
+
+      for (uint8_t i = 0; i < BENCH_PHASES; ++i)
+      {
+        s_tBench.auiRuns[i][uiRun] = g_tState.bench.auiTimes[i];
+        uiTotal += g_tState.bench.auiTimes[i];
+      }
+
+      s_tBench.auiRuns[BENCH_PHASES][uiRun] = uiTotal;
+
+      /* The first run resolves the name of the file; all others replace it */
+      if (SINK_FILE == g_tState.bmpfile.eSink)
+      {
+        g_tState.bForce = true;
+      }
+    }
+
+    if (EOK == iReturn)
+    {
+      printBenchResults(0 == uiSink ? "discard" : "file");
+    }
+  }
+
+  if (!bTimer)
+  {
+    stopTimer();
+  }
+
+  g_tState.bmpfile.eSink = SINK_FILE;
+
+  return iReturn;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* setBenchPhase()                                                            */
+/*----------------------------------------------------------------------------*/
+benchphase_t setBenchPhase(benchphase_t ePhase)
+{
+  benchphase_t ePrevious = g_tState.bench.ePhase;
+  uint32_t uiNow = readTimer();
+
+  g_tState.bench.auiTimes[ePrevious] += getElapsed(g_tState.bench.uiStart, uiNow);
+  g_tState.bench.uiStart = uiNow;
+  g_tState.bench.ePhase  = ePhase;
+
+  return ePrevious;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* beginStats()                                                               */
+/*----------------------------------------------------------------------------*/
+void beginStats(void)
+{
+  g_tState.stats.uiBytes       = 0;
+  g_tState.stats.uiWrites      = 0;
+  g_tState.stats.uiMmuSwitches = 0;
+  g_tState.stats.uiPaletteRegs = 0;
+  g_tState.stats.uiDiTime      = 0;
+
+  memset(g_tState.bench.auiTimes, 0, sizeof(g_tState.bench.auiTimes));
+  g_tState.bench.ePhase = BENCH_OTHER;
+
+  startTimer();
+
+  g_tState.bench.uiStart = readTimer();
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* endStats()                                                                 */
+/*----------------------------------------------------------------------------*/
+void endStats(void)
+{
+  statsblock_t tBlock;
+
+  (void) setBenchPhase(BENCH_OTHER);
+  stopTimer();
+
+  tBlock.uiBytes       = g_tState.stats.uiBytes;
+  tBlock.uiWrites      = g_tState.stats.uiWrites;
+  tBlock.uiMmuSwitches = g_tState.stats.uiMmuSwitches;
+  tBlock.uiPaletteRegs = g_tState.stats.uiPaletteRegs;
+  tBlock.uiDiTime      = BENCH_TICKS_TO_US(g_tState.stats.uiDiTime);
+
+  for (uint8_t i = 0; i < BENCH_PHASES; ++i)
+  {
+    tBlock.auiPhases[i] = BENCH_TICKS_TO_US(g_tState.bench.auiTimes[i]);
+  }
+
+  /*      0.........1.........2.........3. */
+  printf("bytes %lu\n",    (unsigned long) tBlock.uiBytes);
+  printf("writes %u\n",    tBlock.uiWrites);
+  printf("mmu %u\n",       tBlock.uiMmuSwitches);
+  printf("palette %u\n",   tBlock.uiPaletteRegs);
+  printf("di_us %lu\n",    (unsigned long) tBlock.uiDiTime);
+
+  for (uint8_t i = 0; i < BENCH_PHASES; ++i)
+  {
+    printf("%s_us %lu\n", s_acPhases[i], (unsigned long) tBlock.auiPhases[i]);
+  }
+
+  if (0 != g_tState.stats.uiAddr)
+  {
+    memcpy(zxn_memmap(g_tState.stats.uiAddr), &tBlock, sizeof(tBlock));
+  }
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* beginDiTime()                                                              */
+/*----------------------------------------------------------------------------*/
+void beginDiTime(void)
+{
+  g_tState.stats.uiDiStart = readTimer();
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* endDiTime()                                                                */
+/*----------------------------------------------------------------------------*/
+void endDiTime(void)
+{
+  g_tState.stats.uiDiTime += getElapsed(g_tState.stats.uiDiStart, readTimer());
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* startTimer()                                                               */
+/*----------------------------------------------------------------------------*/
+static void startTimer(void)
+{
+  /* Counters first: they wait for the pulses of channel 0 */
+  for (uint8_t i = 3; i > 0; --i)
+  {
+    z80_outp(CTC_PORT(i), CTC_COUNTER);
+    z80_outp(CTC_PORT(i), (1 == i ? CTC_TC_1MS : 0)); /* 0 = 256 */
+  }
+
+  z80_outp(CTC_PORT(0), CTC_TIMER);
+  z80_outp(CTC_PORT(0), CTC_TC_100US);
+
+  g_tState.bench.bTimer = true;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* stopTimer()                                                                */
+/*----------------------------------------------------------------------------*/
+static void stopTimer(void)
+{
+  for (uint8_t i = 0; i < 4; ++i)
+  {
+    z80_outp(CTC_PORT(i), CTC_STOP);
+  }
+
+  g_tState.bench.bTimer = false;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* readTimer()                                                                */
+/*----------------------------------------------------------------------------*/
+static uint32_t readTimer(void)
+{
+  uint8_t uiCount0;
+  uint8_t uiCount1;
+  uint8_t uiCount2;
+  uint8_t uiCount3;
+
+  do
+  {
+    uiCount3 = z80_inp(CTC_PORT(3));
+    uiCount2 = z80_inp(CTC_PORT(2));
+    uiCount1 = z80_inp(CTC_PORT(1));
+    uiCount0 = z80_inp(CTC_PORT(0));
+  }
+  while ((uiCount3 != z80_inp(CTC_PORT(3))) ||
+         (uiCount2 != z80_inp(CTC_PORT(2))) ||
+         (uiCount1 != z80_inp(CTC_PORT(1))));
+
+  /* Down counters: elapsed = time constant - count (256 is read as 0) */
+  return (((((uint32_t) ((uint8_t) (0 - uiCount3))) * 2560UL) +
+           (((uint16_t) ((uint8_t) (0 - uiCount2))) * 10) +
+           ((uint8_t) (CTC_TC_1MS - uiCount1))) * CTC_TC_100US) +
+         ((uint8_t) (CTC_TC_100US - uiCount0));
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* getElapsed()                                                               */
+/*----------------------------------------------------------------------------*/
+static uint32_t getElapsed(uint32_t uiStart, uint32_t uiNow)
+{
+  return (uiNow >= uiStart ? uiNow - uiStart : (uiNow + BENCH_WRAP) - uiStart);
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* printBenchResults()                                                        */
+/*----------------------------------------------------------------------------*/
+static void printBenchResults(const char_t* acSink)
+{
+  uint8_t uiRuns = g_tState.bench.uiRuns;
+
+  /*      0.........1.........2.........3. */
+  printf("%-8s    min    med    max\n", acSink);
+
+  for (uint8_t i = 0; i <= BENCH_PHASES; ++i)
+  {
+    uint32_t* pRuns = s_tBench.auiRuns[i];
+
+    /* Insertion sort: minimum, median and maximum */
+    for (uint8_t j = 1; j < uiRuns; ++j)
+    {
+      uint32_t uiTime = pRuns[j];
+      uint8_t k = j;
+
+      while ((0 < k) && (pRuns[k - 1] > uiTime))
+      {
+        pRuns[k] = pRuns[k - 1];
+        --k;
+      }
+
+      pRuns[k] = uiTime;
+    }
+
+    /* Ticks to 0.1 ms */
+    for (uint8_t j = 0; j < uiRuns; ++j)
+    {
+      pRuns[j] /= BENCH_TICKS_100US;
+    }
+
+    printf("%-8s%5lu.%u%5lu.%u%5lu.%u\n",
+           s_acPhases[i],
+           (unsigned long) (pRuns[0] / 10),          (uint16_t) (pRuns[0] % 10),
+           (unsigned long) (pRuns[uiRuns / 2] / 10), (uint16_t) (pRuns[uiRuns / 2] % 10),
+           (unsigned long) (pRuns[uiRuns - 1] / 10), (uint16_t) (pRuns[uiRuns - 1] % 10));
+  }
+}
+
+
+/*----------------------------------------------------------------------------*/
+/*                                                                            */
+/*----------------------------------------------------------------------------*/
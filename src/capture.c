@@ -0,0 +1,301 @@
+/*-----------------------------------------------------------------------------+
+|                                                                              |
+| filename: capture.c                                                          |
+| project:  zxn::scrnshot                                                      |
+| author:   S. Zell                                                            |
+| date:     10/18/2026                                                         |
+|                                                                              |
++------------------------------------------------------------------------------+
+|                                                                              |
+| description:                                                                 |
+|                                                                              |
+| Capture of screenshots to RAM pages (no file system access)                  |
+|                                                                              |
++------------------------------------------------------------------------------+
+|                                                                              |
+| Copyright (c) 10/18/2026 STZ Engineering                                     |
+|                                                                              |
+| This software is provided  "as is",  without warranty of any kind, express   |
+| or implied. In no event shall STZ or its contributors be held liable for any |
+| direct, indirect, incidental, special or consequential damages arising out   |
+| of the use of or inability to use this software.                             |
+|                                                                              |
+| Permission is granted to anyone  to use this  software for any purpose,      |
+| including commercial applications,  and to alter it and redistribute it      |
+| freely, subject to the following restrictions:                               |
+|                                                                              |
+| 1. Redistributions of source code must retain the above copyright            |
+|    notice, definition, disclaimer, and this list of conditions.              |
+|                                                                              |
+| 2. Redistributions in binary form must reproduce the above copyright         |
+|    notice, definition, disclaimer, and this list of conditions in            |
+|    documentation and/or other materials provided with the distribution.      |
+|                                                                          ;-) |
++-----------------------------------------------------------------------------*/
+
+/*============================================================================*/
+/*                               Includes                                     */
+/*============================================================================*/
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <intrinsic.h>
+#include <arch/zxn.h>
+#include <arch/zxn/esxdos.h>
+
+#include "libzxn.h"
+#include "scrnshot.h"
+#include "native.h"
+#include "capture.h"
+#include "bench.h"
+
+/*============================================================================*/
+/*                               Defines                                      */
+/*============================================================================*/
+
+/*============================================================================*/
+/*                               Namespaces                                   */
+/*============================================================================*/
+
+/*============================================================================*/
+/*                               Constants                                    */
+/*============================================================================*/
+
+/*============================================================================*/
+/*                               Variables                                    */
+/*============================================================================*/
+/*!
+In dieser Struktur werden alle globalen Daten der Anwendung gespeichert.
+*/
+extern appstate_t g_tState;
+
+/*!
+State of the running capture
+*/
+static struct _capturestate
+{
+  capture_t* pCapture;  /* Descriptor of the running capture      */
+  uint16_t   uiOffset;  /* Write position in the last page        */
+} s_tCapture;
+
+/*============================================================================*/
+/*                               Structures                                   */
+/*============================================================================*/
+
+/*============================================================================*/
+/*                               Type-Definitions                             */
+/*============================================================================*/
+
+/*============================================================================*/
+/*                               Prototypes                                   */
+/*============================================================================*/
+
+/*============================================================================*/
+/*                               Classes                                      */
+/*============================================================================*/
+
+/*============================================================================*/
+/*                               Implementation                               */
+/*============================================================================*/
+
+/*----------------------------------------------------------------------------*/
+/* captureScreen()                                                            */
+/*----------------------------------------------------------------------------*/
+int captureScreen(format_t eFormat, capture_t* pCapture)
+{
+  int iReturn = EOK;
+  const screenmode_t* pInfo = getScreenModeInfo(detectScreenMode());
+  format_t eFormat_ = g_tState.eFormat;
+  uint8_t  uiOutputs_ = g_tState.uiOutputs;
+  output_t tOutput_ = g_tState.atOutputs[0];
+
+  if (0 == pCapture)
+  {
+    return EINVAL;
+  }
+
+  memset(pCapture, 0, sizeof(*pCapture));
+  memset(pCapture->auiBanks, INV_BANK, sizeof(pCapture->auiBanks));
+
+  g_tState.eFormat = (FORMAT_NONE == eFormat ? FORMAT_BMP : eFormat);
+
+  /* Native and compressed images: only for modes with a native file type */
+  if ((0 == pInfo) ||
+      (((FORMAT_NATIVE == g_tState.eFormat) || (FORMAT_ZX0 == g_tState.eFormat)) && (0 == getNativeFileExt(pInfo->uiMode, 0))))
+  {
+    iReturn = ENOTSUP;
+  }
+
+  if (EOK == iReturn)
+  {
+    s_tCapture.pCapture = pCapture;
+    s_tCapture.uiOffset = CAPTURE_BANK_SIZE; /* allocate a page on first write */
+
+    /* One output: the RAM pages */
+    g_tState.uiOutputs            = 1;
+    g_tState.atOutputs[0].eFormat     = g_tState.eFormat;
+    g_tState.atOutputs[0].acNativeExt = g_tState.acNativeExt;
+    g_tState.atOutputs[0].hFile       = INV_FILE_HND;
+
+    g_tState.bmpfile.eSink = SINK_BANKS;
+    iReturn = captureImage(pInfo);
+    g_tState.bmpfile.eSink = SINK_FILE;
+
+    g_tState.uiOutputs    = uiOutputs_;
+    g_tState.atOutputs[0] = tOutput_;
+
+    s_tCapture.pCapture = 0;
+  }
+
+  if (EOK != iReturn)
+  {
+    releaseCapture(pCapture);
+  }
+
+  g_tState.eFormat = eFormat_;
+
+  return iReturn;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* releaseCapture()                                                           */
+/*----------------------------------------------------------------------------*/
+void releaseCapture(capture_t* pCapture)
+{
+  if (0 != pCapture)
+  {
+    for (uint8_t i = 0; i < pCapture->uiBanks; ++i)
+    {
+      (void) esx_ide_bank_free(0, pCapture->auiBanks[i]); /* 0 = RAM */
+      pCapture->auiBanks[i] = INV_BANK;
+    }
+
+    pCapture->uiBanks  = 0;
+    pCapture->uiLength = 0;
+  }
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* writeCaptureData()                                                         */
+/*----------------------------------------------------------------------------*/
+int writeCaptureData(const void* pData, uint16_t uiLen)
+{
+  capture_t* pCapture = s_tCapture.pCapture;
+  const uint8_t* pSrc = (const uint8_t*) pData;
+  uint16_t uiChunk;
+  uint16_t uiSrc;
+  uint8_t  uiBank;
+  uint8_t  uiMMU;
+
+  if (0 == pCapture)
+  {
+    return EINVAL;
+  }
+
+  while (0 < uiLen)
+  {
+    /* Next page */
+    if (CAPTURE_BANK_SIZE <= s_tCapture.uiOffset)
+    {
+      if ((CAPTURE_BANKS_MAX <= pCapture->uiBanks) || (INV_BANK == (uiBank = esx_ide_bank_alloc(0)))) /* 0 = RAM */
+      {
+        return ENOMEM;
+      }
+
+      pCapture->auiBanks[pCapture->uiBanks++] = uiBank;
+      s_tCapture.uiOffset = 0;
+    }
+
+    uiChunk = CAPTURE_BANK_SIZE - s_tCapture.uiOffset;
+    uiChunk = (uiLen < uiChunk ? uiLen : uiChunk);
+    uiSrc   = (uint16_t) (uintptr_t) pSrc;   /* Z80 address */
+
+    /*
+    The page is mapped to the MMU slot (MMU2/MMU3) that is not used by the
+    source (video memory, working pages of the encoders). A source crossing
+    0x6000 is split.
+    */
+    if ((0x6000 > uiSrc) && ((0x6000 - uiSrc) < uiChunk))
+    {
+      uiChunk = 0x6000 - uiSrc;
+    }
+
+    uiBank = pCapture->auiBanks[pCapture->uiBanks - 1];
+
+    STATS_DI();
+
+    if ((0x6000 <= uiSrc) && (0x8000 > uiSrc))
+    {
+      uiMMU = ZXN_READ_MMU2();
+      STATS_MMU2(uiBank);
+      memcpy(((uint8_t*) zxn_memmap(0x4000)) + s_tCapture.uiOffset, pSrc, uiChunk);
+      STATS_MMU2(uiMMU);
+    }
+    else
+    {
+      uiMMU = ZXN_READ_MMU3();
+      STATS_MMU3(uiBank);
+      memcpy(((uint8_t*) zxn_memmap(WORK_BANK_ADDR)) + s_tCapture.uiOffset, pSrc, uiChunk);
+      STATS_MMU3(uiMMU);
+    }
+
+    STATS_EI();
+
+    s_tCapture.uiOffset += uiChunk;
+    pCapture->uiLength  += uiChunk;
+    pSrc                += uiChunk;
+    uiLen               -= uiChunk;
+  }
+
+  return EOK;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* makeCapture()                                                              */
+/*----------------------------------------------------------------------------*/
+int makeCapture(void)
+{
+  int iReturn;
+  capture_t tCapture;
+
+  if (1 != g_tState.uiOutputs)
+  {
+    return EINVAL; /* option "-o" is not supported */
+  }
+
+  if (EOK == (iReturn = captureScreen(g_tState.eFormat, &tCapture)))
+  {
+    /* Descriptor for the caller (e.g. NextBASIC: PEEK) */
+    if (0 != g_tState.uiCaptureAddr)
+    {
+      memcpy(zxn_memmap(g_tState.uiCaptureAddr), &tCapture, sizeof(tCapture));
+    }
+
+    if (!g_tState.bQuiet)
+    {
+      char_t acLength[12];
+
+      ultoa(tCapture.uiLength, acLength, 10);
+      printf("%s bytes, pages:", acLength);
+
+      for (uint8_t i = 0; i < tCapture.uiBanks; ++i)
+      {
+        printf(" %u", tCapture.auiBanks[i]);
+      }
+
+      printf("\n");
+    }
+  }
+
+  return iReturn;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/*                                                                            */
+/*----------------------------------------------------------------------------*/
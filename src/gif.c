@@ -0,0 +1,505 @@
+/*-----------------------------------------------------------------------------+
+|                                                                              |
+| filename: gif.c                                                              |
+| project:  zxn::scrnshot                                                      |
+| author:   S. Zell                                                            |
+| date:     10/18/2026                                                         |
+|                                                                              |
++------------------------------------------------------------------------------+
+|                                                                              |
+| description:                                                                 |
+|                                                                              |
+| GIF (LZW) encoder for paletted images                                        |
+|                                                                              |
++------------------------------------------------------------------------------+
+|                                                                              |
+| Copyright (c) 10/18/2026 STZ Engineering                                     |
+|                                                                              |
+| This software is provided  "as is",  without warranty of any kind, express   |
+| or implied. In no event shall STZ or its contributors be held liable for any |
+| direct, indirect, incidental, special or consequential damages arising out   |
+| of the use of or inability to use this software.                             |
+|                                                                              |
+| Permission is granted to anyone  to use this  software for any purpose,      |
+| including commercial applications,  and to alter it and redistribute it      |
+| freely, subject to the following restrictions:                               |
+|                                                                              |
+| 1. Redistributions of source code must retain the above copyright            |
+|    notice, definition, disclaimer, and this list of conditions.              |
+|                                                                              |
+| 2. Redistributions in binary form must reproduce the above copyright         |
+|    notice, definition, disclaimer, and this list of conditions in            |
+|    documentation and/or other materials provided with the distribution.      |
+|                                                                          ;-) |
++-----------------------------------------------------------------------------*/
+
+/*============================================================================*/
+/*                               Includes                                     */
+/*============================================================================*/
+#include <stdint.h>
+#include <errno.h>
+#include <string.h>
+#include <intrinsic.h>
+#include <arch/zxn.h>
+#include <arch/zxn/esxdos.h>
+
+#include "libzxn.h"
+#include "scrnshot.h"
+#include "gif.h"
+#include "bench.h"
+
+/*============================================================================*/
+/*                               Defines                                      */
+/*============================================================================*/
+/*!
+Number of slots of the LZW hash table (4 bytes per slot = one 8K page)
+*/
+#define GIF_HASH_SIZE 2048
+
+/*!
+Mask to wrap indices of the LZW hash table
+*/
+#define GIF_HASH_MASK (GIF_HASH_SIZE - 1)
+
+/*!
+Maximum number of strings stored in the LZW hash table. If the table is filled
+up to this level (75%), a CLEAR code is emitted and the dictionary restarts.
+*/
+#define GIF_HASH_FILL 1536
+
+/*!
+Maximum width of a LZW code (GIF89a)
+*/
+#define GIF_CODE_BITS 12
+
+/*!
+Marker for "no pixel read yet"
+*/
+#define GIF_NO_PREFIX 0xFFFF
+
+/*============================================================================*/
+/*                               Namespaces                                   */
+/*============================================================================*/
+
+/*============================================================================*/
+/*                               Constants                                    */
+/*============================================================================*/
+
+/*============================================================================*/
+/*                               Structures                                   */
+/*============================================================================*/
+/*!
+Slot of the LZW hash table: the string "prefix + pixel" and its code.
+A slot with code 0 is empty (codes 0..CLEAR+1 are never stored).
+*/
+typedef struct _gifslot
+{
+  uint16_t uiKey;   /* bits 0-11: prefix code; bits 12-15: bits 8-11 of code */
+  uint8_t  uiChar;  /* pixel appended to the prefix                         */
+  uint8_t  uiCode;  /* bits 0-7 of code                                     */
+} gifslot_t;
+
+/*!
+State of the GIF encoder
+*/
+typedef struct _gifstate
+{
+  uint8_t  uiBank;          /* 8K page of the LZW hash table       */
+  uint8_t  uiBits;          /* bits per pixel of the image rows    */
+  uint8_t  uiMinCodeSize;   /* LZW minimum code size               */
+  uint8_t  uiCodeSize;      /* current width of the codes          */
+  uint16_t uiClear;         /* CLEAR code                          */
+  uint16_t uiNext;          /* next free code                      */
+  uint16_t uiLimit;         /* code that forces a CLEAR            */
+  uint16_t uiPrefix;        /* code of the current string          */
+  uint32_t uiAccu;          /* bit accumulator                     */
+  uint8_t  uiAccuBits;      /* number of valid bits in accumulator */
+  uint8_t  auiBlock[256];   /* data sub-block (length + 255 bytes) */
+} gifstate_t;
+
+/*============================================================================*/
+/*                               Variables                                    */
+/*============================================================================*/
+/*!
+In dieser Struktur werden alle globalen Daten der Anwendung gespeichert.
+*/
+extern appstate_t g_tState;
+
+/*!
+State of the GIF encoder
+*/
+static gifstate_t s_tGif;
+
+/*============================================================================*/
+/*                               Type-Definitions                             */
+/*============================================================================*/
+
+/*============================================================================*/
+/*                               Prototypes                                   */
+/*============================================================================*/
+/*!
+Clears the LZW hash table (the page has to be mapped to WORK_BANK_ADDR)
+*/
+static void clearGifTable(void);
+
+/*!
+Appends a LZW code to the current data sub-block
+*/
+static int putGifCode(uint16_t uiCode);
+
+/*!
+Saves the current data sub-block to the output file
+*/
+static int flushGifBlock(void);
+
+/*============================================================================*/
+/*                               Classes                                      */
+/*============================================================================*/
+
+/*============================================================================*/
+/*                               Implementation                               */
+/*============================================================================*/
+
+/*----------------------------------------------------------------------------*/
+/* saveGifHeader()                                                            */
+/*----------------------------------------------------------------------------*/
+int saveGifHeader(void)
+{
+  uint8_t  auiHeader[13];
+  uint16_t uiColors = (uint16_t) g_tState.bmpfile.tInfoHdr.uiClrUsed;
+  uint8_t  uiTableBits = 1;
+
+  /* Size of the global colour table: 2^n entries */
+  while ((((uint16_t) 1) << uiTableBits) < uiColors)
+  {
+    ++uiTableBits;
+  }
+
+  memcpy(&auiHeader[0], "GIF89a", 6);
+  auiHeader[ 6] = (uint8_t) (g_tState.bmpfile.tInfoHdr.iWidth);        /* logical screen width  */
+  auiHeader[ 7] = (uint8_t) (g_tState.bmpfile.tInfoHdr.iWidth  >> 8);
+  auiHeader[ 8] = (uint8_t) (g_tState.bmpfile.tInfoHdr.iHeight);       /* logical screen height */
+  auiHeader[ 9] = (uint8_t) (g_tState.bmpfile.tInfoHdr.iHeight >> 8);
+  auiHeader[10] = 0xF0 | (uiTableBits - 1);                            /* GCT, 8 bit resolution */
+  auiHeader[11] = 0;                                                   /* background colour     */
+  auiHeader[12] = 0;                                                   /* pixel aspect ratio    */
+
+  s_tGif.uiBank = INV_BANK;
+
+  return writeImageData(auiHeader, sizeof(auiHeader));
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* saveGifPalette()                                                           */
+/*----------------------------------------------------------------------------*/
+int saveGifPalette(const bmppaletteentry_t* pPalette, uint16_t uiColors)
+{
+  int iReturn = EOK;
+  uint8_t  auiEntry[3];
+  uint16_t uiTableSize = 2;
+
+  while (uiTableSize < uiColors)
+  {
+    uiTableSize <<= 1;
+  }
+
+  /* Global colour table: R, G, B (padded with black) */
+  for (uint16_t i = 0; (EOK == iReturn) && (i < uiTableSize); ++i, ++pPalette)
+  {
+    if (i < uiColors)
+    {
+      auiEntry[0] = pPalette->r;
+      auiEntry[1] = pPalette->g;
+      auiEntry[2] = pPalette->b;
+    }
+    else
+    {
+      memset(auiEntry, 0, sizeof(auiEntry));
+    }
+
+    iReturn = writeImageData(auiEntry, sizeof(auiEntry));
+  }
+
+  /* Image descriptor + LZW minimum code size */
+  if (EOK == iReturn)
+  {
+    uint8_t auiDesc[11];
+
+    s_tGif.uiBits        = (uint8_t) g_tState.bmpfile.tInfoHdr.uiBitCount;
+    s_tGif.uiMinCodeSize = (s_tGif.uiBits < 2 ? 2 : s_tGif.uiBits);
+
+    auiDesc[ 0] = 0x2C;                                                /* image separator */
+    auiDesc[ 1] = 0;                                                   /* left            */
+    auiDesc[ 2] = 0;
+    auiDesc[ 3] = 0;                                                   /* top             */
+    auiDesc[ 4] = 0;
+    auiDesc[ 5] = (uint8_t) (g_tState.bmpfile.tInfoHdr.iWidth);        /* width           */
+    auiDesc[ 6] = (uint8_t) (g_tState.bmpfile.tInfoHdr.iWidth  >> 8);
+    auiDesc[ 7] = (uint8_t) (g_tState.bmpfile.tInfoHdr.iHeight);       /* height          */
+    auiDesc[ 8] = (uint8_t) (g_tState.bmpfile.tInfoHdr.iHeight >> 8);
+    auiDesc[ 9] = 0;                                                   /* no local table  */
+    auiDesc[10] = s_tGif.uiMinCodeSize;                                /* LZW code size   */
+
+    iReturn = writeImageData(auiDesc, sizeof(auiDesc));
+  }
+
+  /* Prepare LZW encoder */
+  if (EOK == iReturn)
+  {
+    if (INV_BANK == (s_tGif.uiBank = allocBank()))
+    {
+      iReturn = ENOMEM;
+    }
+    else
+    {
+      uint8_t uiMMU3 = ZXN_READ_MMU3();
+      STATS_MMU3(s_tGif.uiBank);
+      clearGifTable();
+      STATS_MMU3(uiMMU3);
+
+      s_tGif.uiClear     = ((uint16_t) 1) << s_tGif.uiMinCodeSize;
+      s_tGif.uiNext      = s_tGif.uiClear + 2;
+      s_tGif.uiLimit     = s_tGif.uiNext + GIF_HASH_FILL;
+      s_tGif.uiCodeSize  = s_tGif.uiMinCodeSize + 1;
+      s_tGif.uiPrefix    = GIF_NO_PREFIX;
+      s_tGif.uiAccu      = 0;
+      s_tGif.uiAccuBits  = 0;
+      s_tGif.auiBlock[0] = 0;
+
+      iReturn = putGifCode(s_tGif.uiClear);
+    }
+  }
+
+  return iReturn;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* saveGifRow()                                                               */
+/*----------------------------------------------------------------------------*/
+int saveGifRow(const uint8_t* pRow, uint16_t uiLen)
+{
+  int iReturn = EOK;
+
+  if (INV_BANK != s_tGif.uiBank)
+  {
+    gifslot_t* pTable = (gifslot_t*) zxn_memmap(WORK_BANK_ADDR);
+    gifslot_t* pSlot;
+    uint16_t uiPixels = (uint16_t) g_tState.bmpfile.tInfoHdr.iWidth;
+    uint16_t uiPrefix = s_tGif.uiPrefix;
+    uint16_t uiHash;
+    uint16_t uiCode;
+    uint8_t  uiByte   = 0;
+    uint8_t  uiShift  = 0;
+    uint8_t  uiMask   = (uint8_t) ((1 << s_tGif.uiBits) - 1);
+    uint8_t  uiChar;
+    uint8_t  uiMMU3   = ZXN_READ_MMU3();
+
+    STATS_MMU3(s_tGif.uiBank);
+
+    while (uiPixels--)
+    {
+      /* Next pixel (MSB first) */
+      if (0 == uiShift)
+      {
+        if (0 == uiLen--)
+        {
+          break;
+        }
+
+        uiByte  = *pRow++;
+        uiShift = 8;
+      }
+
+      uiShift -= s_tGif.uiBits;
+      uiChar   = (uiByte >> uiShift) & uiMask;
+
+      if (GIF_NO_PREFIX == uiPrefix)
+      {
+        uiPrefix = uiChar;
+        continue;
+      }
+
+      /* Search string "prefix + pixel" in the dictionary */
+      uiHash = ((((uint16_t) uiChar) << 3) ^ uiPrefix) & GIF_HASH_MASK;
+
+      for (;;)
+      {
+        pSlot  = &pTable[uiHash];
+        uiCode = ((pSlot->uiKey >> 4) & 0x0F00) | pSlot->uiCode;
+
+        if ((0 == uiCode) || (((pSlot->uiKey & 0x0FFF) == uiPrefix) && (pSlot->uiChar == uiChar)))
+        {
+          break;
+        }
+
+        uiHash = (uiHash + 1) & GIF_HASH_MASK;
+      }
+
+      if (0 != uiCode)
+      {
+        uiPrefix = uiCode; /* string found: extend it */
+        continue;
+      }
+
+      /* String not found: emit prefix, add "prefix + pixel" to dictionary */
+      if (EOK != (iReturn = putGifCode(uiPrefix)))
+      {
+        break;
+      }
+
+      if (s_tGif.uiNext < s_tGif.uiLimit)
+      {
+        pSlot->uiKey  = uiPrefix | ((s_tGif.uiNext & 0x0F00) << 4);
+        pSlot->uiChar = uiChar;
+        pSlot->uiCode = (uint8_t) s_tGif.uiNext;
+
+        if (++s_tGif.uiNext > (((uint16_t) 1) << s_tGif.uiCodeSize))
+        {
+          ++s_tGif.uiCodeSize;
+        }
+      }
+      else
+      {
+        /* The decoder adds one more string before it reads the CLEAR code */
+        if (s_tGif.uiNext == (((uint16_t) 1) << s_tGif.uiCodeSize))
+        {
+          ++s_tGif.uiCodeSize;
+        }
+
+        if (EOK != (iReturn = putGifCode(s_tGif.uiClear)))
+        {
+          break;
+        }
+
+        clearGifTable();
+        s_tGif.uiNext     = s_tGif.uiClear + 2;
+        s_tGif.uiCodeSize = s_tGif.uiMinCodeSize + 1;
+      }
+
+      uiPrefix = uiChar;
+    }
+
+    STATS_MMU3(uiMMU3);
+
+    s_tGif.uiPrefix = uiPrefix;
+  }
+  else
+  {
+    iReturn = EINVAL;
+  }
+
+  return iReturn;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* saveGifTrailer()                                                           */
+/*----------------------------------------------------------------------------*/
+int saveGifTrailer(void)
+{
+  int iReturn = EOK;
+
+  if (INV_BANK != s_tGif.uiBank)
+  {
+    if (GIF_NO_PREFIX != s_tGif.uiPrefix)
+    {
+      iReturn = putGifCode(s_tGif.uiPrefix);
+
+      /* The decoder adds one more string before it reads the EOI code */
+      if ((s_tGif.uiNext == (((uint16_t) 1) << s_tGif.uiCodeSize)) && (GIF_CODE_BITS > s_tGif.uiCodeSize))
+      {
+        ++s_tGif.uiCodeSize;
+      }
+    }
+
+    /* EOI code */
+    if (EOK == iReturn)
+    {
+      iReturn = putGifCode(s_tGif.uiClear + 1);
+    }
+
+    /* Remaining bits */
+    if ((EOK == iReturn) && (0 != s_tGif.uiAccuBits))
+    {
+      s_tGif.uiAccuBits = 0;
+      s_tGif.auiBlock[++s_tGif.auiBlock[0]] = (uint8_t) s_tGif.uiAccu;
+    }
+
+    if ((EOK == iReturn) && (0 != s_tGif.auiBlock[0]))
+    {
+      iReturn = flushGifBlock();
+    }
+
+    /* Block terminator + trailer */
+    if (EOK == iReturn)
+    {
+      static const uint8_t auiTrailer[] = {0x00, 0x3B};
+      iReturn = writeImageData(auiTrailer, sizeof(auiTrailer));
+    }
+
+    freeBank(s_tGif.uiBank);
+    s_tGif.uiBank = INV_BANK;
+  }
+  else
+  {
+    iReturn = EINVAL;
+  }
+
+  return iReturn;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* clearGifTable()                                                            */
+/*----------------------------------------------------------------------------*/
+static void clearGifTable(void)
+{
+  memset(zxn_memmap(WORK_BANK_ADDR), 0, GIF_HASH_SIZE * sizeof(gifslot_t));
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* putGifCode()                                                               */
+/*----------------------------------------------------------------------------*/
+static int putGifCode(uint16_t uiCode)
+{
+  int iReturn = EOK;
+
+  s_tGif.uiAccu     |= ((uint32_t) uiCode) << s_tGif.uiAccuBits;
+  s_tGif.uiAccuBits += s_tGif.uiCodeSize;
+
+  while (8 <= s_tGif.uiAccuBits)
+  {
+    s_tGif.auiBlock[++s_tGif.auiBlock[0]] = (uint8_t) s_tGif.uiAccu;
+    s_tGif.uiAccu     >>= 8;
+    s_tGif.uiAccuBits  -= 8;
+
+    if (255 == s_tGif.auiBlock[0])
+    {
+      if (EOK != (iReturn = flushGifBlock()))
+      {
+        break;
+      }
+    }
+  }
+
+  return iReturn;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* flushGifBlock()                                                            */
+/*----------------------------------------------------------------------------*/
+static int flushGifBlock(void)
+{
+  int iReturn = writeImageData(s_tGif.auiBlock, ((uint16_t) s_tGif.auiBlock[0]) + 1);
+  s_tGif.auiBlock[0] = 0;
+  return iReturn;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/*                                                                            */
+/*----------------------------------------------------------------------------*/
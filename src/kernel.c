@@ -0,0 +1,209 @@
+/*-----------------------------------------------------------------------------+
+|                                                                              |
+| filename: kernel.c                                                           |
+| project:  zxn::scrnshot                                                      |
+| author:   S. Zell                                                            |
+| date:     10/18/2026                                                         |
+|                                                                              |
++------------------------------------------------------------------------------+
+|                                                                              |
+| description:                                                                 |
+|                                                                              |
+| Pixel kernels of the hot loops (ULA attributes, HiRes interleave, LoRes      |
+| rows, Layer 2 spans), shared by the dot command and the host build           |
+|                                                                              |
++------------------------------------------------------------------------------+
+|                                                                              |
+| Copyright (c) 10/18/2026 STZ Engineering                                     |
+|                                                                              |
+| This software is provided  "as is",  without warranty of any kind, express   |
+| or implied. In no event shall STZ or its contributors be held liable for any |
+| direct, indirect, incidental, special or consequential damages arising out   |
+| of the use of or inability to use this software.                             |
+|                                                                              |
+| Permission is granted to anyone  to use this  software for any purpose,      |
+| including commercial applications,  and to alter it and redistribute it      |
+| freely, subject to the following restrictions:                               |
+|                                                                              |
+| 1. Redistributions of source code must retain the above copyright            |
+|    notice, definition, disclaimer, and this list of conditions.              |
+|                                                                              |
+| 2. Redistributions in binary form must reproduce the above copyright         |
+|    notice, definition, disclaimer, and this list of conditions in            |
+|    documentation and/or other materials provided with the distribution.      |
+|                                                                          ;-) |
++-----------------------------------------------------------------------------*/
+
+/*============================================================================*/
+/*                               Includes                                     */
+/*============================================================================*/
+#include <stdint.h>
+#include <string.h>
+#include <arch/zxn.h>
+
+#include "libzxn.h"
+#include "kernel.h"
+
+/*============================================================================*/
+/*                               Defines                                      */
+/*============================================================================*/
+/*!
+LoRes: the top half of the screen is stored at 0x4000, the bottom half at
+0x6000
+*/
+#define LORES_ADDR_TOP    0x4000
+#define LORES_ADDR_BOTTOM 0x6000
+#define LORES_HALF_SIZE   0x1800
+
+/*!
+Distance of the Timex screen 1 from screen 0 (0x6000 - 0x4000)
+*/
+#define HIRES_SCREEN1     0x2000
+
+/*============================================================================*/
+/*                               Namespaces                                   */
+/*============================================================================*/
+
+/*============================================================================*/
+/*                               Constants                                    */
+/*============================================================================*/
+
+/*============================================================================*/
+/*                               Variables                                    */
+/*============================================================================*/
+
+/*============================================================================*/
+/*                               Structures                                   */
+/*============================================================================*/
+
+/*============================================================================*/
+/*                               Type-Definitions                             */
+/*============================================================================*/
+
+/*============================================================================*/
+/*                               Prototypes                                   */
+/*============================================================================*/
+
+/*============================================================================*/
+/*                               Classes                                      */
+/*============================================================================*/
+
+/*============================================================================*/
+/*                               Implementation                               */
+/*============================================================================*/
+
+/*----------------------------------------------------------------------------*/
+/* expandUlaRow()                                                             */
+/*----------------------------------------------------------------------------*/
+void expandUlaRow(uint8_t* pDst, const uint8_t* pPixel, const uint8_t* pAttr, uint16_t uiCols)
+{
+  uint8_t uiPixelByte;
+  uint8_t uiAttrByte;
+  uint8_t uiInk;
+  uint8_t uiPaper;
+  uint8_t uiBright;
+
+  while (0 != uiCols--)
+  {
+    uiPixelByte = *pPixel++;
+    uiAttrByte  = *pAttr++;
+
+    /*
+    Bit 7   FLASH   (INK and PAPER swapped)
+    Bit 6   BRIGHT  (colours 8 - 15)
+    Bit 5-3 PAPER
+    Bit 2-0 INK
+    */
+    uiBright = (uiAttrByte & BRIGHT ? 8 : 0);
+
+    if (uiAttrByte & FLASH)
+    {
+      uiInk   = ((uiAttrByte & PAPER_WHITE) >> 3) | uiBright;
+      uiPaper =  (uiAttrByte & INK_WHITE)         | uiBright;
+    }
+    else
+    {
+      uiInk   =  (uiAttrByte & INK_WHITE)         | uiBright;
+      uiPaper = ((uiAttrByte & PAPER_WHITE) >> 3) | uiBright;
+    }
+
+    /* 2 pixels per byte, the left one in the high nibble */
+    for (uint8_t uiBit = 0x80; 0 != uiBit; uiBit >>= 2)
+    {
+      *pDst++ = ((uiPixelByte & uiBit ? uiInk : uiPaper) << 4) |
+                 (uiPixelByte & (uiBit >> 1) ? uiInk : uiPaper);
+    }
+  }
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* interleaveHiResRow()                                                       */
+/*----------------------------------------------------------------------------*/
+void interleaveHiResRow(uint8_t* pDst, const uint8_t* pRow0, uint16_t uiBytes)
+{
+  for (uiBytes >>= 1; 0 != uiBytes; --uiBytes, ++pRow0)
+  {
+    *pDst++ = *pRow0;                   /* screen 0 */
+    *pDst++ = *(pRow0 + HIRES_SCREEN1); /* screen 1 */
+  }
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* copyLoResRow()                                                             */
+/*----------------------------------------------------------------------------*/
+void copyLoResRow(uint8_t* pDst, uint16_t uiOffset, uint16_t uiLen, uint8_t uiStep)
+{
+  const uint8_t* pSrc = (LORES_HALF_SIZE > uiOffset ?
+                         ((const uint8_t*) zxn_memmap(LORES_ADDR_TOP)) + uiOffset :
+                         ((const uint8_t*) zxn_memmap(LORES_ADDR_BOTTOM)) + (uiOffset - LORES_HALF_SIZE));
+
+  if (1 == uiStep)
+  {
+    memcpy(pDst, pSrc, uiLen);
+  }
+  else
+  {
+    for (uint16_t i = 0; i < uiLen; i += uiStep)
+    {
+      *pDst++ = pSrc[i];
+    }
+  }
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* gatherLayer2Cols()                                                         */
+/*----------------------------------------------------------------------------*/
+uint8_t* gatherLayer2Cols(uint8_t* pDst, const uint8_t* pSrc, uint16_t uiCnt, uint8_t uiStep)
+{
+  uint16_t uiStride = ((uint16_t) uiStep) << 8;
+
+  do
+  {
+    *pDst++ = *pSrc;
+    pSrc += uiStride;
+  } while (0 != --uiCnt);
+
+  return pDst;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* packLeftNibbles()                                                          */
+/*----------------------------------------------------------------------------*/
+void packLeftNibbles(uint8_t* pRow, uint16_t uiBytes)
+{
+  const uint8_t* pSrc = pRow;
+
+  for (uiBytes >>= 1; 0 != uiBytes; --uiBytes, pSrc += 2)
+  {
+    *pRow++ = (pSrc[0] & 0xF0) | (pSrc[1] >> 4);
+  }
+}
+
+
+/*----------------------------------------------------------------------------*/
+/*                                                                            */
+/*----------------------------------------------------------------------------*/
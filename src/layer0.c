@@ -46,6 +46,8 @@
 #include "libzxn.h"
 #include "scrnshot.h"
 #include "layer0.h"
+#include "kernel.h"
+#include "walker.h"
 
 /*============================================================================*/
 /*                               Defines                                      */
@@ -91,14 +93,29 @@ extern appstate_t g_tState;
 /* makeScreenshot_L00()                                                       */
 /*----------------------------------------------------------------------------*/
 int makeScreenshot_L00(const screenmode_t* pInfo)
+{
+  return makeUlaScreenshot(pInfo, ATTR_ROW_CELL);
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* makeUlaScreenshot()                                                        */
+/*----------------------------------------------------------------------------*/
+int makeUlaScreenshot(const screenmode_t* pInfo, attrrow_t eAttrRow)
 {
   int iReturn = EOK;
 
   if (0 != pInfo)
   {
+    imagerect_t tRect;
     uint16_t uiPalSize = pInfo->uiColors * sizeof(bmppaletteentry_t);
-    uint8_t  uiLineLen = pInfo->uiResX >> 1;   /* 32bit aligned */
-    uint32_t uiPxlSize = ((uint32_t) pInfo->uiResY) * ((uint32_t) uiLineLen);
+    uint8_t  uiLineLen;
+    uint32_t uiPxlSize;
+
+    /* Region of the screen: whole screen or option "--rect" */
+    iReturn   = getImageRect(pInfo, 4, &tRect);
+    uiLineLen = tRect.uiW >> 1;   /* 32bit aligned */
+    uiPxlSize = ((uint32_t) tRect.uiH) * ((uint32_t) uiLineLen);
 
     /* Create BMP header */
     if (EOK == iReturn)
@@ -109,10 +126,10 @@ int makeScreenshot_L00(const screenmode_t* pInfo)
       g_tState.bmpfile.tFileHdr.uiOffBits += uiPalSize;
 
       /* info header */
-      g_tState.bmpfile.tInfoHdr.iWidth      = pInfo->uiResX;              /* image width     */
-      g_tState.bmpfile.tInfoHdr.iHeight     = pInfo->uiResY;              /* image height    */
+      g_tState.bmpfile.tInfoHdr.iWidth      = tRect.uiW;                  /* image width     */
+      g_tState.bmpfile.tInfoHdr.iHeight     = tRect.uiH;                  /* image height    */
       g_tState.bmpfile.tInfoHdr.uiBitCount  = 4;                          /* bits per pixel  */
-      g_tState.bmpfile.tInfoHdr.uiSizeImage = pInfo->uiResY * uiLineLen;  /* image size      */
+      g_tState.bmpfile.tInfoHdr.uiSizeImage = uiPxlSize;                  /* image size      */
       g_tState.bmpfile.tInfoHdr.uiClrUsed   = pInfo->uiColors;            /* palette entries */
 
       iReturn = saveImageHeader();
@@ -131,11 +148,10 @@ int makeScreenshot_L00(const screenmode_t* pInfo)
       const uint8_t* pAttrData  = (const uint8_t*) zxn_memmap(pInfo->tMemAttr.uiAddr);
       const uint8_t* pPixelRow  = 0;
       const uint8_t* pAttrRow   = 0;
-      uint8_t  uiPixelByte;
-      uint8_t  uiAttrByte;
       uint8_t* pBmpLine = 0;
-      uint8_t  uiBmpIdx;
-      uint8_t  uiBmpPixel;
+     #if (_PIXEL_CALC_ULA_ == 4) || (_PIXEL_CALC_HICOLOR_ == 4)
+      ulawalk_t tWalk;
+     #endif
 
       if (0 == (pBmpLine = malloc(uiLineLen)))
       {
@@ -143,68 +159,71 @@ int makeScreenshot_L00(const screenmode_t* pInfo)
       }
       else
       {
-        memset(pBmpLine, 0, uiLineLen);
+       #if (_PIXEL_CALC_ULA_ == 4) || (_PIXEL_CALC_HICOLOR_ == 4)
+        initUlaWalk(&tWalk, pPixelData, pAttrData, (uint8_t) IMAGE_ROW_FIRST(&tRect));
+       #endif
 
-        for (uint16_t uiY = pInfo->uiResY - 1; uiY != 0xFFFF; --uiY)
+        for (uint16_t uiY = IMAGE_ROW_FIRST(&tRect); IMAGE_ROW_VALID(uiY, &tRect); uiY += g_tState.bmpfile.iRowStep)
         {
-         #if (_PIXEL_CALC_ == 0)
-          pPixelRow = pPixelData
-                      + ((uiY & 0x07) << 8)   /* Zeile innerhalb der 8er-Gruppe        */
-                      + ((uiY & 0x38) << 2)   /* 8er-Gruppe innerhalb des 64er-Blocks  */
-                      + ((uiY & 0xC0) << 5);  /* welcher 64er-Block (oben/mitte/unten) */
-          pAttrRow  = pAttrData
-                      + ((uiY >> 3) << 5);    /* uiY / 8 * 32 */
-         #elif (_PIXEL_CALC_ == 1)
-          pPixelRow = zx_pxy2saddr(0, uiY);           /* Pixeladresse    */
-          pAttrRow  = zx_cxy2aaddr(0, uiY >> 3);      /* Attributadresse */      
-         #elif (_PIXEL_CALC_ == 2)
-          pPixelRow = zxn_pixelad(0, (uint8_t) uiY);  /* Pixeladresse    */
-          pAttrRow  = zx_cxy2aaddr(0, uiY >> 3);      /* Attributadresse */      
-         #elif (_PIXEL_CALC_ == 3)
-          pPixelRow = zxn_pixelad(0, (uint8_t) uiY);  /* Pixeladresse    */
-          pAttrRow  = pAttrData + ((uiY >> 3) << 5);  /* Attributadresse */
-         #else
-          #error Invalid setting for calculation of pixel address !
-         #endif
-
-          for (uint16_t uiX = 0; uiX < pInfo->uiResX; uiX += 8)
+          if (ATTR_ROW_CELL == eAttrRow)
           {
-            uiPixelByte = *(pPixelRow + (uiX >> 3));
-            uiAttrByte  = *(pAttrRow  + (uiX >> 3));
-
-            /*
-            Bit 7   FLASH   (0 = normal, 1 = blinkend Vorder-/Hintergrund wechseln)
-            Bit 6   BRIGHT  (0 = normale Helligkeit, 1 = erhoehte Helligkeit)
-            Bits 5–3 PAPER  (Hintergrundfarbe, 3 Bit: 0–7)
-            Bits 2–0 INK    (Vordergrundfarbe, 3 Bit: 0–7)
-            */
-
-            for (uint16_t uiZ = 0; uiZ < 8; ++uiZ)
-            {
-              if (uiAttrByte & FLASH)
-              {
-                uiBmpPixel = (uiPixelByte & (1 << (7 - uiZ)) ?
-                             (uiAttrByte & PAPER_WHITE) >> 3 :
-                             (uiAttrByte & INK_WHITE));
-              }
-              else
-              {
-                uiBmpPixel = (uiPixelByte & (1 << (7 - uiZ)) ?
-                             (uiAttrByte & INK_WHITE) :
-                             (uiAttrByte & PAPER_WHITE) >> 3);
-              }
-              uiBmpPixel += (uiAttrByte & BRIGHT ? 8 : 0);
-
-              uiBmpIdx = (uiX + uiZ) >> 1;
-              pBmpLine[uiBmpIdx] = (uiX + uiZ) & 0x01 ? /* odd nibble ? */
-                                   (pBmpLine[uiBmpIdx] & 0xF0) | uiBmpPixel :
-                                   (pBmpLine[uiBmpIdx] & 0x0F) | (uiBmpPixel << 4);
-            }
+            /* ULA: one attribute row per character row (8 lines) */
+           #if (_PIXEL_CALC_ULA_ == 0)
+            pPixelRow = pPixelData
+                        + ((uiY & 0x07) << 8)   /* Zeile innerhalb der 8er-Gruppe        */
+                        + ((uiY & 0x38) << 2)   /* 8er-Gruppe innerhalb des 64er-Blocks  */
+                        + ((uiY & 0xC0) << 5);  /* welcher 64er-Block (oben/mitte/unten) */
+            pAttrRow  = pAttrData
+                        + ((uiY >> 3) << 5);    /* uiY / 8 * 32 */
+           #elif (_PIXEL_CALC_ULA_ == 1)
+            pPixelRow = zx_pxy2saddr(0, uiY);           /* Pixeladresse    */
+            pAttrRow  = zx_cxy2aaddr(0, uiY >> 3);      /* Attributadresse */      
+           #elif (_PIXEL_CALC_ULA_ == 2)
+            pPixelRow = zxn_pixelad(0, (uint8_t) uiY);  /* Pixeladresse    */
+            pAttrRow  = zx_cxy2aaddr(0, uiY >> 3);      /* Attributadresse */      
+           #elif (_PIXEL_CALC_ULA_ == 3)
+            pPixelRow = zxn_pixelad(0, (uint8_t) uiY);  /* Pixeladresse    */
+            pAttrRow  = pAttrData + ((uiY >> 3) << 5);  /* Attributadresse */
+           #elif (_PIXEL_CALC_ULA_ == 4)
+            pPixelRow = tWalk.pPixel;                   /* Pixeladresse    */
+            pAttrRow  = tWalk.pAttr;                    /* Attributadresse */
+            stepUlaWalk(&tWalk, g_tState.bmpfile.iRowStep);
+           #else
+            #error Invalid setting for calculation of pixel address !
+           #endif
           }
+          else
+          {
+            /* HiColor: attributes interleaved like pixel data (screen 1) */
+           #if (_PIXEL_CALC_HICOLOR_ == 0)
+            pPixelRow = pPixelData
+                        + ((uiY & 0x07) << 8)   /* Zeile innerhalb der 8er-Gruppe        */
+                        + ((uiY & 0x38) << 2)   /* 8er-Gruppe innerhalb des 64er-Blocks  */
+                        + ((uiY & 0xC0) << 5);  /* welcher 64er-Block (oben/mitte/unten) */
+            pAttrRow  = pAttrData
+                        + (pPixelRow - pPixelData);
+           #elif (_PIXEL_CALC_HICOLOR_ == 1)
+            pPixelRow = tshc_py2saddr(uiY);
+            pAttrRow  = tshc_py2aaddr(uiY);
+           #elif (_PIXEL_CALC_HICOLOR_ == 2)
+            pPixelRow = zxn_pixelad(0, (uint8_t) uiY);
+            pAttrRow  = tshc_saddr2aaddr(pPixelRow);
+           #elif (_PIXEL_CALC_HICOLOR_ == 3)
+            pPixelRow = zxn_pixelad(0, (uint8_t) uiY);
+            pAttrRow  = pPixelRow + 0x2000;             /* screen 1 (0x6000) */
+           #elif (_PIXEL_CALC_HICOLOR_ == 4)
+            pPixelRow = tWalk.pPixel;
+            pAttrRow  = pPixelRow + WALK_SCREEN1;       /* screen 1 (0x6000) */
+            stepUlaWalk(&tWalk, g_tState.bmpfile.iRowStep);
+           #else
+            #error Invalid setting for calculation of pixel address !
+           #endif
+          }
+
+          expandUlaRow(pBmpLine, pPixelRow + (tRect.uiX >> 3), pAttrRow + (tRect.uiX >> 3), tRect.uiW >> 3);
 
-          if (uiLineLen != esx_f_write(g_tState.bmpfile.hFile, pBmpLine, uiLineLen))
+          if (EOK != (iReturn = saveImageRow(pBmpLine, uiLineLen)))
           {
-            iReturn = EBADF;
             goto EXIT_NESTED_LOOPS;
           }
         }
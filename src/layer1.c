@@ -47,11 +47,54 @@
 
 #include "libzxn.h"
 #include "scrnshot.h"
+#include "layer0.h"
 #include "layer1.h"
+#include "kernel.h"
+#include "walker.h"
+#include "bench.h"
 
 /*============================================================================*/
 /*                               Defines                                      */
 /*============================================================================*/
+/*!
+Template of the pixel decoder of LoRes/Radastan with the geometry as
+constants (bytes per row "rowbytes", pixels per byte as shift "pixshift"):
+the rows are contiguous, so every row is a single copy of the region (the
+top half of LoRes at 0x4000, the bottom half at 0x6000, Radastan uses the
+first 6K at 0x4000 only). A scaled image reads every n-th pixel of the row
+(Radastan: the left pixel of every n/2-th byte), the row is passed scaled.
+*/
+#define LORES_DECODER(name, rowbytes, pixshift)                                \
+static int name(const imagerect_t* pRect, uint8_t* pBmpLine)                   \
+{                                                                              \
+  int      iReturn = EOK;                                                      \
+  uint16_t uiCol0  = pRect->uiX >> (pixshift);                                 \
+  uint16_t uiLen   = pRect->uiW >> (pixshift);                                 \
+  uint8_t  uiShift = g_tState.uiScale >> 1;    /* scale 1, 2, 4 => 0, 1, 2 */  \
+  uint8_t  uiStep  = 1 << (uiShift > (pixshift) ? uiShift - (pixshift) : 0);   \
+  uint16_t uiOffset;                                                           \
+                                                                               \
+  for (uint8_t uiY = IMAGE_ROW_FIRST(pRect); IMAGE_ROW_VALID(uiY, pRect); uiY += g_tState.bmpfile.iRowStep) \
+  {                                                                            \
+    uiOffset = ((uint16_t) uiY) * (rowbytes) + uiCol0;                         \
+                                                                               \
+    STATS_DI();                                                                \
+    copyLoResRow(pBmpLine, uiOffset, uiLen, uiStep);                           \
+    STATS_EI();                                                                \
+                                                                               \
+    if ((pixshift) && (0 != uiShift))                                          \
+    {                                                                          \
+      packLeftNibbles(pBmpLine, uiLen / uiStep);                               \
+    }                                                                          \
+                                                                               \
+    if (EOK != (iReturn = saveScaledRow(pBmpLine, uiLen >> uiShift)))          \
+    {                                                                          \
+      break;                                                                   \
+    }                                                                          \
+  }                                                                            \
+                                                                               \
+  return iReturn;                                                              \
+}
 
 /*============================================================================*/
 /*                               Namespaces                                   */
@@ -85,6 +128,11 @@ extern const bmppaletteentry_t g_tColorPalL0[];
 /*============================================================================*/
 /*                               Prototypes                                   */
 /*============================================================================*/
+/*!
+Pixel decoders of LoRes (8 bit) and Radastan (4 bit)
+*/
+static int decodeLoRes_128x96x8(const imagerect_t* pRect, uint8_t* pBmpLine);
+static int decodeLoRes_128x96x4(const imagerect_t* pRect, uint8_t* pBmpLine);
 
 /*============================================================================*/
 /*                               Classes                                      */
@@ -103,10 +151,16 @@ int makeScreenshot_L10(const screenmode_t* pInfo)
 
   if (0 != pInfo)
   {
+    imagerect_t tRect;
     bool     bRadastan = zxn_radastan_mode();
-    uint16_t uiLineLen = (bRadastan ? pInfo->uiResX >> 1 : pInfo->uiResX);
+    uint16_t uiLineLen;
     uint16_t uiPalSize = sizeof(bmppaletteentry_t) * (bRadastan ? pInfo->uiColors >> 4 : pInfo->uiColors);
-    uint32_t uiPxlSize = ((uint32_t) pInfo->uiResY) * ((uint32_t) uiLineLen);
+    uint32_t uiPxlSize;
+
+    /* Region of the screen: whole screen or option "--rect" */
+    iReturn   = getImageRect(pInfo, (bRadastan ? 4 : 8), &tRect);
+    uiLineLen = (bRadastan ? tRect.uiW >> 1 : tRect.uiW);
+    uiPxlSize = ((uint32_t) tRect.uiH) * ((uint32_t) uiLineLen);
 
     /* Create BMP header */
     if (EOK == iReturn)
@@ -117,9 +171,9 @@ int makeScreenshot_L10(const screenmode_t* pInfo)
       g_tState.bmpfile.tFileHdr.uiOffBits += uiPalSize;
 
       /* Create info header */
-      g_tState.bmpfile.tInfoHdr.iWidth      = pInfo->uiResX;              /* image width     */
-      g_tState.bmpfile.tInfoHdr.iHeight     = pInfo->uiResY;              /* image height    */
-      g_tState.bmpfile.tInfoHdr.uiSizeImage = pInfo->uiResY * uiLineLen;  /* image size      */
+      g_tState.bmpfile.tInfoHdr.iWidth      = tRect.uiW;                  /* image width     */
+      g_tState.bmpfile.tInfoHdr.iHeight     = tRect.uiH;                  /* image height    */
+      g_tState.bmpfile.tInfoHdr.uiSizeImage = uiPxlSize;                  /* image size      */
 
       if (bRadastan)
       {
@@ -144,11 +198,7 @@ int makeScreenshot_L10(const screenmode_t* pInfo)
     /* Write pixel data ... */
     if (EOK == iReturn)
     {
-      const uint8_t* pPixelData0 = (const uint8_t*) zxn_memmap(pInfo->tMemPixel.uiAddr);
-      const uint8_t* pPixelData1 = (const uint8_t*) zxn_memmap(pInfo->tMemAttr.uiAddr);
       uint8_t* pBmpLine = 0;
-      uint16_t uiPixelOffset;
-      uint8_t  uiPixelByte;
 
       if (0 == (pBmpLine = malloc(uiLineLen)))
       {
@@ -156,45 +206,7 @@ int makeScreenshot_L10(const screenmode_t* pInfo)
       }
       else
       {
-        memset(pBmpLine, 0, uiLineLen);
-
-        for (uint8_t uiY = pInfo->uiResY - 1; uiY != 0xFF; --uiY)
-        {
-          intrinsic_di();
-
-          if (bRadastan)
-          {
-            for (uint8_t uiX = 0; uiX < pInfo->uiResX; uiX += 2)
-            {
-              uiPixelOffset = ((uint16_t) uiY) * pInfo->uiResX + uiX;
-              uiPixelByte = *(pPixelData0 + (uiPixelOffset >> 1));
-
-              pBmpLine[uiX >> 1] = uiPixelByte;
-            }
-          }
-          else
-          {
-            for (uint8_t uiX = 0; uiX < pInfo->uiResX; ++uiX)
-            {
-              uiPixelOffset = ((uint16_t) uiY) * pInfo->uiResX + uiX;
-              uiPixelByte = (pInfo->tMemPixel.uiSize > uiPixelOffset ? 
-                            *(pPixelData0 + uiPixelOffset) :
-                            *(pPixelData1 + uiPixelOffset - pInfo->tMemPixel.uiSize));
-
-              pBmpLine[uiX] = uiPixelByte;
-            }
-          }
-
-          intrinsic_ei();
-
-          if (uiLineLen != esx_f_write(g_tState.bmpfile.hFile, pBmpLine, uiLineLen))
-          {
-            iReturn = EBADF;
-            goto EXIT_NESTED_LOOPS;
-          }
-        }
-
-      EXIT_NESTED_LOOPS:
+        iReturn = (bRadastan ? decodeLoRes_128x96x4(&tRect, pBmpLine) : decodeLoRes_128x96x8(&tRect, pBmpLine));
 
         free(pBmpLine);
         pBmpLine = 0;
@@ -210,124 +222,19 @@ int makeScreenshot_L10(const screenmode_t* pInfo)
 }
 
 
+/*----------------------------------------------------------------------------*/
+/* decodeLoRes_128x96x8(), decodeLoRes_128x96x4()                             */
+/*----------------------------------------------------------------------------*/
+LORES_DECODER(decodeLoRes_128x96x8, 128, 0)
+LORES_DECODER(decodeLoRes_128x96x4,  64, 1)
+
+
 /*----------------------------------------------------------------------------*/
 /* makeScreenshot_L11()                                                       */
 /*----------------------------------------------------------------------------*/
 int makeScreenshot_L11(const screenmode_t* pInfo)
 {
-  int iReturn = EOK;
-
-  if (0 != pInfo)
-  {
-    uint16_t uiPalSize = pInfo->uiColors * sizeof(bmppaletteentry_t);
-    uint8_t  uiLineLen = pInfo->uiResX >> 1;   /* 32bit aligned */
-    uint32_t uiPxlSize = ((uint32_t) pInfo->uiResY) * ((uint32_t) uiLineLen);
-
-    /* Create BMP header */
-    if (EOK == iReturn)
-    {
-      /* file header */
-      g_tState.bmpfile.tFileHdr.uiSize    += uiPalSize;
-      g_tState.bmpfile.tFileHdr.uiSize    += uiPxlSize;
-      g_tState.bmpfile.tFileHdr.uiOffBits += uiPalSize;
-
-      /* info header */
-      g_tState.bmpfile.tInfoHdr.iWidth      = pInfo->uiResX;                         /* image width     */
-      g_tState.bmpfile.tInfoHdr.iHeight     = pInfo->uiResY;                         /* image height    */
-      g_tState.bmpfile.tInfoHdr.uiBitCount  = 4;                                     /* bits per pixel  */
-      g_tState.bmpfile.tInfoHdr.uiSizeImage = pInfo->uiResY * uiLineLen;             /* image size      */
-      g_tState.bmpfile.tInfoHdr.uiClrUsed   = uiPalSize / sizeof(bmppaletteentry_t); /* palette entries */
-
-      iReturn = saveImageHeader();
-    }
-
-    /* Save color palette ... */
-    if (EOK == iReturn)
-    {
-      iReturn = saveColourPalette(pInfo);
-    }
-
-    /* Write pixel data ... */
-    if (EOK == iReturn)
-    {
-      const uint8_t* pPixelData = (const uint8_t*) zxn_memmap(pInfo->tMemPixel.uiAddr);
-      const uint8_t* pAttrData  = (const uint8_t*) zxn_memmap(pInfo->tMemAttr.uiAddr);
-      const uint8_t* pPixelRow  = 0;
-      const uint8_t* pAttrRow   = 0;
-      uint8_t  uiPixelByte;
-      uint8_t  uiAttrByte;
-      uint8_t* pBmpLine = 0;
-      uint8_t  uiBmpIdx;
-      uint8_t  uiBmpPixel;
-
-      if (0 == (pBmpLine = malloc(uiLineLen)))
-      {
-        iReturn = ENOMEM;
-      }
-      else
-      {
-        memset(pBmpLine, 0, uiLineLen);
-
-        for (uint16_t uiY = pInfo->uiResY - 1; uiY != 0xFFFF; --uiY)
-        {
-          pPixelRow = zxn_pixelad(0, (uint8_t) uiY);  /* Pixeladresse    */
-          pAttrRow  = pAttrData + ((uiY >> 3) << 5);  /* Attributadresse */
-
-          for (uint16_t uiX = 0; uiX < pInfo->uiResX; uiX += 8)
-          {
-            uiPixelByte = *(pPixelRow + (uiX >> 3));
-            uiAttrByte  = *(pAttrRow  + (uiX >> 3));
-
-            /*
-            Bit 7   FLASH   (0 = normal, 1 = blinkend Vorder-/Hintergrund wechseln)
-            Bit 6   BRIGHT  (0 = normale Helligkeit, 1 = erhoehte Helligkeit)
-            Bits 5–3 PAPER  (Hintergrundfarbe, 3 Bit: 0–7)
-            Bits 2–0 INK    (Vordergrundfarbe, 3 Bit: 0–7)
-            */
-
-            for (uint16_t uiZ = 0; uiZ < 8; ++uiZ)
-            {
-              if (uiAttrByte & FLASH)
-              {
-                uiBmpPixel = (uiPixelByte & (1 << (7 - uiZ)) ?
-                             (uiAttrByte & PAPER_WHITE) >> 3 :
-                             (uiAttrByte & INK_WHITE));
-              }
-              else
-              {
-                uiBmpPixel = (uiPixelByte & (1 << (7 - uiZ)) ?
-                             (uiAttrByte & INK_WHITE) :
-                             (uiAttrByte & PAPER_WHITE) >> 3);
-              }
-              uiBmpPixel += (uiAttrByte & BRIGHT ? 8 : 0);
-
-              uiBmpIdx = (uiX + uiZ) >> 1;
-              pBmpLine[uiBmpIdx] = (uiX + uiZ) & 0x01 ? /* odd nibble ? */
-                                   (pBmpLine[uiBmpIdx] & 0xF0) | uiBmpPixel :
-                                   (pBmpLine[uiBmpIdx] & 0x0F) | (uiBmpPixel << 4);
-            }
-          }
-
-          if (uiLineLen != esx_f_write(g_tState.bmpfile.hFile, pBmpLine, uiLineLen))
-          {
-            iReturn = EBADF;
-            goto EXIT_NESTED_LOOPS;
-          }
-        }
-
-      EXIT_NESTED_LOOPS:
-
-        free(pBmpLine);
-        pBmpLine = 0;
-      }
-    }
-  }
-  else
-  {
-    iReturn = EINVAL;
-  }
-
-  return iReturn;
+  return makeUlaScreenshot(pInfo, ATTR_ROW_CELL);
 }
 
 
@@ -340,9 +247,10 @@ int makeScreenshot_L12(const screenmode_t* pInfo)
 
   if (0 != pInfo)
   {
+    imagerect_t tRect;
     uint16_t uiPalSize = pInfo->uiColors * sizeof(bmppaletteentry_t);
-    uint8_t  uiLineLen = pInfo->uiResX >> 3;   /* 32bit aligned */
-    uint32_t uiPxlSize = ((uint32_t) uiLineLen) * ((uint32_t) pInfo->uiResY);
+    uint8_t  uiLineLen;
+    uint32_t uiPxlSize;
 
     /*
     The ULA used by the Timex machines provides a number of additional screen
@@ -376,6 +284,11 @@ int makeScreenshot_L12(const screenmode_t* pInfo)
     the BORDER, are BRIGHT, and the BORDER colour is the same as the PAPER colour.
     */
 
+    /* Region of the screen: whole screen or option "--rect" */
+    iReturn   = getImageRect(pInfo, 1, &tRect);
+    uiLineLen = tRect.uiW >> 3;   /* 32bit aligned */
+    uiPxlSize = ((uint32_t) uiLineLen) * ((uint32_t) tRect.uiH);
+
     /* Create BMP header */
     if (EOK == iReturn)
     {
@@ -385,8 +298,8 @@ int makeScreenshot_L12(const screenmode_t* pInfo)
       g_tState.bmpfile.tFileHdr.uiOffBits += uiPalSize;
 
       /* info header */
-      g_tState.bmpfile.tInfoHdr.iWidth      = pInfo->uiResX;   /* image width     */
-      g_tState.bmpfile.tInfoHdr.iHeight     = pInfo->uiResY;   /* image height    */
+      g_tState.bmpfile.tInfoHdr.iWidth      = tRect.uiW;       /* image width     */
+      g_tState.bmpfile.tInfoHdr.iHeight     = tRect.uiH;       /* image height    */
       g_tState.bmpfile.tInfoHdr.uiBitCount  = 1;               /* bits per pixel  */
       g_tState.bmpfile.tInfoHdr.uiSizeImage = uiPxlSize;       /* image size      */
       g_tState.bmpfile.tInfoHdr.uiClrUsed   = pInfo->uiColors; /* palette entries */
@@ -398,23 +311,21 @@ int makeScreenshot_L12(const screenmode_t* pInfo)
     if (EOK == iReturn)
     {
       uint8_t uiColorSet;
-      bmppaletteentry_t tPalette[2];
 
       uiColorSet = (z80_inp(0xFF) >> 3) & 0x07;
 
-      tPalette[0] = g_tColorPalL0[15 - uiColorSet];
-      tPalette[1] = g_tColorPalL0[ 8 + uiColorSet];
+      g_tState.bmpfile.tPalette[0] = g_tColorPalL0[15 - uiColorSet];
+      g_tState.bmpfile.tPalette[1] = g_tColorPalL0[ 8 + uiColorSet];
 
-      if (sizeof(tPalette) != esx_f_write(g_tState.bmpfile.hFile, &tPalette, sizeof(tPalette)))
-      {
-        iReturn = EBADF;
-      }
+      iReturn = saveColourTable(2);
     }
 
     /* Write pixel data ... */
     if (EOK == iReturn)
     {
-      uint8_t* pBmpLine = 0;
+      const uint8_t* pScreen0 = (const uint8_t*) zxn_memmap(pInfo->tMemPixel.uiAddr);
+      uint8_t*  pBmpLine = 0;
+      ulawalk_t tWalk;
 
       if (0 == (pBmpLine = malloc(uiLineLen)))
       {
@@ -422,25 +333,20 @@ int makeScreenshot_L12(const screenmode_t* pInfo)
       }
       else
       {
-        memset(pBmpLine, 0, uiLineLen);
+        initUlaWalk(&tWalk, pScreen0, pScreen0, (uint8_t) IMAGE_ROW_FIRST(&tRect));
 
-        for (uint16_t uiY = pInfo->uiResY - 1; uiY != 0xFFFF; --uiY)
+        for (uint16_t uiY = IMAGE_ROW_FIRST(&tRect); IMAGE_ROW_VALID(uiY, &tRect); uiY += g_tState.bmpfile.iRowStep)
         {
-          intrinsic_di();
+          STATS_DI();
 
-          for (uint16_t uiX = 0; uiX < pInfo->uiResX; uiX += 8)
-          {
-            /*
-            Pixeldata bytewise alternating between the two memory-banks ...
-            */
-            pBmpLine[uiX >> 3] = *tshr_pxy2saddr(uiX, uiY);
-          }
+          /* Pixeldata bytewise alternating between the two memory-banks ... */
+          interleaveHiResRow(pBmpLine, tWalk.pPixel + (tRect.uiX >> 4), uiLineLen);
+          stepUlaWalk(&tWalk, g_tState.bmpfile.iRowStep);
 
-          intrinsic_ei();
+          STATS_EI();
 
-          if (uiLineLen != esx_f_write(g_tState.bmpfile.hFile, pBmpLine, uiLineLen))
+          if (EOK != (iReturn = saveImageRow(pBmpLine, uiLineLen)))
           {
-            iReturn = EBADF;
             goto EXIT_NESTED_LOOPS;
           }
         }
@@ -466,134 +372,7 @@ int makeScreenshot_L12(const screenmode_t* pInfo)
 /*----------------------------------------------------------------------------*/
 int makeScreenshot_L13(const screenmode_t* pInfo)
 {
-  int iReturn = EOK;
-
-  if (0 != pInfo)
-  {
-    uint16_t uiPalSize  = pInfo->uiColors * sizeof(bmppaletteentry_t);
-    uint8_t  uiLineLen  = pInfo->uiResX >> 1;   /* 32bit aligned */
-    uint32_t uiPxlSize  = ((uint32_t) pInfo->uiResY) * ((uint32_t) uiLineLen);
-
-    /* Create BMP header */
-    if (EOK == iReturn)
-    {
-      /* file header */
-      g_tState.bmpfile.tFileHdr.uiSize    += uiPalSize;
-      g_tState.bmpfile.tFileHdr.uiSize    += uiPxlSize;
-      g_tState.bmpfile.tFileHdr.uiOffBits += uiPalSize;
-
-      /* info header */
-      g_tState.bmpfile.tInfoHdr.iWidth      = pInfo->uiResX;                         /* image width     */
-      g_tState.bmpfile.tInfoHdr.iHeight     = pInfo->uiResY;                         /* image height    */
-      g_tState.bmpfile.tInfoHdr.uiBitCount  = 4;                                     /* bits per pixel  */
-      g_tState.bmpfile.tInfoHdr.uiSizeImage = uiPxlSize;                             /* image size      */
-      g_tState.bmpfile.tInfoHdr.uiClrUsed   = uiPalSize / sizeof(bmppaletteentry_t); /* palette entries */
-
-      iReturn = saveImageHeader();
-    }
-
-    /* Save color palette ... */
-    if (EOK == iReturn)
-    {
-      iReturn = saveColourPalette(pInfo);
-    }
-
-    /* write pixel data ... */
-    if (EOK == iReturn)
-    {
-      const uint8_t* pPixelData = (const uint8_t*) zxn_memmap(pInfo->tMemPixel.uiAddr);
-      const uint8_t* pAttrData  = (const uint8_t*) zxn_memmap(pInfo->tMemAttr.uiAddr);
-      const uint8_t* pPixelRow  = 0;
-      const uint8_t* pAttrRow   = 0;
-      uint8_t  uiPixelByte;
-      uint8_t  uiAttrByte;
-      uint8_t* pBmpLine = 0;
-      uint8_t  uiBmpIdx;
-      uint8_t  uiBmpPixel;
-
-      if (0 == (pBmpLine = malloc(uiLineLen)))
-      {
-        iReturn = ENOMEM;
-      }
-      else
-      {
-        memset(pBmpLine, 0, uiLineLen);
-
-        for (uint16_t uiY = pInfo->uiResY - 1; uiY != 0xFFFF; --uiY)
-        {
-          /*
-          Attributes interleaved like pixel data ...
-          */
-
-         #if (_PIXEL_CALC_ == 0)
-          uiZ = ((uiY & 0x07) << 8) +  /* Zeile innerhalb der 8er-Gruppe        */
-                ((uiY & 0x38) << 2) +  /* 8er-Gruppe innerhalb des 64er-Blocks  */
-                ((uiY & 0xC0) << 5);   /* welcher 64er-Block (oben/mitte/unten) */
-          pPixelRow = pPixelData + uiZ;
-          pAttrRow  = pAttrData  + uiY;
-         #elif (_PIXEL_CALC_ == 1)
-          pPixelRow = tshc_py2saddr(uiY);
-          pAttrRow  = tshc_py2aaddr(uiY);
-         #else
-          pPixelRow = tshc_py2saddr(uiY);
-          pAttrRow  = tshc_saddr2aaddr(pPixelRow);
-         #endif
-
-          for (uint16_t uiX = 0; uiX < pInfo->uiResX; uiX += 8)
-          {
-            uiPixelByte = *(pPixelRow + (uiX >> 3));
-            uiAttrByte  = *(pAttrRow  + (uiX >> 3));
-
-            /*
-            Bit 7   FLASH   (0 = normal, 1 = blinkend Vorder-/Hintergrund wechseln)
-            Bit 6   BRIGHT  (0 = normale Helligkeit, 1 = erhoehte Helligkeit)
-            Bit 5–3 PAPER   (Hintergrundfarbe, 3 Bit: 0–7)
-            Bit 2–0 INK     (Vordergrundfarbe, 3 Bit: 0–7)
-            */
-
-            for (uint16_t uiZ = 0; uiZ < 8; ++uiZ)
-            {
-              if (uiAttrByte & FLASH)
-              {
-                uiBmpPixel = (uiPixelByte & (1 << (7 - uiZ)) ?
-                             (uiAttrByte & PAPER_WHITE) >> 3 :
-                             (uiAttrByte & INK_WHITE));
-              }
-              else
-              {
-                uiBmpPixel = (uiPixelByte & (1 << (7 - uiZ)) ?
-                             (uiAttrByte & INK_WHITE) :
-                             (uiAttrByte & PAPER_WHITE) >> 3);
-              }
-              uiBmpPixel += (uiAttrByte & BRIGHT ? 8 : 0);
-
-              uiBmpIdx = (uiX + uiZ) >> 1;
-              pBmpLine[uiBmpIdx] = (uiX + uiZ) & 0x01 ? /* odd nibble ? */
-                                   (pBmpLine[uiBmpIdx] & 0xF0) |  uiBmpPixel :
-                                   (pBmpLine[uiBmpIdx] & 0x0F) | (uiBmpPixel << 4);
-            }
-          }
-
-          if (uiLineLen != esx_f_write(g_tState.bmpfile.hFile, pBmpLine, uiLineLen))
-          {
-            iReturn = EBADF;
-            goto EXIT_NESTED_LOOPS;
-          }
-        }
-
-      EXIT_NESTED_LOOPS:
-
-        free(pBmpLine);
-        pBmpLine = 0;
-      }
-    }
-  }
-  else
-  {
-    iReturn = EINVAL;
-  }
-
-  return iReturn;
+  return makeUlaScreenshot(pInfo, ATTR_ROW_LINE);
 }
 
 
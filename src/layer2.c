@@ -48,10 +48,139 @@
 #include "libzxn.h"
 #include "scrnshot.h"
 #include "layer2.h"
+#include "kernel.h"
+#include "bench.h"
 
 /*============================================================================*/
 /*                               Defines                                      */
 /*============================================================================*/
+/*!
+Address of the 8K bank of the Layer 2 that is read (MMU2)
+*/
+#define LAYER2_PAGE_ADDR 0x4000
+
+/*!
+Template of the pixel decoder of a Layer 2 mode. The geometry of the mode is
+a constant of the generated function, so the row stride, the bank steps and
+the loop bounds are immediate values instead of fields of "screenmode_t":
+
+  name      name of the generated function
+  pixshift  pixels per byte as shift (0 = 8 bit, 1 = 4 bit)
+  colmajor  memory layout: 0 = rows of 256 bytes, 32 rows per 8K bank (the
+            row is passed to "saveImageRow()" without a copy); 1 = columns
+            of 256 bytes, 32 columns per 8K bank (the row is gathered with
+            a stride of 256 bytes; a scaled image reads every n-th column,
+            640x256: the left pixel of every n/2-th column, and the row is
+            passed scaled)
+
+The bank is only remapped if it differs from the one of the previous access.
+A gathered row is saved with interrupts enabled, so MMU2 is restored before.
+*/
+#define LAYER2_DECODER(name, pixshift, colmajor)                               \
+static int name(const imagerect_t* pRect)                                      \
+{                                                                              \
+  int      iReturn  = EOK;                                                     \
+  uint16_t uiCol0   = pRect->uiX >> (pixshift);                                \
+  uint16_t uiLen    = pRect->uiW >> (pixshift);                                \
+  uint8_t  uiShift  = g_tState.uiScale >> 1;   /* scale 1, 2, 4 => 0, 1, 2 */  \
+  uint8_t  uiSkip   = (uiShift > (pixshift) ? uiShift - (pixshift) : 0);       \
+  uint8_t  uiBank0  = getLayer2Page(); /* 8K bank of the first row/column */   \
+  uint8_t  uiBank;                                                             \
+  uint16_t uiBank_  = 0xFFFF;                                                  \
+  uint8_t  uiMMU2;                                                             \
+  uint8_t* pBmpLine = 0;                                                       \
+  const uint8_t* pPage = (const uint8_t*) zxn_memmap(LAYER2_PAGE_ADDR);        \
+                                                                               \
+  if ((colmajor) && (0 == (pBmpLine = malloc(uiLen))))                         \
+  {                                                                            \
+    return ENOMEM;                                                             \
+  }                                                                            \
+                                                                               \
+  if (!(colmajor))                                                             \
+  {                                                                            \
+    STATS_DI();                                                                \
+  }                                                                            \
+                                                                               \
+  uiMMU2 = ZXN_READ_MMU2();                                                    \
+                                                                               \
+  for (uint16_t uiY = IMAGE_ROW_FIRST(pRect); IMAGE_ROW_VALID(uiY, pRect); uiY += g_tState.bmpfile.iRowStep) \
+  {                                                                            \
+    if (colmajor)                                                              \
+    {                                                                          \
+      uint8_t*       pDst  = pBmpLine;                                         \
+      const uint8_t* pSrc;                                                     \
+      uint16_t       uiCol = uiCol0;                                           \
+      uint16_t       uiEnd = uiCol0 + uiLen;                                   \
+      uint16_t       uiNext;                                                   \
+      uint8_t        uiCnt;                                                    \
+                                                                               \
+      STATS_DI();                                                              \
+                                                                               \
+      while (uiCol < uiEnd)                                                    \
+      {                                                                        \
+        uiBank = uiBank0 + (uint8_t) (uiCol >> 5);                             \
+                                                                               \
+        if (uiBank_ != ((uint16_t) uiBank))                                    \
+        {                                                                      \
+          STATS_MMU2(uiBank);                                                  \
+          uiBank_ = ((uint16_t) uiBank);                                       \
+        }                                                                      \
+                                                                               \
+        /* Rest of the columns of this bank, every 2^uiSkip-th */              \
+        pSrc   = pPage + ((uiCol & 0x1F) << 8) + uiY;                          \
+        uiNext = (uiCol | 0x1F) + 1;                                           \
+        uiNext = (uiEnd < uiNext ? uiEnd : uiNext);                            \
+        uiCnt  = (uint8_t) ((uiNext - uiCol + (1 << uiSkip) - 1) >> uiSkip);   \
+        uiCol += ((uint16_t) uiCnt) << uiSkip;                                 \
+                                                                               \
+        pDst = gatherLayer2Cols(pDst, pSrc, uiCnt, 1 << uiSkip);               \
+      }                                                                        \
+                                                                               \
+      /* The sink runs with interrupts enabled: MMU2 must be bank 5 again */   \
+      STATS_MMU2(uiMMU2);                                                      \
+      uiBank_ = 0xFFFF;                                                        \
+      STATS_EI();                                                              \
+                                                                               \
+      if ((pixshift) && (0 != uiShift))                                        \
+      {                                                                        \
+        packLeftNibbles(pBmpLine, (uint16_t) (pDst - pBmpLine));               \
+      }                                                                        \
+                                                                               \
+      iReturn = saveScaledRow(pBmpLine, uiLen >> uiShift);                     \
+    }                                                                          \
+    else                                                                       \
+    {                                                                          \
+      uiBank = uiBank0 + (uint8_t) (uiY >> 5);                                 \
+                                                                               \
+      if (uiBank_ != ((uint16_t) uiBank))                                      \
+      {                                                                        \
+        STATS_MMU2(uiBank);                                                    \
+        uiBank_ = ((uint16_t) uiBank);                                         \
+      }                                                                        \
+                                                                               \
+      iReturn = saveImageRow(pPage + ((uiY & 0x1F) << 8) + uiCol0, uiLen);     \
+    }                                                                          \
+                                                                               \
+    if (EOK != iReturn)                                                        \
+    {                                                                          \
+      break;                                                                   \
+    }                                                                          \
+  }                                                                            \
+                                                                               \
+  STATS_MMU2(uiMMU2);                                                          \
+                                                                               \
+  if (!(colmajor))                                                             \
+  {                                                                            \
+    STATS_EI();                                                                \
+  }                                                                            \
+                                                                               \
+  if (0 != pBmpLine)                                                           \
+  {                                                                            \
+    free(pBmpLine);                                                            \
+  }                                                                            \
+                                                                               \
+  return iReturn;                                                              \
+}
 
 /*============================================================================*/
 /*                               Namespaces                                   */
@@ -76,10 +205,26 @@ extern appstate_t g_tState;
 /*============================================================================*/
 /*                               Type-Definitions                             */
 /*============================================================================*/
+/*!
+Pixel decoder of a Layer 2 mode (see "LAYER2_DECODER")
+*/
+typedef int (*layer2decoder_t)(const imagerect_t* pRect);
 
 /*============================================================================*/
 /*                               Prototypes                                   */
 /*============================================================================*/
+/*!
+Header, palette and pixel data of a Layer 2 mode with 8 or 4 bits per pixel
+*/
+static int makeLayer2Image(const screenmode_t* pInfo, uint8_t uiBitCount, layer2decoder_t fnDecode);
+
+/*!
+Pixel decoders of the Layer 2 modes: 256x192 (row major), 320x256 and 640x256
+(column major)
+*/
+static int decodeLayer2_256x192(const imagerect_t* pRect);
+static int decodeLayer2_320x256(const imagerect_t* pRect);
+static int decodeLayer2_640x256(const imagerect_t* pRect);
 
 /*============================================================================*/
 /*                               Classes                                      */
@@ -94,116 +239,7 @@ extern appstate_t g_tState;
 /*----------------------------------------------------------------------------*/
 int makeScreenshot_L20(const screenmode_t* pInfo)
 {
-  int iReturn = EOK;
-
-  if (0 != pInfo)
-  {
-    uint16_t uiPalSize = pInfo->uiColors * sizeof(bmppaletteentry_t);
-    uint32_t uiPxlSize = ((uint32_t) pInfo->uiResY) * ((uint32_t) pInfo->uiResX);
-
-    /* Create BMP header */
-    if (EOK == iReturn)
-    {
-      /* file header */
-      g_tState.bmpfile.tFileHdr.uiSize    += uiPalSize;
-      g_tState.bmpfile.tFileHdr.uiSize    += uiPxlSize;
-      g_tState.bmpfile.tFileHdr.uiOffBits += uiPalSize;
-
-      /* info header */
-      g_tState.bmpfile.tInfoHdr.iWidth      = pInfo->uiResX;                  /* image width     */
-      g_tState.bmpfile.tInfoHdr.iHeight     = pInfo->uiResY;                  /* image height    */
-      g_tState.bmpfile.tInfoHdr.uiBitCount  = 8;                              /* bits per pixel  */
-      g_tState.bmpfile.tInfoHdr.uiSizeImage = pInfo->uiResY * pInfo->uiResX;  /* image size      */
-      g_tState.bmpfile.tInfoHdr.uiClrUsed   = pInfo->uiColors;                /* palette entries */
-
-      iReturn = saveImageHeader();
-    }
-
-    /* Save color palette ... */
-    if (EOK == iReturn)
-    {
-      iReturn = saveColourPalette(pInfo);
-    }
-
-#if 0
-    if (EOK == iReturn)
-    {
-      bmppaletteentry_t tEntry;
-      tEntry.a = 0;
-
-      for (uint8_t uiR = 0; uiR < 8; ++uiR)
-      {
-        for (uint8_t uiG = 0; uiG < 8; ++uiG)
-        {
-          for (uint8_t uiB = 0; uiB < 4; ++uiB)
-          {
-           #if 0
-            tEntry.r = (uiR * 255 + 3) / 7;   // oder Bit-Replikation
-            tEntry.g = (uiG * 255 + 3) / 7;
-            tEntry.b = (uiB * 255 + 1) / 3;
-           #else
-            tEntry.r = (uiR << 5) | (uiR << 2) | (uiR >> 1);
-            tEntry.g = (uiG << 5) | (uiG << 2) | (uiG >> 1);
-            tEntry.b = (uiB << 6) | (uiB << 4) | (uiB << 2) | uiB;
-           #endif
-
-            if (sizeof(tEntry) != esx_f_write(g_tState.bmpfile.hFile, &tEntry, sizeof(tEntry)))
-            {
-              iReturn = EBADF;
-            }
-          }
-        }
-      }
-    }
-#endif
-
-    /* Write pixel data ... */
-    if (EOK == iReturn)
-    {
-      const uint8_t* pPixelRow = 0;
-      uint8_t  uiMMU2 = 0xFF;
-      uint8_t  uiPhysBank; /* 8K bank */
-      uint16_t uiPhysBank_ = 0xFFFF;
-      uint32_t uiPhysBase;
-      uint32_t uiPhysAddr;
-
-      uiPhysBank = ZXN_READ_REG(0x12) << 1; /* 0x12 L2.ACTIVE.RAM.BANK | 16K bank => 8K bank*/
-      uiPhysBase = UINT32_C(0x2000) * ((uint32_t) uiPhysBank);  
-
-      intrinsic_di();
-      uiMMU2 = ZXN_READ_MMU2();
-
-      for (uint16_t uiY = pInfo->uiResY - 1; uiY != 0xFFFF; --uiY)
-      {
-        uiPhysAddr = uiPhysBase + (((uint32_t) uiY) * ((uint32_t) pInfo->uiResX));
-        uiPhysBank = (uiPhysAddr >> 13) & 0xFF;
-
-        if (uiPhysBank_ != ((uint16_t) uiPhysBank))
-        {
-          // Neue BANK mappen
-          ZXN_WRITE_MMU2(uiPhysBank);
-          uiPhysBank_ = ((uint16_t) uiPhysBank);
-        }
-
-        pPixelRow = ((const uint8_t*) zxn_memmap(pInfo->tMemPixel.uiAddr)) + (uiPhysAddr & 0x1FFF); 
-
-        if (pInfo->uiResX != esx_f_write(g_tState.bmpfile.hFile, pPixelRow, pInfo->uiResX))
-        {
-          iReturn = EBADF;
-          break;
-        }
-      }
-
-      ZXN_WRITE_MMU2(uiMMU2);
-      intrinsic_ei();
-    }
-  }
-  else
-  {
-    iReturn = EINVAL;
-  }
-
-  return iReturn;
+  return makeLayer2Image(pInfo, 8, decodeLayer2_256x192);
 }
 
 
@@ -212,7 +248,7 @@ int makeScreenshot_L20(const screenmode_t* pInfo)
 /*----------------------------------------------------------------------------*/
 int makeScreenshot_L22(const screenmode_t* pInfo)
 {
-  return makeScreenshot_L20(pInfo);
+  return makeLayer2Image(pInfo, 8, decodeLayer2_320x256);
 }
 
 
@@ -220,14 +256,29 @@ int makeScreenshot_L22(const screenmode_t* pInfo)
 /* makeScreenshot_L23()                                                       */
 /*----------------------------------------------------------------------------*/
 int makeScreenshot_L23(const screenmode_t* pInfo)
+{
+  return makeLayer2Image(pInfo, 4, decodeLayer2_640x256);
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* makeLayer2Image()                                                          */
+/*----------------------------------------------------------------------------*/
+static int makeLayer2Image(const screenmode_t* pInfo, uint8_t uiBitCount, layer2decoder_t fnDecode)
 {
   int iReturn = EOK;
 
   if (0 != pInfo)
   {
+    imagerect_t tRect;
     uint16_t uiPalSize = pInfo->uiColors * sizeof(bmppaletteentry_t);
-    uint16_t uiLineLen = pInfo->uiResX >> 1;  /* 640 pixel = 320 byte; 32bit aligned */
-    uint32_t uiPxlSize = ((uint32_t) pInfo->uiResY) * ((uint32_t) uiLineLen);
+    uint16_t uiLineLen;
+    uint32_t uiPxlSize;
+
+    /* Region of the screen: whole screen or option "--rect" */
+    iReturn   = getImageRect(pInfo, uiBitCount, &tRect);
+    uiLineLen = (8 == uiBitCount ? tRect.uiW : tRect.uiW >> 1);  /* 32bit aligned */
+    uiPxlSize = ((uint32_t) tRect.uiH) * ((uint32_t) uiLineLen);
 
     /* Create BMP header */
     if (EOK == iReturn)
@@ -238,108 +289,25 @@ int makeScreenshot_L23(const screenmode_t* pInfo)
       g_tState.bmpfile.tFileHdr.uiOffBits += uiPalSize;
 
       /* info header */
-      g_tState.bmpfile.tInfoHdr.iWidth      = pInfo->uiResX;                         /* image width     */
-      g_tState.bmpfile.tInfoHdr.iHeight     = pInfo->uiResY;                         /* image height    */
-      g_tState.bmpfile.tInfoHdr.uiBitCount  = 4;                                     /* bits per pixel  */
-      g_tState.bmpfile.tInfoHdr.uiSizeImage = ((uint32_t) pInfo->uiResY) * ((uint32_t) uiLineLen); /* image size */
-      g_tState.bmpfile.tInfoHdr.uiClrUsed   = uiPalSize / sizeof(bmppaletteentry_t); /* palette entries */
+      g_tState.bmpfile.tInfoHdr.iWidth      = tRect.uiW;                      /* image width     */
+      g_tState.bmpfile.tInfoHdr.iHeight     = tRect.uiH;                      /* image height    */
+      g_tState.bmpfile.tInfoHdr.uiBitCount  = uiBitCount;                     /* bits per pixel  */
+      g_tState.bmpfile.tInfoHdr.uiSizeImage = uiPxlSize;                      /* image size      */
+      g_tState.bmpfile.tInfoHdr.uiClrUsed   = pInfo->uiColors;                /* palette entries */
 
       iReturn = saveImageHeader();
     }
 
-    /* save color palette ... */
-   #if 0
-    if (EOK == iReturn)
-    {
-      bmppaletteentry_t tEntry;
-      tEntry.a = 0;
-
-      for (uint8_t uiR = 0; uiR < 8; ++uiR)
-      {
-        for (uint8_t uiG = 0; uiG < 8; ++uiG)
-        {
-          for (uint8_t uiB = 0; uiB < 4; ++uiB)
-          {
-            tEntry.r = (uiR << 5) | (uiR << 2) | (uiR >> 1);
-            tEntry.g = (uiG << 5) | (uiG << 2) | (uiG >> 1);
-            tEntry.b = (uiB << 6) | (uiB << 4) | (uiB << 2) | uiB;
-
-            if (sizeof(tEntry) != esx_f_write(g_tState.bmpfile.hFile, &tEntry, sizeof(tEntry)))
-            {
-              iReturn = EBADF;
-            }
-          }
-        }
-      }
-    }
-   #else
+    /* Save color palette ... */
     if (EOK == iReturn)
     {
       iReturn = saveColourPalette(pInfo);
     }
-   #endif
 
-    /* write pixel data ... */
+    /* Write pixel data ... */
     if (EOK == iReturn)
     {
-      uint8_t* pPixelRow = 0;
-      uint8_t* pBmpLine = 0;
-
-      if (0 == (pBmpLine = malloc(uiLineLen)))
-      {
-        iReturn = ENOMEM;
-      }
-      else
-      {
-        memset(pBmpLine, 0, uiLineLen);
-
-        uint8_t  uiMMU2 = 0xFF;
-        uint8_t  uiPhysBank; /* 8K bank */
-        uint16_t uiPhysBank_ = 0xFFFF;
-        uint32_t uiPhysBase;
-        uint32_t uiPhysAddr;
-        const uint8_t* pVirtBase = (const uint8_t*) zxn_memmap(pInfo->tMemPixel.uiAddr);
-
-        uiPhysBank = ZXN_READ_REG(0x12) * 2; /* 0x12 L2.ACTIVE.RAM.BANK | 16K bank => 8K bank*/
-        uiPhysBase = UINT32_C(0x2000) * ((uint32_t) uiPhysBank);  
-
-        uiMMU2 = ZXN_READ_MMU2();
-
-        for (uint16_t uiY = pInfo->uiResY - 1; uiY != 0xFFFF; --uiY)
-        {
-          intrinsic_di();
-
-          for (uint16_t uiX = 0; uiX < uiLineLen; ++uiX)
-          {
-            uiPhysAddr = uiPhysBase + (((uint32_t) uiY) * ((uint32_t) uiLineLen)) + ((uint32_t) uiX);
-            uiPhysBank = (uiPhysAddr >> 13) & 0xFF;
-
-            if (uiPhysBank_ != ((uint16_t) uiPhysBank))
-            {
-              ZXN_WRITE_MMU2(uiPhysBank);
-              uiPhysBank_ = ((uint16_t) uiPhysBank);
-            }
-
-            pBmpLine[uiX] = pVirtBase[uiPhysAddr & 0x1FFF]; 
-          }
-
-          intrinsic_ei();
-
-          if (uiLineLen != esx_f_write(g_tState.bmpfile.hFile, pBmpLine, uiLineLen))
-          {
-            iReturn = EBADF;
-            break;
-          }
-        }
-
-        ZXN_WRITE_MMU2(uiMMU2);
-
-        if (0 != pBmpLine)
-        {
-          free(pBmpLine);
-          pBmpLine = 0;
-        }
-      }
+      iReturn = fnDecode(&tRect);
     }
   }
   else
@@ -351,6 +319,14 @@ int makeScreenshot_L23(const screenmode_t* pInfo)
 }
 
 
+/*----------------------------------------------------------------------------*/
+/* decodeLayer2_256x192(), decodeLayer2_320x256(), decodeLayer2_640x256()     */
+/*----------------------------------------------------------------------------*/
+LAYER2_DECODER(decodeLayer2_256x192, 0, 0)
+LAYER2_DECODER(decodeLayer2_320x256, 0, 1)
+LAYER2_DECODER(decodeLayer2_640x256, 1, 1)
+
+
 /*----------------------------------------------------------------------------*/
 /*                                                                            */
 /*----------------------------------------------------------------------------*/
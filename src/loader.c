@@ -0,0 +1,636 @@
+/*-----------------------------------------------------------------------------+
+|                                                                              |
+| filename: loader.c                                                           |
+| project:  zxn::scrnshot                                                      |
+| author:   S. Zell                                                            |
+| date:     10/18/2026                                                         |
+|                                                                              |
++------------------------------------------------------------------------------+
+|                                                                              |
+| description:                                                                 |
+|                                                                              |
+| Loading of screenshots back into the video memory                            |
+|                                                                              |
++------------------------------------------------------------------------------+
+|                                                                              |
+| Copyright (c) 10/18/2026 STZ Engineering                                     |
+|                                                                              |
+| This software is provided  "as is",  without warranty of any kind, express   |
+| or implied. In no event shall STZ or its contributors be held liable for any |
+| direct, indirect, incidental, special or consequential damages arising out   |
+| of the use of or inability to use this software.                             |
+|                                                                              |
+| Permission is granted to anyone  to use this  software for any purpose,      |
+| including commercial applications,  and to alter it and redistribute it      |
+| freely, subject to the following restrictions:                               |
+|                                                                              |
+| 1. Redistributions of source code must retain the above copyright            |
+|    notice, definition, disclaimer, and this list of conditions.              |
+|                                                                              |
+| 2. Redistributions in binary form must reproduce the above copyright         |
+|    notice, definition, disclaimer, and this list of conditions in            |
+|    documentation and/or other materials provided with the distribution.      |
+|                                                                          ;-) |
++-----------------------------------------------------------------------------*/
+
+/*============================================================================*/
+/*                               Includes                                     */
+/*============================================================================*/
+#include <stdint.h>
+#include <errno.h>
+#include <string.h>
+#include <malloc.h>
+#include <z80.h>
+#include <intrinsic.h>
+#include <arch/zxn.h>
+#include <arch/zxn/esxdos.h>
+
+#include "libzxn.h"
+#include "scrnshot.h"
+#include "zx0.h"
+#include "loader.h"
+#include "bench.h"
+
+/*============================================================================*/
+/*                               Defines                                      */
+/*============================================================================*/
+/*!
+Marker of an attribute whose INK is already assigned (pass 1 of the ULA
+loader; FLASH is never restored)
+*/
+#define LOADER_INK_SET FLASH
+
+/*============================================================================*/
+/*                               Namespaces                                   */
+/*============================================================================*/
+
+/*============================================================================*/
+/*                               Constants                                    */
+/*============================================================================*/
+
+/*============================================================================*/
+/*                               Variables                                    */
+/*============================================================================*/
+/*!
+In dieser Struktur werden alle globalen Daten der Anwendung gespeichert.
+*/
+extern appstate_t g_tState;
+
+/*!
+BMP color palette including all spectrum layer 0 colors.
+*/
+extern const bmppaletteentry_t g_tColorPalL0[];
+
+/*============================================================================*/
+/*                               Structures                                   */
+/*============================================================================*/
+
+/*============================================================================*/
+/*                               Type-Definitions                             */
+/*============================================================================*/
+
+/*============================================================================*/
+/*                               Prototypes                                   */
+/*============================================================================*/
+/*!
+Reads the next row of the BMP file
+*/
+static int readBmpRow(uint8_t* pRow, uint16_t uiLen);
+
+/*!
+Seeks to the first row of the BMP file
+*/
+static int seekBmpRows(void);
+
+/*!
+Returns the screen row of the n-th row of the BMP file
+*/
+static uint16_t getBmpRowY(uint16_t uiRow, uint16_t uiResY);
+
+/*!
+Loads the pixel data of LAYER 0, LAYER 1,1 and LAYER 1,3 (4 bpp)
+*/
+static int loadBmpUla(const screenmode_t* pInfo, uint8_t* pRow, uint16_t uiRowLen);
+
+/*!
+Loads the pixel data of LAYER 1,0 (LoRes, Radastan)
+*/
+static int loadBmpLoRes(const screenmode_t* pInfo, uint8_t* pRow, uint16_t uiRowLen);
+
+/*!
+Loads the pixel data of LAYER 1,2 (Timex HiRes)
+*/
+static int loadBmpHiRes(const screenmode_t* pInfo, uint8_t* pRow, uint16_t uiRowLen);
+
+/*!
+Loads the pixel data of LAYER 2 (256 x 192): whole 8K pages per read
+*/
+static int loadBmpLayer2(const screenmode_t* pInfo);
+
+/*!
+Loads the pixel data of LAYER 2,2 and LAYER 2,3 (column major)
+*/
+static int loadBmpLayer2Cols(const screenmode_t* pInfo, uint8_t* pRow, uint16_t uiRowLen);
+
+/*============================================================================*/
+/*                               Classes                                      */
+/*============================================================================*/
+
+/*============================================================================*/
+/*                               Implementation                               */
+/*============================================================================*/
+
+/*----------------------------------------------------------------------------*/
+/* loadImage()                                                                */
+/*----------------------------------------------------------------------------*/
+int loadImage(void)
+{
+  int iReturn = EOK;
+  char_t acMagic[4];
+
+  if (INV_FILE_HND == (g_tState.bmpfile.hFile = esx_f_open(g_tState.bmpfile.acPathName, ESXDOS_MODE_R | ESXDOS_MODE_OE)))
+  {
+    return ENOENT;
+  }
+
+  if (sizeof(acMagic) != esx_f_read(g_tState.bmpfile.hFile, acMagic, sizeof(acMagic)))
+  {
+    iReturn = EBADF;
+  }
+
+  esx_f_close(g_tState.bmpfile.hFile);
+  g_tState.bmpfile.hFile = INV_FILE_HND;
+
+  if (EOK == iReturn)
+  {
+    if (('B' == acMagic[0]) && ('M' == acMagic[1]))
+    {
+      iReturn = loadBmpImage();
+    }
+    else if (0 == memcmp(acMagic, "SCZ0", sizeof(acMagic)))
+    {
+      iReturn = loadZx0Image();
+    }
+    else
+    {
+      iReturn = ENOTSUP;
+    }
+  }
+
+  return iReturn;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* loadBmpImage()                                                             */
+/*----------------------------------------------------------------------------*/
+int loadBmpImage(void)
+{
+  int iReturn = EOK;
+  uint8_t uiMode = detectScreenMode();
+  const screenmode_t* pInfo = getScreenModeInfo(uiMode);
+  bmpfileheader_t* pFileHdr = &g_tState.bmpfile.tFileHdr;
+  bmpinfoheader_t* pInfoHdr = &g_tState.bmpfile.tInfoHdr;
+  uint16_t uiBitCount = 0;
+  uint16_t uiColors   = 0;
+  uint16_t uiRowLen   = 0;
+  uint8_t* pRow       = 0;
+
+  /* Bits per pixel of the BMP files of the screen modes */
+  switch (uiMode)
+  {
+    case 0x00:
+    case 0x11:
+    case 0x13:
+    case 0x23:
+      uiBitCount = 4;
+      break;
+
+    case 0x10:
+      uiBitCount = (zxn_radastan_mode() ? 4 : 8);
+      break;
+
+    case 0x12:
+      uiBitCount = 1;
+      break;
+
+    case 0x20:
+    case 0x22:
+      uiBitCount = 8;
+      break;
+
+    default:
+      iReturn = ENOTSUP;
+  }
+
+  /* Headers */
+  if (EOK == iReturn)
+  {
+    if (INV_FILE_HND == (g_tState.bmpfile.hFile = esx_f_open(g_tState.bmpfile.acPathName, ESXDOS_MODE_R | ESXDOS_MODE_OE)))
+    {
+      iReturn = ENOENT;
+    }
+    else if ((sizeof(*pFileHdr) != esx_f_read(g_tState.bmpfile.hFile, pFileHdr, sizeof(*pFileHdr))) ||
+             (sizeof(*pInfoHdr) != esx_f_read(g_tState.bmpfile.hFile, pInfoHdr, sizeof(*pInfoHdr))))
+    {
+      iReturn = EBADF;
+    }
+    else if ((0x4D42 != pFileHdr->uiType) || (sizeof(*pInfoHdr) > pInfoHdr->uiSize) ||
+             (1 != pInfoHdr->uiPlanes) || (0 != pInfoHdr->uiCompression))
+    {
+      iReturn = EBADF;  /* Error: no (uncompressed) BMP file */
+    }
+    else if ((pInfoHdr->uiBitCount != uiBitCount) ||
+             (pInfoHdr->iWidth != ((int32_t) pInfo->uiResX)) ||
+             ((pInfoHdr->iHeight != ((int32_t) pInfo->uiResY)) && (pInfoHdr->iHeight != -((int32_t) pInfo->uiResY))))
+    {
+      iReturn = EINVAL; /* Error: different screen mode */
+    }
+  }
+
+  /* Palette */
+  if (EOK == iReturn)
+  {
+    uiColors = (0 != pInfoHdr->uiClrUsed ? (uint16_t) pInfoHdr->uiClrUsed : (1 << uiBitCount));
+    uiColors = (uiColors > (1 << uiBitCount) ? (1 << uiBitCount) : uiColors);
+    uiRowLen = (uint16_t) ((((uint32_t) pInfo->uiResX) * uiBitCount + 31) >> 5) << 2;
+
+    if ((sizeof(*pFileHdr) + pInfoHdr->uiSize) != esx_f_seek(g_tState.bmpfile.hFile, sizeof(*pFileHdr) + pInfoHdr->uiSize, ESX_SEEK_SET))
+    {
+      iReturn = EBADF;
+    }
+    else if ((uiColors * sizeof(bmppaletteentry_t)) != esx_f_read(g_tState.bmpfile.hFile, g_tState.bmpfile.tPalette, uiColors * sizeof(bmppaletteentry_t)))
+    {
+      iReturn = EBADF;
+    }
+    else
+    {
+      switch (uiMode)
+      {
+        case 0x00:
+        case 0x11:
+        case 0x13:
+          /* ULA palette: INK 0..15, PAPER 16..31 */
+          memcpy(&g_tState.bmpfile.tPalette[16], &g_tState.bmpfile.tPalette[0], 16 * sizeof(bmppaletteentry_t));
+          iReturn = writeColourPalette(pInfo, 32);
+          break;
+
+        case 0x12:
+          /* Timex HiRes: colour set of port 0xFF (see makeScreenshot_L12) */
+          for (uint8_t uiColorSet = 0; uiColorSet < 8; ++uiColorSet)
+          {
+            if (0 == memcmp(&g_tState.bmpfile.tPalette[1], &g_tColorPalL0[8 + uiColorSet], 3))
+            {
+              z80_outp(0xFF, (z80_inp(0xFF) & 0xC7) | (uiColorSet << 3));
+              break;
+            }
+          }
+          break;
+
+        default:
+          iReturn = writeColourPalette(pInfo, uiColors);
+      }
+    }
+  }
+
+  /* Pixel data */
+  if (EOK == iReturn)
+  {
+    if ((0x20 != uiMode) && (0 == (pRow = malloc(uiRowLen))))
+    {
+      iReturn = ENOMEM;
+    }
+    else if (EOK == (iReturn = seekBmpRows()))
+    {
+      switch (uiMode)
+      {
+        case 0x00:
+        case 0x11:
+        case 0x13:
+          iReturn = loadBmpUla(pInfo, pRow, uiRowLen);
+          break;
+
+        case 0x10:
+          iReturn = loadBmpLoRes(pInfo, pRow, uiRowLen);
+          break;
+
+        case 0x12:
+          iReturn = loadBmpHiRes(pInfo, pRow, uiRowLen);
+          break;
+
+        case 0x20:
+          iReturn = loadBmpLayer2(pInfo);
+          break;
+
+        default:
+          iReturn = loadBmpLayer2Cols(pInfo, pRow, uiRowLen);
+      }
+    }
+
+    if (0 != pRow)
+    {
+      free(pRow);
+      pRow = 0;
+    }
+  }
+
+  if (INV_FILE_HND != g_tState.bmpfile.hFile)
+  {
+    esx_f_close(g_tState.bmpfile.hFile);
+    g_tState.bmpfile.hFile = INV_FILE_HND;
+  }
+
+  return iReturn;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* readBmpRow()                                                               */
+/*----------------------------------------------------------------------------*/
+static int readBmpRow(uint8_t* pRow, uint16_t uiLen)
+{
+  return (uiLen == esx_f_read(g_tState.bmpfile.hFile, pRow, uiLen) ? EOK : EBADF);
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* seekBmpRows()                                                              */
+/*----------------------------------------------------------------------------*/
+static int seekBmpRows(void)
+{
+  uint32_t uiOffset = g_tState.bmpfile.tFileHdr.uiOffBits;
+
+  return (uiOffset == esx_f_seek(g_tState.bmpfile.hFile, uiOffset, ESX_SEEK_SET) ? EOK : EBADF);
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* getBmpRowY()                                                               */
+/*----------------------------------------------------------------------------*/
+static uint16_t getBmpRowY(uint16_t uiRow, uint16_t uiResY)
+{
+  /* Positive height: bottom-up */
+  return (0 < g_tState.bmpfile.tInfoHdr.iHeight ? uiResY - 1 - uiRow : uiRow);
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* loadBmpUla()                                                               */
+/*----------------------------------------------------------------------------*/
+static int loadBmpUla(const screenmode_t* pInfo, uint8_t* pRow, uint16_t uiRowLen)
+{
+  int iReturn = EOK;
+  uint8_t* pAttrData = (uint8_t*) zxn_memmap(pInfo->tMemAttr.uiAddr);
+  uint8_t  uiCellH   = (uint8_t) (pInfo->uiResY / pInfo->uiCelY);  /* 8 or 1 */
+  uint8_t* pPixelRow;
+  uint8_t* pAttrRow;
+  uint8_t  uiAttr;
+  uint8_t  uiPaper;
+  uint8_t  uiColour;
+  uint8_t  uiByte;
+  uint16_t uiY;
+
+  /*
+  Pass 1: attributes. PAPER (and BRIGHT) is the colour of the first pixel of
+  a cell, INK the first different colour.
+  Pass 2: pixels. Every pixel that differs from PAPER is set.
+  */
+  for (uint8_t uiPass = 0; (EOK == iReturn) && (uiPass < 2); ++uiPass)
+  {
+    if ((1 == uiPass) && (EOK != (iReturn = seekBmpRows())))
+    {
+      break;
+    }
+
+    for (uint16_t uiRow = 0; uiRow < pInfo->uiResY; ++uiRow)
+    {
+      if (EOK != (iReturn = readBmpRow(pRow, uiRowLen)))
+      {
+        break;
+      }
+
+      uiY       = getBmpRowY(uiRow, pInfo->uiResY);
+      pPixelRow = zxn_pixelad(0, (uint8_t) uiY);
+      pAttrRow  = (1 == uiCellH ?
+                   tshc_saddr2aaddr(pPixelRow) :
+                   pAttrData + ((uiY >> 3) << 5));
+
+      for (uint8_t uiX = 0; uiX < 32; ++uiX)
+      {
+        const uint8_t* pPixels = &pRow[uiX << 2];  /* 8 pixels = 4 bytes */
+
+        uiAttr = pAttrRow[uiX];
+
+        /* First row of the cell in file order */
+        if ((0 == uiPass) && ((uiRow % uiCellH) == 0))
+        {
+          uiPaper = pPixels[0] >> 4;
+          uiAttr  = ((uiPaper & 0x07) << 3) | (uiPaper & 0x08 ? BRIGHT : 0);
+        }
+
+        uiPaper = ((uiAttr >> 3) & 0x07) | (uiAttr & BRIGHT ? 0x08 : 0);
+        uiByte  = 0;
+
+        for (uint8_t uiZ = 0; uiZ < 8; ++uiZ)
+        {
+          uiColour = (uiZ & 0x01 ? pPixels[uiZ >> 1] & 0x0F : pPixels[uiZ >> 1] >> 4);
+
+          if (uiColour != uiPaper)
+          {
+            uiByte |= 0x80 >> uiZ;
+
+            if (!(uiAttr & LOADER_INK_SET))
+            {
+              uiAttr = (uiAttr & ~INK_WHITE) | (uiColour & INK_WHITE) | LOADER_INK_SET;
+            }
+          }
+        }
+
+        if (0 == uiPass)
+        {
+          pAttrRow[uiX] = uiAttr;
+        }
+        else
+        {
+          pPixelRow[uiX] = uiByte;
+        }
+      }
+    }
+
+    /* Remove the markers */
+    if ((EOK == iReturn) && (0 == uiPass))
+    {
+      for (uint16_t i = 0; i < pInfo->tMemAttr.uiSize; ++i)
+      {
+        pAttrData[i] &= ~LOADER_INK_SET;
+      }
+    }
+  }
+
+  return iReturn;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* loadBmpLoRes()                                                             */
+/*----------------------------------------------------------------------------*/
+static int loadBmpLoRes(const screenmode_t* pInfo, uint8_t* pRow, uint16_t uiRowLen)
+{
+  int iReturn = EOK;
+  uint8_t* pPixelData0 = (uint8_t*) zxn_memmap(pInfo->tMemPixel.uiAddr);
+  uint8_t* pPixelData1 = (uint8_t*) zxn_memmap(pInfo->tMemAttr.uiAddr);
+  uint16_t uiOffset;
+
+  for (uint16_t uiRow = 0; uiRow < pInfo->uiResY; ++uiRow)
+  {
+    if (EOK != (iReturn = readBmpRow(pRow, uiRowLen)))
+    {
+      break;
+    }
+
+    /* LoRes: 128 bytes per row; Radastan: 64 bytes per row */
+    uiOffset = getBmpRowY(uiRow, pInfo->uiResY) * uiRowLen;
+
+    memcpy(pInfo->tMemPixel.uiSize > uiOffset ?
+           pPixelData0 + uiOffset :
+           pPixelData1 + uiOffset - pInfo->tMemPixel.uiSize,
+           pRow,
+           uiRowLen);
+  }
+
+  return iReturn;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* loadBmpHiRes()                                                             */
+/*----------------------------------------------------------------------------*/
+static int loadBmpHiRes(const screenmode_t* pInfo, uint8_t* pRow, uint16_t uiRowLen)
+{
+  int iReturn = EOK;
+  uint8_t* pPixelRow0;
+  uint8_t* pPixelRow1;
+
+  for (uint16_t uiRow = 0; uiRow < pInfo->uiResY; ++uiRow)
+  {
+    if (EOK != (iReturn = readBmpRow(pRow, uiRowLen)))
+    {
+      break;
+    }
+
+    /* Even columns: first screen; odd columns: second screen */
+    pPixelRow0 = zxn_pixelad(0, (uint8_t) getBmpRowY(uiRow, pInfo->uiResY));
+    pPixelRow1 = pPixelRow0 - pInfo->tMemPixel.uiAddr + pInfo->tMemAttr.uiAddr;
+
+    for (uint8_t uiX = 0; uiX < 32; ++uiX)
+    {
+      pPixelRow0[uiX] = pRow[(uiX << 1)    ];
+      pPixelRow1[uiX] = pRow[(uiX << 1) + 1];
+    }
+  }
+
+  return iReturn;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* loadBmpLayer2()                                                            */
+/*----------------------------------------------------------------------------*/
+static int loadBmpLayer2(const screenmode_t* pInfo)
+{
+  int iReturn = EOK;
+  bool bBottomUp = (0 < g_tState.bmpfile.tInfoHdr.iHeight);
+  uint8_t  uiMMU2;
+  uint8_t  uiPhysBank = getLayer2Page(); /* 0x12 L2.ACTIVE.RAM.BANK or 0x13 (-b s) | 8K bank */
+  uint8_t  uiPages    = (uint8_t) ((((uint32_t) pInfo->uiResX) * ((uint32_t) pInfo->uiResY)) >> 13);
+  uint8_t* pPage      = (uint8_t*) zxn_memmap(pInfo->tMemPixel.uiAddr);
+
+  STATS_DI();
+  uiMMU2 = ZXN_READ_MMU2();
+
+  /* 32 rows per page: one read per page, bottom-up files from the last page */
+  for (uint8_t i = 0; (EOK == iReturn) && (i < uiPages); ++i)
+  {
+    STATS_MMU2(uiPhysBank + (bBottomUp ? uiPages - 1 - i : i));
+
+    if (pInfo->tMemPixel.uiSize != esx_f_read(g_tState.bmpfile.hFile, pPage, pInfo->tMemPixel.uiSize))
+    {
+      iReturn = EBADF;
+    }
+    else if (bBottomUp)
+    {
+      /* Reverse the order of the rows in the page */
+      uint8_t* pTop = pPage;
+      uint8_t* pBottom = pPage + pInfo->tMemPixel.uiSize - pInfo->uiResX;
+      uint8_t  uiTemp;
+
+      while (pTop < pBottom)
+      {
+        for (uint16_t uiX = 0; uiX < pInfo->uiResX; ++uiX)
+        {
+          uiTemp      = pTop[uiX];
+          pTop[uiX]   = pBottom[uiX];
+          pBottom[uiX] = uiTemp;
+        }
+
+        pTop    += pInfo->uiResX;
+        pBottom -= pInfo->uiResX;
+      }
+    }
+  }
+
+  STATS_MMU2(uiMMU2);
+  STATS_EI();
+
+  return iReturn;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* loadBmpLayer2Cols()                                                        */
+/*----------------------------------------------------------------------------*/
+static int loadBmpLayer2Cols(const screenmode_t* pInfo, uint8_t* pRow, uint16_t uiRowLen)
+{
+  int iReturn = EOK;
+  uint8_t  uiMMU2;
+  uint8_t  uiPhysBank = getLayer2Page(); /* 0x12 L2.ACTIVE.RAM.BANK or 0x13 (-b s) | 8K bank */
+  uint8_t* pPage      = (uint8_t*) zxn_memmap(pInfo->tMemPixel.uiAddr);
+  uint8_t  uiY;
+
+  uiMMU2 = ZXN_READ_MMU2();
+
+  for (uint16_t uiRow = 0; uiRow < pInfo->uiResY; ++uiRow)
+  {
+    if (EOK != (iReturn = readBmpRow(pRow, uiRowLen)))
+    {
+      break;
+    }
+
+    uiY = (uint8_t) getBmpRowY(uiRow, pInfo->uiResY);
+
+    /* Column major: 256 bytes per column (byte), 32 columns per page */
+    STATS_DI();
+
+    for (uint16_t uiX = 0; uiX < uiRowLen; uiX += 32)
+    {
+      uint8_t* pDst = pPage + uiY;
+
+      STATS_MMU2(uiPhysBank + (uint8_t) (uiX >> 5));
+
+      for (uint8_t uiC = 0; uiC < 32; ++uiC, pDst += 256)
+      {
+        *pDst = pRow[uiX + uiC];
+      }
+    }
+
+    STATS_MMU2(uiMMU2);
+    STATS_EI();
+  }
+
+  return iReturn;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/*                                                                            */
+/*----------------------------------------------------------------------------*/
@@ -42,6 +42,7 @@
 #include <string.h>
 #include <malloc.h>
 #include <errno.h>
+#include <z80.h>
 #include <arch/zxn.h>
 #include <arch/zxn/esxdos.h>
 
@@ -51,11 +52,26 @@
 #include "layer1.h"
 #include "layer2.h"
 #include "layer3.h"
+#include "gif.h"
+#include "png.h"
+#include "qoi.h"
+#include "native.h"
+#include "zx0.h"
+#include "loader.h"
+#include "capture.h"
+#include "uart.h"
+#include "archive.h"
+#include "vstate.h"
+#include "bench.h"
 #include "version.h"
 
 /*============================================================================*/
 /*                               Defines                                      */
 /*============================================================================*/
+/*!
+Largest scaled image row (option "-s 2"): 320 x 8 bit or 640 x 4 bit / 2
+*/
+#define SCALED_ROW_MAX 160
 
 /*============================================================================*/
 /*                               Namespaces                                   */
@@ -74,6 +90,12 @@ All global data of the appüliction is stored in this structure
 */
 appstate_t g_tState;
 
+/*!
+Buffer of a scaled image row: static, the heap (CLIB_MALLOC_HEAP_SIZE) holds
+the row buffers of the decoders
+*/
+static uint8_t s_auiScaledRow[SCALED_ROW_MAX];
+
 /*!
 Table to describe all basic properties of valid video-/screenmodes of the
 Spectrum Next
@@ -100,6 +122,27 @@ const screenmode_t g_tScreenModes[] =
   {0xFF,   0,   0,   0,   0,   0,   0, {0x0000, 0x0000}, {0x0000, 0x0000}} 
 };
 
+/*!
+Table of all supported formats of the output file
+*/
+const fileformat_t g_tFileFormats[] =
+{
+  {FORMAT_BMP,     "bmp"},
+  {FORMAT_GIF,     "gif"},
+  {FORMAT_PNG,     "png"},
+  {FORMAT_QOI,     "qoi"},
+  {FORMAT_NATIVE,  "scr"},
+  {FORMAT_NATIVE,  "shc"},
+  {FORMAT_NATIVE,  "shr"},
+  {FORMAT_NATIVE,  "slr"},
+  {FORMAT_NATIVE,  "sl2"},
+  {FORMAT_NATIVE,  "nxi"},
+  {FORMAT_ZX0,     "zx0"},
+  {FORMAT_STATE,   "nvs"},
+  /* --- END-OF-LIST --- */
+  {FORMAT_NONE,    0}
+};
+
 /*!
 BMP color palette including all spectrum layer 0 colors.
 (https://en.wikipedia.org/wiki/ZX_Spectrum_graphic_modes)
@@ -209,10 +252,68 @@ Ausgabe der Versionsinformation dieser Anwendung.
 int showInfo(void);
 
 /*!
-This function is responsible for creation of the BMP file. It calls
-specialized functions for the active video-/screenmode.
+This function creates one screenshot per enabled layer (option "-L"). All
+layers are taken from one snapshot of the video hardware.
+*/
+int makeLayerScreenshots(void);
+
+/*!
+This function takes the snapshot of the video hardware for the screenshots of
+all layers: enabled layers, page of Layer 2 and the colour palettes.
+@return Number of enabled layers
+*/
+static uint8_t takeSnapshot(void);
+
+/*!
+This function writes a thumbnail of the screenshot (option "-T") to the file
+"<name>-s<scale>.<ext>" next to the screenshot.
+*/
+static int makeThumbnail(void);
+
+/*!
+This function creates one screenshot of each Layer 2 buffer (option "-b b"):
+active (NREG 0x12) and shadow (NREG 0x13).
+*/
+static int makeBufferScreenshots(void);
+
+/*!
+This function returns the name of the output file without extension (or
+"<directory>/scrnshot") for files derived from it (layers, buffers). The format
+is taken from the extension of the name, if it is not set by option "-t".
+@param acBase Buffer for the name (ESX_PATHNAME_MAX)
+@return Extension of the format
+*/
+static const char_t* getBaseName(char_t* acBase);
+
+/*!
+This function opens a further output of the screenshot (option "-o"); the
+format is taken from the extension of the filename.
+*/
+int openOutput(uint8_t uiMode, output_t* pOutput);
+
+/*!
+These functions write the parts of the image to the current output (see
+"selectOutput"); the public functions call them for all row based outputs.
+*/
+static int saveOutputHeader(void);
+static int saveOutputColourTable(uint16_t uiColors);
+static int saveOutputRow(const uint8_t* pRow, uint16_t uiLen);
+static int saveOutputTrailer(void);
+
+/*!
+This function subsamples a full size image row to the scale of the image
+(every 2nd/4th pixel) into "g_tState.bmpfile.pScaledRow".
+@param pRow Full size image row
+@param pLen Length of the image row (in: full size, out: scaled)
+@return Scaled image row
+*/
+static const uint8_t* scaleImageRow(const uint8_t* pRow, uint16_t* pLen);
+
+/*!
+This function returns the properties of the file format with the given name
+(extension) or 0, if the format is not supported.
 */
-int makeScreenshot(void);
+const fileformat_t* getFileFormatInfo(const char_t* acExt);
 
 /*============================================================================*/
 /*                               Klassen                                      */
@@ -232,9 +333,41 @@ void _construct(void)
     g_tState.eAction       = ACTION_NONE;
     g_tState.bQuiet        = false;
     g_tState.bForce        = false;
+    g_tState.bArchive      = false;
+    g_tState.eFormat       = FORMAT_NONE;
+    g_tState.acNativeExt   = 0;
+    g_tState.uiLevel       = PNG_LEVEL_FAST;
     g_tState.iExitCode     = EOK;
     g_tState.uiCpuSpeed    = zxn_getspeed();
+    g_tState.uiCaptureAddr = 0;
+    memset(&g_tState.tRect, 0, sizeof(g_tState.tRect));
+    g_tState.uiScale       = 1;
+    g_tState.uiThumb       = 0;
+    g_tState.uiLayer2Reg   = 0x12;
+    g_tState.bLayer2Both   = false;
+    g_tState.uiOutputs     = 1;
+    g_tState.uiOutput      = 0;
     g_tState.bmpfile.hFile = INV_FILE_HND;
+    g_tState.bmpfile.eSink = SINK_FILE;
+    g_tState.bmpfile.pScaledRow = 0;
+    g_tState.snapshot.bValid  = false;
+    g_tState.snapshot.uiModes = 0;
+    g_tState.snapshot.uiLayer = 0;
+    g_tState.bench.uiRuns  = 0;
+    g_tState.bench.bTimer  = false;
+    g_tState.bench.ePhase  = BENCH_OTHER;
+    memset(&g_tState.stats, 0, sizeof(g_tState.stats));
+    g_tState.uiDiNesting   = 0;
+
+    memset(g_tState.auiBanks, INV_BANK, sizeof(g_tState.auiBanks));
+
+    for (uint8_t i = 0; i < OUTPUTS_MAX; ++i)
+    {
+      g_tState.atOutputs[i].eFormat     = FORMAT_NONE;
+      g_tState.atOutputs[i].acNativeExt = 0;
+      g_tState.atOutputs[i].hFile       = INV_FILE_HND;
+      g_tState.atOutputs[i].acPathName  = g_tState.bmpfile.acPathName;
+    }
 
     esx_f_getcwd(g_tState.bmpfile.acPathName);
 
@@ -255,12 +388,31 @@ void _destruct(void)
 {
   if (g_tState.bInitialized)
   {
+    for (uint8_t i = 0; i < g_tState.uiOutputs; ++i)
+    {
+      if (INV_FILE_HND != g_tState.atOutputs[i].hFile)
+      {
+        if (g_tState.atOutputs[i].hFile == g_tState.bmpfile.hFile)
+        {
+          g_tState.bmpfile.hFile = INV_FILE_HND;
+        }
+
+        (void) esx_f_close(g_tState.atOutputs[i].hFile);
+        g_tState.atOutputs[i].hFile = INV_FILE_HND;
+      }
+    }
+
     if (INV_FILE_HND != g_tState.bmpfile.hFile)
     {
       (void) esx_f_close(g_tState.bmpfile.hFile);
       g_tState.bmpfile.hFile = INV_FILE_HND;
     }
 
+    for (uint8_t i = 0; i < BANKS_MAX; ++i)
+    {
+      freeBank(g_tState.auiBanks[i]);
+    }
+
     zxn_setspeed(g_tState.uiCpuSpeed);
     g_tState.bInitialized = false;
   }
@@ -277,6 +429,11 @@ int main(int argc, char* argv[])
 
   if (EOK == (g_tState.iExitCode = parseArguments(argc, argv)))
   {
+    if (g_tState.stats.bEnabled)
+    {
+      beginStats();
+    }
+
     switch (g_tState.eAction)
     {
       case ACTION_NONE:
@@ -292,12 +449,40 @@ int main(int argc, char* argv[])
         break;
 
       case ACTION_SHOT:
-        g_tState.iExitCode = makeScreenshot();
+        if (g_tState.bLayer2Both && (0x20 == (detectScreenMode() & 0xF0)))
+        {
+          g_tState.iExitCode = makeBufferScreenshots();
+        }
+        else if ((EOK == (g_tState.iExitCode = makeScreenshot())) && (0 != g_tState.uiThumb))
+        {
+          g_tState.iExitCode = makeThumbnail();
+        }
+        break;
+
+      case ACTION_LOAD:
+        g_tState.iExitCode = loadImage();
+        break;
+
+      case ACTION_CAPTURE:
+        g_tState.iExitCode = makeCapture();
+        break;
+
+      case ACTION_LAYERS:
+        g_tState.iExitCode = makeLayerScreenshots();
+        break;
+
+      case ACTION_BENCH:
+        g_tState.iExitCode = runBenchmark();
         break;
 
       default:
         g_tState.iExitCode = ESTAT;
     }
+
+    if (g_tState.stats.bEnabled)
+    {
+      endStats();
+    }
   }
 
   return (int) (EOK == g_tState.iExitCode ? 0 : zxn_strerror(g_tState.iExitCode));
@@ -329,6 +514,167 @@ int parseArguments(int argc, char_t* argv[])
       {
         g_tState.eAction = ACTION_INFO;
       }
+      else if ((0 == strcmp(acArg, "-l")) || (0 == stricmp(acArg, "--load")))
+      {
+        g_tState.eAction = ACTION_LOAD;
+      }
+      else if ((0 == strcmp(acArg, "-L")) || (0 == stricmp(acArg, "--layers")))
+      {
+        g_tState.eAction = ACTION_LAYERS;
+      }
+      else if ((0 == strcmp(acArg, "-m")) || (0 == stricmp(acArg, "--mem")))
+      {
+        g_tState.eAction = ACTION_CAPTURE;
+
+        /* Optional: address of the descriptor */
+        if (((i + 1) < argc) && ('0' <= argv[i + 1][0]) && ('9' >= argv[i + 1][0]))
+        {
+          uint32_t uiAddr = strtoul(argv[i + 1], 0, 0);
+
+          if ((0x4000 > uiAddr) || ((0x10000 - sizeof(capture_t)) < uiAddr))
+          {
+            fprintf(stderr, "invalid address\n");
+            iReturn = EINVAL;
+            break;
+          }
+
+          g_tState.uiCaptureAddr = (uint16_t) uiAddr;
+          ++i;
+        }
+      }
+      else if ((0 == strcmp(acArg, "-r")) || (0 == stricmp(acArg, "--rect")))
+      {
+        /* Region of the screen: x,y,w,h */
+        uint16_t auiValues[4];
+        uint8_t  uiValues = 0;
+        char_t*  acValue  = ((i + 1) < argc ? argv[i + 1] : 0);
+
+        while ((0 != acValue) && ('0' <= *acValue) && ('9' >= *acValue) && (4 > uiValues))
+        {
+          auiValues[uiValues++] = (uint16_t) strtoul(acValue, &acValue, 10);
+          acValue = (',' == *acValue ? acValue + 1 : acValue);
+        }
+
+        if ((4 != uiValues) || (0 == auiValues[2]) || (0 == auiValues[3]) || ((0 != acValue) && (0 != *acValue)))
+        {
+          fprintf(stderr, "invalid rectangle\n");
+          iReturn = EINVAL;
+          break;
+        }
+
+        g_tState.tRect.uiX = auiValues[0];
+        g_tState.tRect.uiY = auiValues[1];
+        g_tState.tRect.uiW = auiValues[2];
+        g_tState.tRect.uiH = auiValues[3];
+        ++i;
+      }
+      else if ((0 == strcmp(acArg, "-s")) || (0 == stricmp(acArg, "--scale")))
+      {
+        /* Scale of the image: 1/2 or 1/4 */
+        if (((i + 1) < argc) && (('2' == argv[i + 1][0]) || ('4' == argv[i + 1][0])) && (0 == argv[i + 1][1]))
+        {
+          g_tState.uiScale = (uint8_t) (argv[i + 1][0] - '0');
+          ++i;
+        }
+        else
+        {
+          fprintf(stderr, "invalid scale\n");
+          iReturn = EINVAL;
+          break;
+        }
+      }
+      else if ((0 == strcmp(acArg, "-T")) || (0 == stricmp(acArg, "--thumb")))
+      {
+        /* Additional thumbnail: 1/2 or 1/4 */
+        if (((i + 1) < argc) && (('2' == argv[i + 1][0]) || ('4' == argv[i + 1][0])) && (0 == argv[i + 1][1]))
+        {
+          g_tState.uiThumb = (uint8_t) (argv[i + 1][0] - '0');
+          ++i;
+        }
+        else
+        {
+          fprintf(stderr, "invalid scale\n");
+          iReturn = EINVAL;
+          break;
+        }
+      }
+      else if ((0 == strcmp(acArg, "-b")) || (0 == stricmp(acArg, "--buffer")))
+      {
+        /* Layer 2 buffer: active (0x12), shadow (0x13) or both */
+        char_t cBuffer = ((i + 1) < argc ? argv[i + 1][0] : 0);
+
+        if (('a' == cBuffer) || ('s' == cBuffer) || ('b' == cBuffer))
+        {
+          g_tState.uiLayer2Reg = ('s' == cBuffer ? 0x13 : 0x12);
+          g_tState.bLayer2Both = ('b' == cBuffer);
+          ++i;
+        }
+        else
+        {
+          fprintf(stderr, "invalid buffer\n");
+          iReturn = EINVAL;
+          break;
+        }
+      }
+      else if ((0 == strcmp(acArg, "-o")) || (0 == stricmp(acArg, "--output")))
+      {
+        if (((i + 1) < argc) && (OUTPUTS_MAX > g_tState.uiOutputs))
+        {
+          g_tState.atOutputs[g_tState.uiOutputs++].acPathName = argv[i + 1];
+          ++i;
+        }
+        else
+        {
+          fprintf(stderr, "invalid output\n");
+          iReturn = EINVAL;
+          break;
+        }
+      }
+      else if ((0 == strcmp(acArg, "-a")) || (0 == stricmp(acArg, "--archive")))
+      {
+        g_tState.bArchive = true;
+      }
+      else if ((0 == strcmp(acArg, "-u")) || (0 == stricmp(acArg, "--uart")))
+      {
+        g_tState.bmpfile.eSink = SINK_UART;
+      }
+      else if ((0 == strcmp(acArg, "-B")) || (0 == stricmp(acArg, "--bench")))
+      {
+        uint16_t uiRuns;
+
+        if (((i + 1) < argc) && (0 < (uiRuns = (uint16_t) strtoul(argv[i + 1], 0, 0))) && (BENCH_RUNS_MAX >= uiRuns))
+        {
+          g_tState.bench.uiRuns = (uint8_t) uiRuns;
+          g_tState.eAction = ACTION_BENCH;
+          ++i;
+        }
+        else
+        {
+          fprintf(stderr, "invalid number of runs\n");
+          iReturn = EINVAL;
+          break;
+        }
+      }
+      else if ((0 == strcmp(acArg, "-S")) || (0 == stricmp(acArg, "--stats")))
+      {
+        g_tState.stats.bEnabled = true;
+
+        /* Optional: address of the copy for NextBASIC */
+        if (((i + 1) < argc) && ('0' <= argv[i + 1][0]) && ('9' >= argv[i + 1][0]))
+        {
+          uint32_t uiAddr = strtoul(argv[i + 1], 0, 0);
+
+          if ((0x4000 > uiAddr) || ((0x10000 - sizeof(statsblock_t)) < uiAddr))
+          {
+            fprintf(stderr, "invalid address\n");
+            iReturn = EINVAL;
+            break;
+          }
+
+          g_tState.stats.uiAddr = (uint16_t) uiAddr;
+          ++i;
+        }
+      }
       else if ((0 == strcmp(acArg, "-q")) || (0 == stricmp(acArg, "--quiet")))
       {
         g_tState.bQuiet = true;
@@ -337,6 +683,37 @@ int parseArguments(int argc, char_t* argv[])
       {
         g_tState.bForce = true;
       }
+      else if ((0 == strcmp(acArg, "-t")) || (0 == stricmp(acArg, "--type")))
+      {
+        const fileformat_t* pFormat = 0;
+
+        if (((i + 1) < argc) && (0 != (pFormat = getFileFormatInfo(argv[i + 1]))))
+        {
+          g_tState.eFormat     = pFormat->eFormat;
+          g_tState.acNativeExt = pFormat->acExt;
+          ++i;
+        }
+        else
+        {
+          fprintf(stderr, "invalid file type\n");
+          iReturn = EINVAL;
+          break;
+        }
+      }
+      else if ((0 == strcmp(acArg, "-c")) || (0 == stricmp(acArg, "--compress")))
+      {
+        if (((i + 1) < argc) && ('0' <= argv[i + 1][0]) && ('2' >= argv[i + 1][0]) && (0 == argv[i + 1][1]))
+        {
+          g_tState.uiLevel = (uint8_t) (argv[i + 1][0] - '0');
+          ++i;
+        }
+        else
+        {
+          fprintf(stderr, "invalid compression level\n");
+          iReturn = EINVAL;
+          break;
+        }
+      }
 #if 0
       else if ((0 == strcmp(acArg, "-p")) /* || (0 == stricmp(acArg, "--palette")) */)
       {
@@ -368,6 +745,28 @@ int parseArguments(int argc, char_t* argv[])
     g_tState.eAction = ACTION_SHOT;
   }
 
+  /* Thumbnail: scaled like "-s", checked before the screenshot is written */
+  if ((EOK == iReturn) && (0 != g_tState.uiThumb))
+  {
+    const fileformat_t* pFormat = 0;
+    const char_t* acName = strrchr(g_tState.bmpfile.acPathName, '/');
+    const char_t* acExt;
+    format_t eFormat = g_tState.eFormat;
+
+    acName = (0 != acName ? acName : g_tState.bmpfile.acPathName);
+
+    if ((FORMAT_NONE == eFormat) && (0 != (acExt = strrchr(acName, '.'))) && (0 != (pFormat = getFileFormatInfo(acExt + 1))))
+    {
+      eFormat = pFormat->eFormat;
+    }
+
+    if (!IS_ROW_FORMAT(eFormat))
+    {
+      fprintf(stderr, "thumbnail: bmp, gif, png or qoi only\n");
+      iReturn = EINVAL;
+    }
+  }
+
   return iReturn;
 }
 
@@ -383,9 +782,32 @@ int showHelp(void)
 
   printf("%s\n\n", VER_FILEDESCRIPTION_STR);
 
-  printf("%s file [-f][-q][-h][-v]\n\n", acAppName);
+  printf("%s file [-t x][-c n][-r r][-s n][-T n][-b x][-o f][-a][-l][-L][-m a][-u][-B n][-S a][-f][-q][-h][-v]\n\n", acAppName);
   /*      0.........1.........2.........3. */
   printf(" file        pathname of file\n");
+  printf(" -t[ype] x   file type\n");
+  printf("             bmp,gif,png,qoi,\n");
+  printf("             scr,shc,shr,slr,\n");
+  printf("             sl2,nxi (native)\n");
+  printf("             zx0 (compressed)\n");
+  printf("             nvs (video state)\n");
+  printf(" -c[omp] n   compression (0-2)\n");
+  printf(" -r[ect] r   region x,y,w,h\n");
+  printf(" -s[cale] n  size 1/n (2, 4)\n");
+  printf(" -T[humb] n  + thumbnail 1/n\n");
+  printf(" -b[uffer] x layer 2 buffer\n");
+  printf("             a(ctive),s(hadow),\n");
+  printf("             b(oth)\n");
+  printf(" -o[utput] f more files (max 3)\n");
+  printf(" -a[rchive]  append to archive\n");
+  printf(" -l[oad]     load bmp/zx0 file\n");
+  printf(" -L[ayers]   one file per layer\n");
+  printf(" -m[em] a    capture to RAM\n");
+  printf("             (descriptor at a)\n");
+  printf(" -u[art]     send to host (UART)\n");
+  printf(" -B[ench] n  time n runs (1-16)\n");
+  printf(" -S[tats] a  print counters\n");
+  printf("             (copy at a)\n");
   printf(" -f[orce]    force overwrite\n");
   printf(" -q[uiet]    print no messages\n");
   printf(" -h[elp]     print this help\n");
@@ -435,6 +857,80 @@ int makeScreenshot(void)
 
   uint8_t uiMode = detectScreenMode();
   const screenmode_t* pInfo = getScreenModeInfo(uiMode);
+  const char_t* acExt = 0;
+
+  /* Detect format of the output file: option or extension of the filename */
+  if (FORMAT_NONE == g_tState.eFormat)
+  {
+    const fileformat_t* pFormat = 0;
+    const char_t* acName = strrchr(g_tState.bmpfile.acPathName, '/');
+
+    acName = (0 != acName ? acName : g_tState.bmpfile.acPathName);
+
+    if ((0 != (acExt = strrchr(acName, '.'))) && (0 != (pFormat = getFileFormatInfo(acExt + 1))))
+    {
+      g_tState.eFormat     = pFormat->eFormat;
+      g_tState.acNativeExt = pFormat->acExt;
+    }
+    else
+    {
+      g_tState.eFormat = FORMAT_BMP;
+    }
+  }
+
+  for (const fileformat_t* pFormat = &g_tFileFormats[0]; FORMAT_NONE != pFormat->eFormat; ++pFormat)
+  {
+    if (g_tState.eFormat == pFormat->eFormat)
+    {
+      acExt = pFormat->acExt;
+      break;
+    }
+  }
+
+  /* Native files: the extension depends on the screen mode */
+  if (FORMAT_NATIVE == g_tState.eFormat)
+  {
+    if (0 == (acExt = getNativeFileExt(uiMode, g_tState.acNativeExt)))
+    {
+      iReturn = ENOTSUP;
+    }
+  }
+  else if ((FORMAT_ZX0 == g_tState.eFormat) && (0 == getNativeFileExt(uiMode, 0)))
+  {
+    iReturn = ENOTSUP;
+  }
+
+  /* Transfer to a host receiver: no file system access */
+  if ((EOK == iReturn) && (SINK_UART == g_tState.bmpfile.eSink))
+  {
+    if (1 != g_tState.uiOutputs)
+    {
+      return EINVAL; /* only one image per transfer */
+    }
+
+    g_tState.atOutputs[0].eFormat     = g_tState.eFormat;
+    g_tState.atOutputs[0].acNativeExt = g_tState.acNativeExt;
+    return sendUartImage(pInfo, acExt);
+  }
+
+  /* Benchmark: the image data is discarded, no file system access */
+  if ((EOK == iReturn) && (SINK_NULL == g_tState.bmpfile.eSink))
+  {
+    if (1 != g_tState.uiOutputs)
+    {
+      return EINVAL; /* timing of one image */
+    }
+
+    g_tState.atOutputs[0].eFormat     = g_tState.eFormat;
+    g_tState.atOutputs[0].acNativeExt = g_tState.acNativeExt;
+    return captureImage(pInfo);
+  }
+
+  /* Archive: append to one container file */
+  if ((EOK == iReturn) && g_tState.bArchive)
+  {
+    return saveArchiveImage(pInfo);
+  }
 
   if (EOK == iReturn)
   {
@@ -450,9 +946,10 @@ int makeScreenshot(void)
       while (uiIndex < 0xFFFF)
       {
         snprintf(acPathName, sizeof(acPathName),
-                 "%s" ESX_DIR_SEP VER_INTERNALNAME_STR "-%u.bmp",
+                 "%s" ESX_DIR_SEP VER_INTERNALNAME_STR "-%u.%s",
                  g_tState.bmpfile.acPathName,
-                 uiIndex);
+                 uiIndex,
+                 acExt);
 
         if (INV_FILE_HND == (g_tState.bmpfile.hFile = esx_f_open(acPathName, ESXDOS_MODE_R | ESXDOS_MODE_OE)))
         {
@@ -502,127 +999,933 @@ int makeScreenshot(void)
     {
       iReturn = EACCES;
     }
+
+    g_tState.atOutputs[0].eFormat     = g_tState.eFormat;
+    g_tState.atOutputs[0].acNativeExt = g_tState.acNativeExt;
+    g_tState.atOutputs[0].hFile       = g_tState.bmpfile.hFile;
   }
 
-  if (EOK == iReturn)
+  /* Further outputs (option "-o") */
+  for (uint8_t i = 1; (EOK == iReturn) && (i < g_tState.uiOutputs); ++i)
   {
-    /* Prepare BMP file header */
-    g_tState.bmpfile.tFileHdr.uiType         = 0x4D42;                            /* 'BM' (LE!)      */
-    g_tState.bmpfile.tFileHdr.uiSize         = sizeof(g_tState.bmpfile.tFileHdr); /* file size       */
-    g_tState.bmpfile.tFileHdr.uiSize        += sizeof(g_tState.bmpfile.tInfoHdr);
-    g_tState.bmpfile.tFileHdr.uiRes          = 0;                                 /* reserved        */
-    g_tState.bmpfile.tFileHdr.uiOffBits      = sizeof(g_tState.bmpfile.tFileHdr); /* offset bits     */
-    g_tState.bmpfile.tFileHdr.uiOffBits     += sizeof(g_tState.bmpfile.tInfoHdr);
-
-    /* Prepare BMP info header  */
-    g_tState.bmpfile.tInfoHdr.uiSize         = sizeof(g_tState.bmpfile.tInfoHdr); /* header size     */
-    g_tState.bmpfile.tInfoHdr.uiPlanes       = 1;                                 /* only one layer  */
-    g_tState.bmpfile.tInfoHdr.uiCompression  = 0;                                 /* BI_RGB          */
-    g_tState.bmpfile.tInfoHdr.iXPelsPerMeter = BMP_DPI_72;                        /* 72 DPI          */
-    g_tState.bmpfile.tInfoHdr.iYPelsPerMeter = BMP_DPI_72;                        /* 72 DPI          */
-    g_tState.bmpfile.tInfoHdr.uiClrImportant = 0;                                 /* all colors used */
+    iReturn = openOutput(uiMode, &g_tState.atOutputs[i]);
   }
 
+  /* Header, palette, pixel data and trailer */
   if (EOK == iReturn)
   {
-    switch (uiMode)
+    iReturn = captureImage(pInfo);
+  }
+
+  /* Close files; remove them on error */
+  for (uint8_t i = 0; i < g_tState.uiOutputs; ++i)
+  {
+    if (INV_FILE_HND != g_tState.atOutputs[i].hFile)
     {
-      /* LAYER 0 */
-      case 0x00: 
-        iReturn = makeScreenshot_L00(pInfo);
-        break;
+      (void) esx_f_close(g_tState.atOutputs[i].hFile);
+      g_tState.atOutputs[i].hFile = INV_FILE_HND;
 
-      /* LAYER 1 */
-      case 0x10:
-        iReturn = makeScreenshot_L10(pInfo);
-        break;
-      case 0x11:
-        iReturn = makeScreenshot_L11(pInfo);
-        break;
-      case 0x12:
-        iReturn = makeScreenshot_L12(pInfo);
-        break;
-      case 0x13:
-        iReturn = makeScreenshot_L13(pInfo);
-        break;
+      if (EOK != iReturn)
+      {
+        (void) esx_f_unlink(g_tState.atOutputs[i].acPathName);
+      }
+    }
+  }
 
-      /* LAYER 2 */
-      case 0x20:
-        iReturn = makeScreenshot_L20(pInfo);
-        break;
-      case 0x22:
-        iReturn = makeScreenshot_L22(pInfo);
-        break;
-      case 0x23:
-        iReturn = makeScreenshot_L23(pInfo);
-        break;
+  g_tState.bmpfile.hFile = INV_FILE_HND;
 
-      /* LAYER 3 */
-      case 0x30:
-        iReturn = makeScreenshot_L30(pInfo);
-        break;
-      case 0x31:
-        iReturn = makeScreenshot_L31(pInfo);
-        break;
-      case 0x32:
-        iReturn = makeScreenshot_L32(pInfo);
-        break;
-      case 0x33:
-        iReturn = makeScreenshot_L33(pInfo);
-        break;
+  return iReturn;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* makeLayerScreenshots()                                                     */
+/*----------------------------------------------------------------------------*/
+int makeLayerScreenshots(void)
+{
+  int iReturn = EOK;
+
+  char_t acBase[ESX_PATHNAME_MAX];
+  const char_t* acExt;
+
+  if (1 != g_tState.uiOutputs)
+  {
+    return EINVAL; /* "-o" names one file per output, not per layer */
+  }
+
+  /* One snapshot for all layers */
+  if (0 == takeSnapshot())
+  {
+    return ENOTSUP;
+  }
+
+  acExt = getBaseName(acBase);
+
+  /* One screenshot per layer: "<base>-L<mode>.<ext>" */
+  for (uint8_t i = 0; (EOK == iReturn) && (i < g_tState.snapshot.uiModes); ++i)
+  {
+    uint8_t uiMode = g_tState.snapshot.auiModes[i];
+    const char_t* acModeExt = acExt;
+
+    g_tState.snapshot.uiLayer = i;
+
+    if ((FORMAT_NATIVE == g_tState.eFormat) && (0 != getNativeFileExt(uiMode, 0)))
+    {
+      acModeExt = getNativeFileExt(uiMode, g_tState.acNativeExt);
+    }
+
+    if (!g_tState.bArchive)
+    {
+      snprintf(g_tState.bmpfile.acPathName, sizeof(g_tState.bmpfile.acPathName),
+               "%s-L%u%u.%s", acBase, uiMode >> 4, uiMode & 0x0F, acModeExt);
+    }
+
+    if (ENOTSUP == (iReturn = makeScreenshot()))
+    {
+      if (!g_tState.bQuiet)
+      {
+        printf("Layer %u,%u not supported\n", uiMode >> 4, uiMode & 0x0F);
+      }
+
+      iReturn = EOK; /* skip this layer */
+    }
+    else if ((EOK == iReturn) && !g_tState.bQuiet && !g_tState.bArchive)
+    {
+      printf("%s\n", g_tState.bmpfile.acPathName);
+    }
+  }
+
+  g_tState.snapshot.bValid = false;
+
+  return iReturn;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* takeSnapshot()                                                             */
+/*----------------------------------------------------------------------------*/
+static uint8_t takeSnapshot(void)
+{
+  uint8_t uiMode = detectScreenMode();
+  uint8_t uiValue;
+
+  g_tState.snapshot.bValid  = false;
+  g_tState.snapshot.uiModes = 0;
+
+  /* ULA (NREG 0x68 bit 7: disabled): LoRes, Timex modes or standard screen */
+  if (!(ZXN_READ_REG(0x68) & 0x80))
+  {
+    uiValue = z80_inp(0xFF) & 0x07;
+
+    if (ZXN_READ_REG(0x15) & 0x80)
+    {
+      uiMode = 0x10;
+    }
+    else if (0x02 == uiValue)
+    {
+      uiMode = 0x13;
+    }
+    else if (0x06 == uiValue)
+    {
+      uiMode = 0x12;
+    }
+    else if (0x11 != uiMode)
+    {
+      uiMode = 0x00;
+    }
+
+    g_tState.snapshot.auiModes[g_tState.snapshot.uiModes++] = uiMode;
+  }
+
+  /* Layer 2 (NREG 0x69 bit 7): resolution from NREG 0x70 */
+  if (ZXN_READ_REG(0x69) & 0x80)
+  {
+    uiValue = (ZXN_READ_REG(0x70) >> 4) & 0x03;
+    g_tState.snapshot.auiModes[g_tState.snapshot.uiModes++] = (0x01 == uiValue ? 0x22 : (0x02 == uiValue ? 0x23 : 0x20));
+  }
+
+  /* Tilemap (NREG 0x6B bit 7): 40x32 or 80x32 */
+  if (ZXN_READ_REG(0x6B) & 0x80)
+  {
+    g_tState.snapshot.auiModes[g_tState.snapshot.uiModes++] = (ZXN_READ_REG(0x6B) & 0x40) ? 0x31 : 0x30;
+  }
+
+  g_tState.snapshot.uiLayer2Page = getLayer2Page();
+
+  /* Colour palettes of all layers, before anything is written */
+  for (uint8_t i = 0; i < g_tState.snapshot.uiModes; ++i)
+  {
+    uint16_t uiColors = readColourPalette(getScreenModeInfo(g_tState.snapshot.auiModes[i]));
+
+    for (uint16_t j = 0; j < uiColors; ++j)
+    {
+      g_tState.snapshot.auiPalette[i][j] = rgb8_to_rgb9(&g_tState.bmpfile.tPalette[j]);
+    }
+  }
+
+  g_tState.snapshot.uiLayer = 0;
+  g_tState.snapshot.bValid  = (0 != g_tState.snapshot.uiModes);
+
+  return g_tState.snapshot.uiModes;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* makeBufferScreenshots()                                                    */
+/*----------------------------------------------------------------------------*/
+static int makeBufferScreenshots(void)
+{
+  int iReturn = EOK;
+
+  char_t acBase[ESX_PATHNAME_MAX];
+  const char_t* acExt;
+  uint8_t uiMode = detectScreenMode();
+
+  if (1 != g_tState.uiOutputs)
+  {
+    return EINVAL; /* "-o" names one file per output, not per buffer */
+  }
+
+  acExt = getBaseName(acBase);
+
+  if ((FORMAT_NATIVE == g_tState.eFormat) && (0 != getNativeFileExt(uiMode, 0)))
+  {
+    acExt = getNativeFileExt(uiMode, g_tState.acNativeExt);
+  }
+
+  /* "<base>-active.<ext>" (NREG 0x12) and "<base>-shadow.<ext>" (NREG 0x13) */
+  for (uint8_t uiReg = 0x12; (EOK == iReturn) && (uiReg <= 0x13); ++uiReg)
+  {
+    g_tState.uiLayer2Reg = uiReg;
+
+    if (!g_tState.bArchive)
+    {
+      snprintf(g_tState.bmpfile.acPathName, sizeof(g_tState.bmpfile.acPathName),
+               "%s-%s.%s", acBase, (0x12 == uiReg ? "active" : "shadow"), acExt);
+    }
+
+    if ((EOK == (iReturn = makeScreenshot())) && !g_tState.bQuiet && !g_tState.bArchive)
+    {
+      printf("%s\n", g_tState.bmpfile.acPathName);
+    }
+
+    if ((EOK == iReturn) && (0 != g_tState.uiThumb))
+    {
+      iReturn = makeThumbnail();
+    }
+  }
+
+  g_tState.uiLayer2Reg = 0x12;
+
+  return iReturn;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* getBaseName()                                                              */
+/*----------------------------------------------------------------------------*/
+static const char_t* getBaseName(char_t* acBase)
+{
+  const char_t* acExt = "bmp";
+
+  /* Filename without extension or "scrnshot" in the directory */
+  if (INV_FILE_HND != (g_tState.bmpfile.hFile = esx_f_opendir(g_tState.bmpfile.acPathName)))
+  {
+    esx_f_closedir(g_tState.bmpfile.hFile);
+    g_tState.bmpfile.hFile = INV_FILE_HND;
+
+    snprintf(acBase, ESX_PATHNAME_MAX, "%s" ESX_DIR_SEP VER_INTERNALNAME_STR, g_tState.bmpfile.acPathName);
+  }
+  else
+  {
+    const char_t* acName = strrchr(g_tState.bmpfile.acPathName, '/');
+    char_t* acDot;
+
+    acName = (0 != acName ? acName : g_tState.bmpfile.acPathName);
+
+    snprintf(acBase, ESX_PATHNAME_MAX, "%s", g_tState.bmpfile.acPathName);
+
+    if (0 != (acDot = strrchr(acBase, '.')) && (acDot > acBase + (acName - g_tState.bmpfile.acPathName)))
+    {
+      const fileformat_t* pFormat = getFileFormatInfo(acDot + 1);
+
+      if ((FORMAT_NONE == g_tState.eFormat) && (0 != pFormat))
+      {
+        g_tState.eFormat     = pFormat->eFormat;
+        g_tState.acNativeExt = pFormat->acExt;
+      }
+
+      *acDot = '\0';
+    }
+  }
+
+  if (FORMAT_NONE == g_tState.eFormat)
+  {
+    g_tState.eFormat = FORMAT_BMP;
+  }
+
+  for (const fileformat_t* pFormat = &g_tFileFormats[0]; FORMAT_NONE != pFormat->eFormat; ++pFormat)
+  {
+    if (g_tState.eFormat == pFormat->eFormat)
+    {
+      acExt = pFormat->acExt;
+      break;
+    }
+  }
+
+  return acExt;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* makeThumbnail()                                                            */
+/*----------------------------------------------------------------------------*/
+static int makeThumbnail(void)
+{
+  int iReturn;
+
+  /* Name of the screenshot (already resolved) plus "-s<scale>" */
+  if (!g_tState.bArchive && (SINK_FILE == g_tState.bmpfile.eSink))
+  {
+    char_t  acPathName[ESX_PATHNAME_MAX];
+    char_t* acDot;
+
+    snprintf(acPathName, sizeof(acPathName), "%s", g_tState.bmpfile.acPathName);
+
+    if ((0 != (acDot = strrchr(acPathName, '.'))) && (0 == strchr(acDot, '/')))
+    {
+      *acDot = '\0';
+      ++acDot;
+    }
+    else
+    {
+      acDot = acPathName + strlen(acPathName); /* no extension */
+    }
+
+    snprintf(g_tState.bmpfile.acPathName, sizeof(g_tState.bmpfile.acPathName),
+             "%s-s%u%s%s", acPathName, g_tState.uiThumb, ('\0' != *acDot ? "." : ""), acDot);
+  }
+
+  /* Thumbnail of the first output only */
+  g_tState.uiOutputs = 1;
+  g_tState.uiScale   = g_tState.uiThumb;
+
+  iReturn = makeScreenshot();
+
+  g_tState.uiScale   = 1;
+
+  return iReturn;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* openOutput()                                                               */
+/*----------------------------------------------------------------------------*/
+int openOutput(uint8_t uiMode, output_t* pOutput)
+{
+  const fileformat_t* pFormat = 0;
+  const char_t* acExt = strrchr(pOutput->acPathName, '.');
+
+  /* Format of the output: extension of the filename */
+  if ((0 == acExt) || (0 == (pFormat = getFileFormatInfo(acExt + 1))))
+  {
+    return EINVAL;
+  }
+
+  pOutput->eFormat     = pFormat->eFormat;
+  pOutput->acNativeExt = pFormat->acExt;
+
+  if (((FORMAT_NATIVE == pOutput->eFormat) || (FORMAT_ZX0 == pOutput->eFormat)) && (0 == getNativeFileExt(uiMode, 0)))
+  {
+    return ENOTSUP;
+  }
+
+  /* Stateful encoders exist only once */
+  if ((FORMAT_GIF == pOutput->eFormat) || (FORMAT_PNG == pOutput->eFormat) || (FORMAT_QOI == pOutput->eFormat))
+  {
+    for (const output_t* pOther = &g_tState.atOutputs[0]; pOther < pOutput; ++pOther)
+    {
+      if (pOther->eFormat == pOutput->eFormat)
+      {
+        return EINVAL;
+      }
+    }
+  }
+
+  if (INV_FILE_HND != (pOutput->hFile = esx_f_open(pOutput->acPathName, ESXDOS_MODE_R | ESXDOS_MODE_OE)))
+  {
+    esx_f_close(pOutput->hFile);
+    pOutput->hFile = INV_FILE_HND;
+
+    if (!g_tState.bForce)
+    {
+      return EBADF; /* Error: File exists */
+    }
+
+    esx_f_unlink(pOutput->acPathName);
+  }
+
+  if (INV_FILE_HND == (pOutput->hFile = esx_f_open(pOutput->acPathName, ESXDOS_MODE_W | ESXDOS_MODE_CN)))
+  {
+    return EACCES;
+  }
+
+  return EOK;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* captureImage()                                                             */
+/*----------------------------------------------------------------------------*/
+int captureImage(const screenmode_t* pInfo)
+{
+  int iReturn = EOK;
+  bool bRows = false;
+
+  if (0 == pInfo)
+  {
+    return EINVAL;
+  }
+
+  /*
+  BMP files are stored bottom-up, all other formats top-down. All outputs
+  share one pass over the video memory: together with other formats a BMP
+  file is stored top-down (negative height).
+  */
+  g_tState.bmpfile.iRowStep = -((int8_t) g_tState.uiScale);
+
+  for (uint8_t i = 0; i < g_tState.uiOutputs; ++i)
+  {
+    if (IS_ROW_FORMAT(g_tState.atOutputs[i].eFormat))
+    {
+      bRows = true;
+
+      if (FORMAT_BMP != g_tState.atOutputs[i].eFormat)
+      {
+        g_tState.bmpfile.iRowStep = (int8_t) g_tState.uiScale;
+      }
+    }
+    else if ((0 != g_tState.tRect.uiW) || (1 != g_tState.uiScale))
+    {
+      return EINVAL; /* region and scale: only formats decoded row by row */
+    }
+  }
+
+  /* Prepare BMP file header */
+  g_tState.bmpfile.tFileHdr.uiType         = 0x4D42;                            /* 'BM' (LE!)      */
+  g_tState.bmpfile.tFileHdr.uiSize         = sizeof(g_tState.bmpfile.tFileHdr); /* file size       */
+  g_tState.bmpfile.tFileHdr.uiSize        += sizeof(g_tState.bmpfile.tInfoHdr);
+  g_tState.bmpfile.tFileHdr.uiRes          = 0;                                 /* reserved        */
+  g_tState.bmpfile.tFileHdr.uiOffBits      = sizeof(g_tState.bmpfile.tFileHdr); /* offset bits     */
+  g_tState.bmpfile.tFileHdr.uiOffBits     += sizeof(g_tState.bmpfile.tInfoHdr);
+
+  /* Prepare BMP info header  */
+  g_tState.bmpfile.tInfoHdr.uiSize         = sizeof(g_tState.bmpfile.tInfoHdr); /* header size     */
+  g_tState.bmpfile.tInfoHdr.uiPlanes       = 1;                                 /* only one layer  */
+  g_tState.bmpfile.tInfoHdr.uiCompression  = 0;                                 /* BI_RGB          */
+  g_tState.bmpfile.tInfoHdr.iXPelsPerMeter = BMP_DPI_72;                        /* 72 DPI          */
+  g_tState.bmpfile.tInfoHdr.iYPelsPerMeter = BMP_DPI_72;                        /* 72 DPI          */
+  g_tState.bmpfile.tInfoHdr.uiClrImportant = 0;                                 /* all colors used */
+
+  /* Outputs written from the video memory as a whole */
+  for (uint8_t i = 0; (EOK == iReturn) && (i < g_tState.uiOutputs); ++i)
+  {
+    selectOutput(i);
+
+    if (!IMAGE_SINK_OPEN())
+    {
+      iReturn = EINVAL;
+    }
+    else if (FORMAT_NATIVE == g_tState.eFormat)
+    {
+      /* Native file: video memory without any transformation */
+      iReturn = saveNativeImage(pInfo);
+    }
+    else if (FORMAT_ZX0 == g_tState.eFormat)
+    {
+      /* Compressed file: video memory, compressed block by block */
+      iReturn = saveZx0Image(pInfo);
+    }
+    else if (FORMAT_STATE == g_tState.eFormat)
+    {
+      /* Video state: NextRegs, palettes and video memory */
+      iReturn = saveStateImage(pInfo);
+    }
+  }
+
+  /* Outputs written row by row: one pass over the video memory */
+  if ((EOK == iReturn) && bRows)
+  {
+    switch (pInfo->uiMode)
+    {
+      /* LAYER 0 */
+      case 0x00: 
+        iReturn = makeScreenshot_L00(pInfo);
+        break;
+
+      /* LAYER 1 */
+      case 0x10:
+        iReturn = makeScreenshot_L10(pInfo);
+        break;
+      case 0x11:
+        iReturn = makeScreenshot_L11(pInfo);
+        break;
+      case 0x12:
+        iReturn = makeScreenshot_L12(pInfo);
+        break;
+      case 0x13:
+        iReturn = makeScreenshot_L13(pInfo);
+        break;
+
+      /* LAYER 2 */
+      case 0x20:
+        iReturn = makeScreenshot_L20(pInfo);
+        break;
+      case 0x22:
+        iReturn = makeScreenshot_L22(pInfo);
+        break;
+      case 0x23:
+        iReturn = makeScreenshot_L23(pInfo);
+        break;
+
+      /* LAYER 3 */
+      case 0x30:
+        iReturn = makeScreenshot_L30(pInfo);
+        break;
+      case 0x31:
+        iReturn = makeScreenshot_L31(pInfo);
+        break;
+      case 0x32:
+        iReturn = makeScreenshot_L32(pInfo);
+        break;
+      case 0x33:
+        iReturn = makeScreenshot_L33(pInfo);
+        break;
+
+      default:
+        iReturn = ENOTSUP; /* Error */
+    }
+  }
+
+  /* Complete images */
+  if ((EOK == iReturn) && bRows)
+  {
+    iReturn = saveImageTrailer();
+  }
+
+  g_tState.bmpfile.pScaledRow = 0;
+
+  selectOutput(0);
+
+  return iReturn;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* selectOutput()                                                             */
+/*----------------------------------------------------------------------------*/
+void selectOutput(uint8_t uiOutput)
+{
+  g_tState.uiOutput      = uiOutput;
+  g_tState.eFormat       = g_tState.atOutputs[uiOutput].eFormat;
+  g_tState.bmpfile.hFile = g_tState.atOutputs[uiOutput].hFile;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/*  saveImageHeader()                                                         */
+/*----------------------------------------------------------------------------*/
+int saveImageHeader(void)
+{
+  int iReturn = EOK;
+
+  (void) BENCH_PHASE(BENCH_HEADER);
+
+  /* Scaled image: size from the full size set by the decoder */
+  if (1 < g_tState.uiScale)
+  {
+    uint16_t uiLen;
+
+    g_tState.bmpfile.tInfoHdr.iWidth     /= g_tState.uiScale;
+    g_tState.bmpfile.tInfoHdr.iHeight    /= g_tState.uiScale;
+
+    uiLen = (uint16_t) ((((uint32_t) g_tState.bmpfile.tInfoHdr.iWidth) * g_tState.bmpfile.tInfoHdr.uiBitCount) >> 3);
+
+    g_tState.bmpfile.tInfoHdr.uiSizeImage = ((uint32_t) uiLen) * ((uint32_t) g_tState.bmpfile.tInfoHdr.iHeight);
+    g_tState.bmpfile.tFileHdr.uiSize      = g_tState.bmpfile.tFileHdr.uiOffBits + g_tState.bmpfile.tInfoHdr.uiSizeImage;
+
+    if (SCALED_ROW_MAX < uiLen)
+    {
+      return ENOMEM;
+    }
+
+    g_tState.bmpfile.pScaledRow = s_auiScaledRow;
+  }
+
+  for (uint8_t i = 0; (EOK == iReturn) && (i < g_tState.uiOutputs); ++i)
+  {
+    if (IS_ROW_FORMAT(g_tState.atOutputs[i].eFormat))
+    {
+      selectOutput(i);
+      iReturn = saveOutputHeader();
+    }
+  }
+
+  return iReturn;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* saveOutputHeader()                                                         */
+/*----------------------------------------------------------------------------*/
+static int saveOutputHeader(void)
+{
+  int iReturn = EOK;
+
+  if (IMAGE_SINK_OPEN())
+  {
+    switch (g_tState.eFormat)
+    {
+      case FORMAT_BMP:
+        /* Save BMP file header */
+        if (EOK == iReturn)
+        {
+          iReturn = writeImageData(&g_tState.bmpfile.tFileHdr, sizeof(g_tState.bmpfile.tFileHdr));
+        }
+
+        /* Save BMP info header (top-down: negative height) */
+        if (EOK == iReturn)
+        {
+          bmpinfoheader_t tInfoHdr = g_tState.bmpfile.tInfoHdr;
+
+          if (0 < g_tState.bmpfile.iRowStep)
+          {
+            tInfoHdr.iHeight = -tInfoHdr.iHeight;
+          }
+
+          iReturn = writeImageData(&tInfoHdr, sizeof(tInfoHdr));
+        }
+        break;
+
+      case FORMAT_GIF:
+        iReturn = saveGifHeader();
+        break;
+
+      case FORMAT_PNG:
+        iReturn = savePngHeader();
+        break;
+
+      case FORMAT_QOI:
+        iReturn = saveQoiHeader();
+        break;
+
+      default:
+        iReturn = ENOTSUP;
+    }
+  }
+  else
+  {
+    iReturn = EINVAL;
+  }
+
+  return iReturn;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* saveColourPalette()                                                        */
+/*----------------------------------------------------------------------------*/
+int saveColourPalette(const screenmode_t* pInfo)
+{
+  int iReturn = EINVAL;
+
+  (void) BENCH_PHASE(BENCH_PALETTE);
+
+  if ((0 != pInfo) && IMAGE_SINK_OPEN())
+  {
+    /* Write palette entries */
+    iReturn = saveColourTable(readColourPalette(pInfo));
+  }
+
+  return iReturn;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* readColourPalette()                                                        */
+/*----------------------------------------------------------------------------*/
+uint16_t readColourPalette(const screenmode_t* pInfo)
+{
+  uint16_t uiColors = 0;
+
+  if (0 != pInfo)
+  {
+    bmppaletteentry_t* pEntry = &g_tState.bmpfile.tPalette[0];
+    uint16_t uiValue;
+    uint8_t  uiPalIdx;
+    uint8_t  uiPalCtl;
+
+    uiColors = pInfo->uiColors;
+
+    /* Only LAYER 1,0: Detect number of colours */
+    if ((0x10 == pInfo->uiMode) && zxn_radastan_mode())
+    {
+      uiColors = 16;
+    }
+
+    /* Snapshot (option "-L"): palette was read before the first layer */
+    if (g_tState.snapshot.bValid)
+    {
+      const uint16_t* pValue = &g_tState.snapshot.auiPalette[g_tState.snapshot.uiLayer][0];
+
+      for (uint16_t i = 0; i < uiColors; ++i, ++pEntry, ++pValue)
+      {
+        pEntry->b = rgb3_to_rgb8( *pValue       & 0x07);
+        pEntry->g = rgb3_to_rgb8((*pValue >> 3) & 0x07);
+        pEntry->r = rgb3_to_rgb8((*pValue >> 6) & 0x07);
+        pEntry->a = 0x00;
+      }
+
+      return uiColors;
+    }
+
+    /* Status sichern, um nichts zu verstellen */
+    uiPalIdx = ZXN_READ_REG(REG_PALETTE_INDEX);
+    uiPalCtl = selectColourPalette(pInfo);
+
+    /* Read palette entries */
+    for (uint16_t i = 0; i < uiColors; ++i, ++pEntry)
+    {
+      /* Palettenindex auswaehlen */
+      ZXN_WRITE_REG(REG_PALETTE_INDEX, i);
+
+      /* Aktuellen Farbwert lesen:
+      0x41 liefert RRR GGG BB.
+      0x44 liefert ... ... ..B
+      */
+      uiValue  = ((uint16_t) ZXN_READ_REG(REG_PALETTE_VALUE_8 )) << 1;
+      uiValue |= ((uint16_t) ZXN_READ_REG(REG_PALETTE_VALUE_16)) & 0x01;
+
+      pEntry->b = rgb3_to_rgb8( uiValue       & 0x07);
+      pEntry->g = rgb3_to_rgb8((uiValue >> 3) & 0x07);
+      pEntry->r = rgb3_to_rgb8((uiValue >> 6) & 0x07);
+      pEntry->a = 0x00;
+    }
+
+    /* Registerzustand wiederherstellen */
+    ZXN_WRITE_REG(REG_PALETTE_INDEX,   uiPalIdx);
+    ZXN_WRITE_REG(REG_PALETTE_CONTROL, uiPalCtl);
+
+    STATS_PALETTE(3 * uiColors + 3);
+  }
+
+  return uiColors;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* writeColourPalette()                                                       */
+/*----------------------------------------------------------------------------*/
+int writeColourPalette(const screenmode_t* pInfo, uint16_t uiColors)
+{
+  int iReturn = EINVAL;
+
+  if (0 != pInfo)
+  {
+    const bmppaletteentry_t* pEntry = &g_tState.bmpfile.tPalette[0];
+    uint16_t uiValue;
+    uint8_t  uiPalIdx;
+    uint8_t  uiPalCtl;
 
-      default:
-        iReturn = ENOTSUP; /* Error */
+    uiPalIdx = ZXN_READ_REG(REG_PALETTE_INDEX);
+    uiPalCtl = selectColourPalette(pInfo);
+
+    /* Write palette entries (0x44: RRRGGGBB, then .......B; auto increment) */
+    ZXN_WRITE_REG(REG_PALETTE_INDEX, 0);
+
+    for (uint16_t i = 0; i < uiColors; ++i, ++pEntry)
+    {
+      uiValue = rgb8_to_rgb9(pEntry);
+
+      ZXN_WRITE_REG(REG_PALETTE_VALUE_16, (uint8_t) (uiValue >> 1));
+      ZXN_WRITE_REG(REG_PALETTE_VALUE_16, (uint8_t) (uiValue & 0x01));
     }
+
+    ZXN_WRITE_REG(REG_PALETTE_INDEX,   uiPalIdx);
+    ZXN_WRITE_REG(REG_PALETTE_CONTROL, uiPalCtl);
+
+    STATS_PALETTE(2 * uiColors + 4);
+
+    iReturn = EOK;
   }
 
-  /* Close file */
-  if (INV_FILE_HND != g_tState.bmpfile.hFile)
+  return iReturn;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* selectColourPalette()                                                      */
+/*----------------------------------------------------------------------------*/
+uint8_t selectColourPalette(const screenmode_t* pInfo)
+{
+  uint8_t uiPalCtl = ZXN_READ_REG(REG_PALETTE_CONTROL);
+  uint8_t uiPalAct;
+  uint8_t uiValue;
+
+  /* Detect active palette */
+  switch ((pInfo->uiMode >> 4) & 0x0F)
   {
-    (void) esx_f_close(g_tState.bmpfile.hFile);
-    g_tState.bmpfile.hFile = INV_FILE_HND;
+    case 0:
+    case 1: /* 1.Pal 000, 2.Pal 100 */
+      uiPalAct = (uiPalCtl >> 1) & 0x01;
+      uiValue  = (uiPalCtl & 0x8F) | ((uiPalAct ? 0x04 : 0x00) << 4);
+      break;
+
+    case 2: /* 1. 001, 2. 101 */
+      uiPalAct = (uiPalCtl >> 2) & 0x01;
+      uiValue  = (uiPalCtl & 0x8F) | ((uiPalAct ? 0x05 : 0x01) << 4);
+      break;
+
+    case 3: /* 1. 011, 2. 111 (active: NREG 0x6B bit 4) */
+      uiPalAct = (ZXN_READ_REG(0x6B) >> 4) & 0x01;
+      uiValue  = (uiPalCtl & 0x8F) | ((uiPalAct ? 0x07 : 0x03) << 4);
+      break;
+
+    default:
+      uiValue  = uiPalCtl;
   }
 
-  if (EOK != iReturn)
+  /* Select active palette */
+  ZXN_WRITE_REG(REG_PALETTE_CONTROL, uiValue);
+
+  STATS_PALETTE(2);
+
+  return uiPalCtl;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* saveColourTable()                                                          */
+/*----------------------------------------------------------------------------*/
+int saveColourTable(uint16_t uiColors)
+{
+  int iReturn = EOK;
+
+  (void) BENCH_PHASE(BENCH_PALETTE);
+
+  for (uint8_t i = 0; (EOK == iReturn) && (i < g_tState.uiOutputs); ++i)
   {
-    /* Remove file */
-    (void) esx_f_unlink(g_tState.bmpfile.acPathName);
+    if (IS_ROW_FORMAT(g_tState.atOutputs[i].eFormat))
+    {
+      selectOutput(i);
+      iReturn = saveOutputColourTable(uiColors);
+    }
   }
 
+  /* The rows of the decoder follow */
+  (void) BENCH_PHASE(BENCH_PIXELS);
+
   return iReturn;
 }
 
 
 /*----------------------------------------------------------------------------*/
-/*  saveImageHeader()                                                         */
+/* saveOutputColourTable()                                                    */
 /*----------------------------------------------------------------------------*/
-int saveImageHeader(void)
+static int saveOutputColourTable(uint16_t uiColors)
 {
-  int iReturn = EOK;
+  int iReturn = EINVAL;
 
-  if (INV_FILE_HND != g_tState.bmpfile.hFile)
+  if (IMAGE_SINK_OPEN())
   {
-    /* Save BMP file header */
-    if (EOK == iReturn)
+    switch (g_tState.eFormat)
     {
-      if (sizeof(g_tState.bmpfile.tFileHdr) != esx_f_write(g_tState.bmpfile.hFile, &g_tState.bmpfile.tFileHdr, sizeof(g_tState.bmpfile.tFileHdr)))
-      {
-        iReturn = EBADF;
-      }
+      case FORMAT_BMP:
+        iReturn = writeImageData(g_tState.bmpfile.tPalette, uiColors * sizeof(bmppaletteentry_t));
+        break;
+
+      case FORMAT_GIF:
+        iReturn = saveGifPalette(g_tState.bmpfile.tPalette, uiColors);
+        break;
+
+      case FORMAT_PNG:
+        iReturn = savePngPalette(g_tState.bmpfile.tPalette, uiColors);
+        break;
+
+      case FORMAT_QOI:
+        iReturn = saveQoiPalette(g_tState.bmpfile.tPalette, uiColors);
+        break;
+
+      default:
+        iReturn = ENOTSUP;
     }
+  }
+
+  return iReturn;
+}
 
-    /* Save BMP info header */
-    if (EOK == iReturn)
+
+/*----------------------------------------------------------------------------*/
+/* saveImageRow()                                                             */
+/*----------------------------------------------------------------------------*/
+int saveImageRow(const uint8_t* pRow, uint16_t uiLen)
+{
+  if (0 != g_tState.bmpfile.pScaledRow)
+  {
+    pRow = scaleImageRow(pRow, &uiLen);
+  }
+
+  return saveScaledRow(pRow, uiLen);
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* saveScaledRow()                                                            */
+/*----------------------------------------------------------------------------*/
+int saveScaledRow(const uint8_t* pRow, uint16_t uiLen)
+{
+  int iReturn = EOK;
+
+  for (uint8_t i = 0; (EOK == iReturn) && (i < g_tState.uiOutputs); ++i)
+  {
+    if (IS_ROW_FORMAT(g_tState.atOutputs[i].eFormat))
     {
-      if (sizeof(g_tState.bmpfile.tInfoHdr) != esx_f_write(g_tState.bmpfile.hFile, &g_tState.bmpfile.tInfoHdr, sizeof(g_tState.bmpfile.tInfoHdr)))
-      {
-        iReturn = EBADF;
-      }
+      selectOutput(i);
+      iReturn = saveOutputRow(pRow, uiLen);
     }
   }
-  else
+
+  return iReturn;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* saveOutputRow()                                                            */
+/*----------------------------------------------------------------------------*/
+static int saveOutputRow(const uint8_t* pRow, uint16_t uiLen)
+{
+  int iReturn;
+
+  switch (g_tState.eFormat)
   {
-    iReturn = EINVAL;
+    case FORMAT_BMP:
+      iReturn = writeImageData(pRow, uiLen);
+      break;
+
+    case FORMAT_GIF:
+      iReturn = saveGifRow(pRow, uiLen);
+      break;
+
+    case FORMAT_PNG:
+      iReturn = savePngRow(pRow, uiLen);
+      break;
+
+    case FORMAT_QOI:
+      iReturn = saveQoiRow(pRow, uiLen);
+      break;
+
+    default:
+      iReturn = ENOTSUP;
   }
 
   return iReturn;
@@ -630,88 +1933,188 @@ int saveImageHeader(void)
 
 
 /*----------------------------------------------------------------------------*/
-/* saveColourPalette()                                                        */
+/* scaleImageRow()                                                            */
 /*----------------------------------------------------------------------------*/
-int saveColourPalette(const screenmode_t* pInfo)
+static const uint8_t* scaleImageRow(const uint8_t* pRow, uint16_t* pLen)
 {
-  int iReturn = EINVAL;
+  uint8_t* pDst     = g_tState.bmpfile.pScaledRow;
+  uint16_t uiPixels = (uint16_t) g_tState.bmpfile.tInfoHdr.iWidth;  /* scaled */
+  uint8_t  uiBits   = (uint8_t) g_tState.bmpfile.tInfoHdr.uiBitCount;
+  uint8_t  uiScale  = g_tState.uiScale;
 
-  if ((0 != pInfo) && (INV_FILE_HND != g_tState.bmpfile.hFile))
-  {
-    bmppaletteentry_t tEntry = {.a = 0x00};
-    uint16_t uiValue;
-    uint8_t  uiPalIdx;
-    uint8_t  uiPalCtl;
-    uint8_t  uiPalAct;
-    uint16_t uiColors = pInfo->uiColors;
+  *pLen = (uint16_t) ((((uint32_t) uiPixels) * uiBits) >> 3);
 
-    /* Only LAYER 1,0: Detect number of colours */
-    if ((0x10 == pInfo->uiMode) && zxn_radastan_mode())
+  if (8 == uiBits)
+  {
+    /* One byte per pixel: only every n-th byte is read */
+    for (uint16_t i = 0; i < uiPixels; ++i, pRow += uiScale)
     {
-      uiColors = 16;
+      pDst[i] = *pRow;
     }
+  }
+  else
+  {
+    /* 4 or 1 bit per pixel: pixel "i" is at "i >> uiShift", bits from the left */
+    uint8_t  uiShift = (4 == uiBits ? 1 : 3);
+    uint8_t  uiLast  = (1 << uiShift) - 1;
+    uint8_t  uiMask  = (1 << uiBits) - 1;
+    uint16_t uiSrc   = 0;
+    uint8_t  uiValue;
 
-    /* Status sichern, um nichts zu verstellen */
-    uiPalIdx = ZXN_READ_REG(REG_PALETTE_INDEX  );
-    uiPalCtl = ZXN_READ_REG(REG_PALETTE_CONTROL);
+    memset(pDst, 0, *pLen);
 
-    /* Detect active palette */
-    switch ((pInfo->uiMode >> 4) & 0x0F)
+    for (uint16_t i = 0; i < uiPixels; ++i, uiSrc += uiScale)
     {
-      case 0:
-      case 1: /* 1.Pal 000, 2.Pal 100 */
-        uiPalAct = (uiPalCtl >> 1) & 0x01;
-        uiValue  = (uiPalCtl & 0x8F) | ((uiPalAct ? 0x04 : 0x00) << 4);
-        break;
+      uiValue = (pRow[uiSrc >> uiShift] >> ((uiLast - (uiSrc & uiLast)) * uiBits)) & uiMask;
+      pDst[i >> uiShift] |= uiValue << ((uiLast - (i & uiLast)) * uiBits);
+    }
+  }
 
-      case 2: /* 1. 001, 2. 101 */
-        uiPalAct = (uiPalCtl >> 2) & 0x01;
-        uiValue  = (uiPalCtl & 0x8F) | ((uiPalAct ? 0x05 : 0x01) << 4);
-        break;
+  return g_tState.bmpfile.pScaledRow;
+}
 
-      default:
-        uiValue  = uiPalCtl;
-    }
 
-    /* Select active palette */
-    ZXN_WRITE_REG(REG_PALETTE_CONTROL, uiValue);
+/*----------------------------------------------------------------------------*/
+/* saveImageTrailer()                                                         */
+/*----------------------------------------------------------------------------*/
+int saveImageTrailer(void)
+{
+  int iReturn = EOK;
+
+  (void) BENCH_PHASE(BENCH_TRAILER);
 
-    /* Write palette entries */
-    for (uint16_t i = 0; i < uiColors; ++i)
+  for (uint8_t i = 0; (EOK == iReturn) && (i < g_tState.uiOutputs); ++i)
+  {
+    if (IS_ROW_FORMAT(g_tState.atOutputs[i].eFormat))
     {
-      /* Palettenindex auswaehlen */
-      ZXN_WRITE_REG(REG_PALETTE_INDEX, i);
+      selectOutput(i);
+      iReturn = saveOutputTrailer();
+    }
+  }
 
-      /* Aktuellen Farbwert lesen:
-      0x41 liefert RRR GGG BB.
-      0x44 liefert ... ... ..B
-      */
-      uiValue  = ((uint16_t) ZXN_READ_REG(REG_PALETTE_VALUE_8 )) << 1;
-      uiValue |= ((uint16_t) ZXN_READ_REG(REG_PALETTE_VALUE_16)) & 0x01;
+  (void) BENCH_PHASE(BENCH_OTHER);
+
+  return iReturn;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* saveOutputTrailer()                                                        */
+/*----------------------------------------------------------------------------*/
+static int saveOutputTrailer(void)
+{
+  int iReturn;
+
+  switch (g_tState.eFormat)
+  {
+    case FORMAT_BMP:
+      iReturn = EOK; /* nothing to do */
+      break;
+
+    case FORMAT_GIF:
+      iReturn = saveGifTrailer();
+      break;
+
+    case FORMAT_PNG:
+      iReturn = savePngTrailer();
+      break;
+
+    case FORMAT_QOI:
+      iReturn = saveQoiTrailer();
+      break;
+
+    case FORMAT_NATIVE:
+    case FORMAT_ZX0:
+      iReturn = EOK; /* nothing to do */
+      break;
 
-      tEntry.b = rgb3_to_rgb8( uiValue       & 0x07);
-      tEntry.g = rgb3_to_rgb8((uiValue >> 3) & 0x07);
-      tEntry.r = rgb3_to_rgb8((uiValue >> 6) & 0x07);
+    default:
+      iReturn = ENOTSUP;
+  }
+
+  return iReturn;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* writeImageData()                                                           */
+/*----------------------------------------------------------------------------*/
+int writeImageData(const void* pData, uint16_t uiLen)
+{
+  int iReturn = EOK;
+  benchphase_t ePhase = BENCH_PHASE(BENCH_WRITE);
+
+  g_tState.stats.uiBytes += uiLen;
+
+  switch (g_tState.bmpfile.eSink)
+  {
+    case SINK_BANKS:
+      iReturn = writeCaptureData(pData, uiLen);
+      break;
+
+    case SINK_UART:
+      iReturn = writeUartData(pData, uiLen);
+      break;
 
-      if (sizeof(tEntry) != esx_f_write(g_tState.bmpfile.hFile, &tEntry, sizeof(tEntry)))
+    case SINK_NULL:
+      break; /* discarded: benchmark without SD card */
+
+    default:
+      STATS_WRITE(1);
+
+      if (uiLen != esx_f_write(g_tState.bmpfile.hFile, pData, uiLen))
       {
-        ZXN_WRITE_REG(REG_PALETTE_INDEX,   uiPalIdx);
-        ZXN_WRITE_REG(REG_PALETTE_CONTROL, uiPalCtl);
         iReturn = EBADF;
-        goto EXIT_PALETTE_LOOP;
       }
-    }
+  }
 
-    /* Registerzustand wiederherstellen */
-    ZXN_WRITE_REG(REG_PALETTE_INDEX,   uiPalIdx);
-    ZXN_WRITE_REG(REG_PALETTE_CONTROL, uiPalCtl);
+  (void) BENCH_PHASE(ePhase);
 
-    iReturn = EOK;
+  return iReturn;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* allocBank()                                                                */
+/*----------------------------------------------------------------------------*/
+uint8_t allocBank(void)
+{
+  for (uint8_t i = 0; i < BANKS_MAX; ++i)
+  {
+    if (INV_BANK == g_tState.auiBanks[i])
+    {
+      uint8_t uiBank = esx_ide_bank_alloc(0); /* 0 = RAM */
+
+      if (INV_BANK != uiBank)
+      {
+        g_tState.auiBanks[i] = uiBank;
+      }
+
+      return uiBank;
+    }
   }
 
-EXIT_PALETTE_LOOP:  
+  return INV_BANK;
+}
 
-  return iReturn;
+
+/*----------------------------------------------------------------------------*/
+/* freeBank()                                                                 */
+/*----------------------------------------------------------------------------*/
+void freeBank(uint8_t uiBank)
+{
+  if (INV_BANK != uiBank)
+  {
+    for (uint8_t i = 0; i < BANKS_MAX; ++i)
+    {
+      if (uiBank == g_tState.auiBanks[i])
+      {
+        (void) esx_ide_bank_free(0, uiBank); /* 0 = RAM */
+        g_tState.auiBanks[i] = INV_BANK;
+        break;
+      }
+    }
+  }
 }
 
 
@@ -721,6 +2124,12 @@ EXIT_PALETTE_LOOP:
 uint8_t detectScreenMode(void)
 {
   struct esx_mode tMode;
+
+  if (g_tState.snapshot.bValid)
+  {
+    return g_tState.snapshot.auiModes[g_tState.snapshot.uiLayer];
+  }
+
   memset(&tMode, 0, sizeof(tMode));
 
   if (0 == esx_ide_mode_get(&tMode))
@@ -753,6 +2162,82 @@ const screenmode_t* getScreenModeInfo(uint8_t uiMode)
 }
 
 
+/*----------------------------------------------------------------------------*/
+/* getLayer2Page()                                                            */
+/*----------------------------------------------------------------------------*/
+uint8_t getLayer2Page(void)
+{
+  if (g_tState.snapshot.bValid)
+  {
+    return g_tState.snapshot.uiLayer2Page;
+  }
+
+  /* NREG 0x12 (active) or 0x13 (shadow): 16K bank => 8K page */
+  return ZXN_READ_REG(g_tState.uiLayer2Reg) << 1;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* getImageRect()                                                             */
+/*----------------------------------------------------------------------------*/
+int getImageRect(const screenmode_t* pInfo, uint8_t uiBitCount, imagerect_t* pRect)
+{
+  uint16_t uiAlign = (32 / uiBitCount) * g_tState.uiScale - 1;  /* pixels per 32 bit (scaled) - 1 */
+  uint16_t uiStep  = g_tState.uiScale - 1;                      /* rows per scaled row - 1      */
+  uint16_t uiEnd;
+
+  pRect->uiX = 0;
+  pRect->uiY = 0;
+  pRect->uiW = pInfo->uiResX;
+  pRect->uiH = pInfo->uiResY;
+
+  if (0 != g_tState.tRect.uiW)
+  {
+    if ((pInfo->uiResX <= g_tState.tRect.uiX) || (pInfo->uiResY <= g_tState.tRect.uiY))
+    {
+      return ERANGE;
+    }
+
+    /* Columns: whole 32 bit of the output row, clipped to the screen */
+    uiEnd = ((pInfo->uiResX - g_tState.tRect.uiX) > g_tState.tRect.uiW ? g_tState.tRect.uiX + g_tState.tRect.uiW : pInfo->uiResX);
+    uiEnd = (uiEnd + uiAlign) & ~uiAlign;
+
+    pRect->uiX = g_tState.tRect.uiX & ~uiAlign;
+    pRect->uiW = (pInfo->uiResX < uiEnd ? pInfo->uiResX : uiEnd) - pRect->uiX;
+
+    /* Rows: whole rows of the scaled image, clipped to the screen */
+    uiEnd = ((pInfo->uiResY - g_tState.tRect.uiY) > g_tState.tRect.uiH ? g_tState.tRect.uiY + g_tState.tRect.uiH : pInfo->uiResY);
+    uiEnd = (uiEnd + uiStep) & ~uiStep;
+
+    pRect->uiY = g_tState.tRect.uiY & ~uiStep;
+    pRect->uiH = (pInfo->uiResY < uiEnd ? pInfo->uiResY : uiEnd) - pRect->uiY;
+  }
+
+  return EOK;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* getFileFormatInfo()                                                        */
+/*----------------------------------------------------------------------------*/
+const fileformat_t* getFileFormatInfo(const char_t* acExt)
+{
+  const fileformat_t* pReturn = &g_tFileFormats[0];
+
+  while (FORMAT_NONE != pReturn->eFormat)
+  {
+    if (0 == stricmp(acExt, pReturn->acExt))
+    {
+      return pReturn;
+    }
+
+    ++pReturn;
+  }
+
+  return 0;
+}
+
+
 /*----------------------------------------------------------------------------*/
 /*                                                                            */
 /*----------------------------------------------------------------------------*/
@@ -0,0 +1,259 @@
+/*-----------------------------------------------------------------------------+
+|                                                                              |
+| filename: native.c                                                           |
+| project:  zxn::scrnshot                                                      |
+| author:   S. Zell                                                            |
+| date:     10/18/2026                                                         |
+|                                                                              |
++------------------------------------------------------------------------------+
+|                                                                              |
+| description:                                                                 |
+|                                                                              |
+| Native screen files (SCR, SHC, SHR, SLR, SL2, NXI)                           |
+|                                                                              |
++------------------------------------------------------------------------------+
+|                                                                              |
+| Copyright (c) 10/18/2026 STZ Engineering                                     |
+|                                                                              |
+| This software is provided  "as is",  without warranty of any kind, express   |
+| or implied. In no event shall STZ or its contributors be held liable for any |
+| direct, indirect, incidental, special or consequential damages arising out   |
+| of the use of or inability to use this software.                             |
+|                                                                              |
+| Permission is granted to anyone  to use this  software for any purpose,      |
+| including commercial applications,  and to alter it and redistribute it      |
+| freely, subject to the following restrictions:                               |
+|                                                                              |
+| 1. Redistributions of source code must retain the above copyright            |
+|    notice, definition, disclaimer, and this list of conditions.              |
+|                                                                              |
+| 2. Redistributions in binary form must reproduce the above copyright         |
+|    notice, definition, disclaimer, and this list of conditions in            |
+|    documentation and/or other materials provided with the distribution.      |
+|                                                                          ;-) |
++-----------------------------------------------------------------------------*/
+
+/*============================================================================*/
+/*                               Includes                                     */
+/*============================================================================*/
+#include <stdint.h>
+#include <errno.h>
+#include <string.h>
+#include <z80.h>
+#include <intrinsic.h>
+#include <arch/zxn.h>
+#include <arch/zxn/esxdos.h>
+
+#include "libzxn.h"
+#include "scrnshot.h"
+#include "native.h"
+#include "bench.h"
+
+/*============================================================================*/
+/*                               Defines                                      */
+/*============================================================================*/
+
+/*============================================================================*/
+/*                               Namespaces                                   */
+/*============================================================================*/
+
+/*============================================================================*/
+/*                               Constants                                    */
+/*============================================================================*/
+
+/*============================================================================*/
+/*                               Variables                                    */
+/*============================================================================*/
+/*!
+In dieser Struktur werden alle globalen Daten der Anwendung gespeichert.
+*/
+extern appstate_t g_tState;
+
+/*============================================================================*/
+/*                               Structures                                   */
+/*============================================================================*/
+
+/*============================================================================*/
+/*                               Type-Definitions                             */
+/*============================================================================*/
+
+/*============================================================================*/
+/*                               Prototypes                                   */
+/*============================================================================*/
+/*!
+Saves the palette of layer 2 in NXI format (2 bytes per colour: RRRGGGBB,
+0000000B; always 256 colours, LAYER 2,3 is padded with black)
+*/
+static int saveNativePalette(const screenmode_t* pInfo);
+
+/*!
+Saves the 8K pages of layer 2 to the output file
+*/
+static int saveNativeLayer2(const screenmode_t* pInfo);
+
+/*============================================================================*/
+/*                               Classes                                      */
+/*============================================================================*/
+
+/*============================================================================*/
+/*                               Implementation                               */
+/*============================================================================*/
+
+/*----------------------------------------------------------------------------*/
+/* getNativeFileExt()                                                         */
+/*----------------------------------------------------------------------------*/
+const char_t* getNativeFileExt(uint8_t uiMode, const char_t* acType)
+{
+  switch (uiMode)
+  {
+    case 0x00:
+    case 0x11:
+      return "scr";
+
+    case 0x10:
+      return "slr";
+
+    case 0x12:
+      return "shr";
+
+    case 0x13:
+      return "shc";
+
+    case 0x20:
+    case 0x22:
+    case 0x23:
+      return ((0 != acType) && (0 == stricmp(acType, "sl2")) ? "sl2" : "nxi");
+
+    default:
+      return 0;
+  }
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* saveNativeImage()                                                          */
+/*----------------------------------------------------------------------------*/
+int saveNativeImage(const screenmode_t* pInfo)
+{
+  int iReturn = EOK;
+
+  if (0 != pInfo)
+  {
+    switch (pInfo->uiMode)
+    {
+      /* SCR: pixels, attributes; SLR: top half, bottom half; SHC: pixels,
+         attributes (8x1); SHR: even columns, odd columns, colour byte */
+      case 0x00:
+      case 0x10:
+      case 0x11:
+      case 0x12:
+      case 0x13:
+        iReturn = writeImageData(zxn_memmap(pInfo->tMemPixel.uiAddr), pInfo->tMemPixel.uiSize);
+
+        if (EOK == iReturn)
+        {
+          iReturn = writeImageData(zxn_memmap(pInfo->tMemAttr.uiAddr), pInfo->tMemAttr.uiSize);
+        }
+
+        if ((EOK == iReturn) && (0x12 == pInfo->uiMode))
+        {
+          /* Timex port 0xFF: hi-res mode (bits 2..0) and colour (bits 5..3) */
+          uint8_t uiPort = (z80_inp(0xFF) & 0x38) | 0x06;
+          iReturn = writeImageData(&uiPort, sizeof(uiPort));
+        }
+        break;
+
+      /* SL2: pixels; NXI: palette, pixels */
+      case 0x20:
+      case 0x22:
+      case 0x23:
+      {
+        const char_t* acExt = getNativeFileExt(pInfo->uiMode, g_tState.atOutputs[g_tState.uiOutput].acNativeExt);
+
+        if (0 == strcmp(acExt, "nxi"))
+        {
+          iReturn = saveNativePalette(pInfo);
+        }
+
+        if (EOK == iReturn)
+        {
+          iReturn = saveNativeLayer2(pInfo);
+        }
+        break;
+      }
+
+      default:
+        iReturn = ENOTSUP;
+    }
+  }
+  else
+  {
+    iReturn = EINVAL;
+  }
+
+  return iReturn;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* saveNativePalette()                                                        */
+/*----------------------------------------------------------------------------*/
+static int saveNativePalette(const screenmode_t* pInfo)
+{
+  int iReturn = EOK;
+  uint16_t uiColors = readColourPalette(pInfo);
+  const bmppaletteentry_t* pEntry = &g_tState.bmpfile.tPalette[0];
+  uint8_t auiBuffer[64];
+  uint8_t uiLen = 0;
+
+  /* NXI readers expect 512 bytes: the 16 colours of LAYER 2,3 are padded */
+  for (uint16_t i = 0; (EOK == iReturn) && (i < 256); ++i, ++pEntry)
+  {
+    uint16_t uiValue = (i < uiColors ? rgb8_to_rgb9(pEntry) : 0);
+
+    auiBuffer[uiLen++] = (uint8_t) (uiValue >> 1);
+    auiBuffer[uiLen++] = (uint8_t) (uiValue & 0x01);
+
+    if (sizeof(auiBuffer) == uiLen)
+    {
+      iReturn = writeImageData(auiBuffer, uiLen);
+      uiLen = 0;
+    }
+  }
+
+  return iReturn;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* saveNativeLayer2()                                                         */
+/*----------------------------------------------------------------------------*/
+static int saveNativeLayer2(const screenmode_t* pInfo)
+{
+  int iReturn = EOK;
+  uint8_t  uiMMU2 = 0xFF;
+  uint8_t  uiPhysBank = getLayer2Page(); /* 0x12 L2.ACTIVE.RAM.BANK or snapshot | 8K bank */
+  uint8_t  uiPages;
+
+  /* 256x192x8 = 6 pages; 320x256x8 and 640x256x4 = 10 pages */
+  uiPages = (uint8_t) ((((uint32_t) pInfo->uiResX) * ((uint32_t) pInfo->uiResY) * (16 == pInfo->uiColors ? 4 : 8)) >> 16);
+
+  STATS_DI();
+  uiMMU2 = ZXN_READ_MMU2();
+
+  for (uint8_t i = 0; (EOK == iReturn) && (i < uiPages); ++i)
+  {
+    STATS_MMU2(uiPhysBank + i);
+    iReturn = writeImageData(zxn_memmap(pInfo->tMemPixel.uiAddr), pInfo->tMemPixel.uiSize);
+  }
+
+  STATS_MMU2(uiMMU2);
+  STATS_EI();
+
+  return iReturn;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/*                                                                            */
+/*----------------------------------------------------------------------------*/
@@ -0,0 +1,1192 @@
+/*-----------------------------------------------------------------------------+
+|                                                                              |
+| filename: png.c                                                              |
+| project:  zxn::scrnshot                                                      |
+| author:   S. Zell                                                            |
+| date:     10/18/2026                                                         |
+|                                                                              |
++------------------------------------------------------------------------------+
+|                                                                              |
+| description:                                                                 |
+|                                                                              |
+| PNG encoder (indexed colour, deflate compression)                            |
+|                                                                              |
++------------------------------------------------------------------------------+
+|                                                                              |
+| Copyright (c) 10/18/2026 STZ Engineering                                     |
+|                                                                              |
+| This software is provided  "as is",  without warranty of any kind, express   |
+| or implied. In no event shall STZ or its contributors be held liable for any |
+| direct, indirect, incidental, special or consequential damages arising out   |
+| of the use of or inability to use this software.                             |
+|                                                                              |
+| Permission is granted to anyone  to use this  software for any purpose,      |
+| including commercial applications,  and to alter it and redistribute it      |
+| freely, subject to the following restrictions:                               |
+|                                                                              |
+| 1. Redistributions of source code must retain the above copyright            |
+|    notice, definition, disclaimer, and this list of conditions.              |
+|                                                                              |
+| 2. Redistributions in binary form must reproduce the above copyright         |
+|    notice, definition, disclaimer, and this list of conditions in            |
+|    documentation and/or other materials provided with the distribution.      |
+|                                                                          ;-) |
++-----------------------------------------------------------------------------*/
+
+/*============================================================================*/
+/*                               Includes                                     */
+/*============================================================================*/
+#include <stdint.h>
+#include <errno.h>
+#include <string.h>
+#include <arch/zxn.h>
+#include <arch/zxn/esxdos.h>
+
+#include "libzxn.h"
+#include "scrnshot.h"
+#include "png.h"
+#include "bench.h"
+
+/*============================================================================*/
+/*                               Defines                                      */
+/*============================================================================*/
+/*!
+Size of the sliding window (ring buffer; zlib window size 2K)
+*/
+#define PNG_WINDOW_SIZE 2048
+#define PNG_WINDOW_MASK (PNG_WINDOW_SIZE - 1)
+
+/*!
+Number of entries of the hash table (heads of the hash chains)
+*/
+#define PNG_HASH_SIZE 1024
+#define PNG_HASH_MASK (PNG_HASH_SIZE - 1)
+
+/*!
+Minimum and maximum length of a match
+*/
+#define PNG_MIN_MATCH 3
+#define PNG_MAX_MATCH 258
+
+/*!
+Number of candidates checked per position (level "small")
+*/
+#define PNG_CHAIN_DEPTH 16
+
+/*!
+Maximum size of the payload of an IDAT chunk
+*/
+#define PNG_CHUNK_SIZE 512
+
+/*!
+Number of symbols of the first block (fixed codes) and of all further blocks
+(dynamic codes built from the statistics of the previous block)
+*/
+#define PNG_BLOCK_FIRST 1024
+#define PNG_BLOCK_SIZE  4096
+
+/*!
+Sizes of the deflate alphabets: literal/length, distance and code lengths
+*/
+#define PNG_LIT_CODES  286
+#define PNG_DIST_CODES 30
+#define PNG_CL_CODES   19
+
+/*============================================================================*/
+/*                               Namespaces                                   */
+/*============================================================================*/
+
+/*============================================================================*/
+/*                               Constants                                    */
+/*============================================================================*/
+/*!
+Signature of a PNG file
+*/
+static const uint8_t s_auiPngSignature[8] = {0x89, 'P', 'N', 'G', 0x0D, 0x0A, 0x1A, 0x0A};
+
+/*!
+Base values and extra bits of the length codes 257..285
+*/
+static const uint16_t s_auiLenBase[29] =
+{
+  3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+  35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258
+};
+static const uint8_t s_auiLenExtra[29] =
+{
+  0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+  3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0
+};
+
+/*!
+Base values and extra bits of the distance codes 0..29
+*/
+static const uint16_t s_auiDistBase[PNG_DIST_CODES] =
+{
+  1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+  257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577
+};
+static const uint8_t s_auiDistExtra[PNG_DIST_CODES] =
+{
+  0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+  7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13
+};
+
+/*!
+Transmission order of the code length code lengths
+*/
+static const uint8_t s_auiClOrder[PNG_CL_CODES] =
+{
+  16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15
+};
+
+/*============================================================================*/
+/*                               Structures                                   */
+/*============================================================================*/
+/*!
+Layout of the 8K page of the sliding window (mapped while compressing)
+*/
+typedef struct _pngwindow
+{
+  uint8_t  auiData[PNG_WINDOW_SIZE];  /* ring buffer of the input        */
+  uint16_t auiHead[PNG_HASH_SIZE];    /* latest position per hash value  */
+  uint16_t auiPrev[PNG_WINDOW_SIZE];  /* previous position, same hash    */
+} pngwindow_t;
+
+/*!
+Layout of the 8K page of the tables (mapped to compute CRCs and codes)
+*/
+typedef struct _pngtables
+{
+  uint32_t auiCrc[256];                              /* CRC32 lookup table */
+  uint16_t auiWeight[2 * PNG_LIT_CODES];             /* Huffman tree ...   */
+  uint16_t auiParent[2 * PNG_LIT_CODES];
+  uint16_t auiHeap[PNG_LIT_CODES];
+  uint8_t  auiDepth[2 * PNG_LIT_CODES];
+  uint8_t  auiRleSym[PNG_LIT_CODES + PNG_DIST_CODES]; /* code lengths (RLE) */
+  uint8_t  auiRleExt[PNG_LIT_CODES + PNG_DIST_CODES];
+} pngtables_t;
+
+/*!
+State of the PNG encoder
+*/
+typedef struct _pngstate
+{
+  int      iError;                          /* first write error           */
+  uint8_t  uiBankW;                         /* 8K page of the window       */
+  uint8_t  uiBankT;                         /* 8K page of the tables       */
+  uint8_t  uiLevel;                         /* compression level           */
+  uint16_t uiPos;                           /* next position to compress   */
+  uint16_t uiEnd;                           /* end of the input            */
+  uint16_t uiDone;                          /* compressed bytes (limited)  */
+  uint16_t uiSymbols;                       /* symbols of the current block*/
+  uint16_t uiBlockSize;                     /* symbols per block           */
+  bool     bFixedOnly;                      /* fixed codes, no new blocks  */
+  uint32_t uiAdlerA;                        /* Adler-32                    */
+  uint32_t uiAdlerB;
+  uint32_t uiCrc;                           /* CRC of the current chunk    */
+  uint32_t uiBitBuf;                        /* bit accumulator (LSB first) */
+  uint8_t  uiBitCnt;
+  uint16_t uiChunkLen;                      /* payload of the IDAT chunk   */
+  uint8_t  auiChunk[8 + PNG_CHUNK_SIZE + 4];
+  uint16_t auiLitCode[288];                 /* codes (bit reversed)        */
+  uint8_t  auiLitLen[288];
+  uint16_t auiDistCode[PNG_DIST_CODES];
+  uint8_t  auiDistLen[PNG_DIST_CODES];
+  uint16_t auiLitFreq[PNG_LIT_CODES];       /* statistics of the block     */
+  uint16_t auiDistFreq[PNG_DIST_CODES];
+} pngstate_t;
+
+/*============================================================================*/
+/*                               Variables                                    */
+/*============================================================================*/
+/*!
+In dieser Struktur werden alle globalen Daten der Anwendung gespeichert.
+*/
+extern appstate_t g_tState;
+
+/*!
+State of the PNG encoder
+*/
+static pngstate_t s_tPng;
+
+/*============================================================================*/
+/*                               Type-Definitions                             */
+/*============================================================================*/
+
+/*============================================================================*/
+/*                               Prototypes                                   */
+/*============================================================================*/
+/*!
+Updates a CRC32 with the given data (maps the page of the tables)
+*/
+static uint32_t updatePngCrc(uint32_t uiCrc, const uint8_t* pData, uint16_t uiLen);
+
+/*!
+Saves a complete chunk (length, type, data, CRC) to the output file
+*/
+static int savePngChunk(const char_t* acType, const uint8_t* pData, uint16_t uiLen);
+
+/*!
+Saves the buffered IDAT chunk to the output file
+*/
+static void flushPngChunk(void);
+
+/*!
+Appends one byte to the IDAT chunk
+*/
+static void putPngByte(uint8_t uiByte);
+
+/*!
+Appends up to 16 bits (LSB first) to the deflate stream
+*/
+static void putPngBits(uint16_t uiBits, uint8_t uiCount);
+
+/*!
+Pads the deflate stream to the next byte boundary
+*/
+static void alignPngBits(void);
+
+/*!
+Computes the (bit reversed) canonical Huffman codes of the given code lengths
+*/
+static void makePngCodes(const uint8_t* pLen, uint16_t* pCode, uint16_t uiCount);
+
+/*!
+Computes length limited Huffman code lengths of the given frequencies
+(the page of the tables has to be mapped)
+*/
+static void buildPngLengths(const uint16_t* pFreq, uint8_t* pLen, uint16_t uiCount, uint8_t uiMaxBits, uint8_t uiBias);
+
+/*!
+Starts a new deflate block (fixed or dynamic codes)
+*/
+static void startPngBlock(bool bDynamic);
+
+/*!
+Saves the dynamic Huffman trees of a block header
+(the page of the tables has to be mapped)
+*/
+static void savePngTrees(void);
+
+/*!
+Appends a literal to the deflate stream
+*/
+static void putPngLiteral(uint8_t uiByte);
+
+/*!
+Appends a match (length, distance) to the deflate stream
+*/
+static void putPngMatch(uint16_t uiLen, uint16_t uiDist);
+
+/*!
+Compresses the buffered input (the page of the window has to be mapped)
+*/
+static void deflatePng(bool bFlush);
+
+/*============================================================================*/
+/*                               Classes                                      */
+/*============================================================================*/
+
+/*============================================================================*/
+/*                               Implementation                               */
+/*============================================================================*/
+
+/*----------------------------------------------------------------------------*/
+/* savePngHeader()                                                            */
+/*----------------------------------------------------------------------------*/
+int savePngHeader(void)
+{
+  int iReturn = EOK;
+
+  memset(&s_tPng, 0, sizeof(s_tPng));
+  s_tPng.uiBankW = INV_BANK;
+  s_tPng.uiLevel = (g_tState.uiLevel > PNG_LEVEL_SMALL ? PNG_LEVEL_SMALL : g_tState.uiLevel);
+
+  /* Tables: CRC32 */
+  if (INV_BANK == (s_tPng.uiBankT = allocBank()))
+  {
+    iReturn = ENOMEM;
+  }
+  else
+  {
+    uint8_t uiMMU3 = ZXN_READ_MMU3();
+    pngtables_t* pTab;
+    uint32_t uiCrc;
+
+    STATS_MMU3(s_tPng.uiBankT);
+    pTab = (pngtables_t*) zxn_memmap(WORK_BANK_ADDR);
+
+    for (uint16_t i = 0; i < 256; ++i)
+    {
+      uiCrc = i;
+
+      for (uint8_t j = 0; j < 8; ++j)
+      {
+        uiCrc = (uiCrc & 1 ? UINT32_C(0xEDB88320) ^ (uiCrc >> 1) : uiCrc >> 1);
+      }
+
+      pTab->auiCrc[i] = uiCrc;
+    }
+
+    STATS_MMU3(uiMMU3);
+  }
+
+  /* Signature */
+  if (EOK == iReturn)
+  {
+    iReturn = writeImageData(s_auiPngSignature, sizeof(s_auiPngSignature));
+  }
+
+  /* IHDR */
+  if (EOK == iReturn)
+  {
+    uint8_t auiIhdr[13];
+
+    auiIhdr[ 0] = 0;                                                   /* width              */
+    auiIhdr[ 1] = 0;
+    auiIhdr[ 2] = (uint8_t) (g_tState.bmpfile.tInfoHdr.iWidth  >> 8);
+    auiIhdr[ 3] = (uint8_t) (g_tState.bmpfile.tInfoHdr.iWidth);
+    auiIhdr[ 4] = 0;                                                   /* height             */
+    auiIhdr[ 5] = 0;
+    auiIhdr[ 6] = (uint8_t) (g_tState.bmpfile.tInfoHdr.iHeight >> 8);
+    auiIhdr[ 7] = (uint8_t) (g_tState.bmpfile.tInfoHdr.iHeight);
+    auiIhdr[ 8] = (uint8_t) g_tState.bmpfile.tInfoHdr.uiBitCount;      /* bit depth          */
+    auiIhdr[ 9] = 3;                                                   /* indexed colour     */
+    auiIhdr[10] = 0;                                                   /* deflate            */
+    auiIhdr[11] = 0;                                                   /* adaptive filtering */
+    auiIhdr[12] = 0;                                                   /* no interlace       */
+
+    iReturn = savePngChunk("IHDR", auiIhdr, sizeof(auiIhdr));
+  }
+
+  return iReturn;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* savePngPalette()                                                           */
+/*----------------------------------------------------------------------------*/
+int savePngPalette(const bmppaletteentry_t* pPalette, uint16_t uiColors)
+{
+  int iReturn = EOK;
+
+  /* PLTE: R, G, B (assembled in the chunk buffer) */
+  if (EOK == iReturn)
+  {
+    uint8_t* pData = &s_tPng.auiChunk[0];
+    uint16_t uiLen = uiColors * 3;
+
+    s_tPng.auiChunk[0] = 0;
+    s_tPng.auiChunk[1] = 0;
+    s_tPng.auiChunk[2] = (uint8_t) (uiLen >> 8);
+    s_tPng.auiChunk[3] = (uint8_t) uiLen;
+    memcpy(&s_tPng.auiChunk[4], "PLTE", 4);
+
+    s_tPng.uiCrc = updatePngCrc(UINT32_C(0xFFFFFFFF), &s_tPng.auiChunk[4], 4);
+    iReturn = writeImageData(s_tPng.auiChunk, 8);
+
+    for (uint16_t i = 0; (EOK == iReturn) && (i < uiColors); ++i, ++pPalette)
+    {
+      *pData++ = pPalette->r;
+      *pData++ = pPalette->g;
+      *pData++ = pPalette->b;
+
+      if ((pData >= &s_tPng.auiChunk[PNG_CHUNK_SIZE - 3]) || (i == uiColors - 1))
+      {
+        uiLen = pData - &s_tPng.auiChunk[0];
+        s_tPng.uiCrc = updatePngCrc(s_tPng.uiCrc, s_tPng.auiChunk, uiLen);
+        iReturn = writeImageData(s_tPng.auiChunk, uiLen);
+        pData = &s_tPng.auiChunk[0];
+      }
+    }
+
+    if (EOK == iReturn)
+    {
+      s_tPng.uiCrc ^= UINT32_C(0xFFFFFFFF);
+      s_tPng.auiChunk[0] = (uint8_t) (s_tPng.uiCrc >> 24);
+      s_tPng.auiChunk[1] = (uint8_t) (s_tPng.uiCrc >> 16);
+      s_tPng.auiChunk[2] = (uint8_t) (s_tPng.uiCrc >>  8);
+      s_tPng.auiChunk[3] = (uint8_t) (s_tPng.uiCrc);
+      iReturn = writeImageData(s_tPng.auiChunk, 4);
+    }
+  }
+
+  /* Prepare deflate encoder */
+  if (EOK == iReturn)
+  {
+    s_tPng.iError     = EOK;
+    s_tPng.uiChunkLen = 0;
+    s_tPng.uiBitBuf   = 0;
+    s_tPng.uiBitCnt   = 0;
+    s_tPng.uiAdlerA   = 1;
+    s_tPng.uiAdlerB   = 0;
+
+    /* zlib header: deflate, 2K window, no dictionary */
+    putPngByte(0x38);
+    putPngByte(0x11);
+
+    if (PNG_LEVEL_STORE != s_tPng.uiLevel)
+    {
+      if (INV_BANK == (s_tPng.uiBankW = allocBank()))
+      {
+        iReturn = ENOMEM;
+      }
+      else
+      {
+        uint8_t uiMMU3 = ZXN_READ_MMU3();
+        STATS_MMU3(s_tPng.uiBankW);
+        memset(zxn_memmap(WORK_BANK_ADDR), 0, sizeof(pngwindow_t));
+        STATS_MMU3(uiMMU3);
+
+        s_tPng.uiPos  = 0;
+        s_tPng.uiEnd  = 0;
+        s_tPng.uiDone = 0;
+
+        startPngBlock(false);
+      }
+    }
+  }
+
+  return iReturn;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* savePngRow()                                                               */
+/*----------------------------------------------------------------------------*/
+int savePngRow(const uint8_t* pRow, uint16_t uiLen)
+{
+  uint32_t uiAdlerA = s_tPng.uiAdlerA;
+  uint32_t uiAdlerB = s_tPng.uiAdlerB;
+  uint16_t uiBytes  = (uint16_t) ((((uint32_t) g_tState.bmpfile.tInfoHdr.iWidth) * g_tState.bmpfile.tInfoHdr.uiBitCount + 7) >> 3);
+
+  /* PNG rows are not padded */
+  uiLen = (uiLen < uiBytes ? uiLen : uiBytes);
+
+  /* Adler-32 of the filter byte (0 = none) and the row */
+  uiAdlerB += uiAdlerA;
+
+  for (uint16_t i = 0; i < uiLen; ++i)
+  {
+    uiAdlerA += pRow[i];
+    uiAdlerB += uiAdlerA;
+  }
+
+  s_tPng.uiAdlerA = uiAdlerA % 65521;
+  s_tPng.uiAdlerB = uiAdlerB % 65521;
+
+  if (PNG_LEVEL_STORE == s_tPng.uiLevel)
+  {
+    /* Stored block: BFINAL = 0, BTYPE = 00 */
+    putPngBits(0, 3);
+    alignPngBits();
+    putPngByte((uint8_t) (uiLen + 1));
+    putPngByte((uint8_t) ((uiLen + 1) >> 8));
+    putPngByte((uint8_t) ~(uiLen + 1));
+    putPngByte((uint8_t) (~(uiLen + 1) >> 8));
+    putPngByte(0);
+
+    while (uiLen--)
+    {
+      putPngByte(*pRow++);
+    }
+  }
+  else
+  {
+    uint8_t uiMMU3 = ZXN_READ_MMU3();
+    pngwindow_t* pWin;
+    uint16_t uiOffset;
+    uint16_t uiPart;
+
+    STATS_MMU3(s_tPng.uiBankW);
+    pWin = (pngwindow_t*) zxn_memmap(WORK_BANK_ADDR);
+
+    /* Append filter byte and row to the ring buffer */
+    pWin->auiData[s_tPng.uiEnd++ & PNG_WINDOW_MASK] = 0;
+
+    uiOffset = s_tPng.uiEnd & PNG_WINDOW_MASK;
+    uiPart   = PNG_WINDOW_SIZE - uiOffset;
+    uiPart   = (uiPart < uiLen ? uiPart : uiLen);
+
+    memcpy(&pWin->auiData[uiOffset], pRow, uiPart);
+    memcpy(&pWin->auiData[0], pRow + uiPart, uiLen - uiPart);
+    s_tPng.uiEnd += uiLen;
+
+    deflatePng(false);
+
+    STATS_MMU3(uiMMU3);
+  }
+
+  return s_tPng.iError;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* savePngTrailer()                                                           */
+/*----------------------------------------------------------------------------*/
+int savePngTrailer(void)
+{
+  int iReturn = EOK;
+
+  if (PNG_LEVEL_STORE != s_tPng.uiLevel)
+  {
+    uint8_t uiMMU3 = ZXN_READ_MMU3();
+    STATS_MMU3(s_tPng.uiBankW);
+
+    deflatePng(true);
+    putPngBits(s_tPng.auiLitCode[256], s_tPng.auiLitLen[256]);  /* end of block */
+
+    STATS_MMU3(uiMMU3);
+  }
+
+  /* Empty final block with fixed codes: BFINAL = 1, BTYPE = 01, EOB */
+  putPngBits(3, 3);
+  putPngBits(0, 7);
+  alignPngBits();
+
+  /* Adler-32 (big endian) */
+  putPngByte((uint8_t) (s_tPng.uiAdlerB >> 8));
+  putPngByte((uint8_t) (s_tPng.uiAdlerB));
+  putPngByte((uint8_t) (s_tPng.uiAdlerA >> 8));
+  putPngByte((uint8_t) (s_tPng.uiAdlerA));
+
+  if (0 != s_tPng.uiChunkLen)
+  {
+    flushPngChunk();
+  }
+
+  if (EOK == (iReturn = s_tPng.iError))
+  {
+    iReturn = savePngChunk("IEND", 0, 0);
+  }
+
+  freeBank(s_tPng.uiBankW);
+  freeBank(s_tPng.uiBankT);
+  s_tPng.uiBankW = INV_BANK;
+  s_tPng.uiBankT = INV_BANK;
+
+  return iReturn;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* updatePngCrc()                                                             */
+/*----------------------------------------------------------------------------*/
+static uint32_t updatePngCrc(uint32_t uiCrc, const uint8_t* pData, uint16_t uiLen)
+{
+  uint8_t uiMMU3 = ZXN_READ_MMU3();
+  const uint32_t* pTable;
+
+  STATS_MMU3(s_tPng.uiBankT);
+  pTable = ((const pngtables_t*) zxn_memmap(WORK_BANK_ADDR))->auiCrc;
+
+  while (uiLen--)
+  {
+    uiCrc = pTable[((uint8_t) uiCrc) ^ *pData++] ^ (uiCrc >> 8);
+  }
+
+  STATS_MMU3(uiMMU3);
+
+  return uiCrc;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* savePngChunk()                                                             */
+/*----------------------------------------------------------------------------*/
+static int savePngChunk(const char_t* acType, const uint8_t* pData, uint16_t uiLen)
+{
+  int iReturn;
+  uint8_t auiBuffer[8];
+  uint32_t uiCrc;
+
+  auiBuffer[0] = 0;
+  auiBuffer[1] = 0;
+  auiBuffer[2] = (uint8_t) (uiLen >> 8);
+  auiBuffer[3] = (uint8_t) uiLen;
+  memcpy(&auiBuffer[4], acType, 4);
+
+  uiCrc = updatePngCrc(UINT32_C(0xFFFFFFFF), &auiBuffer[4], 4);
+  uiCrc = updatePngCrc(uiCrc, pData, uiLen) ^ UINT32_C(0xFFFFFFFF);
+
+  if ((EOK == (iReturn = writeImageData(auiBuffer, 8))) && (0 != uiLen))
+  {
+    iReturn = writeImageData(pData, uiLen);
+  }
+
+  if (EOK == iReturn)
+  {
+    auiBuffer[0] = (uint8_t) (uiCrc >> 24);
+    auiBuffer[1] = (uint8_t) (uiCrc >> 16);
+    auiBuffer[2] = (uint8_t) (uiCrc >>  8);
+    auiBuffer[3] = (uint8_t) (uiCrc);
+    iReturn = writeImageData(auiBuffer, 4);
+  }
+
+  return iReturn;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* flushPngChunk()                                                            */
+/*----------------------------------------------------------------------------*/
+static void flushPngChunk(void)
+{
+  uint16_t uiLen = s_tPng.uiChunkLen;
+  uint8_t* pCrc  = &s_tPng.auiChunk[8 + uiLen];
+  uint32_t uiCrc;
+
+  s_tPng.auiChunk[0] = 0;
+  s_tPng.auiChunk[1] = 0;
+  s_tPng.auiChunk[2] = (uint8_t) (uiLen >> 8);
+  s_tPng.auiChunk[3] = (uint8_t) uiLen;
+  memcpy(&s_tPng.auiChunk[4], "IDAT", 4);
+
+  uiCrc = updatePngCrc(UINT32_C(0xFFFFFFFF), &s_tPng.auiChunk[4], uiLen + 4) ^ UINT32_C(0xFFFFFFFF);
+
+  pCrc[0] = (uint8_t) (uiCrc >> 24);
+  pCrc[1] = (uint8_t) (uiCrc >> 16);
+  pCrc[2] = (uint8_t) (uiCrc >>  8);
+  pCrc[3] = (uint8_t) (uiCrc);
+
+  if (EOK == s_tPng.iError)
+  {
+    s_tPng.iError = writeImageData(s_tPng.auiChunk, 8 + uiLen + 4);
+  }
+
+  s_tPng.uiChunkLen = 0;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* putPngByte()                                                               */
+/*----------------------------------------------------------------------------*/
+static void putPngByte(uint8_t uiByte)
+{
+  s_tPng.auiChunk[8 + s_tPng.uiChunkLen] = uiByte;
+
+  if (PNG_CHUNK_SIZE == ++s_tPng.uiChunkLen)
+  {
+    flushPngChunk();
+  }
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* putPngBits()                                                               */
+/*----------------------------------------------------------------------------*/
+static void putPngBits(uint16_t uiBits, uint8_t uiCount)
+{
+  s_tPng.uiBitBuf |= ((uint32_t) uiBits) << s_tPng.uiBitCnt;
+  s_tPng.uiBitCnt += uiCount;
+
+  while (8 <= s_tPng.uiBitCnt)
+  {
+    putPngByte((uint8_t) s_tPng.uiBitBuf);
+    s_tPng.uiBitBuf >>= 8;
+    s_tPng.uiBitCnt  -= 8;
+  }
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* alignPngBits()                                                             */
+/*----------------------------------------------------------------------------*/
+static void alignPngBits(void)
+{
+  if (0 != s_tPng.uiBitCnt)
+  {
+    putPngByte((uint8_t) s_tPng.uiBitBuf);
+    s_tPng.uiBitBuf = 0;
+    s_tPng.uiBitCnt = 0;
+  }
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* makePngCodes()                                                             */
+/*----------------------------------------------------------------------------*/
+static void makePngCodes(const uint8_t* pLen, uint16_t* pCode, uint16_t uiCount)
+{
+  uint16_t auiCount[16];
+  uint16_t auiNext[16];
+  uint16_t uiCode = 0;
+
+  memset(auiCount, 0, sizeof(auiCount));
+
+  for (uint16_t i = 0; i < uiCount; ++i)
+  {
+    ++auiCount[pLen[i]];
+  }
+
+  auiCount[0] = 0;
+
+  for (uint8_t uiBits = 1; uiBits < 16; ++uiBits)
+  {
+    uiCode = (uiCode + auiCount[uiBits - 1]) << 1;
+    auiNext[uiBits] = uiCode;
+  }
+
+  for (uint16_t i = 0; i < uiCount; ++i)
+  {
+    uint8_t  uiLen = pLen[i];
+    uint16_t uiRev = 0;
+
+    if (0 != uiLen)
+    {
+      uiCode = auiNext[uiLen]++;
+
+      /* Huffman codes are sent MSB first */
+      while (uiLen--)
+      {
+        uiRev = (uiRev << 1) | (uiCode & 1);
+        uiCode >>= 1;
+      }
+    }
+
+    pCode[i] = uiRev;
+  }
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* buildPngLengths()                                                          */
+/*----------------------------------------------------------------------------*/
+static void buildPngLengths(const uint16_t* pFreq, uint8_t* pLen, uint16_t uiCount, uint8_t uiMaxBits, uint8_t uiBias)
+{
+  pngtables_t* pTab = (pngtables_t*) zxn_memmap(WORK_BANK_ADDR);
+  uint16_t* pWeight = pTab->auiWeight;
+  uint16_t* pParent = pTab->auiParent;
+  uint16_t* pHeap   = pTab->auiHeap;
+  uint8_t*  pDepth  = pTab->auiDepth;
+  uint8_t   uiShift = 0;
+
+  for (;;)
+  {
+    uint16_t uiHeapLen = 0;
+    uint16_t uiNodes   = uiCount;
+    uint16_t uiNode;
+    uint16_t uiChild;
+    uint16_t uiWeight;
+    uint16_t i;
+    uint8_t  uiMax = 0;
+
+    memset(pLen, 0, uiCount);
+
+    /* Leaves (heap ordered by weight) */
+    for (i = 0; i < uiCount; ++i)
+    {
+      uiWeight = pFreq[i] + uiBias;
+
+      if (0 != uiWeight)
+      {
+        uiWeight >>= uiShift;
+        uiWeight  |= (0 == uiWeight ? 1 : 0);
+
+        pWeight[i] = uiWeight;
+
+        for (uiNode = uiHeapLen++; 0 != uiNode; uiNode = (uiNode - 1) >> 1)
+        {
+          if (pWeight[pHeap[(uiNode - 1) >> 1]] <= uiWeight)
+          {
+            break;
+          }
+
+          pHeap[uiNode] = pHeap[(uiNode - 1) >> 1];
+        }
+
+        pHeap[uiNode] = i;
+      }
+      else
+      {
+        pWeight[i] = 0;
+      }
+    }
+
+    if (uiHeapLen < 2)
+    {
+      if (1 == uiHeapLen)
+      {
+        pLen[pHeap[0]] = 1;
+      }
+
+      return;
+    }
+
+    /* Combine the two lightest nodes until one tree is left */
+    while (1 < uiHeapLen)
+    {
+      uint16_t auiPair[2];
+
+      for (uint8_t k = 0; k < 2; ++k)
+      {
+        uint16_t uiLast = pHeap[--uiHeapLen];
+
+        auiPair[k] = pHeap[0];
+        uiWeight   = pWeight[uiLast];
+
+        for (uiNode = 0; (uiChild = (uiNode << 1) + 1) < uiHeapLen; uiNode = uiChild)
+        {
+          if (((uiChild + 1) < uiHeapLen) && (pWeight[pHeap[uiChild + 1]] < pWeight[pHeap[uiChild]]))
+          {
+            ++uiChild;
+          }
+
+          if (uiWeight <= pWeight[pHeap[uiChild]])
+          {
+            break;
+          }
+
+          pHeap[uiNode] = pHeap[uiChild];
+        }
+
+        pHeap[uiNode] = uiLast;
+      }
+
+      pWeight[uiNodes] = pWeight[auiPair[0]] + pWeight[auiPair[1]];
+      pParent[auiPair[0]] = uiNodes;
+      pParent[auiPair[1]] = uiNodes;
+      uiWeight = pWeight[uiNodes];
+
+      for (uiNode = uiHeapLen++; 0 != uiNode; uiNode = (uiNode - 1) >> 1)
+      {
+        if (pWeight[pHeap[(uiNode - 1) >> 1]] <= uiWeight)
+        {
+          break;
+        }
+
+        pHeap[uiNode] = pHeap[(uiNode - 1) >> 1];
+      }
+
+      pHeap[uiNode] = uiNodes++;
+    }
+
+    /* Depth of all nodes (parents are created after their children) */
+    pDepth[uiNodes - 1] = 0;
+
+    for (i = uiNodes - 1; i-- > uiCount; )
+    {
+      pDepth[i] = pDepth[pParent[i]] + 1;
+    }
+
+    for (i = 0; i < uiCount; ++i)
+    {
+      if (0 != pWeight[i])
+      {
+        pLen[i] = pDepth[pParent[i]] + 1;
+        uiMax   = (pLen[i] > uiMax ? pLen[i] : uiMax);
+      }
+    }
+
+    if (uiMax <= uiMaxBits)
+    {
+      break;
+    }
+
+    /* Tree too deep: flatten the statistics and try again */
+    ++uiShift;
+  }
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* startPngBlock()                                                            */
+/*----------------------------------------------------------------------------*/
+static void startPngBlock(bool bDynamic)
+{
+  if (bDynamic)
+  {
+    uint8_t uiMMU3 = ZXN_READ_MMU3();
+
+    STATS_MMU3(s_tPng.uiBankT);
+
+    /* BFINAL = 0, BTYPE = 10 */
+    putPngBits(4, 3);
+    savePngTrees();
+
+    STATS_MMU3(uiMMU3);
+
+    s_tPng.uiBlockSize = PNG_BLOCK_SIZE;
+  }
+  else
+  {
+    uint16_t i;
+
+    for (i =   0; i < 144; ++i) s_tPng.auiLitLen[i] = 8;
+    for (     ; i < 256; ++i) s_tPng.auiLitLen[i] = 9;
+    for (     ; i < 280; ++i) s_tPng.auiLitLen[i] = 7;
+    for (     ; i < 288; ++i) s_tPng.auiLitLen[i] = 8;
+
+    memset(s_tPng.auiDistLen, 5, sizeof(s_tPng.auiDistLen));
+
+    makePngCodes(s_tPng.auiLitLen,  s_tPng.auiLitCode,  288);
+    makePngCodes(s_tPng.auiDistLen, s_tPng.auiDistCode, PNG_DIST_CODES);
+
+    /* BFINAL = 0, BTYPE = 01 */
+    putPngBits(2, 3);
+
+    s_tPng.uiBlockSize = PNG_BLOCK_FIRST;
+    s_tPng.bFixedOnly  = (PNG_LEVEL_SMALL != s_tPng.uiLevel);
+  }
+
+  memset(s_tPng.auiLitFreq,  0, sizeof(s_tPng.auiLitFreq));
+  memset(s_tPng.auiDistFreq, 0, sizeof(s_tPng.auiDistFreq));
+  s_tPng.uiSymbols = 0;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* savePngTrees()                                                             */
+/*----------------------------------------------------------------------------*/
+static void savePngTrees(void)
+{
+  pngtables_t* pTab = (pngtables_t*) zxn_memmap(WORK_BANK_ADDR);
+  uint16_t auiClFreq[PNG_CL_CODES];
+  uint16_t auiClCode[PNG_CL_CODES];
+  uint8_t  auiClLen[PNG_CL_CODES];
+  uint16_t uiRle = 0;
+  uint16_t uiRun;
+  uint16_t i;
+  uint8_t  uiHclen;
+  uint8_t  uiCur;
+
+  /* Codes built from the statistics of the previous block; every symbol
+     gets a code, so no symbols have to be buffered */
+  buildPngLengths(s_tPng.auiLitFreq,  s_tPng.auiLitLen,  PNG_LIT_CODES,  15, 1);
+  buildPngLengths(s_tPng.auiDistFreq, s_tPng.auiDistLen, PNG_DIST_CODES, 15, 1);
+  s_tPng.auiLitLen[286] = 0;
+  s_tPng.auiLitLen[287] = 0;
+
+  makePngCodes(s_tPng.auiLitLen,  s_tPng.auiLitCode,  PNG_LIT_CODES);
+  makePngCodes(s_tPng.auiDistLen, s_tPng.auiDistCode, PNG_DIST_CODES);
+
+  /* Run length encoding of the code lengths (literal + distance) */
+  memset(auiClFreq, 0, sizeof(auiClFreq));
+
+  #define PNG_CODE_LEN(n) ((n) < PNG_LIT_CODES ? s_tPng.auiLitLen[n] : s_tPng.auiDistLen[(n) - PNG_LIT_CODES])
+
+  for (i = 0; i < PNG_LIT_CODES + PNG_DIST_CODES; )
+  {
+    uiCur = PNG_CODE_LEN(i);
+    uiRun = 1;
+
+    while (((i + uiRun) < (PNG_LIT_CODES + PNG_DIST_CODES)) && (PNG_CODE_LEN(i + uiRun) == uiCur) && (uiRun < 138))
+    {
+      ++uiRun;
+    }
+
+    if ((0 == uiCur) && (3 <= uiRun))
+    {
+      pTab->auiRleSym[uiRle] = (uiRun <= 10 ? 17 : 18);
+      pTab->auiRleExt[uiRle] = (uint8_t) (uiRun <= 10 ? uiRun - 3 : uiRun - 11);
+      ++auiClFreq[pTab->auiRleSym[uiRle++]];
+      i += uiRun;
+    }
+    else
+    {
+      pTab->auiRleSym[uiRle] = uiCur;
+      pTab->auiRleExt[uiRle] = 0;
+      ++auiClFreq[pTab->auiRleSym[uiRle++]];
+      ++i;
+      --uiRun;
+
+      while (3 <= uiRun)
+      {
+        uint8_t uiRep = (uiRun > 6 ? 6 : (uint8_t) uiRun);
+
+        pTab->auiRleSym[uiRle] = 16;
+        pTab->auiRleExt[uiRle] = uiRep - 3;
+        ++auiClFreq[pTab->auiRleSym[uiRle++]];
+        i     += uiRep;
+        uiRun -= uiRep;
+      }
+    }
+  }
+
+  #undef PNG_CODE_LEN
+
+  /* Code length codes */
+  buildPngLengths(auiClFreq, auiClLen, PNG_CL_CODES, 7, 0);
+  makePngCodes(auiClLen, auiClCode, PNG_CL_CODES);
+
+  for (uiHclen = PNG_CL_CODES; (4 < uiHclen) && (0 == auiClLen[s_auiClOrder[uiHclen - 1]]); --uiHclen)
+  {
+  }
+
+  putPngBits(PNG_LIT_CODES  - 257, 5);  /* HLIT  */
+  putPngBits(PNG_DIST_CODES -   1, 5);  /* HDIST */
+  putPngBits(uiHclen        -   4, 4);  /* HCLEN */
+
+  for (i = 0; i < uiHclen; ++i)
+  {
+    putPngBits(auiClLen[s_auiClOrder[i]], 3);
+  }
+
+  for (i = 0; i < uiRle; ++i)
+  {
+    uiCur = pTab->auiRleSym[i];
+    putPngBits(auiClCode[uiCur], auiClLen[uiCur]);
+
+    switch (uiCur)
+    {
+      case 16: putPngBits(pTab->auiRleExt[i], 2); break;
+      case 17: putPngBits(pTab->auiRleExt[i], 3); break;
+      case 18: putPngBits(pTab->auiRleExt[i], 7); break;
+      default: break;
+    }
+  }
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* putPngLiteral()                                                            */
+/*----------------------------------------------------------------------------*/
+static void putPngLiteral(uint8_t uiByte)
+{
+  putPngBits(s_tPng.auiLitCode[uiByte], s_tPng.auiLitLen[uiByte]);
+  ++s_tPng.auiLitFreq[uiByte];
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* putPngMatch()                                                              */
+/*----------------------------------------------------------------------------*/
+static void putPngMatch(uint16_t uiLen, uint16_t uiDist)
+{
+  uint8_t i = 28;
+  uint8_t j = PNG_DIST_CODES - 1;
+
+  while (s_auiLenBase[i] > uiLen)
+  {
+    --i;
+  }
+
+  while (s_auiDistBase[j] > uiDist)
+  {
+    --j;
+  }
+
+  putPngBits(s_tPng.auiLitCode[257 + i], s_tPng.auiLitLen[257 + i]);
+  putPngBits(uiLen - s_auiLenBase[i], s_auiLenExtra[i]);
+  putPngBits(s_tPng.auiDistCode[j], s_tPng.auiDistLen[j]);
+  putPngBits(uiDist - s_auiDistBase[j], s_auiDistExtra[j]);
+
+  ++s_tPng.auiLitFreq[257 + i];
+  ++s_tPng.auiDistFreq[j];
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* deflatePng()                                                               */
+/*----------------------------------------------------------------------------*/
+static void deflatePng(bool bFlush)
+{
+  pngwindow_t* pWin = (pngwindow_t*) zxn_memmap(WORK_BANK_ADDR);
+  const uint8_t* pData = pWin->auiData;
+  uint8_t  uiDepth = (PNG_LEVEL_SMALL == s_tPng.uiLevel ? PNG_CHAIN_DEPTH : 1);
+  uint16_t uiAvail;
+  uint16_t uiPos;
+  uint16_t uiCand;
+  uint16_t uiHash;
+  uint16_t uiDist;
+  uint16_t uiLimit;
+  uint16_t uiMaxLen;
+  uint16_t uiLen;
+  uint16_t uiBestLen;
+  uint16_t uiBestDist;
+
+  #define PNG_HASH(p) ((((uint16_t) pData[(p) & PNG_WINDOW_MASK]) << 4) ^ \
+                       (pData[(p) & PNG_WINDOW_MASK] >> 6)                ^ \
+                       (((uint16_t) pData[((p) + 1) & PNG_WINDOW_MASK]) << 2) ^ \
+                       pData[((p) + 2) & PNG_WINDOW_MASK]) & PNG_HASH_MASK
+
+  while ((0 != (uiAvail = s_tPng.uiEnd - s_tPng.uiPos)) && (bFlush || (PNG_MAX_MATCH <= uiAvail)))
+  {
+    uiPos      = s_tPng.uiPos;
+    uiBestLen  = 0;
+    uiBestDist = 0;
+
+    if (PNG_MIN_MATCH <= uiAvail)
+    {
+      /* Matches have to start inside the window and after the first byte */
+      uiLimit  = PNG_WINDOW_SIZE - uiAvail;
+      uiLimit  = (uiLimit < s_tPng.uiDone ? uiLimit : s_tPng.uiDone);
+      uiMaxLen = (uiAvail < PNG_MAX_MATCH ? uiAvail : PNG_MAX_MATCH);
+
+      uiHash = PNG_HASH(uiPos);
+      uiCand = pWin->auiHead[uiHash];
+      pWin->auiPrev[uiPos & PNG_WINDOW_MASK] = uiCand;
+      pWin->auiHead[uiHash] = uiPos;
+
+      for (uint8_t n = uiDepth; 0 != n; --n)
+      {
+        uiDist = uiPos - uiCand;
+
+        if ((0 == uiDist) || (uiDist > uiLimit))
+        {
+          break;
+        }
+
+        if (pData[(uiCand + uiBestLen) & PNG_WINDOW_MASK] == pData[(uiPos + uiBestLen) & PNG_WINDOW_MASK])
+        {
+          for (uiLen = 0; (uiLen < uiMaxLen) && (pData[(uiCand + uiLen) & PNG_WINDOW_MASK] == pData[(uiPos + uiLen) & PNG_WINDOW_MASK]); ++uiLen)
+          {
+          }
+
+          if (uiLen > uiBestLen)
+          {
+            uiBestLen  = uiLen;
+            uiBestDist = uiDist;
+
+            if (uiLen == uiMaxLen)
+            {
+              break;
+            }
+          }
+        }
+
+        uiCand = pWin->auiPrev[uiCand & PNG_WINDOW_MASK];
+      }
+    }
+
+    if (PNG_MIN_MATCH <= uiBestLen)
+    {
+      putPngMatch(uiBestLen, uiBestDist);
+
+      /* Level "small": all positions of the match are added to the chains */
+      if (PNG_LEVEL_SMALL == s_tPng.uiLevel)
+      {
+        for (uiLen = 1; (uiLen < uiBestLen) && (PNG_MIN_MATCH <= (uiAvail - uiLen)); ++uiLen)
+        {
+          uiHash = PNG_HASH(uiPos + uiLen);
+          pWin->auiPrev[(uiPos + uiLen) & PNG_WINDOW_MASK] = pWin->auiHead[uiHash];
+          pWin->auiHead[uiHash] = uiPos + uiLen;
+        }
+      }
+    }
+    else
+    {
+      uiBestLen = 1;
+      putPngLiteral(pData[uiPos & PNG_WINDOW_MASK]);
+    }
+
+    s_tPng.uiPos  += uiBestLen;
+    s_tPng.uiDone  = (s_tPng.uiDone < PNG_WINDOW_SIZE ? s_tPng.uiDone + uiBestLen : s_tPng.uiDone);
+
+    /* Next block: codes from the statistics of this block */
+    if ((!s_tPng.bFixedOnly) && (++s_tPng.uiSymbols == s_tPng.uiBlockSize))
+    {
+      putPngBits(s_tPng.auiLitCode[256], s_tPng.auiLitLen[256]);
+      ++s_tPng.auiLitFreq[256];
+      startPngBlock(true);
+    }
+  }
+
+  #undef PNG_HASH
+}
+
+
+/*----------------------------------------------------------------------------*/
+/*                                                                            */
+/*----------------------------------------------------------------------------*/
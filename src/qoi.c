@@ -0,0 +1,395 @@
+/*-----------------------------------------------------------------------------+
+|                                                                              |
+| filename: qoi.c                                                              |
+| project:  zxn::scrnshot                                                      |
+| author:   S. Zell                                                            |
+| date:     10/18/2026                                                         |
+|                                                                              |
++------------------------------------------------------------------------------+
+|                                                                              |
+| description:                                                                 |
+|                                                                              |
+| QOI encoder ("Quite OK Image" format, lossless)                              |
+|                                                                              |
++------------------------------------------------------------------------------+
+|                                                                              |
+| Copyright (c) 10/18/2026 STZ Engineering                                     |
+|                                                                              |
+| This software is provided  "as is",  without warranty of any kind, express   |
+| or implied. In no event shall STZ or its contributors be held liable for any |
+| direct, indirect, incidental, special or consequential damages arising out   |
+| of the use of or inability to use this software.                             |
+|                                                                              |
+| Permission is granted to anyone  to use this  software for any purpose,      |
+| including commercial applications,  and to alter it and redistribute it      |
+| freely, subject to the following restrictions:                               |
+|                                                                              |
+| 1. Redistributions of source code must retain the above copyright            |
+|    notice, definition, disclaimer, and this list of conditions.              |
+|                                                                              |
+| 2. Redistributions in binary form must reproduce the above copyright         |
+|    notice, definition, disclaimer, and this list of conditions in            |
+|    documentation and/or other materials provided with the distribution.      |
+|                                                                          ;-) |
++-----------------------------------------------------------------------------*/
+
+/*============================================================================*/
+/*                               Includes                                     */
+/*============================================================================*/
+#include <stdint.h>
+#include <errno.h>
+#include <string.h>
+#include <arch/zxn.h>
+#include <arch/zxn/esxdos.h>
+
+#include "libzxn.h"
+#include "scrnshot.h"
+#include "qoi.h"
+
+/*============================================================================*/
+/*                               Defines                                      */
+/*============================================================================*/
+/*!
+QOI operations (2-bit and 8-bit tags)
+*/
+#define QOI_OP_INDEX 0x00
+#define QOI_OP_DIFF  0x40
+#define QOI_OP_LUMA  0x80
+#define QOI_OP_RUN   0xC0
+#define QOI_OP_RGB   0xFE
+
+/*!
+Maximum length of a run
+*/
+#define QOI_RUN_MAX 62
+
+/*!
+Size of the output buffer
+*/
+#define QOI_BUFFER_SIZE 256
+
+/*!
+Palette index of the previous pixel: none (compare the colours)
+*/
+#define QOI_NO_INDEX 0xFFFF
+
+/*============================================================================*/
+/*                               Namespaces                                   */
+/*============================================================================*/
+
+/*============================================================================*/
+/*                               Constants                                    */
+/*============================================================================*/
+/*!
+End marker of a QOI file
+*/
+static const uint8_t s_auiQoiEnd[8] = {0, 0, 0, 0, 0, 0, 0, 1};
+
+/*============================================================================*/
+/*                               Structures                                   */
+/*============================================================================*/
+/*!
+Colour of a pixel: red, green, blue and either alpha (table of seen colours)
+or the precomputed hash (palette)
+*/
+typedef struct _qoicolour
+{
+  uint8_t r;
+  uint8_t g;
+  uint8_t b;
+  uint8_t x;
+} qoicolour_t;
+
+/*!
+State of the QOI encoder
+*/
+typedef struct _qoistate
+{
+  int         iError;                     /* first write error           */
+  qoicolour_t tPrev;                      /* colour of the previous pixel */
+  uint16_t    uiPrevIndex;                /* palette index of it         */
+  uint8_t     uiRun;                      /* length of the current run   */
+  uint16_t    uiOutLen;                   /* bytes in the output buffer  */
+  uint8_t     auiOut[QOI_BUFFER_SIZE];
+  qoicolour_t atSeen[64];                 /* colours seen (x = alpha)    */
+  qoicolour_t atPalette[256];             /* palette (x = hash)          */
+} qoistate_t;
+
+/*============================================================================*/
+/*                               Variables                                    */
+/*============================================================================*/
+/*!
+In dieser Struktur werden alle globalen Daten der Anwendung gespeichert.
+*/
+extern appstate_t g_tState;
+
+/*!
+State of the QOI encoder
+*/
+static qoistate_t s_tQoi;
+
+/*============================================================================*/
+/*                               Type-Definitions                             */
+/*============================================================================*/
+
+/*============================================================================*/
+/*                               Prototypes                                   */
+/*============================================================================*/
+/*!
+Appends one byte to the output buffer
+*/
+static void putQoiByte(uint8_t uiByte);
+
+/*!
+Saves the output buffer to the output file
+*/
+static void flushQoiBuffer(void);
+
+/*!
+Encodes one pixel (palette index)
+*/
+static void putQoiPixel(uint8_t uiIndex);
+
+/*============================================================================*/
+/*                               Classes                                      */
+/*============================================================================*/
+
+/*============================================================================*/
+/*                               Implementation                               */
+/*============================================================================*/
+
+/*----------------------------------------------------------------------------*/
+/* saveQoiHeader()                                                            */
+/*----------------------------------------------------------------------------*/
+int saveQoiHeader(void)
+{
+  uint8_t auiHeader[14];
+  uint16_t uiWidth  = (uint16_t) g_tState.bmpfile.tInfoHdr.iWidth;
+  uint16_t uiHeight = (uint16_t) g_tState.bmpfile.tInfoHdr.iHeight;
+
+  memset(&s_tQoi, 0, sizeof(s_tQoi));
+  s_tQoi.iError      = EOK;
+  s_tQoi.tPrev.x     = 0xFF;
+  s_tQoi.uiPrevIndex = QOI_NO_INDEX;
+
+  memcpy(&auiHeader[0], "qoif", 4);
+  auiHeader[ 4] = 0;                          /* width (big endian)  */
+  auiHeader[ 5] = 0;
+  auiHeader[ 6] = (uint8_t) (uiWidth >> 8);
+  auiHeader[ 7] = (uint8_t) (uiWidth);
+  auiHeader[ 8] = 0;                          /* height (big endian) */
+  auiHeader[ 9] = 0;
+  auiHeader[10] = (uint8_t) (uiHeight >> 8);
+  auiHeader[11] = (uint8_t) (uiHeight);
+  auiHeader[12] = 3;                          /* channels: RGB       */
+  auiHeader[13] = 0;                          /* sRGB                */
+
+  return writeImageData(auiHeader, sizeof(auiHeader));
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* saveQoiPalette()                                                           */
+/*----------------------------------------------------------------------------*/
+int saveQoiPalette(const bmppaletteentry_t* pPalette, uint16_t uiColors)
+{
+  qoicolour_t* pColour = &s_tQoi.atPalette[0];
+
+  for (uint16_t i = 0; (i < uiColors) && (i < 256); ++i, ++pPalette, ++pColour)
+  {
+    pColour->r = pPalette->r;
+    pColour->g = pPalette->g;
+    pColour->b = pPalette->b;
+
+    /* Hash of the colour: (r * 3 + g * 5 + b * 7 + a * 11) % 64, a = 255 */
+    pColour->x = (uint8_t) ((pColour->r * 3 + pColour->g * 5 + pColour->b * 7 + 255 * 11) & 0x3F);
+  }
+
+  return EOK;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* saveQoiRow()                                                               */
+/*----------------------------------------------------------------------------*/
+int saveQoiRow(const uint8_t* pRow, uint16_t uiLen)
+{
+  uint16_t uiPixels = (uint16_t) g_tState.bmpfile.tInfoHdr.iWidth;
+
+  switch (g_tState.bmpfile.tInfoHdr.uiBitCount)
+  {
+    case 8:
+      while (uiPixels-- && uiLen--)
+      {
+        putQoiPixel(*pRow++);
+      }
+      break;
+
+    case 4:
+      while (uiPixels && uiLen--)
+      {
+        putQoiPixel(*pRow >> 4);
+
+        if (0 != --uiPixels)
+        {
+          putQoiPixel(*pRow & 0x0F);
+          --uiPixels;
+        }
+
+        ++pRow;
+      }
+      break;
+
+    case 1:
+      while (uiPixels && uiLen--)
+      {
+        for (uint8_t uiMask = 0x80; (0 != uiMask) && (0 != uiPixels); uiMask >>= 1, --uiPixels)
+        {
+          putQoiPixel(*pRow & uiMask ? 1 : 0);
+        }
+
+        ++pRow;
+      }
+      break;
+
+    default:
+      return ENOTSUP;
+  }
+
+  return s_tQoi.iError;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* saveQoiTrailer()                                                           */
+/*----------------------------------------------------------------------------*/
+int saveQoiTrailer(void)
+{
+  if (0 != s_tQoi.uiRun)
+  {
+    putQoiByte(QOI_OP_RUN | (s_tQoi.uiRun - 1));
+    s_tQoi.uiRun = 0;
+  }
+
+  for (uint8_t i = 0; i < sizeof(s_auiQoiEnd); ++i)
+  {
+    putQoiByte(s_auiQoiEnd[i]);
+  }
+
+  flushQoiBuffer();
+
+  return s_tQoi.iError;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* putQoiByte()                                                               */
+/*----------------------------------------------------------------------------*/
+static void putQoiByte(uint8_t uiByte)
+{
+  s_tQoi.auiOut[s_tQoi.uiOutLen] = uiByte;
+
+  if (QOI_BUFFER_SIZE == ++s_tQoi.uiOutLen)
+  {
+    flushQoiBuffer();
+  }
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* flushQoiBuffer()                                                           */
+/*----------------------------------------------------------------------------*/
+static void flushQoiBuffer(void)
+{
+  if ((EOK == s_tQoi.iError) && (0 != s_tQoi.uiOutLen))
+  {
+    s_tQoi.iError = writeImageData(s_tQoi.auiOut, s_tQoi.uiOutLen);
+  }
+
+  s_tQoi.uiOutLen = 0;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* putQoiPixel()                                                              */
+/*----------------------------------------------------------------------------*/
+static void putQoiPixel(uint8_t uiIndex)
+{
+  const qoicolour_t* pColour = &s_tQoi.atPalette[uiIndex];
+  qoicolour_t* pSeen;
+  int8_t iDr;
+  int8_t iDg;
+  int8_t iDb;
+
+  /* Same palette index or same colour: run */
+  if ((uiIndex == s_tQoi.uiPrevIndex) ||
+      ((pColour->r == s_tQoi.tPrev.r) && (pColour->g == s_tQoi.tPrev.g) && (pColour->b == s_tQoi.tPrev.b)))
+  {
+    s_tQoi.uiPrevIndex = uiIndex;
+
+    if (QOI_RUN_MAX == ++s_tQoi.uiRun)
+    {
+      putQoiByte(QOI_OP_RUN | (QOI_RUN_MAX - 1));
+      s_tQoi.uiRun = 0;
+    }
+
+    return;
+  }
+
+  if (0 != s_tQoi.uiRun)
+  {
+    putQoiByte(QOI_OP_RUN | (s_tQoi.uiRun - 1));
+    s_tQoi.uiRun = 0;
+  }
+
+  pSeen = &s_tQoi.atSeen[pColour->x];
+
+  if ((0xFF == pSeen->x) && (pColour->r == pSeen->r) && (pColour->g == pSeen->g) && (pColour->b == pSeen->b))
+  {
+    putQoiByte(QOI_OP_INDEX | pColour->x);
+  }
+  else
+  {
+    pSeen->r = pColour->r;
+    pSeen->g = pColour->g;
+    pSeen->b = pColour->b;
+    pSeen->x = 0xFF;
+
+    iDr = (int8_t) (pColour->r - s_tQoi.tPrev.r);
+    iDg = (int8_t) (pColour->g - s_tQoi.tPrev.g);
+    iDb = (int8_t) (pColour->b - s_tQoi.tPrev.b);
+
+    if ((-2 <= iDr) && (iDr <= 1) && (-2 <= iDg) && (iDg <= 1) && (-2 <= iDb) && (iDb <= 1))
+    {
+      putQoiByte(QOI_OP_DIFF | ((iDr + 2) << 4) | ((iDg + 2) << 2) | (iDb + 2));
+    }
+    else
+    {
+      iDr = (int8_t) (iDr - iDg);
+      iDb = (int8_t) (iDb - iDg);
+
+      if ((-32 <= iDg) && (iDg <= 31) && (-8 <= iDr) && (iDr <= 7) && (-8 <= iDb) && (iDb <= 7))
+      {
+        putQoiByte(QOI_OP_LUMA | (iDg + 32));
+        putQoiByte(((iDr + 8) << 4) | (iDb + 8));
+      }
+      else
+      {
+        putQoiByte(QOI_OP_RGB);
+        putQoiByte(pColour->r);
+        putQoiByte(pColour->g);
+        putQoiByte(pColour->b);
+      }
+    }
+  }
+
+  s_tQoi.tPrev.r     = pColour->r;
+  s_tQoi.tPrev.g     = pColour->g;
+  s_tQoi.tPrev.b     = pColour->b;
+  s_tQoi.uiPrevIndex = uiIndex;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/*                                                                            */
+/*----------------------------------------------------------------------------*/
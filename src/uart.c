@@ -0,0 +1,349 @@
+/*-----------------------------------------------------------------------------+
+|                                                                              |
+| filename: uart.c                                                             |
+| project:  zxn::scrnshot                                                      |
+| author:   S. Zell                                                            |
+| date:     10/18/2026                                                         |
+|                                                                              |
++------------------------------------------------------------------------------+
+|                                                                              |
+| description:                                                                 |
+|                                                                              |
+| Transfer of screenshots over the UART to a host receiver                     |
+|                                                                              |
++------------------------------------------------------------------------------+
+|                                                                              |
+| Copyright (c) 10/18/2026 STZ Engineering                                     |
+|                                                                              |
+| This software is provided  "as is",  without warranty of any kind, express   |
+| or implied. In no event shall STZ or its contributors be held liable for any |
+| direct, indirect, incidental, special or consequential damages arising out   |
+| of the use of or inability to use this software.                             |
+|                                                                              |
+| Permission is granted to anyone  to use this  software for any purpose,      |
+| including commercial applications,  and to alter it and redistribute it      |
+| freely, subject to the following restrictions:                               |
+|                                                                              |
+| 1. Redistributions of source code must retain the above copyright            |
+|    notice, definition, disclaimer, and this list of conditions.              |
+|                                                                              |
+| 2. Redistributions in binary form must reproduce the above copyright         |
+|    notice, definition, disclaimer, and this list of conditions in            |
+|    documentation and/or other materials provided with the distribution.      |
+|                                                                          ;-) |
++-----------------------------------------------------------------------------*/
+
+/*============================================================================*/
+/*                               Includes                                     */
+/*============================================================================*/
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <z80.h>
+#include <arch/zxn.h>
+#include <arch/zxn/esxdos.h>
+
+#include "libzxn.h"
+#include "scrnshot.h"
+#include "uart.h"
+#include "version.h"
+
+/*============================================================================*/
+/*                               Defines                                      */
+/*============================================================================*/
+/*!
+Ports of the UART:
+0x133B: write = send byte, read = status
+0x143B: write = baud rate prescaler (bit 7 = 0: bits 6:0, 1: bits 13:7)
+0x153B: bit 6 = selected UART (0 = ESP, 1 = Pi), bit 4 = write bits 16:14 of
+        the prescaler (bits 2:0)
+*/
+#define UART_PORT_TX     0x133B
+#define UART_PORT_RX     0x143B
+#define UART_PORT_SELECT 0x153B
+
+/*!
+Status of the UART: transmit buffer is full
+*/
+#define UART_STATUS_TX_FULL 0x02
+
+/*!
+Payload of the packet that is filled
+*/
+#define UART_FILL_PAYLOAD() (&s_tUart.auiPacket[s_tUart.uiFill][4])
+
+/*============================================================================*/
+/*                               Namespaces                                   */
+/*============================================================================*/
+
+/*============================================================================*/
+/*                               Constants                                    */
+/*============================================================================*/
+/*!
+Clock of the UART for all video timings (NextReg 0x11)
+*/
+static const uint32_t s_auiUartClock[8] =
+{
+  28000000, 28571429, 29464286, 30000000, 31000000, 32000000, 33000000, 27000000
+};
+
+/*============================================================================*/
+/*                               Variables                                    */
+/*============================================================================*/
+/*!
+In dieser Struktur werden alle globalen Daten der Anwendung gespeichert.
+*/
+extern appstate_t g_tState;
+
+/*!
+State of the transfer: one packet is filled while the other is sent
+*/
+static struct _uartstate
+{
+  uint8_t  auiPacket[2][UART_PAYLOAD_MAX + UART_PKT_OVERHEAD];
+  uint8_t  uiFill;      /* Packet that is filled                    */
+  uint8_t  uiSend;      /* Packet that is sent                      */
+  uint16_t uiSendPos;   /* Next byte of the packet to send          */
+  uint16_t uiSendLen;   /* Length of the packet to send (0 = idle)  */
+  uint8_t  uiSeq;       /* Sequence number of the next packet       */
+  uint32_t uiLength;    /* Number of image bytes sent               */
+} s_tUart;
+
+/*============================================================================*/
+/*                               Structures                                   */
+/*============================================================================*/
+
+/*============================================================================*/
+/*                               Type-Definitions                             */
+/*============================================================================*/
+
+/*============================================================================*/
+/*                               Prototypes                                   */
+/*============================================================================*/
+/*!
+Sends bytes of the pending packet as long as the UART accepts them
+*/
+static void pumpUart(void);
+
+/*!
+Completes the packet that is filled (header, checksum) and hands it over to
+the transmitter; waits for the previous packet.
+*/
+static void queueUartPacket(uint8_t uiType);
+
+/*============================================================================*/
+/*                               Classes                                      */
+/*============================================================================*/
+
+/*============================================================================*/
+/*                               Implementation                               */
+/*============================================================================*/
+
+/*----------------------------------------------------------------------------*/
+/* sendUartImage()                                                            */
+/*----------------------------------------------------------------------------*/
+int sendUartImage(const screenmode_t* pInfo, const char_t* acExt)
+{
+  int iReturn;
+  char_t acName[0x20];
+  const char_t* acBase = strrchr(g_tState.bmpfile.acPathName, '/');
+
+  acBase = (0 != acBase ? acBase + 1 : g_tState.bmpfile.acPathName);
+
+  /* Name of the image: given filename or default name */
+  if ((0 != acBase[0]) && (0 != strchr(acBase, '.')))
+  {
+    snprintf(acName, sizeof(acName), "%s", acBase);
+  }
+  else
+  {
+    snprintf(acName, sizeof(acName), VER_INTERNALNAME_STR ".%s", acExt);
+  }
+
+  if (EOK == (iReturn = openUart(acName)))
+  {
+    iReturn = captureImage(pInfo);
+    iReturn = closeUart(iReturn);
+  }
+
+  return iReturn;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* openUart()                                                                 */
+/*----------------------------------------------------------------------------*/
+int openUart(const char_t* acName)
+{
+  uint32_t uiClock = s_auiUartClock[ZXN_READ_REG(0x11) & 0x07];
+  uint32_t uiPrescaler = (uiClock + (UART_BAUD / 2)) / UART_BAUD;
+  uint16_t uiLen = strlen(acName);
+
+  if (UART_PAYLOAD_MAX < uiLen)
+  {
+    return EINVAL;
+  }
+
+  /* Baud rate: keep the selected UART (ESP, Pi) */
+  z80_outp(UART_PORT_SELECT, (z80_inp(UART_PORT_SELECT) & 0x40) | 0x10 | ((uint8_t) (uiPrescaler >> 14) & 0x07));
+  z80_outp(UART_PORT_RX, 0x80 | ((uint8_t) (uiPrescaler >> 7) & 0x7F));
+  z80_outp(UART_PORT_RX, (uint8_t) uiPrescaler & 0x7F);
+
+  s_tUart.uiFill    = 0;
+  s_tUart.uiSend    = 1;
+  s_tUart.uiSendPos = 0;
+  s_tUart.uiSendLen = 0;
+  s_tUart.uiSeq     = 0;
+  s_tUart.uiLength  = 0;
+
+  memcpy(UART_FILL_PAYLOAD(), acName, uiLen);
+  s_tUart.auiPacket[s_tUart.uiFill][3] = (uint8_t) uiLen;
+  queueUartPacket(UART_PKT_START);
+
+  return EOK;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* writeUartData()                                                            */
+/*----------------------------------------------------------------------------*/
+int writeUartData(const void* pData, uint16_t uiLen)
+{
+  const uint8_t* pSrc = (const uint8_t*) pData;
+  uint8_t* pPacket;
+  uint16_t uiChunk;
+
+  while (0 < uiLen)
+  {
+    pPacket = s_tUart.auiPacket[s_tUart.uiFill];
+    uiChunk = UART_PAYLOAD_MAX - pPacket[3];
+    uiChunk = (uiLen < uiChunk ? uiLen : uiChunk);
+
+    memcpy(&pPacket[4 + pPacket[3]], pSrc, uiChunk);
+    pPacket[3] += (uint8_t) uiChunk;
+
+    s_tUart.uiLength += uiChunk;
+    pSrc             += uiChunk;
+    uiLen            -= uiChunk;
+
+    if (UART_PAYLOAD_MAX == pPacket[3])
+    {
+      queueUartPacket(UART_PKT_DATA);
+    }
+  }
+
+  /* Transmit while the encoder produces the next data */
+  pumpUart();
+
+  return EOK;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* closeUart()                                                                */
+/*----------------------------------------------------------------------------*/
+int closeUart(int iResult)
+{
+  uint8_t* pPayload;
+
+  if (EOK == iResult)
+  {
+    if (0 != s_tUart.auiPacket[s_tUart.uiFill][3])
+    {
+      queueUartPacket(UART_PKT_DATA);
+    }
+
+    pPayload = UART_FILL_PAYLOAD();
+    pPayload[0] = (uint8_t) (s_tUart.uiLength      );
+    pPayload[1] = (uint8_t) (s_tUart.uiLength >>  8);
+    pPayload[2] = (uint8_t) (s_tUart.uiLength >> 16);
+    pPayload[3] = (uint8_t) (s_tUart.uiLength >> 24);
+    s_tUart.auiPacket[s_tUart.uiFill][3] = 4;
+    queueUartPacket(UART_PKT_END);
+  }
+  else
+  {
+    s_tUart.auiPacket[s_tUart.uiFill][3] = 0;
+    queueUartPacket(UART_PKT_ABORT);
+  }
+
+  /* Wait for the last packet */
+  while (0 != s_tUart.uiSendLen)
+  {
+    pumpUart();
+  }
+
+  return iResult;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* pumpUart()                                                                 */
+/*----------------------------------------------------------------------------*/
+static void pumpUart(void)
+{
+  const uint8_t* pPacket = s_tUart.auiPacket[s_tUart.uiSend];
+
+  while ((s_tUart.uiSendPos < s_tUart.uiSendLen) && !(z80_inp(UART_PORT_TX) & UART_STATUS_TX_FULL))
+  {
+    z80_outp(UART_PORT_TX, pPacket[s_tUart.uiSendPos++]);
+  }
+
+  if (s_tUart.uiSendPos >= s_tUart.uiSendLen)
+  {
+    s_tUart.uiSendLen = 0;
+  }
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* queueUartPacket()                                                          */
+/*----------------------------------------------------------------------------*/
+static void queueUartPacket(uint8_t uiType)
+{
+  uint8_t* pPacket = s_tUart.auiPacket[s_tUart.uiFill];
+  uint16_t uiLen   = 4 + pPacket[3];
+  uint16_t uiSum1  = 0;
+  uint16_t uiSum2  = 0;
+
+  pPacket[0] = UART_PKT_SYNC;
+  pPacket[1] = uiType;
+  pPacket[2] = s_tUart.uiSeq++;
+
+  /* Fletcher-16 of TYPE, SEQ, LEN and PAYLOAD */
+  for (uint16_t i = 1; i < uiLen; ++i)
+  {
+    if (255 <= (uiSum1 += pPacket[i]))
+    {
+      uiSum1 -= 255;
+    }
+
+    if (255 <= (uiSum2 += uiSum1))
+    {
+      uiSum2 -= 255;
+    }
+  }
+
+  pPacket[uiLen++] = (uint8_t) uiSum1;
+  pPacket[uiLen++] = (uint8_t) uiSum2;
+
+  /* Double buffering: wait for the previous packet, then swap */
+  while (0 != s_tUart.uiSendLen)
+  {
+    pumpUart();
+  }
+
+  s_tUart.uiSend    = s_tUart.uiFill;
+  s_tUart.uiSendPos = 0;
+  s_tUart.uiSendLen = uiLen;
+  s_tUart.uiFill   ^= 1;
+  s_tUart.auiPacket[s_tUart.uiFill][3] = 0;
+
+  pumpUart();
+}
+
+
+/*----------------------------------------------------------------------------*/
+/*                                                                            */
+/*----------------------------------------------------------------------------*/
@@ -0,0 +1,335 @@
+/*-----------------------------------------------------------------------------+
+|                                                                              |
+| filename: vstate.c                                                           |
+| project:  zxn::scrnshot                                                      |
+| author:   S. Zell                                                            |
+| date:     10/18/2026                                                         |
+|                                                                              |
++------------------------------------------------------------------------------+
+|                                                                              |
+| description:                                                                 |
+|                                                                              |
+| Dump of the complete state of the video hardware (NextRegs, palettes,        |
+| clip windows, video memory) for a host side renderer                         |
+|                                                                              |
++------------------------------------------------------------------------------+
+|                                                                              |
+| Copyright (c) 10/18/2026 STZ Engineering                                     |
+|                                                                              |
+| This software is provided  "as is",  without warranty of any kind, express   |
+| or implied. In no event shall STZ or its contributors be held liable for any |
+| direct, indirect, incidental, special or consequential damages arising out   |
+| of the use of or inability to use this software.                             |
+|                                                                              |
+| Permission is granted to anyone  to use this  software for any purpose,      |
+| including commercial applications,  and to alter it and redistribute it      |
+| freely, subject to the following restrictions:                               |
+|                                                                              |
+| 1. Redistributions of source code must retain the above copyright            |
+|    notice, definition, disclaimer, and this list of conditions.              |
+|                                                                              |
+| 2. Redistributions in binary form must reproduce the above copyright         |
+|    notice, definition, disclaimer, and this list of conditions in            |
+|    documentation and/or other materials provided with the distribution.      |
+|                                                                          ;-) |
++-----------------------------------------------------------------------------*/
+
+/*============================================================================*/
+/*                               Includes                                     */
+/*============================================================================*/
+#include <stdint.h>
+#include <errno.h>
+#include <string.h>
+#include <z80.h>
+#include <intrinsic.h>
+#include <arch/zxn.h>
+#include <arch/zxn/esxdos.h>
+
+#include "libzxn.h"
+#include "scrnshot.h"
+#include "vstate.h"
+#include "bench.h"
+
+/*============================================================================*/
+/*                               Defines                                      */
+/*============================================================================*/
+/*!
+Maximum number of 8K pages of a dump: ULA (bank 5), shadow screen/tilemap
+(bank 7) and Layer 2 (up to 10 pages)
+*/
+#define VSTATE_PAGES_MAX 14
+
+/*============================================================================*/
+/*                               Namespaces                                   */
+/*============================================================================*/
+
+/*============================================================================*/
+/*                               Constants                                    */
+/*============================================================================*/
+
+/*============================================================================*/
+/*                               Variables                                    */
+/*============================================================================*/
+/*!
+In dieser Struktur werden alle globalen Daten der Anwendung gespeichert.
+*/
+extern appstate_t g_tState;
+
+/*============================================================================*/
+/*                               Structures                                   */
+/*============================================================================*/
+
+/*============================================================================*/
+/*                               Type-Definitions                             */
+/*============================================================================*/
+
+/*============================================================================*/
+/*                               Prototypes                                   */
+/*============================================================================*/
+/*!
+Writes the header of a chunk and - if given - its payload
+*/
+static int saveStateChunk(uint8_t uiType, uint8_t uiId, uint32_t uiSize, const void* pData);
+
+/*!
+Reads the four clip windows (Layer 2, sprites, ULA, tilemap; 4 bytes each).
+The registers can only be read at the current index, so every value is
+written back to step to the next one; the indices are restored afterwards.
+*/
+static void readClipWindows(uint8_t* pData);
+
+/*!
+Saves all colour palettes (chunk "PALETTE" per palette)
+*/
+static int saveStatePalettes(void);
+
+/*!
+Saves one 8K page (chunk "PAGE"); the page is mapped to MMU2
+*/
+static int saveStatePage(uint8_t uiPage);
+
+/*============================================================================*/
+/*                               Classes                                      */
+/*============================================================================*/
+
+/*============================================================================*/
+/*                               Implementation                               */
+/*============================================================================*/
+
+/*----------------------------------------------------------------------------*/
+/* saveStateImage()                                                           */
+/*----------------------------------------------------------------------------*/
+int saveStateImage(const screenmode_t* pInfo)
+{
+  int iReturn = EOK;
+  vstateheader_t tHeader;
+  uint8_t auiRegs[VSTATE_REGS];
+  uint8_t auiClip[16];
+  uint8_t auiPorts[6];
+  uint8_t auiPages[VSTATE_PAGES_MAX];
+  uint8_t uiPages = 0;
+
+  if (0 == pInfo)
+  {
+    return EINVAL;
+  }
+
+  /* NextRegs as seen by the video hardware */
+  for (uint8_t i = 0; i < VSTATE_REGS; ++i)
+  {
+    auiRegs[i] = ZXN_READ_REG(i);
+  }
+
+  readClipWindows(auiClip);
+
+  /* Timex port (mode, hi-res colour) and Layer 2 port (enable, mapping) */
+  auiPorts[0] = 0xFF;
+  auiPorts[1] = 0x00;
+  auiPorts[2] = z80_inp(0xFF);
+  auiPorts[3] = 0x3B;
+  auiPorts[4] = 0x12;
+  auiPorts[5] = z80_inp(0x123B);
+
+  /* Pages in use: ULA (bank 5) ... */
+  auiPages[uiPages++] = 10;
+  auiPages[uiPages++] = 11;
+
+  /* ... shadow screen (NREG 0x69 bit 6) or tilemap in bank 7 (NREG 0x6B
+     bit 7, NREG 0x6E bit 7) ... */
+  if ((auiRegs[0x69] & 0x40) || ((auiRegs[0x6B] & 0x80) && (auiRegs[0x6E] & 0x80)))
+  {
+    auiPages[uiPages++] = 14;
+    auiPages[uiPages++] = 15;
+  }
+
+  /* ... and Layer 2 (NREG 0x69 bit 7; 256x192: 6 pages, 320x256 and 640x256:
+     10 pages) */
+  if (auiRegs[0x69] & 0x80)
+  {
+    uint8_t uiPage = auiRegs[0x12] << 1; /* 16K bank => 8K page */
+    uint8_t uiCount = (auiRegs[0x70] & 0x30) ? 10 : 6;
+
+    for (uint8_t i = 0; i < uiCount; ++i)
+    {
+      auiPages[uiPages++] = uiPage + i;
+    }
+  }
+
+  /* Header */
+  memcpy(tHeader.acMagic, VSTATE_MAGIC, sizeof(tHeader.acMagic));
+  tHeader.uiVersion = VSTATE_VERSION;
+  tHeader.uiMode    = pInfo->uiMode;
+  tHeader.uiChunks  = 3 + VSTATE_PALETTES + uiPages;
+
+  iReturn = writeImageData(&tHeader, sizeof(tHeader));
+
+  if (EOK == iReturn)
+  {
+    iReturn = saveStateChunk(VSTATE_CHUNK_REGS, 0, sizeof(auiRegs), auiRegs);
+  }
+
+  if (EOK == iReturn)
+  {
+    iReturn = saveStateChunk(VSTATE_CHUNK_CLIP, 0, sizeof(auiClip), auiClip);
+  }
+
+  if (EOK == iReturn)
+  {
+    iReturn = saveStateChunk(VSTATE_CHUNK_PORTS, 0, sizeof(auiPorts), auiPorts);
+  }
+
+  if (EOK == iReturn)
+  {
+    iReturn = saveStatePalettes();
+  }
+
+  for (uint8_t i = 0; (EOK == iReturn) && (i < uiPages); ++i)
+  {
+    iReturn = saveStatePage(auiPages[i]);
+  }
+
+  return iReturn;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* saveStateChunk()                                                           */
+/*----------------------------------------------------------------------------*/
+static int saveStateChunk(uint8_t uiType, uint8_t uiId, uint32_t uiSize, const void* pData)
+{
+  int iReturn;
+  vstatechunk_t tChunk;
+
+  tChunk.uiType = uiType;
+  tChunk.uiId   = uiId;
+  tChunk.uiRes  = 0;
+  tChunk.uiSize = uiSize;
+
+  iReturn = writeImageData(&tChunk, sizeof(tChunk));
+
+  if ((EOK == iReturn) && (0 != pData))
+  {
+    iReturn = writeImageData(pData, (uint16_t) uiSize);
+  }
+
+  return iReturn;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* readClipWindows()                                                          */
+/*----------------------------------------------------------------------------*/
+static void readClipWindows(uint8_t* pData)
+{
+  uint8_t uiIndex = ZXN_READ_REG(0x1C); /* 2 bits per window */
+
+  ZXN_WRITE_REG(0x1C, 0x0F); /* reset all indices */
+
+  for (uint8_t i = 0; i < 4; ++i)
+  {
+    for (uint8_t j = 0; j < 4; ++j)
+    {
+      pData[(i << 2) + j] = ZXN_READ_REG(0x18 + i);
+      ZXN_WRITE_REG(0x18 + i, pData[(i << 2) + j]);
+    }
+
+    /* The index has wrapped around: step to the previous position */
+    for (uint8_t j = 0; j < ((uiIndex >> (i << 1)) & 0x03); ++j)
+    {
+      ZXN_WRITE_REG(0x18 + i, pData[(i << 2) + j]);
+    }
+  }
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* saveStatePalettes()                                                        */
+/*----------------------------------------------------------------------------*/
+static int saveStatePalettes(void)
+{
+  int iReturn = EOK;
+  uint8_t auiBuffer[64];
+  uint8_t uiLen;
+  uint8_t uiPalIdx = ZXN_READ_REG(REG_PALETTE_INDEX);
+  uint8_t uiPalCtl = ZXN_READ_REG(REG_PALETTE_CONTROL);
+
+  for (uint8_t uiPal = 0; (EOK == iReturn) && (uiPal < VSTATE_PALETTES); ++uiPal)
+  {
+    ZXN_WRITE_REG(REG_PALETTE_CONTROL, (uiPalCtl & 0x8F) | (uiPal << 4));
+
+    iReturn = saveStateChunk(VSTATE_CHUNK_PALETTE, uiPal, 512, 0);
+    uiLen   = 0;
+
+    for (uint16_t i = 0; (EOK == iReturn) && (i < 256); ++i)
+    {
+      ZXN_WRITE_REG(REG_PALETTE_INDEX, (uint8_t) i);
+
+      auiBuffer[uiLen++] = ZXN_READ_REG(REG_PALETTE_VALUE_8);
+      auiBuffer[uiLen++] = ZXN_READ_REG(REG_PALETTE_VALUE_16);
+
+      if (sizeof(auiBuffer) == uiLen)
+      {
+        iReturn = writeImageData(auiBuffer, uiLen);
+        uiLen = 0;
+      }
+    }
+
+    STATS_PALETTE(1 + 3 * 256);
+  }
+
+  ZXN_WRITE_REG(REG_PALETTE_INDEX,   uiPalIdx);
+  ZXN_WRITE_REG(REG_PALETTE_CONTROL, uiPalCtl);
+
+  STATS_PALETTE(4);
+
+  return iReturn;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* saveStatePage()                                                            */
+/*----------------------------------------------------------------------------*/
+static int saveStatePage(uint8_t uiPage)
+{
+  int iReturn = saveStateChunk(VSTATE_CHUNK_PAGE, uiPage, 0x2000, 0);
+  uint8_t uiMMU2;
+
+  if (EOK == iReturn)
+  {
+    STATS_DI();
+    uiMMU2 = ZXN_READ_MMU2();
+    STATS_MMU2(uiPage);
+
+    iReturn = writeImageData(zxn_memmap(0x4000), 0x2000);
+
+    STATS_MMU2(uiMMU2);
+    STATS_EI();
+  }
+
+  return iReturn;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/*                                                                            */
+/*----------------------------------------------------------------------------*/
@@ -0,0 +1,135 @@
+/*-----------------------------------------------------------------------------+
+|                                                                              |
+| filename: walker.c                                                           |
+| project:  zxn::scrnshot                                                      |
+| author:   S. Zell                                                            |
+| date:     10/18/2026                                                         |
+|                                                                              |
++------------------------------------------------------------------------------+
+|                                                                              |
+| description:                                                                 |
+|                                                                              |
+| Row walker over the ULA and Timex screen layout                              |
+|                                                                              |
++------------------------------------------------------------------------------+
+|                                                                              |
+| Copyright (c) 10/18/2026 STZ Engineering                                     |
+|                                                                              |
+| This software is provided  "as is",  without warranty of any kind, express   |
+| or implied. In no event shall STZ or its contributors be held liable for any |
+| direct, indirect, incidental, special or consequential damages arising out   |
+| of the use of or inability to use this software.                             |
+|                                                                              |
+| Permission is granted to anyone  to use this  software for any purpose,      |
+| including commercial applications,  and to alter it and redistribute it      |
+| freely, subject to the following restrictions:                               |
+|                                                                              |
+| 1. Redistributions of source code must retain the above copyright            |
+|    notice, definition, disclaimer, and this list of conditions.              |
+|                                                                              |
+| 2. Redistributions in binary form must reproduce the above copyright         |
+|    notice, definition, disclaimer, and this list of conditions in            |
+|    documentation and/or other materials provided with the distribution.      |
+|                                                                          ;-) |
++-----------------------------------------------------------------------------*/
+
+/*============================================================================*/
+/*                               Includes                                     */
+/*============================================================================*/
+#include <stdint.h>
+
+#include "walker.h"
+
+/*============================================================================*/
+/*                               Defines                                      */
+/*============================================================================*/
+/*!
+Bits of the row offset: pixel line in the cell, character row in the third,
+third of the screen
+*/
+#define WALK_LINE  0x0700
+#define WALK_ROW   0x00E0
+#define WALK_THIRD 0x0800
+
+/*============================================================================*/
+/*                               Namespaces                                   */
+/*============================================================================*/
+
+/*============================================================================*/
+/*                               Constants                                    */
+/*============================================================================*/
+
+/*============================================================================*/
+/*                               Variables                                    */
+/*============================================================================*/
+
+/*============================================================================*/
+/*                               Structures                                   */
+/*============================================================================*/
+
+/*============================================================================*/
+/*                               Type-Definitions                             */
+/*============================================================================*/
+
+/*============================================================================*/
+/*                               Prototypes                                   */
+/*============================================================================*/
+
+/*============================================================================*/
+/*                               Classes                                      */
+/*============================================================================*/
+
+/*============================================================================*/
+/*                               Implementation                               */
+/*============================================================================*/
+
+/*----------------------------------------------------------------------------*/
+/* initUlaWalk()                                                              */
+/*----------------------------------------------------------------------------*/
+void initUlaWalk(ulawalk_t* pWalk, const uint8_t* pScreen, const uint8_t* pAttrs, uint8_t uiY)
+{
+  pWalk->uiOffset = (((uint16_t) (uiY & 0x07)) << 8)   /* line in the cell         */
+                  | (((uint16_t) (uiY & 0x38)) << 2)   /* character row            */
+                  | (((uint16_t) (uiY & 0xC0)) << 5);  /* third                    */
+  pWalk->pPixel   = pScreen + pWalk->uiOffset;
+  pWalk->pAttr    = pAttrs + (((uint16_t) (uiY >> 3)) << 5);
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* stepUlaWalk()                                                              */
+/*----------------------------------------------------------------------------*/
+void stepUlaWalk(ulawalk_t* pWalk, int8_t iStep)
+{
+  uint16_t uiOffset = pWalk->uiOffset;
+
+  /* Lines of the cell; a carry/borrow of the line bits goes into the third */
+  uiOffset += ((int16_t) iStep) << 8;
+
+  if (0 < iStep)
+  {
+    if (0 == (uiOffset & WALK_LINE))
+    {
+      /* Next character row; from the last row of a third keep the carry */
+      uiOffset += ((WALK_ROW != (uiOffset & WALK_ROW)) ? 0x0020 - WALK_THIRD : -WALK_ROW);
+      pWalk->pAttr += 32;
+    }
+  }
+  else
+  {
+    if (((uint16_t) (-iStep << 8)) > (pWalk->uiOffset & WALK_LINE))
+    {
+      /* Previous character row; from the first row of a third keep the borrow */
+      uiOffset += ((0 != (uiOffset & WALK_ROW)) ? WALK_THIRD - 0x0020 : WALK_ROW);
+      pWalk->pAttr -= 32;
+    }
+  }
+
+  pWalk->pPixel  += (int16_t) (uiOffset - pWalk->uiOffset);
+  pWalk->uiOffset = uiOffset;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/*                                                                            */
+/*----------------------------------------------------------------------------*/
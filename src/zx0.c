@@ -0,0 +1,795 @@
+/*-----------------------------------------------------------------------------+
+|                                                                              |
+| filename: zx0.c                                                              |
+| project:  zxn::scrnshot                                                      |
+| author:   S. Zell                                                            |
+| date:     10/18/2026                                                         |
+|                                                                              |
++------------------------------------------------------------------------------+
+|                                                                              |
+| description:                                                                 |
+|                                                                              |
+| Compressed screen files (ZX0) and loader                                     |
+|                                                                              |
++------------------------------------------------------------------------------+
+|                                                                              |
+| Copyright (c) 10/18/2026 STZ Engineering                                     |
+|                                                                              |
+| This software is provided  "as is",  without warranty of any kind, express   |
+| or implied. In no event shall STZ or its contributors be held liable for any |
+| direct, indirect, incidental, special or consequential damages arising out   |
+| of the use of or inability to use this software.                             |
+|                                                                              |
+| Permission is granted to anyone  to use this  software for any purpose,      |
+| including commercial applications,  and to alter it and redistribute it      |
+| freely, subject to the following restrictions:                               |
+|                                                                              |
+| 1. Redistributions of source code must retain the above copyright            |
+|    notice, definition, disclaimer, and this list of conditions.              |
+|                                                                              |
+| 2. Redistributions in binary form must reproduce the above copyright         |
+|    notice, definition, disclaimer, and this list of conditions in            |
+|    documentation and/or other materials provided with the distribution.      |
+|                                                                          ;-) |
++-----------------------------------------------------------------------------*/
+
+/*============================================================================*/
+/*                               Includes                                     */
+/*============================================================================*/
+#include <stdint.h>
+#include <errno.h>
+#include <string.h>
+#include <z80.h>
+#include <intrinsic.h>
+#include <compress/zx0.h>
+#include <arch/zxn.h>
+#include <arch/zxn/esxdos.h>
+
+#include "libzxn.h"
+#include "scrnshot.h"
+#include "zx0.h"
+#include "bench.h"
+
+/*============================================================================*/
+/*                               Defines                                      */
+/*============================================================================*/
+/*!
+Address of the MMU slot the video memory is mapped to while (de)compressing;
+the compressed data is kept in the work bank (WORK_BANK_ADDR)
+*/
+#define ZX0_VIDEO_ADDR 0x4000
+
+/*!
+Number of entries of the hash table of the compressor
+*/
+#define ZX0_HASH_SIZE 1024
+#define ZX0_HASH_MASK (ZX0_HASH_SIZE - 1)
+#define ZX0_NO_POS    0xFFFF
+
+/*!
+Maximum offset of a ZX0 match
+*/
+#define ZX0_MAX_OFFSET 32640
+
+/*!
+Types of the blocks of a compressed screen file
+*/
+#define ZX0_BLOCK_MEMORY  0   /* region of the Z80 address space (ULA)  */
+#define ZX0_BLOCK_LAYER2  1   /* 8K page of layer 2 (relative to 0x12)  */
+#define ZX0_BLOCK_PALETTE 2   /* palette: 2 bytes per colour (NXI)      */
+#define ZX0_BLOCK_PORT    3   /* value of Timex port 0xFF               */
+
+/*============================================================================*/
+/*                               Namespaces                                   */
+/*============================================================================*/
+
+/*============================================================================*/
+/*                               Constants                                    */
+/*============================================================================*/
+/*!
+Signature of a compressed screen file
+*/
+static const char_t s_acZx0Magic[4] = {'S', 'C', 'Z', '0'};
+
+/*============================================================================*/
+/*                               Structures                                   */
+/*============================================================================*/
+/*!
+File header of a compressed screen file
+*/
+typedef struct _zx0fileheader
+{
+  char_t  acMagic[4];   /* "SCZ0"                  */
+  uint8_t uiMode;       /* screen mode (0x00, ...) */
+  uint8_t uiReserved;
+} zx0fileheader_t;
+
+/*!
+Header of a block of a compressed screen file
+*/
+typedef struct _zx0blockheader
+{
+  uint8_t  uiType;      /* ZX0_BLOCK_...                              */
+  uint8_t  uiPage;      /* layer 2: page relative to the active bank  */
+  uint16_t uiAddr;      /* memory: address in the Z80 address space   */
+  uint16_t uiSize;      /* size of the uncompressed data              */
+  uint16_t uiPacked;    /* size of the data; "uiSize" = not compressed */
+} zx0blockheader_t;
+
+/*!
+State of the ZX0 compressor
+*/
+typedef struct _zx0state
+{
+  uint8_t  uiBank;                  /* work bank (compressed data)  */
+  uint8_t* pOut;                    /* output buffer                */
+  uint16_t uiOut;                   /* bytes in the output buffer   */
+  uint16_t uiMax;                   /* size of the output buffer    */
+  uint16_t uiBitIdx;                /* index of the current bit byte */
+  uint8_t  uiBitMask;               /* next bit of the bit byte     */
+  bool     bBacktrack;              /* next bit goes to the LSB byte */
+  uint16_t auiHead[ZX0_HASH_SIZE];  /* last position per hash value */
+} zx0state_t;
+
+/*============================================================================*/
+/*                               Variables                                    */
+/*============================================================================*/
+/*!
+In dieser Struktur werden alle globalen Daten der Anwendung gespeichert.
+*/
+extern appstate_t g_tState;
+
+/*!
+State of the ZX0 compressor
+*/
+static zx0state_t s_tZx0;
+
+/*============================================================================*/
+/*                               Type-Definitions                             */
+/*============================================================================*/
+
+/*============================================================================*/
+/*                               Prototypes                                   */
+/*============================================================================*/
+/*!
+Compresses a block of video memory and saves it to the output file
+*/
+static int saveZx0Block(uint8_t uiType, uint8_t uiPage, uint8_t uiPhysPage, uint16_t uiAddr, uint16_t uiSize);
+
+/*!
+Saves a block without compression (palette, port)
+*/
+static int saveZx0Raw(uint8_t uiType, const void* pData, uint16_t uiSize);
+
+/*!
+Saves the active palette of the screen mode (2 bytes per colour, like NXI)
+*/
+static int saveZx0Palette(const screenmode_t* pInfo);
+
+/*!
+Reads a block from the input file and decompresses it to video memory
+*/
+static int loadZx0Block(uint8_t uiPhysPage, const zx0blockheader_t* pHeader);
+
+/*!
+Compresses data in ZX0 format (greedy parsing).
+@return Size of the compressed data; "0" = does not fit into "uiMax" bytes
+*/
+static uint16_t packZx0(const uint8_t* pSrc, uint16_t uiLen, uint8_t* pDst, uint16_t uiMax);
+
+/*!
+Appends a byte / a bit / an interlaced Elias gamma code to the output
+*/
+static void putZx0Byte(uint8_t uiByte);
+static void putZx0Bit(uint8_t uiBit);
+static void putZx0Gamma(uint16_t uiValue, uint8_t uiInvert);
+
+/*============================================================================*/
+/*                               Classes                                      */
+/*============================================================================*/
+
+/*============================================================================*/
+/*                               Implementation                               */
+/*============================================================================*/
+
+/*----------------------------------------------------------------------------*/
+/* saveZx0Image()                                                             */
+/*----------------------------------------------------------------------------*/
+int saveZx0Image(const screenmode_t* pInfo)
+{
+  int iReturn = EOK;
+
+  if (0 == pInfo)
+  {
+    iReturn = EINVAL;
+  }
+  else if (INV_BANK == (s_tZx0.uiBank = allocBank()))
+  {
+    iReturn = ENOMEM;
+  }
+
+  /* File header */
+  if (EOK == iReturn)
+  {
+    zx0fileheader_t tHeader;
+
+    memcpy(tHeader.acMagic, s_acZx0Magic, sizeof(tHeader.acMagic));
+    tHeader.uiMode     = pInfo->uiMode;
+    tHeader.uiReserved = 0;
+
+    iReturn = writeImageData(&tHeader, sizeof(tHeader));
+  }
+
+  /* Palette (LAYER 1,2: colours of port 0xFF, see below) */
+  if ((EOK == iReturn) && (0x12 != pInfo->uiMode))
+  {
+    iReturn = saveZx0Palette(pInfo);
+  }
+
+  if (EOK == iReturn)
+  {
+    switch (pInfo->uiMode)
+    {
+      /* ULA, Timex: pixel and attribute memory */
+      case 0x00:
+      case 0x10:
+      case 0x11:
+      case 0x12:
+      case 0x13:
+        iReturn = saveZx0Block(ZX0_BLOCK_MEMORY, 0,
+                               pInfo->tMemPixel.uiAddr < 0x6000 ? ZXN_READ_MMU2() : ZXN_READ_MMU3(),
+                               pInfo->tMemPixel.uiAddr, pInfo->tMemPixel.uiSize);
+
+        if (EOK == iReturn)
+        {
+          iReturn = saveZx0Block(ZX0_BLOCK_MEMORY, 0,
+                                 pInfo->tMemAttr.uiAddr < 0x6000 ? ZXN_READ_MMU2() : ZXN_READ_MMU3(),
+                                 pInfo->tMemAttr.uiAddr, pInfo->tMemAttr.uiSize);
+        }
+
+        if ((EOK == iReturn) && (0x12 == pInfo->uiMode))
+        {
+          uint8_t uiPort = z80_inp(0xFF);
+          iReturn = saveZx0Raw(ZX0_BLOCK_PORT, &uiPort, sizeof(uiPort));
+        }
+        break;
+
+      /* Layer 2: all 8K pages */
+      case 0x20:
+      case 0x22:
+      case 0x23:
+      {
+        uint8_t  uiPhysBank = getLayer2Page(); /* 0x12 L2.ACTIVE.RAM.BANK or snapshot | 8K bank */
+        uint8_t  uiPages = (uint8_t) ((((uint32_t) pInfo->uiResX) * ((uint32_t) pInfo->uiResY) * (16 == pInfo->uiColors ? 4 : 8)) >> 16);
+
+        for (uint8_t i = 0; (EOK == iReturn) && (i < uiPages); ++i)
+        {
+          iReturn = saveZx0Block(ZX0_BLOCK_LAYER2, i, uiPhysBank + i, 0x0000, pInfo->tMemPixel.uiSize);
+        }
+        break;
+      }
+
+      default:
+        iReturn = ENOTSUP;
+    }
+  }
+
+  if (INV_BANK != s_tZx0.uiBank)
+  {
+    freeBank(s_tZx0.uiBank);
+    s_tZx0.uiBank = INV_BANK;
+  }
+
+  return iReturn;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* loadZx0Image()                                                             */
+/*----------------------------------------------------------------------------*/
+int loadZx0Image(void)
+{
+  int iReturn = EOK;
+  uint8_t uiMode = detectScreenMode();
+  const screenmode_t* pInfo = getScreenModeInfo(uiMode);
+  zx0fileheader_t  tFileHeader;
+  zx0blockheader_t tHeader;
+
+  s_tZx0.uiBank = INV_BANK;
+
+  if (INV_FILE_HND == (g_tState.bmpfile.hFile = esx_f_open(g_tState.bmpfile.acPathName, ESXDOS_MODE_R | ESXDOS_MODE_OE)))
+  {
+    iReturn = ENOENT;
+  }
+  else if (sizeof(tFileHeader) != esx_f_read(g_tState.bmpfile.hFile, &tFileHeader, sizeof(tFileHeader)))
+  {
+    iReturn = EBADF;
+  }
+  else if (0 != memcmp(tFileHeader.acMagic, s_acZx0Magic, sizeof(s_acZx0Magic)))
+  {
+    iReturn = EBADF;
+  }
+  else if ((0 == pInfo) || (tFileHeader.uiMode != uiMode))
+  {
+    iReturn = EINVAL; /* Error: different screen mode */
+  }
+  else if (INV_BANK == (s_tZx0.uiBank = allocBank()))
+  {
+    iReturn = ENOMEM;
+  }
+
+  while (EOK == iReturn)
+  {
+    uint16_t uiRead = esx_f_read(g_tState.bmpfile.hFile, &tHeader, sizeof(tHeader));
+
+    if (0 == uiRead)
+    {
+      break; /* end of file */
+    }
+    else if ((sizeof(tHeader) != uiRead) ||
+             (tHeader.uiSize > 0x2000) || (tHeader.uiPacked > tHeader.uiSize) ||
+             (((tHeader.uiAddr & 0x1FFF) + tHeader.uiSize) > 0x2000))
+    {
+      iReturn = EBADF;
+      break;
+    }
+
+    switch (tHeader.uiType)
+    {
+      case ZX0_BLOCK_MEMORY:
+        if ((tHeader.uiAddr < 0x4000) || (tHeader.uiAddr >= 0x8000))
+        {
+          iReturn = EBADF;
+        }
+        else
+        {
+          iReturn = loadZx0Block(tHeader.uiAddr < 0x6000 ? ZXN_READ_MMU2() : ZXN_READ_MMU3(), &tHeader);
+        }
+        break;
+
+      case ZX0_BLOCK_LAYER2:
+        iReturn = loadZx0Block(getLayer2Page() + tHeader.uiPage, &tHeader);
+        break;
+
+      case ZX0_BLOCK_PALETTE:
+      {
+        uint8_t* pPalette = (uint8_t*) &g_tState.bmpfile.tPalette[0];
+        uint16_t uiColors = tHeader.uiSize >> 1;
+
+        if ((tHeader.uiSize != tHeader.uiPacked) || (uiColors > 256))
+        {
+          iReturn = EBADF;
+        }
+        else if (tHeader.uiSize != esx_f_read(g_tState.bmpfile.hFile, pPalette, tHeader.uiSize))
+        {
+          iReturn = EBADF;
+        }
+        else
+        {
+          /* Expand in place (backwards: 2 bytes -> 4 bytes per entry) */
+          for (uint16_t i = uiColors; i-- > 0; )
+          {
+            uint16_t uiValue = (((uint16_t) pPalette[i << 1]) << 1) | (pPalette[(i << 1) + 1] & 0x01);
+            bmppaletteentry_t* pEntry = &g_tState.bmpfile.tPalette[i];
+
+            pEntry->b = rgb3_to_rgb8( uiValue       & 0x07);
+            pEntry->g = rgb3_to_rgb8((uiValue >> 3) & 0x07);
+            pEntry->r = rgb3_to_rgb8((uiValue >> 6) & 0x07);
+            pEntry->a = 0x00;
+          }
+
+          /* ULA palette: INK 0..15, PAPER 16..31 (as "-l" of a BMP file) */
+          if ((16 == uiColors) && ((0x00 == uiMode) || (0x11 == uiMode) || (0x13 == uiMode)))
+          {
+            memcpy(&g_tState.bmpfile.tPalette[16], &g_tState.bmpfile.tPalette[0], 16 * sizeof(bmppaletteentry_t));
+            uiColors = 32;
+          }
+
+          iReturn = writeColourPalette(pInfo, uiColors);
+        }
+        break;
+      }
+
+      case ZX0_BLOCK_PORT:
+      {
+        uint8_t uiPort;
+
+        if ((sizeof(uiPort) != tHeader.uiSize) || (sizeof(uiPort) != esx_f_read(g_tState.bmpfile.hFile, &uiPort, sizeof(uiPort))))
+        {
+          iReturn = EBADF;
+        }
+        else
+        {
+          z80_outp(0xFF, uiPort);
+        }
+        break;
+      }
+
+      default:
+        iReturn = EBADF;
+    }
+  }
+
+  if (INV_FILE_HND != g_tState.bmpfile.hFile)
+  {
+    esx_f_close(g_tState.bmpfile.hFile);
+    g_tState.bmpfile.hFile = INV_FILE_HND;
+  }
+
+  if (INV_BANK != s_tZx0.uiBank)
+  {
+    freeBank(s_tZx0.uiBank);
+    s_tZx0.uiBank = INV_BANK;
+  }
+
+  return iReturn;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* saveZx0Block()                                                             */
+/*----------------------------------------------------------------------------*/
+static int saveZx0Block(uint8_t uiType, uint8_t uiPage, uint8_t uiPhysPage, uint16_t uiAddr, uint16_t uiSize)
+{
+  int iReturn;
+  zx0blockheader_t tHeader;
+  uint8_t uiMMU2;
+  uint8_t uiMMU3;
+  const uint8_t* pSrc = (const uint8_t*) zxn_memmap(ZX0_VIDEO_ADDR + (uiAddr & 0x1FFF));
+  uint8_t* pDst = (uint8_t*) zxn_memmap(WORK_BANK_ADDR);
+
+  STATS_DI();
+  uiMMU2 = ZXN_READ_MMU2();
+  uiMMU3 = ZXN_READ_MMU3();
+  STATS_MMU2(uiPhysPage);
+  STATS_MMU3(s_tZx0.uiBank);
+
+  tHeader.uiType   = uiType;
+  tHeader.uiPage   = uiPage;
+  tHeader.uiAddr   = uiAddr;
+  tHeader.uiSize   = uiSize;
+  tHeader.uiPacked = packZx0(pSrc, uiSize, pDst, uiSize - 1);
+
+  if (0 == tHeader.uiPacked)
+  {
+    /* Incompressible: store */
+    tHeader.uiPacked = uiSize;
+    pDst = (uint8_t*) pSrc;
+  }
+
+  if (EOK == (iReturn = writeImageData(&tHeader, sizeof(tHeader))))
+  {
+    iReturn = writeImageData(pDst, tHeader.uiPacked);
+  }
+
+  STATS_MMU3(uiMMU3);
+  STATS_MMU2(uiMMU2);
+  STATS_EI();
+
+  return iReturn;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* saveZx0Raw()                                                               */
+/*----------------------------------------------------------------------------*/
+static int saveZx0Raw(uint8_t uiType, const void* pData, uint16_t uiSize)
+{
+  int iReturn;
+  zx0blockheader_t tHeader;
+
+  tHeader.uiType   = uiType;
+  tHeader.uiPage   = 0;
+  tHeader.uiAddr   = 0;
+  tHeader.uiSize   = uiSize;
+  tHeader.uiPacked = uiSize;
+
+  if (EOK == (iReturn = writeImageData(&tHeader, sizeof(tHeader))))
+  {
+    iReturn = writeImageData(pData, uiSize);
+  }
+
+  return iReturn;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* saveZx0Palette()                                                           */
+/*----------------------------------------------------------------------------*/
+static int saveZx0Palette(const screenmode_t* pInfo)
+{
+  uint16_t uiColors = readColourPalette(pInfo);
+  uint8_t* pPalette = (uint8_t*) &g_tState.bmpfile.tPalette[0];
+
+  /* 9-bit palette in place (2 bytes per entry, 4 bytes per RGB8 entry) */
+  for (uint16_t i = 0; i < uiColors; ++i)
+  {
+    uint16_t uiValue = rgb8_to_rgb9(&g_tState.bmpfile.tPalette[i]);
+
+    pPalette[(i << 1)    ] = (uint8_t) (uiValue >> 1);
+    pPalette[(i << 1) + 1] = (uint8_t) (uiValue & 0x01);
+  }
+
+  return saveZx0Raw(ZX0_BLOCK_PALETTE, pPalette, uiColors << 1);
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* loadZx0Block()                                                             */
+/*----------------------------------------------------------------------------*/
+static int loadZx0Block(uint8_t uiPhysPage, const zx0blockheader_t* pHeader)
+{
+  int iReturn = EOK;
+  uint8_t uiMMU2;
+  uint8_t uiMMU3;
+  uint8_t* pDst = (uint8_t*) zxn_memmap(ZX0_VIDEO_ADDR + (pHeader->uiAddr & 0x1FFF));
+  uint8_t* pSrc = (uint8_t*) zxn_memmap(WORK_BANK_ADDR);
+
+  STATS_DI();
+  uiMMU2 = ZXN_READ_MMU2();
+  uiMMU3 = ZXN_READ_MMU3();
+  STATS_MMU2(uiPhysPage);
+  STATS_MMU3(s_tZx0.uiBank);
+
+  if (pHeader->uiPacked == pHeader->uiSize)
+  {
+    /* Stored: straight into video memory */
+    if (pHeader->uiSize != esx_f_read(g_tState.bmpfile.hFile, pDst, pHeader->uiSize))
+    {
+      iReturn = EBADF;
+    }
+  }
+  else if (pHeader->uiPacked != esx_f_read(g_tState.bmpfile.hFile, pSrc, pHeader->uiPacked))
+  {
+    iReturn = EBADF;
+  }
+  else
+  {
+    dzx0_standard(pSrc, pDst);
+  }
+
+  STATS_MMU3(uiMMU3);
+  STATS_MMU2(uiMMU2);
+  STATS_EI();
+
+  return iReturn;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* packZx0()                                                                  */
+/*----------------------------------------------------------------------------*/
+static uint16_t packZx0(const uint8_t* pSrc, uint16_t uiLen, uint8_t* pDst, uint16_t uiMax)
+{
+  uint16_t uiPos     = 0;
+  uint16_t uiLast    = 1;     /* last offset (initial value of the decoder) */
+  uint16_t uiLitPos  = 0;     /* pending literals                           */
+  uint16_t uiLitLen  = 0;
+  bool     bFirst    = true;  /* first block: literals without indicator    */
+
+  s_tZx0.pOut       = pDst;
+  s_tZx0.uiOut      = 0;
+  s_tZx0.uiMax      = uiMax;
+  s_tZx0.uiBitMask  = 0;
+  s_tZx0.bBacktrack = false;
+
+  memset(s_tZx0.auiHead, 0xFF, sizeof(s_tZx0.auiHead));
+
+  #define ZX0_HASH(p) (((((uint16_t) pSrc[p]) << 2) ^ pSrc[(p) + 1]) & ZX0_HASH_MASK)
+
+  while (uiPos < uiLen)
+  {
+    uint16_t uiAvail   = uiLen - uiPos;
+    uint16_t uiRepLen  = 0;
+    uint16_t uiBestLen = 0;
+    uint16_t uiBestOff = 0;
+    uint16_t uiCand;
+    uint16_t n;
+
+    /* Match at the last offset (only allowed after literals) */
+    if ((0 != uiLitLen) && (uiPos >= uiLast))
+    {
+      for (n = 0; (n < uiAvail) && (pSrc[uiPos + n] == pSrc[uiPos + n - uiLast]); ++n)
+      {
+      }
+
+      uiRepLen = n;
+    }
+
+    /* Match at a new offset (latest position with the same 2 bytes) */
+    if (2 <= uiAvail)
+    {
+      uint16_t uiHash = ZX0_HASH(uiPos);
+
+      uiCand = s_tZx0.auiHead[uiHash];
+      s_tZx0.auiHead[uiHash] = uiPos;
+
+      if ((ZX0_NO_POS != uiCand) && ((uiPos - uiCand) <= ZX0_MAX_OFFSET))
+      {
+        for (n = 0; (n < uiAvail) && (pSrc[uiPos + n] == pSrc[uiCand + n]); ++n)
+        {
+        }
+
+        if ((0 != uiLitLen) && ((uiPos - uiCand) == uiLast))
+        {
+          /* Already found as match at the last offset */
+        }
+        else if (2 <= n)
+        {
+          uiBestLen = n;
+          uiBestOff = uiPos - uiCand;
+        }
+      }
+    }
+
+    /* Short new matches cost more than literals */
+    if ((2 == uiBestLen) && (128 < uiBestOff))
+    {
+      uiBestLen = 0;
+    }
+
+    if ((0 != uiRepLen) && ((uiRepLen + 1) >= uiBestLen))
+    {
+      uiBestLen = uiRepLen;
+      uiBestOff = 0;
+    }
+
+    if (0 == uiBestLen)
+    {
+      /* Literal */
+      uiLitPos  = (0 == uiLitLen ? uiPos : uiLitPos);
+      ++uiLitLen;
+      ++uiPos;
+      continue;
+    }
+
+    /* Pending literals */
+    if (0 != uiLitLen)
+    {
+      if (!bFirst)
+      {
+        putZx0Bit(0);
+      }
+
+      bFirst = false;
+      putZx0Gamma(uiLitLen, 0);
+
+      while (uiLitLen)
+      {
+        putZx0Byte(pSrc[uiLitPos++]);
+        --uiLitLen;
+      }
+    }
+
+    if (0 == uiBestOff)
+    {
+      /* Copy from last offset */
+      putZx0Bit(0);
+      putZx0Gamma(uiBestLen, 0);
+    }
+    else
+    {
+      /* Copy from new offset */
+      putZx0Bit(1);
+      putZx0Gamma(((uiBestOff - 1) >> 7) + 1, 1);
+      putZx0Byte((uint8_t) ((127 - ((uiBestOff - 1) & 0x7F)) << 1));
+      s_tZx0.bBacktrack = true;
+      putZx0Gamma(uiBestLen - 1, 0);
+      uiLast = uiBestOff;
+    }
+
+    /* Positions inside the match */
+    for (n = 1; (n < uiBestLen) && ((uiPos + n + 1) < uiLen); ++n)
+    {
+      s_tZx0.auiHead[ZX0_HASH(uiPos + n)] = uiPos + n;
+    }
+
+    uiPos += uiBestLen;
+
+    if (s_tZx0.uiOut > s_tZx0.uiMax)
+    {
+      break;
+    }
+  }
+
+  #undef ZX0_HASH
+
+  /* Pending literals */
+  if (0 != uiLitLen)
+  {
+    if (!bFirst)
+    {
+      putZx0Bit(0);
+    }
+
+    putZx0Gamma(uiLitLen, 0);
+
+    while (uiLitLen)
+    {
+      putZx0Byte(pSrc[uiLitPos++]);
+      --uiLitLen;
+    }
+  }
+
+  /* End marker */
+  putZx0Bit(1);
+  putZx0Gamma(256, 1);
+
+  return (s_tZx0.uiOut <= s_tZx0.uiMax ? s_tZx0.uiOut : 0);
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* putZx0Byte()                                                               */
+/*----------------------------------------------------------------------------*/
+static void putZx0Byte(uint8_t uiByte)
+{
+  if (s_tZx0.uiOut < s_tZx0.uiMax)
+  {
+    s_tZx0.pOut[s_tZx0.uiOut] = uiByte;
+  }
+
+  ++s_tZx0.uiOut;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* putZx0Bit()                                                                */
+/*----------------------------------------------------------------------------*/
+static void putZx0Bit(uint8_t uiBit)
+{
+  if (s_tZx0.bBacktrack)
+  {
+    /* First bit after the LSB of an offset: bit 0 of that byte */
+    if (uiBit && (s_tZx0.uiOut <= s_tZx0.uiMax))
+    {
+      s_tZx0.pOut[s_tZx0.uiOut - 1] |= 0x01;
+    }
+
+    s_tZx0.bBacktrack = false;
+  }
+  else
+  {
+    if (0 == s_tZx0.uiBitMask)
+    {
+      s_tZx0.uiBitMask = 0x80;
+      s_tZx0.uiBitIdx  = s_tZx0.uiOut;
+      putZx0Byte(0);
+    }
+
+    if (uiBit && (s_tZx0.uiBitIdx < s_tZx0.uiMax))
+    {
+      s_tZx0.pOut[s_tZx0.uiBitIdx] |= s_tZx0.uiBitMask;
+    }
+
+    s_tZx0.uiBitMask >>= 1;
+  }
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* putZx0Gamma()                                                              */
+/*----------------------------------------------------------------------------*/
+static void putZx0Gamma(uint16_t uiValue, uint8_t uiInvert)
+{
+  uint16_t uiMask = 0x8000;
+
+  while (!(uiValue & uiMask))
+  {
+    uiMask >>= 1;
+  }
+
+  /* Interlaced: 0 + data bit for each bit below the leading 1; end: 1 */
+  while (uiMask >>= 1)
+  {
+    putZx0Bit(0);
+    putZx0Bit((uiValue & uiMask ? 1 : 0) ^ uiInvert);
+  }
+
+  putZx0Bit(1);
+}
+
+
+/*----------------------------------------------------------------------------*/
+/*                                                                            */
+/*----------------------------------------------------------------------------*/